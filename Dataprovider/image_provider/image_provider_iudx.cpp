@@ -4,15 +4,17 @@
 #include <boost/program_options.hpp>
 #include <boost/serialization/string.hpp>
 #include <boost/thread.hpp>
+#include <array>
+#include <cmath>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <optional>
-#include <random>
 #include <stdexcept>
 #include <type_traits>
-#include "./fixed-point.h"
+#include <vector>
+#include "compute_server/compute_server.h"
 
 #define MAX_CONNECT_RETRIES 50
 using namespace boost::asio;
@@ -26,13 +28,22 @@ struct Options {
   int cs1_port;
   std::size_t fractional_bits;
   int index;
-  std::string NameofImageFile;
-  std::string fullfilepath;
+  int batch_size;
+  std::vector<std::string> image_paths;
+  bool seed_compressed;
 };
 
 struct Shares {
   uint64_t Delta, delta;
 };
+static_assert(sizeof(Shares) == 2 * sizeof(uint64_t));
+
+// Public shares of the image and the seeds from which the secret shares of
+// compute server 0 and compute server 1 are expanded.
+struct ImageShares {
+  std::vector<uint64_t> Delta;
+  std::array<COMPUTE_SERVER::Seed, 2> seeds;
+};
 
 bool is_valid_IP(const std::string& ip) {
   ip::address ipAddress;
@@ -71,8 +82,10 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
     ("compute-server1-ip", po::value<std::string>()->default_value("127.0.0.1"), "IP address of compute server 1")
     ("compute-server1-port", po::value<int>()->required(), "Port number of compute server 1")
     ("index", po::value<int>()->required(), "Index of image file")
+    ("batch-size", po::value<int>()->default_value(1), "number of consecutive images (starting at index) which are sent as the columns of one tensor")
     ("fractional-bits", po::value<size_t>()->required(), "Number of fractional bits")
     ("filepath", po::value<std::string>()->required(), "Name of the image file for which shares should be created")
+    ("seed-compressed", po::bool_switch()->default_value(false), "send a PRG seed instead of the secret shares (the receivers need the same flag)")
     ;
   // clang-format on
 
@@ -94,18 +107,26 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
   options.cs1_ip = vm["compute-server1-ip"].as<std::string>();
   options.cs1_port = vm["compute-server1-port"].as<int>();
   options.index = vm["index"].as<int>();
-  options.NameofImageFile = "X" + std::to_string(options.index);
-  options.fullfilepath = vm["filepath"].as<std::string>();
+  options.batch_size = vm["batch-size"].as<int>();
   options.fractional_bits = vm["fractional-bits"].as<size_t>();
-  options.fullfilepath += "/images/" + options.NameofImageFile + ".csv";
-  std::cout << "Image Path: " << options.fullfilepath << "\n";
+  options.seed_compressed = vm["seed-compressed"].as<bool>();
   // --------------------------------- Input Validation ---------------------------------------//
-  if (std::ifstream(options.fullfilepath)) {
-    std::cout << "Image file found.";
-  } else {
-    std::cout << "No image file found at " << options.fullfilepath << std::endl;
+  if (options.batch_size < 1) {
+    std::cerr << "Batch size must be at least 1.\n";
     return std::nullopt;
   }
+  for (int i = 0; i < options.batch_size; ++i) {
+    const auto image_path = vm["filepath"].as<std::string>() + "/images/X" +
+                            std::to_string(options.index + i) + ".csv";
+    std::cout << "Image Path: " << image_path << "\n";
+    if (std::ifstream(image_path)) {
+      std::cout << "Image file found.";
+    } else {
+      std::cout << "No image file found at " << image_path << std::endl;
+      return std::nullopt;
+    }
+    options.image_paths.push_back(image_path);
+  }
   // Check whether IP addresses are valid
   if ((!is_valid_IP(options.cs0_ip)) || (!is_valid_IP(options.cs1_ip))) {
     std::cerr << "Invalid IP address." << std::endl;
@@ -122,56 +143,58 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
   return options;
 }
 
-template <typename E>
-std::uint64_t RandomNumDistribution(E& engine) {
-  std::uniform_int_distribution<unsigned long long> distribution(
-      std::numeric_limits<std::uint64_t>::min(), std::numeric_limits<std::uint64_t>::max());
-  return distribution(engine);
+// Encode all values as fixed point numbers in one pass.  Going through int64_t
+// keeps the conversion of negative values well-defined and lets the compiler
+// vectorize the loop.
+void encode_fixed_point(std::vector<std::uint64_t>& encoded, const std::vector<float>& data,
+                        std::size_t fractional_bits) {
+  const double scale = std::exp2(fractional_bits);
+  encoded.resize(data.size());
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    encoded[i] = static_cast<std::uint64_t>(static_cast<std::int64_t>(data[i] * scale));
+  }
 }
 
-int share_generation(std::ifstream& image_data, int num_elements, Shares* cs0_data,
-                     Shares* cs1_data, size_t fractional_bits) {
-  // get input data
-  std::vector<float> data;
+// Reads one image into column `column` of the row-major rows x batch_size matrix `data`.
+int read_image(std::ifstream& image_data, int rows, int batch_size, int column,
+               std::vector<float>& data) {
+  int num_values = 0;
   std::string line;
   while (std::getline(image_data, line)) {
     float temp;
     std::istringstream iss(line);
     if (iss >> temp) {
-      data.push_back(temp);
+      if (num_values < rows) {
+        data[num_values * batch_size + column] = temp;
+      }
+      ++num_values;
     }
   }
-  auto data_size = data.size();
-  if (data_size != (num_elements)) {
-    std::cerr << "Image file should have " << num_elements << " values. It has " << data_size
+  if (num_values != rows) {
+    std::cerr << "Image file should have " << rows << " values. It has " << num_values
               << " values." << std::endl;
     return EXIT_FAILURE;
   }
+  return EXIT_SUCCESS;
+}
 
+int share_generation(const std::vector<float>& data, ImageShares& shares,
+                     size_t fractional_bits) {
+  auto data_size = data.size();
   std::cout << "Generating image shares. \n";
   // Now that we have the data, need to generate the shares
   try {
-    for (int i = 0; i < data_size; i++) {
-      std::random_device rd;
-      std::mt19937 gen(rd());
-      std::uint64_t del0 = RandomNumDistribution(gen), del1 = RandomNumDistribution(gen);
-      std::uint64_t Del =
-          del0 + del1 + MOTION::new_fixed_point::encode<uint64_t, float>(data[i], fractional_bits);
-
-      // For each data, creating 2 shares variables - 1 for computer server 0  and another for
-      // compute server 1
-      Shares cs0, cs1;
+    // The secret shares of each compute server are expanded from a fresh seed,
+    // so that they can be sent either in full or as the seed only.
+    shares.seeds = {COMPUTE_SERVER::sample_seed(), COMPUTE_SERVER::sample_seed()};
+    const auto del0 = COMPUTE_SERVER::expand_seed(shares.seeds[0], data_size);
+    const auto del1 = COMPUTE_SERVER::expand_seed(shares.seeds[1], data_size);
+    std::vector<std::uint64_t> encoded;
+    encode_fixed_point(encoded, data, fractional_bits);
 
-      cs0.Delta = Del;
-      cs0.delta = del0;
-
-      cs1.Delta = Del;
-      cs1.delta = del1;
-
-      cs0_data[i] = cs0;
-      cs1_data[i] = cs1;
-      // std::cout << "Data = " << data[i] << " Delta = " << cs0.Delta << " delta0 = " << cs0.delta
-      //      << " delta1 = " << cs1.delta << "\n";
+    shares.Delta.resize(data_size);
+    for (std::size_t i = 0; i < data_size; ++i) {
+      shares.Delta[i] = del0[i] + del1[i] + encoded[i];
     }
   } catch (std::exception& e) {
     std::cerr << "Error during image share generation: " << e.what() << std::endl;
@@ -180,17 +203,25 @@ int share_generation(std::ifstream& image_data, int num_elements, Shares* cs0_da
   return EXIT_SUCCESS;
 }
 
-void write_struct(tcp::socket& socket, Shares* data, int num_elements) {
+// Sends the shares of compute server id with a single write.  Shares is laid
+// out as the (Delta, delta) pair the receiver expects.  In the seed compressed
+// format only the seed and the public shares are sent.
+void write_struct(tcp::socket& socket, const ImageShares& shares, int id, bool seed_compressed) {
   boost::system::error_code error;
-  for (int i = 0; i < num_elements; i++) {
-    uint64_t arr[2];
-    arr[0] = data[i].Delta;
-    arr[1] = data[i].delta;
-    // std::cout << arr[0] << " " << arr[1] << "\n";
-    boost::asio::write(socket, boost::asio::buffer(&arr, sizeof(arr)), error);
-    if (error) {
-      std::cerr << "Unable to send share " << i + 1 << ".\nError: " << error.message() << std::endl;
+  if (seed_compressed) {
+    std::array<boost::asio::const_buffer, 2> buffers = {boost::asio::buffer(shares.seeds[id]),
+                                                        boost::asio::buffer(shares.Delta)};
+    boost::asio::write(socket, buffers, error);
+  } else {
+    const auto delta = COMPUTE_SERVER::expand_seed(shares.seeds[id], shares.Delta.size());
+    std::vector<Shares> data(shares.Delta.size());
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      data[i] = {shares.Delta[i], delta[i]};
     }
+    boost::asio::write(socket, boost::asio::buffer(data), error);
+  }
+  if (error) {
+    throw std::runtime_error("Unable to send shares. Error: " + error.message());
   }
 }
 
@@ -201,29 +232,33 @@ int main(int argc, char* argv[]) {
     std::cerr << "Error while parsing the given input options.\n";
     return EXIT_FAILURE;
   }
-  int rows = 784, columns = 1;  // hardcoded
-  int num_elements = rows * columns;
-  Shares cs0_data[num_elements];
-  Shares cs1_data[num_elements];
-  // Reading contents from image file
-  std::ifstream image_file;
-  try {
-    image_file.open(options->fullfilepath);
-    if (!image_file) {
-      std::cerr << "Unable to open the image file.\n";
-      throw std::ifstream::failure("Error opening the image file.");
-    }
-    std::cout << "Image: " << options->NameofImageFile << "\n";
-    int is_error =
-        share_generation(image_file, num_elements, cs0_data, cs1_data, options->fractional_bits);
-    if (is_error) {
+  // every image is one column of the tensor, so that the compute servers can
+  // evaluate the whole batch with matrix-matrix products
+  int rows = 784, columns = options->batch_size;  // hardcoded
+  std::vector<float> data(rows * columns);
+  ImageShares shares;
+  // Reading contents from image files
+  for (int column = 0; column < columns; ++column) {
+    std::ifstream image_file;
+    try {
+      image_file.open(options->image_paths[column]);
+      if (!image_file) {
+        std::cerr << "Unable to open the image file.\n";
+        throw std::ifstream::failure("Error opening the image file.");
+      }
+      std::cout << "Image: X" << options->index + column << "\n";
+      int is_error = read_image(image_file, rows, columns, column, data);
+      image_file.close();
+      if (is_error) {
+        return EXIT_FAILURE;
+      }
+    } catch (const std::ifstream::failure& e) {
+      std::cerr << "Error in image share generation: " << e.what() << std::endl;
       image_file.close();
       return EXIT_FAILURE;
     }
-    image_file.close();
-  } catch (const std::ifstream::failure& e) {
-    std::cerr << "Error in image share generation: " << e.what() << std::endl;
-    image_file.close();
+  }
+  if (share_generation(data, shares, options->fractional_bits)) {
     return EXIT_FAILURE;
   }
   for (int id = 0; id < 2; id++) {
@@ -308,11 +343,7 @@ int main(int argc, char* argv[]) {
     // --------------------------------- Sending shares to
     // compute_server----------------------------------------------------
     try {
-      auto data1 = cs0_data;
-      if (id == 1) {
-        data1 = cs1_data;
-      }
-      write_struct(socket, data1, num_elements);
+      write_struct(socket, shares, id, options->seed_compressed);
       socket.close();
       std::cout << "Finished sending the shares to server " << id << "\n";
 
@@ -2,12 +2,14 @@
 //  --compute-server1-ip 127.0.0.1 --compute-server1-port 1235 --fractional-bits 13
 //  --filepath ${BASE_DIR}/data/ModelProvider --config-file-path ${BASE_DIR}/config_files/model_config.json
 
+#include <array>
+#include <cmath>
 #include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <optional>
-#include <random>
+#include <vector>
 #include <stdexcept>
 #include <type_traits>
 #include <boost/chrono.hpp>
@@ -18,7 +20,7 @@
 #include <boost/serialization/string.hpp>
 #include <boost/property_tree/json_parser.hpp>
 #include <boost/property_tree/ptree.hpp>
-#include "./fixed-point.h"
+#include "compute_server/compute_server.h"
 
 #define MAX_CONNECT_RETRIES 50
 using namespace std::chrono;
@@ -36,6 +38,7 @@ struct Options {
   std::string model_directory;
   std::filesystem::path config_file;
   int numberOfLayers;
+  bool seed_compressed;
 };
 bool is_valid_IP(const std::string& ip) {
   ip::address ipAddress;
@@ -82,6 +85,7 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
     ("fractional-bits", po::value<size_t>()->required(), "Number of fractional bits")
     ("filepath", po::value<std::string>()->required(), "Directory where the weights and biases are stored")
     ("config-file-path", po::value<std::string>()->required(), "File path which has the name of all the weights and bias csv files")
+    ("seed-compressed", po::bool_switch()->default_value(false), "send a PRG seed instead of the secret shares (the receivers need the same flag)")
     ;
   // clang-format on
 
@@ -108,6 +112,7 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
   options.fractional_bits = vm["fractional-bits"].as<size_t>();
   options.model_directory = vm["filepath"].as<std::string>();
   options.config_file = vm["config-file-path"].as<std::string>();
+  options.seed_compressed = vm["seed-compressed"].as<bool>();
   // --------------------------------- Input Validation ---------------------------------------//
 
   // Check whether IP addresses are valid
@@ -137,31 +142,31 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
   return options;
 }
 
-template <typename E>
-std::uint64_t RandomNumDistribution(E& engine) {
-  std::uniform_int_distribution<unsigned long long> distribution(std::numeric_limits<std::uint64_t>::min(),
-                                                        std::numeric_limits<std::uint64_t>::max());
-  return distribution(engine);
-}
-
 struct Shares {
   uint64_t Delta, delta;
 };
+static_assert(sizeof(Shares) == 2 * sizeof(uint64_t));
 
 //----------------------------------Sending shares------------------------------------------//
-void write_struct_vector(tcp::socket& socket, Shares* data, int num_elements) {
-  uint64_t arr[2 * num_elements];
-  int j = 0;
-  for (int i = 0; i < num_elements; i++) {
-    // uint64_t arr[2];
-    arr[j] = data[i].Delta;
-    j++;
-    arr[j] = data[i].delta;
-    j++;
-  }
+// Shares is laid out as the (Delta, delta) pair the receiver expects, so the
+// whole matrix is sent with a single write.  In the seed compressed format
+// only the seed and the public shares are sent.
+void write_struct_vector(tcp::socket& socket, const std::vector<uint64_t>& Delta,
+                         const COMPUTE_SERVER::Seed& seed, bool seed_compressed) {
   boost::system::error_code error;
   std::cout << "Started sending the weight shares." <<std::endl;
-  boost::asio::write(socket, boost::asio::buffer(&arr, sizeof(arr)), error);
+  if (seed_compressed) {
+    std::array<boost::asio::const_buffer, 2> buffers = {boost::asio::buffer(seed),
+                                                        boost::asio::buffer(Delta)};
+    boost::asio::write(socket, buffers, error);
+  } else {
+    const auto delta = COMPUTE_SERVER::expand_seed(seed, Delta.size());
+    std::vector<Shares> data(Delta.size());
+    for (std::size_t i = 0; i < data.size(); ++i) {
+      data[i] = {Delta[i], delta[i]};
+    }
+    boost::asio::write(socket, boost::asio::buffer(data), error);
+  }
   if (error) 
       {
       throw std::runtime_error("Unable to send shares.\nError:"+ error.message() + "\n");
@@ -169,29 +174,14 @@ void write_struct_vector(tcp::socket& socket, Shares* data, int num_elements) {
   std::cout<<"Sent successfully\n";
 }
 
-void write_struct(tcp::socket& socket, Shares* data, int num_elements) {
-  for (int i = 0; i < num_elements; i++) {
-    uint64_t arr[2];
-    arr[0] = data[i].Delta;
-    arr[1] = data[i].delta;
-
-    boost::system::error_code error;
-    boost::asio::write(socket, boost::asio::buffer(&arr, sizeof(arr)), error);
-    if (error) 
-          {
-          std::cerr << "Unable to send share "<< i+1<<".\nError: " << error.message() << std::endl;
-          return;
-          }
-    }
-    std::cout<<"Sent successfully\n";
-}
-
 class Matrix {
  private:
   uint64_t rows, columns, num_elements, fractional_bits;
   std::string fullFileName;
   std::vector<float> data;
-  struct Shares *cs0_data, *cs1_data;
+  // public shares and the seeds of the secret shares of CS0 and CS1
+  std::vector<uint64_t> Delta;
+  std::array<COMPUTE_SERVER::Seed, 2> seeds;
 
  public:
   Matrix(int row, int col, std::string fileName, std::size_t fraction_bits,
@@ -203,28 +193,20 @@ class Matrix {
 
     fullFileName = fileName;
     std::cout << fullFileName << std::endl;
-    cs0_data = (struct Shares*)malloc(sizeof(struct Shares) * num_elements);
-    cs1_data = (struct Shares*)malloc(sizeof(struct Shares) * num_elements);
   }
   //------- Function to access rows and columns of a Matrix, Ramya May 3,2023----------
-  std::pair<int, int> getShareDimensions() {
+  std::pair<int, int> getShareDimensions() const {
     std::pair<int, int> dimensions;
     dimensions.first = rows;
     dimensions.second = columns;
     return dimensions;
   }
 
-  int getNumberofElements() { return num_elements; }
-  std::string getFileName() { return fullFileName; }
+  int getNumberofElements() const { return num_elements; }
+  std::string getFileName() const { return fullFileName; }
   //------------ Function to aceess data from the Matrix, Ramya May 3,2023 -------------
-  Shares* getData(int a) {
-    if (a == 0) {
-      return cs0_data;
-    } 
-    else {
-      return cs1_data;
-    }
-  }
+  const std::vector<uint64_t>& getPublicShares() const { return Delta; }
+  const COMPUTE_SERVER::Seed& getSeed(int a) const { return seeds[a]; }
 
   void readMatrixCSV() {
     auto start = high_resolution_clock::now();
@@ -260,34 +242,26 @@ class Matrix {
   void generateShares() {
     // Now that we have data, need to generate the shares
     try{
-        for (int i = 0; i < data.size(); i++) {
-          std::random_device rd;
-          std::mt19937 gen(rd());
-          std::uint64_t del0 = RandomNumDistribution(gen), del1 = RandomNumDistribution(gen);
-          std::uint64_t Del =
-              del0 + del1 +
-              MOTION::new_fixed_point::encode<uint64_t, long double>(data[i], fractional_bits);
-          // For each data, creating 2 shares variables - 1 for CS0 and another for CS1
-          Shares cs0, cs1;
-
-          cs0.Delta = Del;
-          cs0.delta = del0;
-
-          cs1.Delta = Del;
-          cs1.delta = del1;
-
-          cs0_data[i] = cs0;
-          cs1_data[i] = cs1;
-
-          // std::cout << "Data = " << data[i] << " Delta = " << cs0.Delta << " delta0 = " << cs0.delta
-          // << " delta1 = " << cs1.delta << "\n";
+        const auto n = data.size();
+        // The secret shares of CS0 and CS1 are expanded from fresh seeds, so that
+        // they can be sent either in full or as the seed only.
+        seeds = {COMPUTE_SERVER::sample_seed(), COMPUTE_SERVER::sample_seed()};
+        const auto del0 = COMPUTE_SERVER::expand_seed(seeds[0], n);
+        const auto del1 = COMPUTE_SERVER::expand_seed(seeds[1], n);
+
+        // Going through int64_t keeps the fixed point encoding of negative
+        // values well-defined and lets the compiler vectorize the loop.
+        const double scale = std::exp2(fractional_bits);
+        Delta.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+          const auto encoded = static_cast<std::uint64_t>(static_cast<std::int64_t>(data[i] * scale));
+          Delta[i] = del0[i] + del1[i] + encoded;
         }
       }
     catch(std::exception& e){
       std::string err = e.what();
       throw std::runtime_error("Error during share generation: " + err + "\n");
     }
-    // return EXIT_SUCCESS;
   }
 };
 
@@ -378,7 +352,7 @@ std::vector<Matrix> read_Data(Options& options) {
   return allData;
 }
 
-void send_shares_to_servers(std::vector<Matrix> data_shares, const Options& options) {
+void send_shares_to_servers(const std::vector<Matrix>& data_shares, const Options& options) {
   std::cout << "Sending shares to the compute servers." << std::endl;
 
   for(int i = 1; i >= 0; --i) {
@@ -452,7 +426,7 @@ void send_shares_to_servers(std::vector<Matrix> data_shares, const Options& opti
     std::cout << "Received response: "<< data << std::endl;
     // ------------------------------------ Sending shares ------------------------------------------------
     std::cout<<"Start sending all the weight and bias shares\n";
-    for (auto data_array : data_shares) {
+    for (const auto& data_array : data_shares) {
       std::cout << "File name:" << data_array.getFileName() << "\n";
       // ----Send rows and columns to compute server----
       int rows, columns;
@@ -480,12 +454,7 @@ void send_shares_to_servers(std::vector<Matrix> data_shares, const Options& opti
       std::cout <<"Received Response: " << data << std::endl;
       
       // -----Sending share data to compute_server------
-      auto share_data = data_array.getData(0);
-      if (i) {
-        share_data = data_array.getData(1);
-      }
       // std::cout << "inside main size of cs 0 data:" << sizeof(cs0_data)<< "\n";
-      // std::cout << "inside main size of data:" << sizeof(share_data)<< "\n";
       //  Use auto keyword to avoid typing long
       //  type definitions to get the timepoint
       //  at this instant use function now()
@@ -494,7 +463,8 @@ void send_shares_to_servers(std::vector<Matrix> data_shares, const Options& opti
       std::cout << "Number of elements:" << num_of_elements << std::endl;
       std::cout << "....Sending data...." << "\n";
       try{
-        write_struct_vector(socket, share_data, num_of_elements);
+        write_struct_vector(socket, data_array.getPublicShares(), data_array.getSeed(i),
+                            options.seed_compressed);
       }
       catch(std::runtime_error& e){
           socket.close();
@@ -169,7 +169,7 @@ do
    echo "Layer $layer_id: Matrix multiplication and addition is done"
 
    #######################################ReLu layer 1 ####################################################################################
-   $build_path/bin/tensor_gt_relu --my-id 0 --party 0,$cs0_host,$relu0_port_inference --party 1,$cs1_host,$relu1_port_inference --arithmetic-protocol beavy --boolean-protocol yao --fractional-bits $fractional_bits --filepath file_config_input0 --current-path $build_path > $debug_0/tensor_gt_relu1_layer0.txt &
+   $build_path/bin/tensor_gt_relu --my-id 0 --party 0,$cs0_host,$relu0_port_inference --party 1,$cs1_host,$relu1_port_inference --arithmetic-protocol beavy --boolean-protocol yao --fractional-bits $fractional_bits --filepath server0/outputshare_0 --current-path $build_path > $debug_0/tensor_gt_relu1_layer0.txt &
    pid1=$!
    wait $pid1
    check_exit_statuses $?
@@ -199,7 +199,7 @@ check_exit_statuses $?
 echo "Layer $layer_id: Matrix multiplication and addition is done"
 
 ####################################### Argmax  ###########################################################################
-$build_path/bin/argmax --my-id 0 --threads 1 --party 0,$cs0_host,$cs0_port_inference --party 1,$cs1_host,$cs1_port_inference --arithmetic-protocol beavy --boolean-protocol beavy --repetitions 1 --config-filename file_config_input0 --config-input $image_share --current-path $build_path > $debug_0/argmax0_layer2.txt &
+$build_path/bin/argmax --my-id 0 --threads 1 --party 0,$cs0_host,$cs0_port_inference --party 1,$cs1_host,$cs1_port_inference --arithmetic-protocol beavy --boolean-protocol beavy --repetitions 1 --config-filename server0/outputshare_0 --config-input $image_share --current-path $build_path > $debug_0/argmax0_layer2.txt &
 pid1=$!
 wait $pid1
 check_exit_statuses $?
@@ -183,8 +183,7 @@ for split_layer in $(echo "$smpc_config" | jq -r '.split_layers_genr[] | @base64
       check_exit_statuses $? 
       echo "Layer $layer_id, split $m: Matrix multiplication and addition is done."
       if [ $m -eq 1 ]; then
-         touch finaloutput_0
-         printf "$x 1\n" > finaloutput_0
+         rm -f finaloutput_0
          $build_path/bin/appendfile 0
          pid1=$!
          wait $pid1 
@@ -195,13 +194,12 @@ for split_layer in $(echo "$smpc_config" | jq -r '.split_layers_genr[] | @base64
          wait $pid1 
          check_exit_statuses $?
       fi
-	   sed -i "1s/${r} 1/${b} 1/" finaloutput_0
    done
 
    cp finaloutput_0  $build_path/server0/outputshare_0 
    check_exit_statuses $?
 ####################################### ReLu layer 1 ####################################################################################
-   $build_path/bin/tensor_gt_relu --my-id 0 --party 0,$cs0_host,$cs0_port_inference --party 1,$cs1_host,$cs1_port_inference --arithmetic-protocol beavy --boolean-protocol yao --fractional-bits $fractional_bits --filepath file_config_input0 --current-path $build_path > $debug_0/tensor_gt_relu1_layer0.txt &
+   $build_path/bin/tensor_gt_relu --my-id 0 --party 0,$cs0_host,$cs0_port_inference --party 1,$cs1_host,$cs1_port_inference --arithmetic-protocol beavy --boolean-protocol yao --fractional-bits $fractional_bits --filepath server0/outputshare_0 --current-path $build_path > $debug_0/tensor_gt_relu1_layer0.txt &
    pid1=$!
    wait $pid1
    check_exit_statuses $?
@@ -245,7 +243,7 @@ for((; layer_id<$number_of_layers; layer_id++)); do
    echo "Layer $layer_id: Matrix multiplication and addition is done"
 
 ####################################### ReLu ####################################################################################
-   $build_path/bin/tensor_gt_relu --my-id 0 --party 0,$cs0_host,$cs0_port_inference --party 1,$cs1_host,$cs1_port_inference --arithmetic-protocol beavy --boolean-protocol yao --fractional-bits $fractional_bits --filepath file_config_input0 --current-path $build_path > $debug_0/tensor_gt_relu0_layer${layer_id}.txt &
+   $build_path/bin/tensor_gt_relu --my-id 0 --party 0,$cs0_host,$cs0_port_inference --party 1,$cs1_host,$cs1_port_inference --arithmetic-protocol beavy --boolean-protocol yao --fractional-bits $fractional_bits --filepath server0/outputshare_0 --current-path $build_path > $debug_0/tensor_gt_relu0_layer${layer_id}.txt &
    pid1=$!
    wait $pid1 
    check_exit_statuses $?
@@ -265,7 +263,7 @@ check_exit_statuses $?
 echo "Layer $layer_id: Matrix multiplication and addition is done"
 
 ####################################### Argmax  ###########################################################################
-$build_path/bin/argmax --my-id 0 --threads 1 --party 0,$cs0_host,$cs0_port_inference --party 1,$cs1_host,$cs1_port_inference --arithmetic-protocol beavy --boolean-protocol beavy --repetitions 1 --config-filename file_config_input0 --config-input $image_share --current-path $build_path  > $debug_0/argmax0_layer2.txt &
+$build_path/bin/argmax --my-id 0 --threads 1 --party 0,$cs0_host,$cs0_port_inference --party 1,$cs1_host,$cs1_port_inference --arithmetic-protocol beavy --boolean-protocol beavy --repetitions 1 --config-filename server0/outputshare_0 --config-input $image_share --current-path $build_path  > $debug_0/argmax0_layer2.txt &
 pid1=$!
 wait $pid1 
 check_exit_statuses $?
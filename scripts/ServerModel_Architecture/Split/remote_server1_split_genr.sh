@@ -182,10 +182,7 @@ for split_layer in $(echo "$smpc_config" | jq -r '.split_layers_genr[] | @base64
    
    if [ $m -eq 1 ];then
 
-      touch finaloutput_1
-
-      printf "$x 1\n" >> finaloutput_1
-
+      rm -f finaloutput_1
       $build_path/bin/appendfile 1
       pid1=$!
       wait $pid1 
@@ -197,16 +194,13 @@ for split_layer in $(echo "$smpc_config" | jq -r '.split_layers_genr[] | @base64
       wait $pid1 
       check_exit_statuses $? 
     fi
-
-	sed -i "1s/${r} 1/${b} 1/" finaloutput_1
-
 done
 
 cp finaloutput_1  $build_path/server1/outputshare_1
 check_exit_statuses $? 
 
 #######################################ReLu layer 1 ####################################################################################
-$build_path/bin/tensor_gt_relu --my-id 1 --party 0,$cs0_host,$cs0_port_inference --party 1,$cs1_host,$cs1_port_inference --arithmetic-protocol beavy --boolean-protocol yao --fractional-bits $fractional_bits --filepath file_config_input1 --current-path $build_path > $debug_1/tensor_gt_relu1_layer${layer_id}.txt &
+$build_path/bin/tensor_gt_relu --my-id 1 --party 0,$cs0_host,$cs0_port_inference --party 1,$cs1_host,$cs1_port_inference --arithmetic-protocol beavy --boolean-protocol yao --fractional-bits $fractional_bits --filepath server1/outputshare_1 --current-path $build_path > $debug_1/tensor_gt_relu1_layer${layer_id}.txt &
 pid1=$!
 wait $pid1 
 check_exit_statuses $? 
@@ -246,7 +240,7 @@ check_exit_statuses $?
 echo "Layer $layer_id: Matrix multiplication and addition is done"
 
 #######################################ReLu layer 1 ####################################################################################
-$build_path/bin/tensor_gt_relu --my-id 1 --party 0,$cs0_host,$cs0_port_inference --party 1,$cs1_host,$cs1_port_inference --arithmetic-protocol beavy --boolean-protocol yao --fractional-bits $fractional_bits --filepath file_config_input1 --current-path $build_path > $debug_1/tensor_gt_relu1_layer1.txt &
+$build_path/bin/tensor_gt_relu --my-id 1 --party 0,$cs0_host,$cs0_port_inference --party 1,$cs1_host,$cs1_port_inference --arithmetic-protocol beavy --boolean-protocol yao --fractional-bits $fractional_bits --filepath server1/outputshare_1 --current-path $build_path > $debug_1/tensor_gt_relu1_layer1.txt &
 pid1=$!
 
 wait $pid1 
@@ -266,7 +260,7 @@ echo "Layer $layer_id: Matrix multiplication and addition is done"
 
 ####################################### Argmax  ###########################################################################
 
-$build_path/bin/argmax --my-id 1 --threads 1 --party 0,$cs0_host,$cs0_port_inference --party 1,$cs1_host,$cs1_port_inference --arithmetic-protocol beavy --boolean-protocol beavy --repetitions 1 --config-filename file_config_input1 --config-input $image_share --current-path $build_path  > $debug_1/argmax1_layer${layer_id}.txt &
+$build_path/bin/argmax --my-id 1 --threads 1 --party 0,$cs0_host,$cs0_port_inference --party 1,$cs1_host,$cs1_port_inference --arithmetic-protocol beavy --boolean-protocol beavy --repetitions 1 --config-filename server1/outputshare_1 --config-input $image_share --current-path $build_path  > $debug_1/argmax1_layer${layer_id}.txt &
 pid1=$!
 
 wait $pid1 
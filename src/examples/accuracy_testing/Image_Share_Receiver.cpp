@@ -36,9 +36,10 @@
 #include <boost/log/trivial.hpp>
 #include <boost/program_options.hpp>
 
-#include "compute_server/compute_server.h"
+#include "compute_server/share_ingestion_server.h"
 #include "utility/logger.h"
 #include "utility/fixed_point.h"
+#include "utility/share_file.h"
 
 namespace po = boost::program_options;
 
@@ -58,6 +59,7 @@ struct Options {
   std::vector<std::string> filepaths;
   std::string currentpath;
   int port;
+  bool seed_compressed;
 };
 
 void read_filenames(Options& options) {
@@ -120,35 +122,21 @@ void generate_filepaths(Options& options) {
 
 
 void retrieve_shares(Options& options) {
-  std::ofstream shares_file;
-  auto [frac_bits, shares_and_sizes] = COMPUTE_SERVER::get_provider_mat_mul_data(options.port);
-  std::vector<COMPUTE_SERVER::Shares> image_shares_all = shares_and_sizes.first;
-  // options.image.row = shares_and_sizes.second[0];
-  // options.image.col = shares_and_sizes.second[1];
-  options.fractional_bits = frac_bits;
+  COMPUTE_SERVER::ShareIngestionServer server(options.port, 1, options.seed_compressed);
+  const auto upload = server.receive_upload();
+  const auto& image = upload.tensors_.at(0);
+  options.fractional_bits = upload.fractional_bits_;
 
   auto temp = options.filepaths[1];
-  shares_file.open(temp, std::ios_base::out);
-  if (!shares_file) {
-    std::cerr << "Unable to create/open file "<<temp<<"\n";
-    throw std::runtime_error("Unable to create file " + temp+"\n");
-    // return EXIT_FAILURE;
-  }
-  try{
-    shares_file << shares_and_sizes.second[0] << " " << shares_and_sizes.second[1] << "\n";
-    std::cout << "Number of image share pairs received:" << image_shares_all.size() << "\n";
-    for (int i = 0; i < image_shares_all.size(); i++) {
-      // options.image.Delta.push_back(image_shares_all[i].Delta);
-      // options.image.delta.push_back(image_shares_all[i].delta);
-      shares_file << image_shares_all[i].Delta << " " << image_shares_all[i].delta << "\n";
-    }
+  std::cout << "Number of image share pairs received:" << image.public_shares_.size() << "\n";
+  try {
+    MOTION::write_share_file<std::uint64_t>(temp, options.my_id, options.fractional_bits,
+                                            image.rows_, image.cols_, image.public_shares_,
+                                            image.secret_shares_);
+  } catch (std::exception& e) {
+    std::cerr << "Error while writing shares to file. Error: " << e.what() << std::endl;
+    throw std::runtime_error("Unable to write image shares to " + temp + "\n");
   }
-  catch(std::exception& e)
-    {
-      std::cerr<<"Error while writing shares to file. Error: "<<e.what()<<std::endl;
-      // return EXIT_FAILURE;
-    }
-  shares_file.close();
 
   // int count = 0;
   // std::string line;
@@ -179,6 +167,7 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
     ("fractional-bits", po::value<std::size_t>()->default_value(16), "number of fractional bits for fixed-point arithmetic")
     ("file-names",po::value<std::string>()->required(), "filename")
     ("current-path",po::value<std::string>()->required(), "current path build_debwithrelinfo")
+    ("seed-compressed", po::bool_switch()->default_value(false), "the provider sends a PRG seed instead of the secret shares")
     ;
   // clang-format on
 
@@ -203,6 +192,7 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
   options.fractional_bits = vm["fractional-bits"].as<std::size_t>();
   options.filenames = vm["file-names"].as<std::string>();
   options.currentpath = vm["current-path"].as<std::string>();
+  options.seed_compressed = vm["seed-compressed"].as<bool>();
   // ----------------- Input Validation ----------------------------------------//
   if (options.my_id > 1) {
     std::cerr << "my-id must be 0 or 1\n";
@@ -1,8 +1,8 @@
 /*
 ./bin/argmax --my-id 0 --party 0,::1,7000 --party 1,::1,7001 --arithmetic-protocol
-beavy --boolean-protocol yao --repetitions 1 --config-filename file_config_input0 --config-input X
+beavy --boolean-protocol yao --repetitions 1 --config-filename server0/outputshare_0 --config-input X
 ./bin/argmax --my-id 1 --party 0,::1,7000 --party 1,::1,7001 --arithmetic-protocol
-beavy --boolean-protocol yao --repetitions 1 --config-filename file_config_input1 --config-input X
+beavy --boolean-protocol yao --repetitions 1 --config-filename server1/outputshare_1 --config-input X
 */
 // MIT License
 //
@@ -49,6 +49,7 @@ beavy --boolean-protocol yao --repetitions 1 --config-filename file_config_input
 #include "compute_server/compute_server.h"
 #include "statistics/analysis.h"
 #include "utility/logger.h"
+#include "utility/share_file.h"
 
 #include "base/two_party_tensor_backend.h"
 #include "protocols/beavy/tensor.h"
@@ -87,8 +88,6 @@ struct Options {
   Matrix input;
 };
 
-bool is_empty(std::ifstream& file) { return file.peek() == std::ifstream::traits_type::eof(); }
-
 void testMemoryOccupied(int WriteToFiles, int my_id, std::string path) {
   int tSize = 0, resident = 0, share = 0;
   std::ifstream buffer("/proc/self/statm");
@@ -143,120 +142,22 @@ std::uint64_t read_file(std::ifstream& indata) {
   return ret;
 }
 
-std::string read_filepath(std::ifstream& indata) {
-  // std::cout << "Inside read file path\n";
-  std::string str;
-
-  char num;
-  while (indata) {
-    // std::cout << "inside while \n";
-    std::getline(indata, str);
-    // std::cout << str << std::endl;
-  }
-  // std::cout << "string read filepath:" << str << " \n";
-  return str;
-}
-
-int input_shares(Options* options, std::string p) {
-  std::ifstream indata;
-  try {
-    if (std::ifstream(p)) {
-      std::cout << "File found\n";
-    } else {
-      std::cout << "File not found\n";
-    }
-    indata.open(p);
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while opening the input bias share file.\n";
-    return EXIT_FAILURE;
-  }
-
-  try {
-    if (is_empty(indata)) {
-      // file is empty
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Input share file is empty.\n";
-    return EXIT_FAILURE;
-  }
-
-  int num_elements, col;
-  try {
-    num_elements = read_file(indata);
-    std::cout << "num_elements: " << num_elements << " ";
-    col = read_file(indata);
-    std::cout << "col: " << col << "\n";
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while reading rows and columns from input share file.\n";
-    return EXIT_FAILURE;
-  }
-
-  options->num_elements = num_elements;
-  options->col = col;
-
-  for (int i = 0; i < options->num_elements; i++) {
-    try {
-      uint64_t m1 = read_file(indata);
-      options->input.Delta_T.push_back(m1);
-      uint64_t m2 = read_file(indata);
-      options->input.delta_T.push_back(m2);
-    } catch (std::ifstream::failure e) {
-      std::cerr << "Error while reading the input share file.\n";
-      return EXIT_FAILURE;
-    }
-  }
-  indata.close();
-}
-
 int file_read(Options* options) {
-  std::string path = options->currentpath;
-  // std::string path = std::filesystem::current_path();
-  std::string t1 = path + "/" + options->filepath;
-  std::cout << t1 << std::endl;
-
-  // std::string t2 = path + "/" + "server" + std::to_string(options->my_id) + "/Actual_label/" +
-  //                  "remote_share_actual_answer";
-  //  std::cout << t2 << std::endl;
-
-  std::ifstream file1;
-
-  try {
-    if (std::ifstream(t1)) {
-      std::cout << "File found\n";
-    } else {
-      std::cout << "File not found\n";
-    }
-    file1.open(t1);
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while opening the file_config_input.\n";
-    return EXIT_FAILURE;
-  }
-
+  const auto path = options->currentpath + "/" + options->filepath;
   try {
-    if (is_empty(file1)) {
-      // file is empty
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Input share file is empty.\n";
+    const MOTION::MappedShareFile file(path);
+    const auto& header = file.get_header();
+    const auto public_shares = file.get_public_shares<std::uint64_t>();
+    const auto secret_shares = file.get_secret_shares<std::uint64_t>();
+    options->num_elements = header.rows_;
+    options->col = header.cols_;
+    options->input.Delta_T.assign(std::begin(public_shares), std::end(public_shares));
+    options->input.delta_T.assign(std::begin(secret_shares), std::end(secret_shares));
+  } catch (std::runtime_error& e) {
+    std::cerr << "Error while reading the input shares: " << e.what() << "\n";
     return EXIT_FAILURE;
   }
-
-  std::string i = read_filepath(file1);
-  // std::cout << "i:" << i << "\n";
-
-  file1.close();
-  input_shares(options, i);
-
-  // reading input number for test case
-
-  // file1.open(t2);
-  // if (file1) {
-  //   std::cout << "File found\n";
-  // } else {
-  //   std::cout << "File not found\n";
-  // }
-  // options->x = read_file(file1);
-  // file1.close();
+  return EXIT_SUCCESS;
 }
 
 std::optional<Options> parse_program_options(int argc, char* argv[]) {
@@ -266,7 +167,7 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
   desc.add_options()
     ("help,h", po::bool_switch()->default_value(false),"produce help message")
     ("config-file", po::value<std::string>(), "config file containing options")
-    ("config-filename", po::value<std::string>()->required(), "Path of the shares file from build_debwithrelinfo folder")
+    ("config-filename", po::value<std::string>()->required(), "path of the share file relative to the current path, e.g., server0/outputshare_0")
     ("config-input", po::value<std::string>()->required(), "Path of the input from build_debwithrelinfo folder")
     ("my-id", po::value<std::size_t>()->required(), "my party id")
     ("party", po::value<std::vector<std::string>>()->multitoken(),
@@ -341,7 +242,9 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
     return std::nullopt;
   }
 
-  file_read(&options);
+  if (file_read(&options) != EXIT_SUCCESS) {
+    return std::nullopt;
+  }
 
   const auto parse_party_argument =
       [](const auto& s) -> std::pair<std::size_t, MOTION::Communication::tcp_connection_config> {
@@ -413,7 +316,7 @@ auto create_composite_circuit(const Options& options, MOTION::TwoPartyBackend& b
   std::vector<ENCRYPTO::ReusableFiberPromise<MOTION::IntegerValues<uint64_t>>> promises_1;
   // std::vector<std::vector<ENCRYPTO::ReusableFiberPromise<MOTION::IntegerValues<uint64_t>>>>input_final;
   //  MOTION::WireVector input_0_arith, input_1_arith;
-  std::vector<MOTION::WireVector> input_bool, input_bool_1;
+  MOTION::WireVector input_bool;
   for (int i = 0; i < options.num_elements; i++) {
     auto pair = gate_factory_arith.make_arithmetic_64_input_gate_shares(1);
     auto promises = std::move(pair.first);
@@ -424,53 +327,22 @@ auto create_composite_circuit(const Options& options, MOTION::TwoPartyBackend& b
     auto delta = std::move(promises[1]);
     input_1.push_back(std::move(delta));
 
-    auto temp1 = backend.convert(options.boolean_protocol, input_a_arith);
-    auto temp2 = backend.convert(options.boolean_protocol, input_a_arith);
-    input_bool.push_back(std::move(temp1));
-    input_bool_1.push_back(std::move(temp2));
-  }
-
-  MOTION::CircuitLoader circuit_loader, circuit_loader_1;
-  auto& gt_circuit =
-      circuit_loader.load_gt_circuit(64, options.boolean_protocol != MOTION::MPCProtocol::Yao);
-  auto& gtmux_circuit =
-      circuit_loader.load_gtmux_circuit(64, options.boolean_protocol != MOTION::MPCProtocol::Yao);
-
-  auto max = std::move(input_bool[0]);
-  // auto output_future = gate_factory_arith.make_arithmetic_64_output_gate_my(MOTION::ALL_PARTIES,
-  // max); auto output_bool_0 = gate_factory_bool.make_boolean_output_gate_my(MOTION::ALL_PARTIES,
-  // max);
-
-  auto n = input_bool.size();
-  for (int i = 1; i < n; ++i) {
-    auto intermediate_wire = std::move(input_bool[i]);
-    max = backend.make_circuit(gtmux_circuit, intermediate_wire, max);
+    auto element_bool = backend.convert(options.boolean_protocol, input_a_arith);
+    input_bool.insert(std::end(input_bool), std::begin(element_bool), std::end(element_bool));
   }
 
-  std::vector<MOTION::WireVector> output_final;
-  int n1 = input_bool_1.size();
-  for (int j = 0; j < n1; ++j) {
-    auto temp_0 = std::move(input_bool_1[j]);
-    auto output1 = backend.make_circuit(gt_circuit, max, temp_0);
-    output_final.push_back(output1);
-  }
-
-  // const int k=26;
-  // auto temp1=backend.convert(options.arithmetic_protocol,max);
-  // auto output_future = gate_factory_arith.make_arithmetic_64_output_gate_my(MOTION::ALL_PARTIES,
-  // temp1);
-
-  int k = options.num_elements;
+  MOTION::CircuitLoader circuit_loader;
+  auto& argmax_circuit = circuit_loader.load_argmax_circuit(
+      64, options.num_elements, options.boolean_protocol != MOTION::MPCProtocol::Yao);
+  const auto one_hot = backend.make_circuit(argmax_circuit, input_bool);
+  // the share files hold a 0 at the position of the maximum
+  const auto output_final = backend.make_unary_gate(ENCRYPTO::PrimitiveOperationType::INV, one_hot);
 
-  // std::array<ENCRYPTO::ReusableFiberFuture<MOTION::BitValues>, 26>* outputbool =
-  // new std::array<ENCRYPTO::ReusableFiberFuture<MOTION::BitValues>, 26>();
-  std::vector<size_t> gate_ids(10);
+  // consolidate_share_files expects consecutive gate ids
+  std::vector<size_t> gate_ids;
   for (int i = 0; i < options.num_elements; i++) {
-    // (*outputbool)[i] =
-    //     gate_factory_bool.make_boolean_output_gate_my(MOTION::ALL_PARTIES, output_final[i]);
-    gate_ids[i] = gate_factory_bool.make_boolean_output_gate_my_wo_getting_output(
-        MOTION::ALL_PARTIES, output_final[i]);
-    // std::cout << gate_ids[i] << std::endl;
+    gate_ids.push_back(gate_factory_bool.make_boolean_output_gate_my_wo_getting_output(
+        MOTION::ALL_PARTIES, {output_final[i]}));
   }
 
   return std::make_pair(gate_ids, std::move(input_1));
@@ -71,6 +71,7 @@ file_config_model1 --layer-id 1 --row_start 1 --row_end 784
 #include "tensor/tensor_op.h"
 #include "tensor/tensor_op_factory.h"
 #include "utility/fixed_point.h"
+#include "utility/share_file.h"
 
 namespace po = boost::program_options;
 int j = 0;
@@ -159,22 +160,6 @@ void testMemoryOccupied(bool WriteToFiles, int my_id, int layer_id, int p, std::
 bool is_empty(std::ifstream& file) { return file.peek() == std::ifstream::traits_type::eof(); }
 
 //////////////////New functions////////////////////////////////////////
-/// In read_file also include file not there error and file empty alerts
-std::uint64_t read_file(std::ifstream& pro) {
-  std::string str;
-  char num;
-  while (pro >> std::noskipws >> num) {
-    if (num != ' ' && num != '\n') {
-      str.push_back(num);
-    } else {
-      break;
-    }
-  }
-
-  std::string::size_type sz = 0;
-  std::uint64_t ret = (uint64_t)std::stoull(str, &sz, 0);
-  return ret;
-}
 ///////////// New function that reads from a specific point in file ////////
 
 std::fstream& GotoLine(std::fstream& file, unsigned int num) {
@@ -208,207 +193,63 @@ std::string read_filepath(std::ifstream& indata, int count) {
 }
 
 int image_shares(Options* options, std::string p) {
-  std::ifstream temps;
-
   try {
-    temps.open(p);
-    if (temps) {
-      std::cout << "File found\n";
-    } else {
-      std::cout << "File not found\n";
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while opening the image share file.\n";
-    return EXIT_FAILURE;
-  }
-
-  try {
-    if (is_empty(temps)) {
-      // file is empty
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Image share input file is empty.\n";
-    return EXIT_FAILURE;
-  }
-
-  std::uint64_t rows, cols;
-  try {
-    rows = read_file(temps);
-    options->image_file.row = rows;
-    std::cout << "r " << rows << " ";
-    cols = read_file(temps);
-    options->image_file.col = cols;
-    std::cout << "c " << cols << "\n";
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while reading columns from image shares.\n";
+    auto shares = MOTION::read_share_file<std::uint64_t>(p);
+    options->image_file.row = shares.rows_;
+    options->image_file.col = shares.cols_;
+    std::cout << "r " << shares.rows_ << " c " << shares.cols_ << "\n";
+    options->image_file.Delta = std::move(shares.public_shares_);
+    options->image_file.delta = std::move(shares.secret_shares_);
+  } catch (std::runtime_error& e) {
+    std::cerr << "Error while reading the image shares: " << e.what() << "\n";
     return EXIT_FAILURE;
   }
-
-  // ////////////////////////////Reading from specific rows////////////////////
-  //    // t1 is the path of the file that is to be read
-  //    //std::ifstream file(t1);
-  //     temps.seekg(std::ios::beg);
-  //     for(int i=0; i < options->row_start; ++i){
-  //         temps.ignore(std::numeric_limits<std::streamsize>::max(),'\n');
-  //     }
-
-  //     for (int i = options->row_start ; i < options->row_end +1 ; ++i) {
-  //       std::cout << "\n" << i << "\n";
-  //       uint64_t m1 = read_file(temps);
-  //     // std::cout << m1 << " ";
-  //     options->image_file.Delta.push_back(m1);
-  //     uint64_t m2 = read_file(temps);
-  //     // std::cout << m2 << "\n";
-  //     options->image_file.delta.push_back(m2);
-  //    // std::cout << "\n" << i << "\n";
-  //    }
-  //    //////////////////////////////////////////////////////////////////////////
-
-  for (int i = 0; i < rows * cols; ++i) {
-    try {
-      uint64_t m1 = read_file(temps);
-      options->image_file.Delta.push_back(m1);
-      uint64_t m2 = read_file(temps);
-      options->image_file.delta.push_back(m2);
-    } catch (std::ifstream::failure e) {
-      std::cerr << "Error while reading columns from image shares.\n";
-      return EXIT_FAILURE;
-    }
-  }
-  temps.close();
+  return EXIT_SUCCESS;
 }
 
-int W_shares(Options* options, std::string p) {
-  std::ifstream indata;
+// Reads the rows row_start, ..., row_end (counted from 1) of a share file.  Binary share files
+// are mapped, so that only the requested rows are read.
+int share_rows(const std::string& p, int row_start, int row_end, Matrix& m) {
   try {
-    indata.open(p);
-    if (std::ifstream(p)) {
-      std::cout << "File found\n";
+    std::size_t cols;
+    const auto select_rows = [&](std::size_t rows, auto public_shares, auto secret_shares) {
+      if (row_start < 1 || row_end < row_start || static_cast<std::size_t>(row_end) > rows) {
+        throw std::runtime_error("rows " + std::to_string(row_start) + " to " +
+                                 std::to_string(row_end) + " not in share file " + p);
+      }
+      const std::size_t offset = (row_start - 1) * cols;
+      const std::size_t count = (row_end - row_start + 1) * cols;
+      const auto public_begin = std::begin(public_shares) + offset;
+      const auto secret_begin = std::begin(secret_shares) + offset;
+      m.Delta.assign(public_begin, public_begin + count);
+      m.delta.assign(secret_begin, secret_begin + count);
+    };
+    if (MOTION::MappedShareFile::is_share_file(p)) {
+      MOTION::MappedShareFile file(p);
+      cols = file.get_header().cols_;
+      select_rows(file.get_header().rows_, file.get_public_shares<std::uint64_t>(),
+                  file.get_secret_shares<std::uint64_t>());
     } else {
-      std::cout << "File not found\n";
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while opening the input weight share file.\n";
-    return EXIT_FAILURE;
-  }
-
-  try {
-    if (is_empty(indata)) {
-      // file is empty
+      auto shares = MOTION::read_share_file<std::uint64_t>(p);
+      cols = shares.cols_;
+      select_rows(shares.rows_, shares.public_shares_, shares.secret_shares_);
     }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Weight share file is empty.\n";
-    return EXIT_FAILURE;
-  }
-
-  int rows, cols;
-  try {
-    rows = read_file(indata);
-    cols = read_file(indata);
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while reading rows and columns from weight shares.\n";
+    m.row = row_end - row_start + 1;
+    m.col = cols;
+    std::cout << "Effective rows: " << m.row << " columns: " << m.col << "\n";
+  } catch (std::runtime_error& e) {
+    std::cerr << "Error while reading shares: " << e.what() << "\n";
     return EXIT_FAILURE;
   }
+  return EXIT_SUCCESS;
+}
 
-  int effective_rows = (options->row_end - options->row_start) + 1;
-  options->W_file.row = effective_rows;
-  // options->W_file.row = rows;
-  std::cout << "Effective rows: " << effective_rows << "\n ";
-  std::cout << "Actual rows,r: " << rows << " ";
-  options->W_file.col = cols;
-  std::cout << "Actual columns,c: " << cols << "\n";
-
-  ////////////////////////////Reading from specific rows////////////////////
-  // t1 is the path of the file that is to be read
-  // std::ifstream file(t1);
-  indata.seekg(std::ios::beg);
-  for (int i = 0; i < ((options->row_start - 1) * cols) + 1; ++i) {
-    // std::cout << "i is " << i << "\n";
-    indata.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-  }
-
-  for (int i = ((options->row_start) * cols); i < ((options->row_end + 1) * cols); ++i) {
-    try {
-      uint64_t m1 = read_file(indata);
-      options->W_file.Delta.push_back(m1);
-      uint64_t m2 = read_file(indata);
-      options->W_file.delta.push_back(m2);
-    } catch (std::ifstream::failure e) {
-      std::cerr << "Error while reading input weight shares from file.\n";
-      return EXIT_FAILURE;
-    }
-  }
-  indata.close();
+int W_shares(Options* options, std::string p) {
+  return share_rows(p, options->row_start, options->row_end, options->W_file);
 }
 
 int B_shares(Options* options, std::string p) {
-  std::ifstream indata;
-  try {
-    if (std::ifstream(p)) {
-      std::cout << "File found\n";
-    } else {
-      std::cout << "File not found\n";
-    }
-
-    indata.open(p);
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while opening the input bias share file.\n";
-    return EXIT_FAILURE;
-  }
-
-  try {
-    if (is_empty(indata)) {
-      // file is empty
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Bias share file is empty.\n";
-    return EXIT_FAILURE;
-  }
-
-  int rows, cols;
-  try {
-    rows = read_file(indata);
-    cols = read_file(indata);
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while reading rows and columns from input bias share file.\n";
-    return EXIT_FAILURE;
-  }
-
-  int effective_rows = (options->row_end - options->row_start) + 1;
-  options->B_file.row = effective_rows;
-  // options->B_file.row = rows;
-  std::cout << "r " << rows << " ";
-  options->B_file.col = cols;
-  std::cout << "c " << cols << "\n";
-  ////////////////////////////Reading from specific rows////////////////////
-  // t1 is the path of the file that is to be read
-  // std::ifstream file(t1);
-  indata.seekg(std::ios::beg);
-  for (int i = 0; i < ((options->row_start)); ++i) {
-    // std::cout << "i is " << i << "\n";
-    indata.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-  }
-
-  for (int i = ((options->row_start)); i < ((options->row_end + 1)); ++i) {
-    try {
-      uint64_t m1 = read_file(indata);
-      options->B_file.Delta.push_back(m1);
-      uint64_t m2 = read_file(indata);
-      options->B_file.delta.push_back(m2);
-    } catch (std::ifstream::failure e) {
-      std::cerr << "Error while reading the input bias share file.\n";
-      return EXIT_FAILURE;
-    }
-  }
-  //////////////////////////////////////////////////////////////////////////
-
-  // for (int i = 0; i < rows * cols; ++i) {
-  //   uint64_t m1 = read_file(indata);
-  //   options->B_file.Delta.push_back(m1);
-  //   uint64_t m2 = read_file(indata);
-  //   options->B_file.delta.push_back(m2);
-  // }
-  indata.close();
+  return share_rows(p, options->row_start, options->row_end, options->B_file);
 }
 
 // changes made in this function
@@ -743,6 +584,7 @@ int main(int argc, char* argv[]) {
     MOTION::Statistics::AccumulatedCommunicationStats comm_stats;
     MOTION::TwoPartyTensorBackend backend(*comm_layer, options->threads,
                                           options->sync_between_setup_and_online, logger);
+    backend.set_output_share_directory(options->currentpath, options->fractional_bits);
     run_composite_circuit(*options, backend);
     comm_layer->sync();
     comm_stats.add(comm_layer->get_transport_statistics());
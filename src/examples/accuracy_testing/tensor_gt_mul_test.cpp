@@ -70,6 +70,7 @@ Server-1
 #include "tensor/tensor_op.h"
 #include "tensor/tensor_op_factory.h"
 #include "utility/new_fixed_point.h"
+#include "utility/share_file.h"
 
 namespace po = boost::program_options;
 int j = 0;
@@ -117,23 +118,6 @@ void testMemoryOccupied(int WriteToFiles, int my_id, std::string path) {
 }
 
 //////////////////New functions////////////////////////////////////////
-/// In read_file also include file not there error and file empty alerts
-std::uint64_t read_file(std::ifstream& pro) {
-  std::string str;
-  char num;
-  while (pro >> std::noskipws >> num) {
-    if (num != ' ' && num != '\n') {
-      str.push_back(num);
-    } else {
-      break;
-    }
-  }
-
-  std::string::size_type sz = 0;
-  std::uint64_t ret = (uint64_t)std::stoull(str, &sz, 0);
-  return ret;
-}
-
 struct Matrix {
   std::vector<uint64_t> Delta;
   std::vector<uint64_t> delta;
@@ -188,153 +172,48 @@ std::string read_filepath(std::ifstream& indata, int count) {
 }
 
 int image_shares(Options* options, std::string p) {
-  std::ifstream temps;
   try {
-    temps.open(p);
-    if (temps) {
-      std::cout << "File found\n";
-    } else {
-      std::cout << "File not found\n";
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while opening the image share file.\n";
-    return EXIT_FAILURE;
-  }
-
-  try {
-    if (is_empty(temps)) {
-      // file is empty
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Image share input file is empty.\n";
-    return EXIT_FAILURE;
-  }
-
-  std::uint64_t rows, cols;
-  try {
-    rows = read_file(temps);
-    options->image_file.row = rows;
-    std::cout << "r " << rows << " ";
-    cols = read_file(temps);
-    options->image_file.col = cols;
-    std::cout << "c " << cols << "\n";
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while reading columns from image shares.\n";
+    auto shares = MOTION::read_share_file<std::uint64_t>(p);
+    options->image_file.row = shares.rows_;
+    options->image_file.col = shares.cols_;
+    std::cout << "r " << shares.rows_ << " c " << shares.cols_ << "\n";
+    options->image_file.Delta = std::move(shares.public_shares_);
+    options->image_file.delta = std::move(shares.secret_shares_);
+  } catch (std::runtime_error& e) {
+    std::cerr << "Error while reading the image shares: " << e.what() << "\n";
     return EXIT_FAILURE;
   }
-
-  for (int i = 0; i < rows * cols; ++i) {
-    try {
-      uint64_t m1 = read_file(temps);
-      options->image_file.Delta.push_back(m1);
-      uint64_t m2 = read_file(temps);
-      options->image_file.delta.push_back(m2);
-    } catch (std::ifstream::failure e) {
-      std::cerr << "Error while reading columns from image shares.\n";
-      return EXIT_FAILURE;
-    }
-  }
-  temps.close();
+  return EXIT_SUCCESS;
 }
 
 int W_shares(Options* options, std::string p) {
-  std::ifstream indata;
-  try {
-    indata.open(p);
-    if (std::ifstream(p)) {
-      std::cout << "File found\n";
-    } else {
-      std::cout << "File not found\n";
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while opening the input weight share file.\n";
-    return EXIT_FAILURE;
-  }
-
-  try {
-    if (is_empty(indata)) {
-      // file is empty
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Weight share input file is empty.\n";
-    return EXIT_FAILURE;
-  }
-
-  int rows, cols;
   try {
-    rows = read_file(indata);
-    options->W_file.row = rows;
-    std::cout << "r " << rows << " ";
-    cols = read_file(indata);
-    options->W_file.col = cols;
-    std::cout << "c " << cols << "\n";
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while reading rows and columns from weight shares.\n";
+    auto shares = MOTION::read_share_file<std::uint64_t>(p);
+    options->W_file.row = shares.rows_;
+    options->W_file.col = shares.cols_;
+    std::cout << "r " << shares.rows_ << " c " << shares.cols_ << "\n";
+    options->W_file.Delta = std::move(shares.public_shares_);
+    options->W_file.delta = std::move(shares.secret_shares_);
+  } catch (std::runtime_error& e) {
+    std::cerr << "Error while reading the weight shares: " << e.what() << "\n";
     return EXIT_FAILURE;
   }
-
-  for (int i = 0; i < rows * cols; ++i) {
-    try {
-      uint64_t m1 = read_file(indata);
-      options->W_file.Delta.push_back(m1);
-      uint64_t m2 = read_file(indata);
-      options->W_file.delta.push_back(m2);
-    } catch (std::ifstream::failure e) {
-      std::cerr << "Error while reading input weight shares from file.\n";
-      return EXIT_FAILURE;
-    }
-  }
-  indata.close();
+  return EXIT_SUCCESS;
 }
 
 int B_shares(Options* options, std::string p) {
-  std::ifstream indata;
   try {
-    if (std::ifstream(p)) {
-      std::cout << "File found\n";
-    } else {
-      std::cout << "File not found\n";
-    }
-
-    indata.open(p);
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while opening the input bias share file.\n";
-    return EXIT_FAILURE;
-  }
-
-  try {
-    if (is_empty(indata)) {
-      // file is empty
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Bias share file is empty.\n";
-    return EXIT_FAILURE;
-  }
-
-  int rows, cols;
-  try {
-    rows = read_file(indata);
-    options->B_file.row = rows;
-    std::cout << "r " << rows << " ";
-    cols = read_file(indata);
-    options->B_file.col = cols;
-    std::cout << "c " << cols << "\n";
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while reading rows and columns from input bias share file.\n";
+    auto shares = MOTION::read_share_file<std::uint64_t>(p);
+    options->B_file.row = shares.rows_;
+    options->B_file.col = shares.cols_;
+    std::cout << "r " << shares.rows_ << " c " << shares.cols_ << "\n";
+    options->B_file.Delta = std::move(shares.public_shares_);
+    options->B_file.delta = std::move(shares.secret_shares_);
+  } catch (std::runtime_error& e) {
+    std::cerr << "Error while reading the bias shares: " << e.what() << "\n";
     return EXIT_FAILURE;
   }
-  for (int i = 0; i < rows * cols; ++i) {
-    try {
-      uint64_t m1 = read_file(indata);
-      options->B_file.Delta.push_back(m1);
-      uint64_t m2 = read_file(indata);
-      options->B_file.delta.push_back(m2);
-    } catch (std::ifstream::failure e) {
-      std::cerr << "Error while reading the input bias share file.\n";
-      return EXIT_FAILURE;
-    }
-  }
-  indata.close();
+  return EXIT_SUCCESS;
 }
 
 // changes made in this function
@@ -651,6 +530,7 @@ int main(int argc, char* argv[]) {
     MOTION::Statistics::AccumulatedCommunicationStats comm_stats;
     MOTION::TwoPartyTensorBackend backend(*comm_layer, options->threads,
                                           options->sync_between_setup_and_online, logger);
+    backend.set_output_share_directory(options->currentpath, options->fractional_bits);
     run_composite_circuit(*options, backend);
     comm_layer->sync();
     comm_stats.add(comm_layer->get_transport_statistics());
@@ -4,14 +4,14 @@ build_debwithrelinfo/ShareFiles/B.txt and performs a ReLU operation on them.
 If this code is run with a function to write output shares (in tensor_op.cpp)
 output shares of this will be written. The following instructions run this code.
 
-At the argument "--filepath " give the path of the file containing shares from build_deb.... folder
+At the argument "--filepath " give the path of the share file relative to the build folder
 Server-0
 ./bin/tensor_gt_relu --my-id 0 --party 0,::1,7002 --party 1,::1,7000 --arithmetic-protocol beavy
---boolean-protocol yao --fractional-bits 13 --filepath file_config_input0
+--boolean-protocol yao --fractional-bits 13 --filepath server0/outputshare_0
 
 Server-1
 ./bin/tensor_gt_relu --my-id 1 --party 0,::1,7002 --party 1,::1,7001 --arithmetic-protocol beavy
---boolean-protocol yao --repetitions 1 --fractional-bits 13 --filepath file_config_input1
+--boolean-protocol yao --repetitions 1 --fractional-bits 13 --filepath server1/outputshare_1
 */
 // MIT License
 //
@@ -67,6 +67,7 @@ Server-1
 #include "tensor/tensor_op.h"
 #include "tensor/tensor_op_factory.h"
 #include "utility/fixed_point.h"
+#include "utility/share_file.h"
 
 void testMemoryOccupied(bool WriteToFiles, int my_id, std::string path) {
   int tSize = 0, resident = 0, share = 0;
@@ -138,134 +139,22 @@ struct Options {
   bool no_run = false;
 };
 
-bool is_empty(std::ifstream& file) { return file.peek() == std::ifstream::traits_type::eof(); }
-
-//////////////////New functions////////////////////////////////////////
-/// In read_file also include file not there error and file empty alerts
-std::uint64_t read_file(std::ifstream& indata) {
-  std::string str;
-  char num;
-  while (indata >> std::noskipws >> num) {
-    if (num != ' ' && num != '\n') {
-      str.push_back(num);
-    } else {
-      break;
-    }
-  }
-  std::string::size_type sz = 0;
-  std::uint64_t ret = (uint64_t)std::stoull(str, &sz, 0);
-  return ret;
-}
-
-std::string read_filepath(std::ifstream& indata) {
-  std::string str;
-
-  char num;
-  while (indata) {
-    std::getline(indata, str);
-  }
-  // std::cout << str << std::endl;
-  return str;
-}
-
-int input_shares(Options* options, std::string p) {
-  std::ifstream indata1, indata2;
-
-  try {
-    indata1.open(p);
-    if (indata1) {
-      std::cout << "File found\n";
-    } else {
-      std::cout << "File not found\n";
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while opening the input share file.\n";
-    return EXIT_FAILURE;
-  }
-
-  try {
-    if (is_empty(indata1)) {
-      // file is empty
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Image share input file is empty.\n";
-    return EXIT_FAILURE;
-  }
-
-  int num_elements, column_size;
-  try {
-    num_elements = read_file(indata1);
-    column_size = read_file(indata1);
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while reading columns from image shares.\n";
-    return EXIT_FAILURE;
-  }
-
-  options->num_elements = num_elements;
-  options->column_size = column_size;
-
-  auto k = 0;
-  while (k < options->num_elements * options->column_size * 2) {
-    std::uint64_t num = read_file(indata1);
-    if (indata1.eof()) {
-      std::cerr << "File contains less number of elements" << std::endl;
-      return EXIT_FAILURE;
-    }
-    k++;
-  }
-
-  indata1.close();
-  indata2.open(p);
-
-  options->num_elements = read_file(indata2);
-  options->column_size = read_file(indata2);
-  // std::cout << options->num_elements << " " << options->column_size << "\n";
-  for (int i = 0; i < options->num_elements; ++i) {
-    try {
-      uint64_t m1 = read_file(indata2);
-      options->input.Delta.push_back(m1);
-      uint64_t m2 = read_file(indata2);
-      options->input.delta.push_back(m2);
-    } catch (std::ifstream::failure e) {
-      std::cerr << "Error while reading columns from image shares.\n";
-      return EXIT_FAILURE;
-    }
-  }
-  indata2.close();
-}
-
 int file_read(Options* options) {
-  std::string path = options->currentpath;
-  // std::string path = std::filesystem::current_path();
-  std::string t1 = path + "/" + options->filepath_frombuild;
-
-  std::ifstream file1;
-  try {
-    file1.open(t1);
-    if (file1) {
-      std::cout << "File found\n";
-    } else {
-      std::cout << "File not found\n";
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "Error while opening config_model file.\n";
-    return EXIT_FAILURE;
-  }
-
+  const auto path = options->currentpath + "/" + options->filepath_frombuild;
   try {
-    if (is_empty(file1)) {
-      // file is empty
-    }
-  } catch (std::ifstream::failure e) {
-    std::cerr << "config_file_model is empty.\n";
+    const MOTION::MappedShareFile file(path);
+    const auto& header = file.get_header();
+    const auto public_shares = file.get_public_shares<std::uint64_t>();
+    const auto secret_shares = file.get_secret_shares<std::uint64_t>();
+    options->num_elements = header.rows_;
+    options->column_size = header.cols_;
+    options->input.Delta.assign(std::begin(public_shares), std::end(public_shares));
+    options->input.delta.assign(std::begin(secret_shares), std::end(secret_shares));
+  } catch (std::runtime_error& e) {
+    std::cerr << "Error while reading the input shares: " << e.what() << "\n";
     return EXIT_FAILURE;
   }
-
-  std::string i = read_filepath(file1);
-  std::cout << "i:" << i << "\n";
-
-  file1.close();
-  input_shares(options, i);
+  return EXIT_SUCCESS;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -285,7 +174,7 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
      "number of fractional bits for fixed-point arithmetic")
     ("arithmetic-protocol", po::value<std::string>()->required(), "2PC protocol (GMW or BEAVY)")
     ("boolean-protocol", po::value<std::string>()->required(), "2PC protocol (Yao, GMW or BEAVY)")
-    ("filepath", po::value<std::string>()->required(), "Path of the shares file from build_debwithrelinfo folder")
+    ("filepath", po::value<std::string>()->required(), "path of the share file relative to the current path, e.g., server0/outputshare_0")
     ("repetitions", po::value<std::size_t>()->default_value(1), "number of repetitions")
     ("num-simd", po::value<std::size_t>()->default_value(1), "number of SIMD values")
     ("current-path",po::value<std::string>()->required(), "current path build_debwithrelinfo")
@@ -354,9 +243,9 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
     return std::nullopt;
   }
 
-  //////////////////////////////////////////////////////////////////
-  file_read(&options);
-  ////////////////////////////////////////////////////////////////////
+  if (file_read(&options) != EXIT_SUCCESS) {
+    return std::nullopt;
+  }
 
   const auto parse_party_argument =
       [](const auto& s) -> std::pair<std::size_t, MOTION::Communication::tcp_connection_config> {
@@ -505,6 +394,7 @@ int main(int argc, char* argv[]) {
     MOTION::Statistics::AccumulatedCommunicationStats comm_stats;
     MOTION::TwoPartyTensorBackend backend(*comm_layer, options->threads,
                                           options->sync_between_setup_and_online, logger);
+    backend.set_output_share_directory(options->currentpath, options->fractional_bits);
     run_composite_circuit(*options, backend);
     comm_layer->sync();
     comm_stats.add(comm_layer->get_transport_statistics());
@@ -46,8 +46,10 @@
 #include <boost/program_options.hpp>
 
 #include "compute_server/compute_server.h"
+#include "compute_server/share_ingestion_server.h"
 #include "utility/logger.h"
 #include "utility/fixed_point.h"
+#include "utility/share_file.h"
 
 namespace po = boost::program_options;
 
@@ -57,6 +59,7 @@ struct Options {
   std::vector<std::string> filepaths;
   std::string currentpath;
   int port;
+  bool seed_compressed;
   int number_of_layers;
 };
 
@@ -69,6 +72,7 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
     ("my-id", po::value<std::size_t>()->required(), "my party id")
     ("port" , po::value<int>()->required(), "Port number on which to listen")
     ("current-path",po::value<std::string>()->required(), "current path build_debwithrelinfo")
+    ("seed-compressed", po::bool_switch()->default_value(false), "the provider sends a PRG seed instead of the secret shares")
     ;
   // clang-format on
 
@@ -91,6 +95,7 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
   options.port = vm["port"].as<int>();
   // options.filenames = vm["file-names"].as<std::string>();
   options.currentpath = vm["current-path"].as<std::string>();
+  options.seed_compressed = vm["seed-compressed"].as<bool>();
   // ----------------- Input Validation ----------------------------------------//
   if (options.my_id > 1) {
     std::cerr << "my-id must be 0 or 1\n";
@@ -154,33 +159,22 @@ void generate_filepaths(Options& options) {
 }
 
 void retrieve_shares(Options& options) {
-  std::ofstream file;
   ////////////////////////////////////////////////////////////
 
-  auto [numberOfLayers, frac, data_and_dims] =
-      COMPUTE_SERVER::get_provider_total_data_genr(options.port);
-  options.number_of_layers = numberOfLayers;
-  if(options.number_of_layers<1){
-    throw std::runtime_error("Number of layers cannot be lesser than one.\n");
-  }
+  COMPUTE_SERVER::ShareIngestionServer server(options.port, 1, options.seed_compressed,
+                                              COMPUTE_SERVER::UploadFormat::model);
+  const auto upload = server.receive_upload();
+  options.number_of_layers = upload.tensors_.size() / 2;
   generate_filepaths(options);
 
-  for (auto i = 0; i < 2*numberOfLayers; i++) {
+  for (std::size_t i = 0; i < upload.tensors_.size(); i++) {
     auto data_share_file_path = options.filepaths[i];
     std::cout << "Writing shares to file "<< data_share_file_path << "\n";
-    std::vector<COMPUTE_SERVER::Shares> input_values_dp1 = data_and_dims.first[i];
-    auto currentdims = data_and_dims.second[i];
-    file.open(data_share_file_path, std::ios_base::out);
-    if(!file.is_open()){
-        file.close();
-        throw std::runtime_error("Unable to open file "+data_share_file_path+"\n");
-    }
-    file << currentdims.first << " " << currentdims.second << "\n";
-    std::cout << "No. of rows:" << currentdims.first << "No. of columns:" << currentdims.second << std::endl;
-    for (int j = 0; j < input_values_dp1.size(); j++) {
-      file << input_values_dp1[j].Delta << " " << input_values_dp1[j].delta << "\n";
-    }
-    file.close();
+    const auto& tensor = upload.tensors_[i];
+    std::cout << "No. of rows:" << tensor.rows_ << "No. of columns:" << tensor.cols_ << std::endl;
+    MOTION::write_share_file<std::uint64_t>(data_share_file_path, options.my_id,
+                                            upload.fractional_bits_, tensor.rows_, tensor.cols_,
+                                            tensor.public_shares_, tensor.secret_shares_);
   }
 }
 
@@ -0,0 +1,87 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <Eigen/Core>
+
+#include "utility/helpers.h"
+#include "utility/linear_algebra.h"
+
+// Arguments are the dimensions l, m, n of the product of an l x m and an m x n
+// matrix.  The first shapes are the fully connected layers of the MNIST and
+// CryptoNets models (weights times one image), the last ones the same layers
+// evaluated on a batch of 64 images.
+static void shapes(benchmark::internal::Benchmark* b) {
+  b->ArgNames({"l", "m", "n"});
+  b->Args({256, 784, 1});
+  b->Args({10, 256, 1});
+  b->Args({100, 845, 1});
+  b->Args({10, 100, 1});
+  b->Args({256, 784, 64});
+  b->Args({100, 845, 64});
+}
+
+template <typename T>
+static void BM_matrix_multiply(benchmark::State& state) {
+  const std::size_t dim_l = state.range(0);
+  const std::size_t dim_m = state.range(1);
+  const std::size_t dim_n = state.range(2);
+  const auto A = MOTION::Helpers::RandomVector<T>(dim_l * dim_m);
+  const auto B = MOTION::Helpers::RandomVector<T>(dim_m * dim_n);
+  std::vector<T> output(dim_l * dim_n);
+
+  for (auto _ : state) {
+    MOTION::matrix_multiply(dim_l, dim_m, dim_n, A.data(), B.data(), output.data());
+    benchmark::DoNotOptimize(output.data());
+  }
+  state.counters["mul_adds_per_second"] = benchmark::Counter(
+      state.iterations() * dim_l * dim_m * dim_n, benchmark::Counter::kIsRate);
+}
+BENCHMARK_TEMPLATE(BM_matrix_multiply, std::uint64_t)->Apply(shapes);
+BENCHMARK_TEMPLATE(BM_matrix_multiply, __uint128_t)->Apply(shapes);
+
+// the previous implementation of matrix_multiply
+template <typename T>
+static void BM_matrix_multiply_eigen(benchmark::State& state) {
+  using MatrixType = Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+  const std::size_t dim_l = state.range(0);
+  const std::size_t dim_m = state.range(1);
+  const std::size_t dim_n = state.range(2);
+  const auto A = MOTION::Helpers::RandomVector<T>(dim_l * dim_m);
+  const auto B = MOTION::Helpers::RandomVector<T>(dim_m * dim_n);
+  std::vector<T> output(dim_l * dim_n);
+  Eigen::Map<MatrixType> matrix_output(output.data(), dim_l, dim_n);
+  Eigen::Map<const MatrixType> matrix_A(A.data(), dim_l, dim_m);
+  Eigen::Map<const MatrixType> matrix_B(B.data(), dim_m, dim_n);
+
+  for (auto _ : state) {
+    matrix_output = matrix_A * matrix_B;
+    benchmark::DoNotOptimize(output.data());
+  }
+  state.counters["mul_adds_per_second"] = benchmark::Counter(
+      state.iterations() * dim_l * dim_m * dim_n, benchmark::Counter::kIsRate);
+}
+BENCHMARK_TEMPLATE(BM_matrix_multiply_eigen, std::uint64_t)->Apply(shapes);
+BENCHMARK_TEMPLATE(BM_matrix_multiply_eigen, __uint128_t)->Apply(shapes);
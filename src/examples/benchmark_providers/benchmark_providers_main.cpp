@@ -45,7 +45,7 @@ bool CheckPartyArgumentSyntax(const std::string& p);
 
 std::tuple<po::variables_map, bool, bool> ParseProgramOptions(int ac, char* av[]);
 
-MOTION::PartyPtr CreateParty(const po::variables_map& vm);
+MOTION::PartyPtr CreateParty(const po::variables_map& vm, bool silent_ot);
 
 int main(int ac, char* av[]) {
   auto [vm, help_flag, ots_flag] = ParseProgramOptions(ac, av);
@@ -89,21 +89,36 @@ int main(int ac, char* av[]) {
                                        {ROT, 128, batch_size}};
   // clang-format on
 
+  // OT extension backends to run each combination with
+  std::vector<bool> silent_ot_options;
+  const auto ot_backend{vm["ot-backend"].as<std::string>()};
+  if (ot_backend == "iknp") {
+    silent_ot_options = {false};
+  } else if (ot_backend == "silent") {
+    silent_ot_options = {true};
+  } else if (ot_backend == "both") {
+    silent_ot_options = {false, true};
+  } else {
+    throw std::runtime_error(fmt::format("unknown OT extension backend: {}", ot_backend));
+  }
+
   auto chosen_combs = ots_flag ? combs_ots : combs;
   for (const auto comb : chosen_combs) {
-    MOTION::Statistics::AccumulatedRunTimeStats accumulated_stats;
-    MOTION::Statistics::AccumulatedCommunicationStats accumulated_comm_stats;
-    for (std::size_t i = 0; i < num_repetitions; ++i) {
-      MOTION::PartyPtr party{CreateParty(vm)};
-      auto stats = BenchmarkProvider(party, comb.batch_size_, comb.p_, comb.bit_size_);
-      accumulated_stats.add(stats);
-      auto comm_stats = party->get_communication_layer().get_transport_statistics();
-      accumulated_comm_stats.add(comm_stats);
+    for (const bool silent_ot : silent_ot_options) {
+      MOTION::Statistics::AccumulatedRunTimeStats accumulated_stats;
+      MOTION::Statistics::AccumulatedCommunicationStats accumulated_comm_stats;
+      for (std::size_t i = 0; i < num_repetitions; ++i) {
+        MOTION::PartyPtr party{CreateParty(vm, silent_ot)};
+        auto stats = BenchmarkProvider(party, comb.batch_size_, comb.p_, comb.bit_size_);
+        accumulated_stats.add(stats);
+        auto comm_stats = party->get_communication_layer().get_transport_statistics();
+        accumulated_comm_stats.add(comm_stats);
+      }
+      std::cout << MOTION::Statistics::print_stats(
+          fmt::format("Provider {} bit size {} batch size {} OT extension {}", ToString(comb.p_),
+                      comb.bit_size_, comb.batch_size_, silent_ot ? "silent" : "IKNP"),
+          accumulated_stats, accumulated_comm_stats);
     }
-    std::cout << MOTION::Statistics::print_stats(
-        fmt::format("Provider {} bit size {} batch size {}", ToString(comb.p_), comb.bit_size_,
-                    comb.batch_size_),
-        accumulated_stats, accumulated_comm_stats);
   }
   return EXIT_SUCCESS;
 }
@@ -142,6 +157,7 @@ std::tuple<po::variables_map, bool, bool> ParseProgramOptions(int ac, char* av[]
       ("other-parties", po::value<std::vector<std::string>>()->multitoken(), "(other party id, IP, port, my role), e.g., --other-parties 1,127.0.0.1,7777")
       ("online-after-setup", po::value<bool>()->default_value(true), "compute the online phase of the gate evaluations after the setup phase for all of them is completed (true/1 or false/0)")
       ("repetitions", po::value<std::size_t>()->default_value(1), "number of repetitions")
+      ("ot-backend", po::value<std::string>()->default_value("iknp"), "OT extension used in the preprocessing: iknp, silent, or both to compare them side by side")
       ("ots,o", po::bool_switch(&ots)->default_value(false),"test OTs, otherwise all other providers");
   // clang-format on
 
@@ -194,7 +210,7 @@ std::tuple<po::variables_map, bool, bool> ParseProgramOptions(int ac, char* av[]
   return std::make_tuple(vm, help, ots);
 }
 
-MOTION::PartyPtr CreateParty(const po::variables_map& vm) {
+MOTION::PartyPtr CreateParty(const po::variables_map& vm, bool silent_ot) {
   const auto parties_str{vm["other-parties"].as<const std::vector<std::string>>()};
   const auto num_parties{parties_str.size()};
   const auto my_id{vm["my-id"].as<std::size_t>()};
@@ -224,5 +240,6 @@ MOTION::PartyPtr CreateParty(const po::variables_map& vm) {
   const auto logging{!vm.count("disable-logging")};
   config->SetLoggingEnabled(logging);
   config->SetOnlineAfterSetup(vm["online-after-setup"].as<bool>());
+  config->SetUseSilentOT(silent_ot);
   return party;
 }
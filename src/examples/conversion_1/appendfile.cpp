@@ -1,57 +1,53 @@
+// Appends the output shares of one split of a layer (server<id>/outputshare_<id>)
+// to finaloutput_<id>, which holds the column vector of all splits so far.  Both
+// are binary share files; finaloutput_<id> is created if it does not exist.
 #include <stdlib.h>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include <string>
 
-std::uint64_t read_file(std::ifstream& indata) {
-  std::string str;
-  char num;
-  while (indata >> std::noskipws >> num) {
-    if (num != ' ' && num != '\n') {
-      str.push_back(num);
-    } else {
-      break;
-    }
-  }
-  std::string::size_type sz = 0;
-  std::uint64_t ret = (uint64_t)std::stoull(str, &sz, 0);
-  return ret;
-}
+#include "utility/share_file.h"
 
 int main(int argc, char* argv[]) {
+  if (argc != 2) {
+    std::cerr << "usage: " << argv[0] << " <my-id>\n";
+    return EXIT_FAILURE;
+  }
   int id = atoi(argv[1]);
-  if (id % 2 == id) {
-    std::ofstream indata1;
-
-    std::string base_dir = getenv("BASE_DIR");
-    std::string build_dir = base_dir + "/build_debwithrelinfo_gcc";
-    std::string server_dir = build_dir + "/server" + std::to_string(id);
-    
-    std::string dest_file_path = build_dir + "/finaloutput_" + std::to_string(id);
-
-    indata1.open(dest_file_path, std::ios_base::app);
-
-    std::string source_file_path = server_dir + "/outputshare_" + std::to_string(id);
-    
-    std::ifstream indata2;
-    indata2.open(source_file_path);
-
-    std::uint64_t rows = read_file(indata2);
-
-    std::uint64_t col = read_file(indata2);
-
-    for (int i = 0; i < rows * col; i++) {
-      std::uint64_t nums1 = read_file(indata2);
-      indata1 << nums1 << " ";
-      std::uint64_t nums2 = read_file(indata2);
-      indata1 << nums2 << "\n";
-    }
-
-    indata1.close();
-    indata2.close();
-  } else {
+  if (id != 0 && id != 1) {
     std::cout << "Wrong Argument"
               << "\n";
+    return EXIT_FAILURE;
+  }
+
+  std::string base_dir = getenv("BASE_DIR");
+  std::string build_dir = base_dir + "/build_debwithrelinfo_gcc";
+  std::string server_dir = build_dir + "/server" + std::to_string(id);
+  std::string dest_file_path = build_dir + "/finaloutput_" + std::to_string(id);
+  std::string source_file_path = server_dir + "/outputshare_" + std::to_string(id);
+
+  try {
+    const MOTION::MappedShareFile source(source_file_path);
+    const auto source_public = source.get_public_shares<std::uint64_t>();
+    const auto source_secret = source.get_secret_shares<std::uint64_t>();
+
+    std::vector<std::uint64_t> public_shares, secret_shares;
+    if (std::filesystem::exists(dest_file_path)) {
+      auto dest = MOTION::read_share_file<std::uint64_t>(dest_file_path);
+      public_shares = std::move(dest.public_shares_);
+      secret_shares = std::move(dest.secret_shares_);
+    }
+    public_shares.insert(std::end(public_shares), std::begin(source_public),
+                         std::end(source_public));
+    secret_shares.insert(std::end(secret_shares), std::begin(source_secret),
+                         std::end(source_secret));
+    MOTION::write_share_file<std::uint64_t>(
+        dest_file_path, id, source.get_header().fractional_bits_, public_shares.size(), 1,
+        public_shares, secret_shares);
+  } catch (std::runtime_error& e) {
+    std::cerr << "Error while appending the output shares: " << e.what() << "\n";
+    return EXIT_FAILURE;
   }
+  return EXIT_SUCCESS;
 }
@@ -0,0 +1,544 @@
+/*
+Long-lived inference server which evaluates all layers of the model in a single process.
+
+The weight and bias shares listed in the model config file (as written by
+weight_share_receiver_genr) are loaded once at startup.  Afterwards the daemon reads one request
+per line from stdin of the form "<image share file> [<output name>]", where the image share file
+has the format written by Image_Share_Receiver.  The file may contain a batch of images, one per
+column (see the --batch-size option of image_provider_iudx); the whole batch is evaluated in one
+circuit, so every layer is a matrix-matrix product and the rounds are shared by all images.  For
+every request all layers
+(Gemm + bias, ReLU, ..., Gemm + bias) and the final argmax are evaluated over the same
+CommunicationLayer.  The intermediate shares are passed between the layers in memory.  Each layer
+uses its own backend which is destroyed as soon as the layer is finished, so that only the gates of
+one layer are alive at any time.  The final boolean shares are written to
+server<id>/Boolean_Output_Shares/Final_Boolean_Shares_server<id>_<output name>.txt where
+final_output_provider expects them.  For batches, "_<column>" is appended to the output name.
+
+Server-0
+./bin/inference_daemon --my-id 0 --party 0,::1,7000 --party 1,::1,7001 --fractional-bits 13
+--config-file-model file_config_model0 --current-path $build_path
+
+Server-1
+./bin/inference_daemon --my-id 1 --party 0,::1,7000 --party 1,::1,7001 --fractional-bits 13
+--config-file-model file_config_model1 --current-path $build_path
+*/
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <regex>
+#include <sstream>
+#include <stdexcept>
+
+#include <boost/algorithm/string.hpp>
+#include <boost/json/serialize.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/program_options.hpp>
+#include <fmt/format.h>
+
+#include "algorithm/circuit_loader.h"
+#include "base/gate_factory.h"
+#include "base/two_party_backend.h"
+#include "base/two_party_tensor_backend.h"
+#include "communication/communication_layer.h"
+#include "communication/shm_transport.h"
+#include "communication/tcp_transport.h"
+#include "protocols/beavy/tensor.h"
+#include "protocols/common/comm_mixin.h"
+#include "statistics/analysis.h"
+#include "statistics/run_time_stats.h"
+#include "tensor/tensor.h"
+#include "tensor/tensor_op.h"
+#include "tensor/tensor_op_factory.h"
+#include "utility/logger.h"
+#include "utility/share_file.h"
+
+namespace po = boost::program_options;
+
+// BEAVY shares of a matrix, (Delta, delta) per element in row-major order.
+struct Matrix {
+  std::vector<std::uint64_t> Delta;
+  std::vector<std::uint64_t> delta;
+  std::size_t row;
+  std::size_t col;
+};
+
+struct Layer {
+  Matrix weights;
+  Matrix bias;
+};
+
+struct Options {
+  std::size_t threads;
+  bool json;
+  bool sync_between_setup_and_online;
+  std::size_t fractional_bits;
+  std::size_t my_id;
+  std::string config_file_model;
+  std::string currentpath;
+  std::optional<std::string> boolean_output_share_dir;
+  MOTION::Communication::tcp_parties_config tcp_config;
+  MOTION::Communication::TCPSetupOptions tcp_options;
+  std::optional<std::string> shm_name;
+  bool compress_messages;
+  std::size_t ot_matrix_window_size;
+  bool silent_ot;
+  bool yao_relu;
+  bool asap;
+  bool release_dead_tensors;
+};
+
+// Reads a binary or text share file, see utility/share_file.h.
+Matrix read_shares(const std::string& path) {
+  auto shares = MOTION::read_share_file<std::uint64_t>(path);
+  return {std::move(shares.public_shares_), std::move(shares.secret_shares_), shares.rows_,
+          shares.cols_};
+}
+
+// The model config file lists the weight and bias share files of each layer, one per line.
+std::vector<Layer> read_model(const Options& options) {
+  const auto config_path = options.currentpath + "/" + options.config_file_model;
+  std::ifstream config_file(config_path);
+  if (!config_file) {
+    throw std::runtime_error("unable to open model config file " + config_path);
+  }
+  std::vector<Layer> layers;
+  std::string weights_path, bias_path;
+  while (config_file >> weights_path >> bias_path) {
+    auto& layer = layers.emplace_back();
+    layer.weights = read_shares(weights_path);
+    layer.bias = read_shares(bias_path);
+    if (layer.bias.row != layer.weights.row || layer.bias.col != 1) {
+      throw std::runtime_error("bias " + bias_path + " does not match weights " + weights_path);
+    }
+  }
+  if (layers.empty()) {
+    throw std::runtime_error("model config file " + config_path + " contains no layers");
+  }
+  return layers;
+}
+
+std::optional<Options> parse_program_options(int argc, char* argv[]) {
+  Options options;
+  boost::program_options::options_description desc("Allowed options");
+  // clang-format off
+  desc.add_options()
+    ("help,h", po::bool_switch()->default_value(false),"produce help message")
+    ("config-file", po::value<std::string>(), "config file containing options")
+    ("my-id", po::value<std::size_t>()->required(), "my party id")
+    ("party", po::value<std::vector<std::string>>()->multitoken(),
+     "(party id, IP, port), e.g., --party 1,127.0.0.1,7777")
+    ("threads", po::value<std::size_t>()->default_value(0), "number of threads to use for gate evaluation")
+    ("json", po::bool_switch()->default_value(false), "output data in JSON format")
+    ("fractional-bits", po::value<std::size_t>()->default_value(16),
+     "number of fractional bits for fixed-point arithmetic")
+    ("config-file-model", po::value<std::string>()->required(), "config file listing the weight and bias share files")
+    ("current-path", po::value<std::string>()->required(), "current path build_debwithrelinfo")
+    ("boolean-output-share-dir", po::value<std::string>(),
+     "directory in which the output gates of the argmax write their shares, defaults to "
+     "$BASE_DIR/build_debwithrelinfo_gcc/server<my-id>/Boolean_Output_Shares")
+    ("sync-between-setup-and-online", po::bool_switch()->default_value(false),
+     "run a synchronization protocol before the online phase starts")
+    ("num-streams", po::value<std::size_t>()->default_value(1),
+     "number of TCP connections to stripe large messages over (must match the other party)")
+    ("shm-name", po::value<std::string>(),
+     "connect to the other party on this host via shared memory of this name instead of TCP")
+    ("compress-messages", po::bool_switch()->default_value(false),
+     "try to compress the sent integer messages")
+    ("ot-matrix-window", po::value<std::size_t>()->default_value(0),
+     "expand and transpose the OT extension matrix in windows of this many OTs, 0 extends all "
+     "at once; this bounds the matrix scratch space and the masks in flight, but not the OT "
+     "outputs (must match the other party)")
+    ("silent-ot", po::bool_switch()->default_value(false),
+     "extend OTs with the silent OT extension instead of IKNP to reduce the preprocessing "
+     "communication (must match the other party)")
+    ("yao-relu", po::bool_switch()->default_value(false),
+     "compute the ReLU with a garbled circuit on the converted input instead of extracting only "
+     "the sign bit (must match the other party)")
+    ("asap", po::bool_switch()->default_value(false),
+     "start each layer's gates as soon as their inputs are ready instead of running the setup of "
+     "all gates before the online phase")
+    ("release-dead-tensors", po::bool_switch()->default_value(false),
+     "free the buffers of each tensor as soon as no gate reads it anymore")
+    ;
+  // clang-format on
+
+  po::variables_map vm;
+  po::store(po::parse_command_line(argc, argv, desc), vm);
+  bool help = vm["help"].as<bool>();
+  if (help) {
+    std::cerr << desc << "\n";
+    return std::nullopt;
+  }
+  if (vm.count("config-file")) {
+    std::ifstream ifs(vm["config-file"].as<std::string>().c_str());
+    po::store(po::parse_config_file(ifs, desc), vm);
+  }
+  try {
+    po::notify(vm);
+  } catch (std::exception& e) {
+    std::cerr << "error:" << e.what() << "\n\n";
+    std::cerr << desc << "\n";
+    return std::nullopt;
+  }
+
+  options.my_id = vm["my-id"].as<std::size_t>();
+  options.threads = vm["threads"].as<std::size_t>();
+  options.json = vm["json"].as<bool>();
+  options.sync_between_setup_and_online = vm["sync-between-setup-and-online"].as<bool>();
+  options.fractional_bits = vm["fractional-bits"].as<std::size_t>();
+  options.config_file_model = vm["config-file-model"].as<std::string>();
+  options.currentpath = vm["current-path"].as<std::string>();
+  if (vm.count("boolean-output-share-dir")) {
+    options.boolean_output_share_dir = vm["boolean-output-share-dir"].as<std::string>();
+  }
+  options.tcp_options.num_streams_ = vm["num-streams"].as<std::size_t>();
+  if (vm.count("shm-name")) {
+    options.shm_name = vm["shm-name"].as<std::string>();
+  }
+  options.compress_messages = vm["compress-messages"].as<bool>();
+  options.ot_matrix_window_size = vm["ot-matrix-window"].as<std::size_t>();
+  options.silent_ot = vm["silent-ot"].as<bool>();
+  options.yao_relu = vm["yao-relu"].as<bool>();
+  options.asap = vm["asap"].as<bool>();
+  options.release_dead_tensors = vm["release-dead-tensors"].as<bool>();
+  if (options.my_id > 1) {
+    std::cerr << "my-id must be one of 0 and 1\n";
+    return std::nullopt;
+  }
+
+  const auto parse_party_argument =
+      [](const auto& s) -> std::pair<std::size_t, MOTION::Communication::tcp_connection_config> {
+    const static std::regex party_argument_re("([01]),([^,]+),(\\d{1,5})");
+    std::smatch match;
+    if (!std::regex_match(s, match, party_argument_re)) {
+      throw std::invalid_argument("invalid party argument");
+    }
+    auto id = boost::lexical_cast<std::size_t>(match[1]);
+    auto host = match[2];
+    auto port = boost::lexical_cast<std::uint16_t>(match[3]);
+    return {id, {host, port}};
+  };
+
+  if (options.shm_name.has_value()) {
+    // no addresses needed
+    return options;
+  }
+  const std::vector<std::string> party_infos = vm["party"].as<std::vector<std::string>>();
+  if (party_infos.size() != 2) {
+    std::cerr << "expecting two --party options\n";
+    return std::nullopt;
+  }
+
+  options.tcp_config.resize(2);
+
+  const auto [id0, conn_info0] = parse_party_argument(party_infos[0]);
+  const auto [id1, conn_info1] = parse_party_argument(party_infos[1]);
+  if (id0 == id1) {
+    std::cerr << "need party arguments for party 0 and 1\n";
+    return std::nullopt;
+  }
+  options.tcp_config[id0] = conn_info0;
+  options.tcp_config[id1] = conn_info1;
+
+  return options;
+}
+
+std::unique_ptr<MOTION::Communication::CommunicationLayer> setup_communication(
+    const Options& options) {
+  if (options.shm_name.has_value()) {
+    MOTION::Communication::ShmSetupHelper helper(options.my_id, 2, *options.shm_name);
+    return std::make_unique<MOTION::Communication::CommunicationLayer>(
+        options.my_id, helper.setup_connections());
+  }
+  MOTION::Communication::TCPSetupHelper helper(options.my_id, options.tcp_config,
+                                               options.tcp_options);
+  return std::make_unique<MOTION::Communication::CommunicationLayer>(options.my_id,
+                                                                     helper.setup_connections());
+}
+
+void print_stats(const Options& options, const std::string& name,
+                 const MOTION::Statistics::AccumulatedRunTimeStats& run_time_stats,
+                 const MOTION::Statistics::AccumulatedCommunicationStats& comm_stats) {
+  if (options.json) {
+    auto obj = MOTION::Statistics::to_json(name, run_time_stats, comm_stats);
+    obj.emplace("party_id", options.my_id);
+    obj.emplace("threads", options.threads);
+    obj.emplace("sync_between_setup_and_online", options.sync_between_setup_and_online);
+    std::cout << obj << "\n";
+  } else {
+    std::cout << MOTION::Statistics::print_stats(name, run_time_stats, comm_stats);
+  }
+}
+
+// Repeats the column vector m num_columns times.  Copying the shares is a valid sharing of the
+// repeated vector, so no interaction is needed.
+Matrix broadcast(const Matrix& m, std::size_t num_columns) {
+  if (num_columns == 1) {
+    return m;
+  }
+  Matrix result{std::vector<std::uint64_t>(m.row * num_columns),
+                std::vector<std::uint64_t>(m.row * num_columns), m.row, num_columns};
+  for (std::size_t i = 0; i < m.row; ++i) {
+    std::fill_n(result.Delta.begin() + i * num_columns, num_columns, m.Delta[i]);
+    std::fill_n(result.delta.begin() + i * num_columns, num_columns, m.delta[i]);
+  }
+  return result;
+}
+
+// Evaluates W * X + b (followed by a ReLU unless this is the last layer) on a fresh tensor backend
+// and returns the shares of the result.  Every column of X is one image of the batch, and b is
+// added to each column.  The backend, and with it all gates of the layer, is
+// destroyed before returning.
+Matrix run_layer(const Options& options, MOTION::Communication::CommunicationLayer& comm_layer,
+                 std::shared_ptr<MOTION::Logger> logger, const Layer& layer, const Matrix& input,
+                 bool apply_relu, MOTION::Statistics::AccumulatedRunTimeStats& run_time_stats) {
+  MOTION::TwoPartyTensorBackend backend(comm_layer, options.threads,
+                                        options.sync_between_setup_and_online, logger);
+  backend.set_message_compression(options.compress_messages);
+  backend.set_ot_extension_window_size(options.ot_matrix_window_size);
+  backend.set_silent_ot_extension(options.silent_ot);
+  backend.set_release_dead_tensors(options.release_dead_tensors);
+  auto& arithmetic_tof = backend.get_tensor_op_factory(MOTION::MPCProtocol::ArithmeticBEAVY);
+  auto& boolean_tof = backend.get_tensor_op_factory(MOTION::MPCProtocol::Yao);
+
+  if (layer.weights.col != input.row) {
+    throw std::runtime_error(fmt::format("layer expects an input with {} rows, got {}x{}",
+                                         layer.weights.col, input.row, input.col));
+  }
+  const auto batch_size = input.col;
+  const MOTION::tensor::GemmOp gemm_op = {
+      .input_A_shape_ = {layer.weights.row, layer.weights.col},
+      .input_B_shape_ = {input.row, input.col},
+      .output_shape_ = {layer.weights.row, input.col}};
+
+  const auto make_input = [&arithmetic_tof](const auto& dims, const Matrix& m) {
+    auto [promises, tensor] = arithmetic_tof.make_arithmetic_64_tensor_input_shares(dims);
+    promises[0].set_value(m.Delta);
+    promises[1].set_value(m.delta);
+    return tensor;
+  };
+  const auto tensor_W = make_input(gemm_op.get_input_A_tensor_dims(), layer.weights);
+  const auto tensor_X = make_input(gemm_op.get_input_B_tensor_dims(), input);
+  const auto tensor_B =
+      make_input(gemm_op.get_output_tensor_dims(), broadcast(layer.bias, batch_size));
+
+  const auto gemm_output =
+      arithmetic_tof.make_tensor_gemm_op(gemm_op, tensor_W, tensor_X, options.fractional_bits);
+  auto output = arithmetic_tof.make_tensor_add_op(gemm_output, tensor_B);
+  if (apply_relu && !options.yao_relu) {
+    output = arithmetic_tof.make_tensor_relu_op(output);
+  } else if (apply_relu) {
+    const auto negated_tensor = arithmetic_tof.make_tensor_negate(output);
+    const auto boolean_tensor =
+        boolean_tof.make_tensor_conversion(MOTION::MPCProtocol::Yao, negated_tensor);
+    const auto relu_tensor = boolean_tof.make_tensor_relu_op(boolean_tensor);
+    const auto arithmetic_tensor =
+        boolean_tof.make_tensor_conversion(MOTION::MPCProtocol::ArithmeticBEAVY, relu_tensor);
+    output = arithmetic_tof.make_tensor_negate(arithmetic_tensor);
+  }
+
+  if (options.asap) {
+    backend.run_asap();
+  } else {
+    backend.run();
+  }
+  comm_layer.sync();
+  run_time_stats.add(backend.get_run_time_stats());
+  if (options.compress_messages) {
+    const auto encoding_stats = backend.get_message_encoding_statistics();
+    logger->LogInfo(fmt::format("compressed {} integer messages from {} B to {} B",
+                                encoding_stats.num_messages_, encoding_stats.num_raw_bytes_,
+                                encoding_stats.num_encoded_bytes_));
+  }
+
+  const auto beavy_output =
+      std::dynamic_pointer_cast<const MOTION::proto::beavy::ArithmeticBEAVYTensor<std::uint64_t>>(
+          output);
+  assert(beavy_output);
+  return {beavy_output->get_public_share(), beavy_output->get_secret_share(), layer.weights.row,
+          batch_size};
+}
+
+// Computes the boolean shares of gt(max, x_i) for every element of the last layer, as done by
+// the argmax example.  The element equal to the maximum is the one whose bit is 0.  The columns of
+// the input are evaluated as SIMD values of the same gates and written to one file each.
+void run_argmax(const Options& options, MOTION::Communication::CommunicationLayer& comm_layer,
+                std::shared_ptr<MOTION::Logger> logger, const Matrix& input,
+                const std::vector<std::string>& output_names,
+                MOTION::Statistics::AccumulatedRunTimeStats& run_time_stats) {
+  const auto boolean_protocol = MOTION::MPCProtocol::BooleanBEAVY;
+  const auto num_elements = input.row;
+  const auto batch_size = input.col;
+  if (output_names.size() != batch_size) {
+    throw std::runtime_error(fmt::format(
+        "the request names {} outputs, but the share file holds a batch of {} images",
+        output_names.size(), batch_size));
+  }
+  std::vector<std::size_t> gate_ids;
+  std::filesystem::path gate_share_dir;
+  {
+    MOTION::TwoPartyBackend backend(comm_layer, options.threads,
+                                    options.sync_between_setup_and_online, logger);
+    if (options.boolean_output_share_dir.has_value()) {
+      backend.set_boolean_output_share_directory(*options.boolean_output_share_dir);
+    }
+    gate_share_dir = backend.get_boolean_output_share_directory();
+    auto& gate_factory_arith = backend.get_gate_factory(MOTION::MPCProtocol::ArithmeticBEAVY);
+    auto& gate_factory_bool = backend.get_gate_factory(boolean_protocol);
+
+    MOTION::WireVector input_bool;
+    for (std::size_t i = 0; i < num_elements; ++i) {
+      auto [promises, input_arith] =
+          gate_factory_arith.make_arithmetic_64_input_gate_shares(batch_size);
+      const auto row_begin = i * batch_size;
+      promises[0].set_value(std::vector<std::uint64_t>(
+          input.Delta.begin() + row_begin, input.Delta.begin() + row_begin + batch_size));
+      promises[1].set_value(std::vector<std::uint64_t>(
+          input.delta.begin() + row_begin, input.delta.begin() + row_begin + batch_size));
+      const auto element_bool = backend.convert(boolean_protocol, input_arith);
+      input_bool.insert(std::end(input_bool), std::begin(element_bool), std::end(element_bool));
+    }
+
+    MOTION::CircuitLoader circuit_loader;
+    auto& argmax_circuit = circuit_loader.load_argmax_circuit(64, num_elements, true);
+    const auto one_hot = backend.make_circuit(argmax_circuit, input_bool);
+    for (std::size_t i = 0; i < num_elements; ++i) {
+      // final_output_provider expects a 0 at the position of the maximum
+      auto output = backend.make_unary_gate(ENCRYPTO::PrimitiveOperationType::INV, {one_hot[i]});
+      gate_ids.push_back(gate_factory_bool.make_boolean_output_gate_my_wo_getting_output(
+          MOTION::ALL_PARTIES, output));
+    }
+
+    backend.run();
+    comm_layer.sync();
+    run_time_stats.add(backend.get_run_time_stats());
+  }
+
+  // collect the shares written by the output gates into the file read by final_output_provider
+  const auto server = "server" + std::to_string(options.my_id);
+  const std::filesystem::path output_dir =
+      options.currentpath + "/" + server + "/Boolean_Output_Shares";
+  std::filesystem::create_directories(output_dir);
+  std::vector<std::ofstream> output_files;
+  for (const auto& output_name : output_names) {
+    auto& output_file = output_files.emplace_back(
+        output_dir / ("Final_Boolean_Shares_" + server + "_" + output_name + ".txt"));
+    if (!output_file) {
+      throw std::runtime_error("unable to write final output shares for " + output_name);
+    }
+    output_file << gate_ids.size() << "\n";
+  }
+  std::sort(std::begin(gate_ids), std::end(gate_ids));
+  for (const auto gate_id : gate_ids) {
+    const auto gate_share_path =
+        gate_share_dir /
+        ("output_share_for_" + server + "_gate" + std::to_string(gate_id) + ".txt");
+    std::ifstream gate_share_file(gate_share_path);
+    std::string Delta, delta;
+    // one bit per column of the batch
+    if (!(gate_share_file >> Delta >> delta) || Delta.size() != batch_size ||
+        delta.size() != batch_size) {
+      throw std::runtime_error("unable to read output share " + gate_share_path.string());
+    }
+    for (std::size_t j = 0; j < batch_size; ++j) {
+      output_files[j] << Delta[j] << " " << delta[j] << "\n";
+    }
+    gate_share_file.close();
+    std::filesystem::remove(gate_share_path);
+  }
+}
+
+int main(int argc, char* argv[]) {
+  try {
+    auto options = parse_program_options(argc, argv);
+    if (!options.has_value()) {
+      return EXIT_FAILURE;
+    }
+
+    const auto layers = read_model(*options);
+
+    auto comm_layer = setup_communication(*options);
+    auto logger = std::make_shared<MOTION::Logger>(options->my_id,
+                                                   boost::log::trivial::severity_level::trace);
+    comm_layer->set_logger(logger);
+
+    std::string request;
+    while (std::getline(std::cin, request)) {
+      std::istringstream request_stream(request);
+      std::string image_share_path, output_name;
+      if (!(request_stream >> image_share_path)) {
+        continue;
+      }
+      if (image_share_path == "exit") {
+        break;
+      }
+      if (!(request_stream >> output_name)) {
+        output_name = std::filesystem::path(image_share_path).stem();
+      }
+
+      MOTION::Statistics::AccumulatedRunTimeStats run_time_stats;
+      MOTION::Statistics::AccumulatedCommunicationStats comm_stats;
+      const auto start_time = std::chrono::steady_clock::now();
+
+      auto activations = read_shares(image_share_path);
+      const auto batch_size = activations.col;
+      std::vector<std::string> output_names;
+      if (batch_size == 1) {
+        output_names.push_back(output_name);
+      } else {
+        for (std::size_t j = 0; j < batch_size; ++j) {
+          output_names.push_back(output_name + "_" + std::to_string(j));
+        }
+      }
+      for (std::size_t layer_i = 0; layer_i < layers.size(); ++layer_i) {
+        const bool is_last_layer = layer_i + 1 == layers.size();
+        activations = run_layer(*options, *comm_layer, logger, layers[layer_i], activations,
+                                !is_last_layer, run_time_stats);
+      }
+      run_argmax(*options, *comm_layer, logger, activations, output_names, run_time_stats);
+
+      const std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start_time;
+      comm_stats.add(comm_layer->get_transport_statistics());
+      comm_layer->reset_transport_statistics();
+      print_stats(*options, "inference_daemon", run_time_stats, comm_stats);
+      std::cout << fmt::format("{} images in {:.3f} s ({:.2f} images/s)\n", batch_size,
+                               duration.count(), batch_size / duration.count());
+      std::cout << "done " << output_name << std::endl;
+    }
+
+    comm_layer->shutdown();
+  } catch (std::exception& e) {
+    std::cerr << "ERROR OCCURRED: " << e.what() << "\n";
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
@@ -22,6 +22,7 @@
 #include <parallel/algorithm>
 #include <vector>
 #include "utility/new_fixed_point.h"
+#include "utility/share_file.h"
 
 #include <boost/chrono.hpp>
 #include <boost/thread/thread.hpp>
@@ -35,6 +36,7 @@ std::vector<std::uint64_t> randomnum, prod1;
 bool helpernode_ready_flag = false;
 int operations_done_flag = 0;
 std::uint64_t fractional_bits;
+std::string current_path;
 namespace po = boost::program_options;
 
 void testMemoryOccupied(int WriteToFiles, int my_id, std::string path) {
@@ -121,6 +123,7 @@ std::optional<Options> parse_program_options(int argc, char* argv[]) {
   options.layer_id = vm["layer-id"].as<std::size_t>();
   options.fractional_bits = vm["fractional-bits"].as<std::size_t>();
   fractional_bits = options.fractional_bits;
+  current_path = options.current_path;
   std::cout<<"Fractional bits: "<<fractional_bits<<std::endl;
   // clang-format on;
 
@@ -424,36 +427,47 @@ class TestMessageHandler : public MOTION::Communication::MessageHandler {
     //final secret share=randomnum
 	  __gnu_parallel::transform(randomnum_begin, randomnum_end, bsecret_begin, randomnum_begin , std::plus{});
 
-   std::string basedir = getenv("BASE_DIR");
-   std::string filename = basedir + "/build_debwithrelinfo_gcc";
-   std::string totalpath = filename + "/server0/" + "outputshare_0";
-
-   std::ofstream indata;
-   indata.open(totalpath,std::ios_base::out);
-   assert(indata);
-
-   indata<<Final_public[0]<<" "<<Final_public[1]<<"\n";
-   for(int i=2;i<Final_public.size();i++)
-   {
-    indata<<Final_public[i]<<" "<<randomnum[i]<<"\n";
-   }
-   indata.close();
-
-   //Adding the path to the config file for using in the next layer
-    std::string file_config_input = filename + "/file_config_input0";
-    std::ofstream config_file;
-    config_file.open(file_config_input,std::ios_base::out);
-    if (!config_file.is_open()) {
-        std::cerr << " Error in writing the file_config_input0 file\n";
-        exit(1);
-      }
-    config_file<<totalpath;
-    config_file.close();
+   // shares for the next layer
+   const std::size_t rows = Final_public[0], cols = Final_public[1];
+   const auto totalpath = current_path + "/server0/outputshare_0";
+   MOTION::write_share_file<std::uint64_t>(totalpath, 0, fractional_bits, rows, cols,
+                                           std::span(Final_public).subspan(2, rows * cols),
+                                           std::span(randomnum).subspan(2, rows * cols));
   } 
 }
 }; 
 
 
+// Reads a binary or text share file and appends rows, cols and the shares to the given vectors.
+// If message is given, rows, cols and the secret shares are appended to it as well.
+void load_shares(const std::string& path, std::vector<std::uint64_t>& public_shares,
+                 std::vector<std::uint64_t>& secret_shares, std::vector<uint8_t>* message)
+{
+  MOTION::ShareFileContents<std::uint64_t> shares;
+  try {
+    shares = MOTION::read_share_file<std::uint64_t>(path);
+  } catch (std::runtime_error& e) {
+    std::cerr << "Error while reading shares: " << e.what() << "\n";
+    exit(1);
+  }
+  std::cout << "Number of shares read from " << path << ": " << shares.public_shares_.size() << "\n";
+  public_shares.push_back(shares.rows_);
+  public_shares.push_back(shares.cols_);
+  public_shares.insert(public_shares.end(), shares.public_shares_.begin(),
+                       shares.public_shares_.end());
+  secret_shares.push_back(shares.rows_);
+  secret_shares.push_back(shares.cols_);
+  secret_shares.insert(secret_shares.end(), shares.secret_shares_.begin(),
+                       shares.secret_shares_.end());
+  if (message != nullptr) {
+    adduint64(shares.rows_, *message);
+    adduint64(shares.cols_, *message);
+    for (auto secret_share : shares.secret_shares_) {
+      adduint64(secret_share, *message);
+    }
+  }
+}
+
 void read_shares(int choice,int my_id, std::vector<uint8_t>&message,const Options& options)
 { 
    std::string name=options.WB_file;
@@ -485,111 +499,8 @@ void read_shares(int choice,int my_id, std::vector<uint8_t>&message,const Option
 
     std::cout<<"Weights path: "<<wpath<<"\nBias path: "<<bpath<<"\n";
     
-    std::ifstream file(wpath);
-    if (!file) {
-      std::cerr << "Error in opening the weights file\n";
-      exit(1);
-    }
-    std::uint64_t rows, col;
-    try{
-    file >> rows >> col;
-    }
-    catch (std::ifstream::failure e) {
-      std::cerr << "Error while reading rows and columns from weight shares file.\n";
-      exit(1);
-    }
-
-    if (file.eof()) {
-      std::cerr << "Weights File doesn't contain the shares" << std::endl;
-      exit(1);
-    }
-
-    auto k = 0;
-    adduint64(rows, message);
-    adduint64(col, message);
-    wpublic.push_back(rows);
-    wpublic.push_back(col);
-    wsecret.push_back(rows);
-    wsecret.push_back(col);
-    while (k < rows * col) {
-      std::uint64_t public_share, secret_share;
-      try{    
-        file >> public_share;
-        wpublic.push_back(public_share);
-        file >> secret_share;
-        wsecret.push_back(secret_share);
-      }
-      catch (std::ifstream::failure e) {
-      std::cerr << "Error while reading the weight shares.\n";
-      exit(1);
-      }
-      if (file.eof()) {
-        std::cerr << "Weight shares file contains less number of elements" << std::endl;
-        exit(1);
-      }
-      adduint64(secret_share, message);
-      k++;
-    }
-    std::cout<<"Number of weight shares read: "<<k<<"\n"; 
-    if (k == rows * col) {
-      std::uint64_t num;
-      file >> num;
-      if (!file.eof()) {
-        std::cerr << "Weight shares file contains more number of elements" << std::endl;
-        exit(1);
-      }
-    }
-    file.close();
-
-    file.open(bpath);
-    if (!file) {
-    std::cerr << " Error in opening bias file\n";
-    exit(1);
-    }
-    try{
-      file >> rows >> col;
-    }
-    catch (std::ifstream::failure e) {
-      std::cerr << "Error while reading rows and columns from bias shares file.\n";
-      exit(1);
-    }
-    if (file.eof()) {
-      std::cerr << "Bias shares file doesn't contain rows and columns" << std::endl;
-      exit(1);
-    }
-       
-    auto j=0;
-    bpublic.push_back(rows);
-    bpublic.push_back(col);
-    bsecret.push_back(rows);
-    bsecret.push_back(col);
-    while (j < rows * col) {
-      std::uint64_t public_share, secret_share;
-      try{
-      file >> public_share;
-      bpublic.push_back(public_share);
-      file >> secret_share;
-      bsecret.push_back(secret_share);
-      }
-      catch (std::ifstream::failure e) {
-      std::cerr << "Error while reading bias shares.\n";
-      exit(1);
-      }
-      if (file.eof()) {
-        std::cerr << "Bias shares file contains less number of elements" << std::endl;
-        exit(1);
-      }
-      j++;
-    }
-    if (j == rows * col) {
-      std::uint64_t num;
-        file >> num;
-      if (!file.eof()) {
-        std::cerr << "Bias shares file contains more number of elements" << std::endl;
-        exit(1);
-      }
-    }
-    file.close();
+    load_shares(wpath, wpublic, wsecret, &message);
+    load_shares(bpath, bpublic, bsecret, nullptr);
   }
   else if(choice==2)
   {
@@ -604,59 +515,7 @@ void read_shares(int choice,int my_id, std::vector<uint8_t>&message,const Option
     std::cout<<"Input share file path: "<<fullpath<<std::endl;
     std::cout<<"Reading the input shares\n";
 
-    std::ifstream file(fullpath);
-
-    if (!file) {
-      std::cerr << "Error in opening input file at "<<fullpath<<"\n";
-      exit(1);
-    }
-    std::uint64_t rows, col;
-    try{
-    file >> rows >> col;
-    }
-    catch (std::ifstream::failure e) {
-      std::cerr << "Error while reading rows and columns from input shares file.\n";
-      exit(1);
-    }
-    if (file.eof()) {
-      std::cerr << "Input shares file doesn't contain rows and columns" << std::endl;
-      exit(1);
-    }
-    auto k = 0;
-    adduint64(rows, message);
-    adduint64(col, message);
-    xpublic.push_back(rows);
-    xpublic.push_back(col);
-    xsecret.push_back(rows);
-    xsecret.push_back(col);
-    while (k < rows * col) {
-      std::uint64_t public_share, secret_share;
-      try{
-      file >> public_share;
-      xpublic.push_back(public_share);
-      file >> secret_share;
-      xsecret.push_back(secret_share);
-      }
-      catch (std::ifstream::failure e) {
-      std::cerr << "Error while reading the input shares.\n";
-      exit(1);
-      }
-      if (file.eof()) {
-      std::cerr << "Input shares file contains less number of elements" << std::endl;
-      exit(1);
-      }
-      adduint64(secret_share, message);
-      k++;
-    }
-    if (k == rows * col) {
-      std::uint64_t num;
-      file >> num;
-      if (!file.eof()) {
-        std::cerr << "File contains more number of elements" << std::endl;
-        exit(1);
-      }
-    }
-    file.close();
+    load_shares(fullpath, xpublic, xsecret, &message);
   }
 }
 
@@ -25,6 +25,7 @@
 #include "algorithm_description.h"
 
 #include <fstream>
+#include <limits>
 #include <regex>
 #include <sstream>
 
@@ -411,4 +412,66 @@ AlgorithmDescription AlgorithmDescription::FromABY(std::ifstream& stream) {
   }
   return algo;
 }  // namespace ENCRYPTO
+
+void AlgorithmDescription::compute_wire_slots() {
+  assert(gates_.size() == n_gates_);
+  constexpr auto dead = std::numeric_limits<std::size_t>::max();
+  const auto n_input_wires = n_input_wires_parent_a_ + n_input_wires_parent_b_.value_or(0);
+
+  // index of the last gate reading each wire, the outputs are live until the end
+  std::vector<std::size_t> last_use(n_wires_, dead);
+  for (std::size_t gate_i = 0; gate_i < n_gates_; ++gate_i) {
+    const auto& op = gates_[gate_i];
+    last_use[op.parent_a_] = gate_i;
+    if (op.parent_b_.has_value()) {
+      last_use[*op.parent_b_] = gate_i;
+    }
+    if (op.selection_bit_.has_value()) {
+      last_use[*op.selection_bit_] = gate_i;
+    }
+  }
+  for (std::size_t wire_i = n_wires_ - n_output_wires_; wire_i < n_wires_; ++wire_i) {
+    last_use[wire_i] = n_gates_;
+  }
+
+  wire_slots_.assign(n_wires_, 0);
+  n_slots_ = 0;
+  // reuse the most recently freed slot first, since it is likely still cached
+  std::vector<std::size_t> free_slots;
+  const auto allocate = [&](std::size_t wire) {
+    if (free_slots.empty()) {
+      wire_slots_[wire] = n_slots_++;
+    } else {
+      wire_slots_[wire] = free_slots.back();
+      free_slots.pop_back();
+    }
+  };
+  const auto release_after = [&](std::size_t wire, std::size_t gate_i) {
+    if (last_use[wire] == gate_i) {
+      free_slots.push_back(wire_slots_[wire]);
+      last_use[wire] = dead - 1;
+    }
+  };
+
+  for (std::size_t wire_i = 0; wire_i < n_input_wires; ++wire_i) {
+    allocate(wire_i);
+  }
+  for (std::size_t wire_i = 0; wire_i < n_input_wires; ++wire_i) {
+    release_after(wire_i, dead);
+  }
+  for (std::size_t gate_i = 0; gate_i < n_gates_; ++gate_i) {
+    const auto& op = gates_[gate_i];
+    // allocate the output before releasing the inputs, so that they never alias
+    allocate(op.output_wire_);
+    release_after(op.parent_a_, gate_i);
+    if (op.parent_b_.has_value()) {
+      release_after(*op.parent_b_, gate_i);
+    }
+    if (op.selection_bit_.has_value()) {
+      release_after(*op.selection_bit_, gate_i);
+    }
+    release_after(op.output_wire_, dead);
+  }
+}
+
 }
@@ -59,9 +59,23 @@ struct AlgorithmDescription {
 
   static AlgorithmDescription FromABY(std::ifstream& stream);
 
+  // Computes the lifetimes of the wires and assigns them slots s.t. wires which
+  // are live at the same time never share a slot.  The slots need to be
+  // recomputed whenever the gates are modified.
+  void compute_wire_slots();
+
+  // position of the wire in a buffer of get_num_slots() wires
+  std::size_t get_wire_slot(std::size_t wire) const {
+    return wire_slots_.empty() ? wire : wire_slots_[wire];
+  }
+  std::size_t get_num_slots() const { return wire_slots_.empty() ? n_wires_ : n_slots_; }
+
   std::size_t n_output_wires_{0}, n_input_wires_parent_a_{0}, n_wires_{0}, n_gates_{0};
   std::optional<std::size_t> n_input_wires_parent_b_{std::nullopt};
   std::vector<PrimitiveOperation> gates_;
+  // [wire -> slot], empty if the slots have not been computed
+  std::vector<std::size_t> wire_slots_;
+  std::size_t n_slots_{0};
 };
 
 }
@@ -23,11 +23,14 @@
 #include "circuit_loader.h"
 
 #include <algorithm>
+#include <cassert>
 #include <exception>
 #include <filesystem>
+#include <numeric>
 #include <optional>
 #include <queue>
 #include <stdexcept>
+#include <vector>
 
 #include <fmt/format.h>
 
@@ -62,6 +65,12 @@ static std::string format_search_path(std::vector<fs::path> paths) {
   return s;
 }
 
+const ENCRYPTO::AlgorithmDescription& CircuitLoader::cache_circuit(
+    const std::string& name, ENCRYPTO::AlgorithmDescription&& algo) {
+  algo.compute_wire_slots();
+  return algo_cache_[name] = std::move(algo);
+}
+
 const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_circuit(std::string name,
                                                                   CircuitFormat format) {
   auto it = algo_cache_.find(name);
@@ -76,17 +85,14 @@ const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_circuit(std::string na
       try {
         switch (format) {
           case CircuitFormat::ABY:
-            algo_cache_[name] = ENCRYPTO::AlgorithmDescription::FromABY(dir_entry.path());
-            break;
+            return cache_circuit(name, ENCRYPTO::AlgorithmDescription::FromABY(dir_entry.path()));
           case CircuitFormat::Bristol:
-            algo_cache_[name] = ENCRYPTO::AlgorithmDescription::FromBristol(dir_entry.path());
-            break;
+            return cache_circuit(name,
+                                 ENCRYPTO::AlgorithmDescription::FromBristol(dir_entry.path()));
           case CircuitFormat::BristolFashion:
-            algo_cache_[name] =
-                ENCRYPTO::AlgorithmDescription::FromBristolFashion(dir_entry.path());
-            break;
+            return cache_circuit(
+                name, ENCRYPTO::AlgorithmDescription::FromBristolFashion(dir_entry.path()));
         }
-        return algo_cache_[name];
       } catch (std::runtime_error& e) {
         throw std::runtime_error(
             fmt::format("Could not load circuit description '{:s}' from file {:s}: '{:s}'", name,
@@ -128,8 +134,7 @@ const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_relu_circuit(std::size
                                       .n_wires_ = 2 * bit_size + 1,
                                       .n_gates_ = bit_size + 1,
                                       .gates_ = std::move(gates)};
-  algo_cache_[name] = std::move(algo);
-  return algo_cache_[name];
+  return cache_circuit(name, std::move(algo));
 }
 
 const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_gt_circuit(std::size_t bit_size,
@@ -154,7 +159,7 @@ const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_gt_circuit(std::size_t
   algo.gates_.resize(algo.n_gates_);
   algo.gates_.at(algo.n_gates_ - 1).output_wire_ -= 2;
 
-  return algo_cache_[name] = std::move(algo);
+  return cache_circuit(name, std::move(algo));
 }
 
 const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_gtmux_circuit(std::size_t bit_size,
@@ -212,8 +217,7 @@ const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_gtmux_circuit(std::siz
     assert(op.output_wire_ < algo.n_wires_);
   }
 
-  algo_cache_[name] = std::move(algo);
-  return algo_cache_[name];
+  return cache_circuit(name, std::move(algo));
 }
 
 const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_gtmod_circuit(std::size_t bit_size,
@@ -265,8 +269,7 @@ const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_gtmod_circuit(std::siz
     assert(op.output_wire_ < algo.n_wires_);
   }
 
-  algo_cache_[name] = std::move(algo);
-  return algo_cache_[name];
+  return cache_circuit(name, std::move(algo));
 }
 
 const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_tree_circuit(const std::string& algo_name,
@@ -368,8 +371,7 @@ const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_tree_circuit(const std
     }
   }
 
-  algo_cache_[name] = std::move(tree_algo);
-  return algo_cache_[name];
+  return cache_circuit(name, std::move(tree_algo));
 }
 
 const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_maxpool_circuit(std::size_t bit_size,
@@ -390,4 +392,132 @@ const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_gt_tensor_circuit(std:
   return load_tree_circuit(name, bit_size, num_inputs);
 }
 
+const ENCRYPTO::AlgorithmDescription& CircuitLoader::load_argmax_circuit(std::size_t bit_size,
+                                                                         std::size_t num_inputs,
+                                                                         bool depth_optimized) {
+  if (num_inputs < 2) {
+    throw std::logic_error("need at least two inputs to compare");
+  }
+  const auto name = fmt::format("__circuit_loader_builtin__argmax_{}_bit_{}_inputs_{}", bit_size,
+                                num_inputs, depth_optimized ? "depth" : "size");
+  auto it = algo_cache_.find(name);
+  if (it != std::end(algo_cache_)) {
+    return it->second;
+  }
+  const auto& gt_algo = load_gt_circuit(bit_size, depth_optimized);
+
+  // A candidate is the maximum of a range of inputs together with the mask
+  // which selects it among these inputs.  The mask of an input is std::nullopt
+  // as long as it is constant 1, i.e., it has not been compared yet.
+  struct Candidate {
+    std::vector<std::size_t> value;
+    std::vector<std::pair<std::size_t, std::optional<std::size_t>>> masks;
+  };
+  std::vector<Candidate> candidates(num_inputs);
+  for (std::size_t input_i = 0; input_i < num_inputs; ++input_i) {
+    auto& value = candidates[input_i].value;
+    value.resize(bit_size);
+    std::iota(std::begin(value), std::end(value), input_i * bit_size);
+    candidates[input_i].masks.emplace_back(input_i, std::nullopt);
+  }
+
+  std::vector<ENCRYPTO::PrimitiveOperation> gates;
+  std::size_t next_wire = num_inputs * bit_size;
+  const auto add_gate = [&gates, &next_wire](auto type, std::size_t parent_a,
+                                             std::optional<std::size_t> parent_b = std::nullopt) {
+    gates.push_back(ENCRYPTO::PrimitiveOperation{
+        .type_ = type, .parent_a_ = parent_a, .parent_b_ = parent_b, .output_wire_ = next_wire});
+    return next_wire++;
+  };
+  // c = Y > X, such that X is kept on ties
+  const auto add_gt = [&gates, &next_wire, &gt_algo, bit_size](const Candidate& x,
+                                                               const Candidate& y) {
+    const auto map_wire = [&](std::size_t w) {
+      if (w < bit_size) {
+        return y.value[w];
+      } else if (w < 2 * bit_size) {
+        return x.value[w - bit_size];
+      }
+      return next_wire + w - 2 * bit_size;
+    };
+    for (auto op : gt_algo.gates_) {
+      op.parent_a_ = map_wire(op.parent_a_);
+      if (op.parent_b_.has_value()) {
+        op.parent_b_ = map_wire(*op.parent_b_);
+      }
+      op.output_wire_ = map_wire(op.output_wire_);
+      gates.push_back(op);
+    }
+    next_wire += gt_algo.n_wires_ - 2 * bit_size;
+    return next_wire - 1;
+  };
+
+  using ENCRYPTO::PrimitiveOperationType;
+  // compare neighbouring candidates level by level, an unpaired last candidate
+  // moves up unchanged
+  while (candidates.size() > 2) {
+    std::vector<Candidate> next_candidates;
+    for (std::size_t cand_i = 0; cand_i + 1 < candidates.size(); cand_i += 2) {
+      auto& x = candidates[cand_i];
+      auto& y = candidates[cand_i + 1];
+      const auto choice = add_gt(x, y);
+      const auto not_choice = add_gate(PrimitiveOperationType::INV, choice);
+      auto& result = next_candidates.emplace_back();
+      // X ^ (X ^ Y) * c
+      for (std::size_t bit_j = 0; bit_j < bit_size; ++bit_j) {
+        const auto diff = add_gate(PrimitiveOperationType::XOR, x.value[bit_j], y.value[bit_j]);
+        const auto selected_diff = add_gate(PrimitiveOperationType::AND, diff, choice);
+        result.value.push_back(
+            add_gate(PrimitiveOperationType::XOR, x.value[bit_j], selected_diff));
+      }
+      const auto update_masks = [&](auto& masks, std::size_t selector) {
+        for (auto& [input_i, mask] : masks) {
+          result.masks.emplace_back(
+              input_i, mask.has_value() ? add_gate(PrimitiveOperationType::AND, *mask, selector)
+                                        : selector);
+        }
+      };
+      update_masks(x.masks, not_choice);
+      update_masks(y.masks, choice);
+    }
+    if (candidates.size() % 2 == 1) {
+      next_candidates.push_back(std::move(candidates.back()));
+    }
+    candidates = std::move(next_candidates);
+  }
+
+  // the final comparison only updates the masks, which are written to the
+  // output wires in the order of the inputs
+  const auto choice = add_gt(candidates[0], candidates[1]);
+  const auto not_choice = add_gate(PrimitiveOperationType::INV, choice);
+  std::vector<std::pair<std::size_t, ENCRYPTO::PrimitiveOperation>> output_gates;
+  for (std::size_t cand_i = 0; cand_i < 2; ++cand_i) {
+    const auto selector = cand_i == 0 ? not_choice : choice;
+    for (const auto& [input_i, mask] : candidates[cand_i].masks) {
+      // (passthrough of the selector is done by inverting the other one)
+      output_gates.emplace_back(
+          input_i, mask.has_value()
+                       ? ENCRYPTO::PrimitiveOperation{.type_ = PrimitiveOperationType::AND,
+                                                      .parent_a_ = *mask,
+                                                      .parent_b_ = selector}
+                       : ENCRYPTO::PrimitiveOperation{.type_ = PrimitiveOperationType::INV,
+                                                      .parent_a_ = cand_i == 0 ? choice
+                                                                               : not_choice});
+    }
+  }
+  assert(output_gates.size() == num_inputs);
+  for (auto& [input_i, op] : output_gates) {
+    op.output_wire_ = next_wire + input_i;
+    gates.push_back(op);
+  }
+  next_wire += num_inputs;
+
+  ENCRYPTO::AlgorithmDescription algo{.n_output_wires_ = num_inputs,
+                                      .n_input_wires_parent_a_ = bit_size * num_inputs,
+                                      .n_wires_ = next_wire,
+                                      .n_gates_ = gates.size(),
+                                      .gates_ = std::move(gates)};
+  return cache_circuit(name, std::move(algo));
+}
+
 }  // namespace MOTION
@@ -57,8 +57,17 @@ class CircuitLoader {
   const ENCRYPTO::AlgorithmDescription& load_gt_tensor_circuit(std::size_t bit_size,
                                                              std::size_t num_inputs,
                                                              bool depth_optimized = false);
+  // Tournament of gtmux circuits with depth log2(num_inputs) which outputs a
+  // one-hot encoding of the position of the maximum (the first one on ties).
+  const ENCRYPTO::AlgorithmDescription& load_argmax_circuit(std::size_t bit_size,
+                                                            std::size_t num_inputs,
+                                                            bool depth_optimized = false);
 
  private:
+  // computes the wire slots of the circuit and stores it in the cache
+  const ENCRYPTO::AlgorithmDescription& cache_circuit(const std::string& name,
+                                                     ENCRYPTO::AlgorithmDescription&& algo);
+
   std::vector<std::filesystem::path> circuit_search_path_;
   std::unordered_map<std::string, ENCRYPTO::AlgorithmDescription> algo_cache_;
 };
@@ -70,6 +70,38 @@ WireVector make_circuit(Builder& builder, const ENCRYPTO::AlgorithmDescription&
   return output_wires;
 }
 
+template <typename Builder>
+WireVector make_circuit(Builder& builder, const ENCRYPTO::AlgorithmDescription& algo,
+                        const WireVector& wires_in_a) {
+  if (algo.n_input_wires_parent_b_.has_value()) {
+    throw std::invalid_argument("AlgorithmDescription expects 2 input but only 1 is provided");
+  }
+  if (algo.n_input_wires_parent_a_ != wires_in_a.size()) {
+    throw std::invalid_argument(
+        fmt::format("AlgorithmDescription expects {} wires for input a, but {} are provided",
+                    algo.n_input_wires_parent_a_, wires_in_a.size()));
+  }
+  WireVector circuit_wires(algo.n_wires_);
+  // load the input wires into vector
+  std::copy(std::begin(wires_in_a), std::end(wires_in_a), std::begin(circuit_wires));
+  // create all the gates gate
+  for (const auto& prim_op : algo.gates_) {
+    auto op_type = prim_op.type_;
+    const auto& gate_input_wire_a = circuit_wires.at(prim_op.parent_a_);
+    WireVector gate_output_wires;
+    if (prim_op.parent_b_.has_value()) {
+      const auto& gate_input_wire_b = circuit_wires.at(*prim_op.parent_b_);
+      gate_output_wires =
+          builder.make_binary_gate(op_type, {gate_input_wire_a}, {gate_input_wire_b});
+    } else {
+      gate_output_wires = builder.make_unary_gate(op_type, {gate_input_wire_a});
+    }
+    circuit_wires.at(prim_op.output_wire_) = std::move(gate_output_wires.at(0));
+  }
+  WireVector output_wires(std::end(circuit_wires) - algo.n_output_wires_, std::end(circuit_wires));
+  return output_wires;
+}
+
 template <typename Builder>
 std::pair<std::vector<std::unique_ptr<NewGate>>, WireVector> construct_circuit(
     Builder& builder, const ENCRYPTO::AlgorithmDescription& algo, const WireVector& wires_in_a) {
@@ -352,6 +352,9 @@ void Backend::OTExtensionSetup() {
   }
 
   motion_base_provider_->setup();
+  ot_provider_manager_->set_extension_backend(
+      config_->GetUseSilentOT() ? ENCRYPTO::ObliviousTransfer::OTExtensionBackend::silent
+                                : ENCRYPTO::ObliviousTransfer::OTExtensionBackend::iknp);
   ot_provider_manager_->run_setup();
 }
 
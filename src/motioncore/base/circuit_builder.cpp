@@ -107,6 +107,11 @@ std::optional<MPCProtocol> CircuitBuilder::convert_via(MPCProtocol, MPCProtocol)
   return std::nullopt;
 }
 
+WireVector CircuitBuilder::make_circuit(const ENCRYPTO::AlgorithmDescription& algo,
+                                        const WireVector& wires_in_a) {
+  return ::MOTION::make_circuit(*this, algo, wires_in_a);
+}
+
 WireVector CircuitBuilder::make_circuit(const ENCRYPTO::AlgorithmDescription& algo,
                                         const WireVector& wires_in_a,
                                         const WireVector& wires_in_b) {
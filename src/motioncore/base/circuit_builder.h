@@ -44,6 +44,7 @@ class CircuitBuilder {
   WireVector make_unary_gate(ENCRYPTO::PrimitiveOperationType, const WireVector&);
   WireVector make_binary_gate(ENCRYPTO::PrimitiveOperationType, const WireVector&,
                               const WireVector&);
+  WireVector make_circuit(const ENCRYPTO::AlgorithmDescription&, const WireVector&);
   WireVector make_circuit(const ENCRYPTO::AlgorithmDescription&, const WireVector&,
                           const WireVector&);
   WireVector convert(MPCProtocol, const WireVector&);
@@ -47,6 +47,10 @@ class Configuration {
 
   void SetOnlineAfterSetup(bool value);
 
+  bool GetUseSilentOT() const noexcept { return use_silent_ot_; }
+
+  void SetUseSilentOT(bool value = true) { use_silent_ot_ = value; }
+
   void SetLoggingEnabled(bool value = true) { logging_enabled_ = value; }
 
   bool GetLoggingEnabled() const noexcept { return logging_enabled_; }
@@ -71,6 +75,10 @@ class Configuration {
   /// until proceeding to the online phase
   bool online_after_setup_ = false;
 
+  /// @param use_silent_ot_ if set true, OTs are extended with the silent OT extension instead of
+  /// IKNP, which sends much less for large numbers of OTs (must match the other parties)
+  bool use_silent_ot_ = false;
+
   // determines how many worker threads are used in openmp, but not in
   // communication handlers! the latter always use at least 2 threads for each
   // communication channel to send and receive data to prevent the communication
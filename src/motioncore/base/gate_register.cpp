@@ -59,4 +59,14 @@ void GateRegister::increment_gate_online_counter() noexcept {
   }
 }
 
+void GateRegister::clear() {
+  for (auto& gate : gates_) {
+    gate->clear();
+  }
+  num_evaluated_setup_ = 0;
+  num_evaluated_online_ = 0;
+  reset_setup_ready();
+  reset_online_ready();
+}
+
 }  // namespace MOTION
@@ -41,6 +41,8 @@ class GateRegister : public ENCRYPTO::enable_wait_setup, public ENCRYPTO::enable
   void register_gate(std::unique_ptr<NewGate>&& gate);
   void increment_gate_setup_counter() noexcept;
   void increment_gate_online_counter() noexcept;
+  // Prepare all gates for another evaluation, see NewGate::clear.
+  void clear();
 
   std::size_t get_num_gates() const noexcept { return next_gate_id_; }
   std::size_t get_num_gates_with_setup() const noexcept { return num_gates_with_setup_; }
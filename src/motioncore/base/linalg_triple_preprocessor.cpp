@@ -0,0 +1,288 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "linalg_triple_preprocessor.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <stdexcept>
+
+#include <fmt/format.h>
+
+#include "communication/communication_layer.h"
+#include "communication/message.h"
+#include "communication/message_handler.h"
+#include "crypto/arithmetic_provider.h"
+#include "crypto/base_ots/base_ot_provider.h"
+#include "crypto/motion_base_provider.h"
+#include "crypto/multiplication_triple/linalg_triple_pool.h"
+#include "crypto/multiplication_triple/linalg_triple_provider.h"
+#include "crypto/oblivious_transfer/ot_provider.h"
+#include "statistics/run_time_stats.h"
+#include "utility/logger.h"
+#include "utility/synchronized_queue.h"
+
+namespace MOTION {
+
+// Receives the round proposals of the other party and wakes up the
+// preprocessor waiting for room in the pool.
+class LinAlgTriplePreprocessor::RoundHandler : public Communication::MessageHandler {
+ public:
+  RoundHandler(LinAlgTriplePool& pool) : pool_(pool) {}
+
+  void received_message(std::size_t, std::vector<std::uint8_t>&& raw_message) override {
+    const auto message = Communication::GetMessage(raw_message.data());
+    const auto* payload = message->payload();
+    proposals_.enqueue(std::vector<std::uint8_t>(payload->begin(), payload->end()));
+    pool_.wake_producer();
+  }
+
+  bool has_proposal() const noexcept { return !proposals_.empty(); }
+
+  std::optional<std::vector<std::uint8_t>> receive_proposal() { return proposals_.dequeue(); }
+
+ private:
+  LinAlgTriplePool& pool_;
+  ENCRYPTO::SynchronizedQueue<std::vector<std::uint8_t>> proposals_;
+};
+
+LinAlgTriplePreprocessor::LinAlgTriplePreprocessor(Communication::CommunicationLayer& comm_layer,
+                                                   std::shared_ptr<LinAlgTriplePool> pool,
+                                                   std::size_t batch_size,
+                                                   std::shared_ptr<Logger> logger)
+    : comm_layer_(comm_layer), pool_(std::move(pool)), batch_size_(batch_size), logger_(logger) {
+  if (batch_size_ == 0 || batch_size_ > pool_->get_capacity()) {
+    throw std::invalid_argument(
+        fmt::format("LinAlgTriplePreprocessor: batch size {} does not fit into pool of capacity {}",
+                    batch_size_, pool_->get_capacity()));
+  }
+}
+
+LinAlgTriplePreprocessor::~LinAlgTriplePreprocessor() { stop(); }
+
+template <typename T>
+void LinAlgTriplePreprocessor::register_gemm(const tensor::GemmOp& gemm_op) {
+  if (thread_.joinable()) {
+    throw std::logic_error("LinAlgTriplePreprocessor: cannot register shapes after start");
+  }
+  shapes_.push_back(
+      {[this, gemm_op](auto& provider) {
+         for (std::size_t i = 0; i < batch_size_; ++i) {
+           provider.template register_for_gemm_triple<T>(gemm_op);
+         }
+       },
+       [this, gemm_op](auto& provider) {
+         for (std::size_t i = 0; i < batch_size_; ++i) {
+           pool_->put_gemm_triple<T>(gemm_op, provider.template get_gemm_triple<T>(gemm_op, i));
+         }
+       },
+       [this, gemm_op] { return pool_->get_free_gemm<T>(gemm_op); }});
+}
+
+template <typename T>
+void LinAlgTriplePreprocessor::register_conv2d(const tensor::Conv2DOp& conv_op) {
+  if (thread_.joinable()) {
+    throw std::logic_error("LinAlgTriplePreprocessor: cannot register shapes after start");
+  }
+  shapes_.push_back(
+      {[this, conv_op](auto& provider) {
+         for (std::size_t i = 0; i < batch_size_; ++i) {
+           provider.template register_for_conv2d_triple<T>(conv_op);
+         }
+       },
+       [this, conv_op](auto& provider) {
+         for (std::size_t i = 0; i < batch_size_; ++i) {
+           pool_->put_conv2d_triple<T>(conv_op,
+                                       provider.template get_conv2d_triple<T>(conv_op, i));
+         }
+       },
+       [this, conv_op] { return pool_->get_free_conv2d<T>(conv_op); }});
+}
+
+template void LinAlgTriplePreprocessor::register_gemm<std::uint8_t>(const tensor::GemmOp&);
+template void LinAlgTriplePreprocessor::register_gemm<std::uint16_t>(const tensor::GemmOp&);
+template void LinAlgTriplePreprocessor::register_gemm<std::uint32_t>(const tensor::GemmOp&);
+template void LinAlgTriplePreprocessor::register_gemm<std::uint64_t>(const tensor::GemmOp&);
+template void LinAlgTriplePreprocessor::register_gemm<__uint128_t>(const tensor::GemmOp&);
+template void LinAlgTriplePreprocessor::register_conv2d<std::uint8_t>(const tensor::Conv2DOp&);
+template void LinAlgTriplePreprocessor::register_conv2d<std::uint16_t>(const tensor::Conv2DOp&);
+template void LinAlgTriplePreprocessor::register_conv2d<std::uint32_t>(const tensor::Conv2DOp&);
+template void LinAlgTriplePreprocessor::register_conv2d<std::uint64_t>(const tensor::Conv2DOp&);
+template void LinAlgTriplePreprocessor::register_conv2d<__uint128_t>(const tensor::Conv2DOp&);
+
+void LinAlgTriplePreprocessor::register_relu(std::size_t num_triples, std::size_t bit_size) {
+  if (thread_.joinable()) {
+    throw std::logic_error("LinAlgTriplePreprocessor: cannot register shapes after start");
+  }
+  shapes_.push_back({[this, num_triples, bit_size](auto& provider) {
+                       for (std::size_t i = 0; i < batch_size_; ++i) {
+                         provider.register_for_relu_triple(num_triples, bit_size);
+                       }
+                     },
+                     [this, num_triples, bit_size](auto& provider) {
+                       for (std::size_t i = 0; i < batch_size_; ++i) {
+                         pool_->put_relu_triple(num_triples, bit_size,
+                                                provider.get_relu_triple(num_triples, bit_size, i));
+                       }
+                     },
+                     [this, num_triples, bit_size] {
+                       return pool_->get_free_relu(num_triples, bit_size);
+                     }});
+}
+
+void LinAlgTriplePreprocessor::start() {
+  if (thread_.joinable()) {
+    return;
+  }
+  stopped_ = false;
+  round_handler_ = std::make_shared<RoundHandler>(*pool_);
+  comm_layer_.register_message_handler([this](auto) { return round_handler_; },
+                                       {Communication::MessageType::LinAlgTripleRound});
+  comm_layer_.start();
+  thread_ = std::thread([this] { run(); });
+}
+
+void LinAlgTriplePreprocessor::stop() {
+  stopped_ = true;
+  pool_->close();
+  if (thread_.joinable()) {
+    thread_.join();
+  }
+  if (round_handler_) {
+    comm_layer_.deregister_message_handler({Communication::MessageType::LinAlgTripleRound});
+    round_handler_ = nullptr;
+  }
+}
+
+bool LinAlgTriplePreprocessor::has_room() const {
+  return std::any_of(std::begin(shapes_), std::end(shapes_),
+                     [this](const auto& shape) { return shape.get_free_() >= batch_size_; });
+}
+
+void LinAlgTriplePreprocessor::run() {
+  const auto other_id = 1 - comm_layer_.get_my_id();
+  // number of taken triples when the last proposal did not lead to a round
+  std::optional<std::size_t> num_taken_idle;
+  try {
+    // the other party needs to have installed its round handler
+    comm_layer_.sync();
+    while (true) {
+      // Propose a round once a shape has room for a batch and triples have
+      // been taken since the last idle proposal.  Answer proposals of the
+      // other party and stop requests right away.
+      while (true) {
+        const auto num_events = pool_->get_num_events();
+        if (stopped_ || round_handler_->has_proposal() ||
+            (pool_->get_num_taken() != num_taken_idle && has_room())) {
+          break;
+        }
+        pool_->wait_for_event(num_events);
+      }
+
+      const auto num_taken = pool_->get_num_taken();
+      // whether we continue, followed by whether each shape has room
+      std::vector<std::uint8_t> proposal(1 + shapes_.size());
+      proposal[0] = !stopped_;
+      for (std::size_t shape_i = 0; shape_i < shapes_.size(); ++shape_i) {
+        proposal[1 + shape_i] = shapes_[shape_i].get_free_() >= batch_size_;
+      }
+      comm_layer_.send_message(other_id, Communication::BuildMessage(
+                                             Communication::MessageType::LinAlgTripleRound,
+                                             &proposal));
+      const auto other_proposal = round_handler_->receive_proposal();
+      if (!other_proposal.has_value() || other_proposal->size() != proposal.size()) {
+        throw std::runtime_error("received an invalid round proposal");
+      }
+      if (!proposal[0] || !(*other_proposal)[0]) {
+        break;
+      }
+
+      std::vector<bool> selected_shapes(shapes_.size());
+      for (std::size_t shape_i = 0; shape_i < shapes_.size(); ++shape_i) {
+        selected_shapes[shape_i] = proposal[1 + shape_i] && (*other_proposal)[1 + shape_i];
+      }
+      if (std::none_of(std::begin(selected_shapes), std::end(selected_shapes),
+                       [](bool selected) { return selected; })) {
+        num_taken_idle = num_taken;
+        continue;
+      }
+      num_taken_idle = std::nullopt;
+      run_round(selected_shapes);
+    }
+  } catch (std::exception& e) {
+    if (logger_) {
+      logger_->LogError(fmt::format("LinAlgTriplePreprocessor: {}", e.what()));
+    }
+  }
+  // no more triples are generated, do not let the consumers wait for them
+  pool_->close();
+}
+
+void LinAlgTriplePreprocessor::run_round() {
+  run_round(std::vector<bool>(shapes_.size(), true));
+}
+
+void LinAlgTriplePreprocessor::run_round(const std::vector<bool>& selected_shapes) {
+  if constexpr (MOTION_DEBUG) {
+    if (logger_) {
+      logger_->LogDebug("LinAlgTriplePreprocessor::run_round start");
+    }
+  }
+  const auto my_id = comm_layer_.get_my_id();
+  Statistics::RunTimeStats stats;
+  Crypto::MotionBaseProvider motion_base_provider(comm_layer_, logger_);
+  BaseOTProvider base_ot_provider(comm_layer_, &stats, logger_);
+  ENCRYPTO::ObliviousTransfer::OTProviderManager ot_manager(
+      comm_layer_, base_ot_provider, motion_base_provider, &stats, logger_);
+  ArithmeticProviderManager arithmetic_manager(comm_layer_, ot_manager, logger_);
+  LinAlgTriplesFromAP linalg_triple_provider(arithmetic_manager.get_provider(1 - my_id),
+                                             ot_manager.get_provider(1 - my_id), stats, logger_);
+  for (std::size_t shape_i = 0; shape_i < shapes_.size(); ++shape_i) {
+    if (selected_shapes[shape_i]) {
+      shapes_[shape_i].register_batch_(linalg_triple_provider);
+    }
+  }
+  comm_layer_.start();
+  // the message handlers of both parties need to be installed
+  comm_layer_.sync();
+
+  motion_base_provider.setup();
+  base_ot_provider.ComputeBaseOTs();
+  ot_manager.run_setup();
+  linalg_triple_provider.setup();
+
+  for (std::size_t shape_i = 0; shape_i < shapes_.size(); ++shape_i) {
+    if (selected_shapes[shape_i]) {
+      shapes_[shape_i].collect_batch_(linalg_triple_provider);
+    }
+  }
+  // the providers deregister their handlers when they are destroyed
+  comm_layer_.sync();
+  if constexpr (MOTION_DEBUG) {
+    if (logger_) {
+      logger_->LogDebug("LinAlgTriplePreprocessor::run_round end");
+    }
+  }
+}
+
+}  // namespace MOTION
@@ -0,0 +1,100 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "tensor/tensor_op.h"
+
+namespace MOTION {
+
+namespace Communication {
+class CommunicationLayer;
+}
+
+class LinAlgTripleProvider;
+class LinAlgTriplePool;
+class Logger;
+
+// Background service which pregenerates the linear algebra and ReLU triples
+// of a set of registered shapes into a LinAlgTriplePool.  An online run then
+// only needs to take the triples from the pool (cf. PooledLinAlgTripleProvider)
+// instead of running the OT-based triple generation itself.
+//
+// Rounds run on a dedicated CommunicationLayer.  Before each round, the
+// parties exchange whether they continue and which shapes have room for
+// another batch_size triples in their pool.  The round then generates a batch
+// of each shape which has room at both parties.  A party proposes a round once
+// one of its shapes has room and answers the proposals of the other party.
+// Both parties need to register the same shapes in the same order, and need to
+// consume the same triples.
+class LinAlgTriplePreprocessor {
+ public:
+  LinAlgTriplePreprocessor(Communication::CommunicationLayer&, std::shared_ptr<LinAlgTriplePool>,
+                           std::size_t batch_size, std::shared_ptr<Logger>);
+  ~LinAlgTriplePreprocessor();
+
+  template <typename T>
+  void register_gemm(const tensor::GemmOp&);
+  template <typename T>
+  void register_conv2d(const tensor::Conv2DOp&);
+  void register_relu(std::size_t num_triples, std::size_t bit_size);
+
+  // Start the background thread.
+  void start();
+  // Close the pool and join the background thread.  The thread ends after it
+  // has told the other party, whose preprocessor then stops and closes its
+  // pool as well, so both parties can stop while triples are still consumed.
+  void stop();
+
+  // Generate one batch of triples of every shape synchronously.
+  void run_round();
+
+ private:
+  struct Shape {
+    std::function<void(LinAlgTripleProvider&)> register_batch_;
+    std::function<void(LinAlgTripleProvider&)> collect_batch_;
+    std::function<std::size_t()> get_free_;
+  };
+  class RoundHandler;
+
+  bool has_room() const;
+  void run();
+  // Generate one batch of triples of the selected shapes.
+  void run_round(const std::vector<bool>& selected_shapes);
+
+  Communication::CommunicationLayer& comm_layer_;
+  std::shared_ptr<LinAlgTriplePool> pool_;
+  const std::size_t batch_size_;
+  std::shared_ptr<Logger> logger_;
+  std::vector<Shape> shapes_;
+  std::shared_ptr<RoundHandler> round_handler_;
+  std::atomic<bool> stopped_ = false;
+  std::thread thread_;
+};
+
+}  // namespace MOTION
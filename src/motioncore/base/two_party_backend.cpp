@@ -126,6 +126,14 @@ void TwoPartyBackend::run_wo_broadcast() {
 
 }
 
+void TwoPartyBackend::set_boolean_output_share_directory(const std::string& directory) {
+  beavy_provider_->set_boolean_output_share_directory(directory);
+}
+
+std::string TwoPartyBackend::get_boolean_output_share_directory() const {
+  return beavy_provider_->get_boolean_output_share_directory();
+}
+
 std::optional<MPCProtocol> TwoPartyBackend::convert_via(MPCProtocol src_proto,
                                                         MPCProtocol dst_proto) {
   if (src_proto == MPCProtocol::ArithmeticGMW && dst_proto == MPCProtocol::BooleanGMW) {
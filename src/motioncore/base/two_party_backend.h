@@ -23,6 +23,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 
 #include "circuit_builder.h"
@@ -85,6 +86,11 @@ class TwoPartyBackend : public CircuitBuilder {
 
   const Statistics::RunTimeStats& get_run_time_stats() const noexcept;
 
+  // Directory of the boolean output gates' share files, see
+  // BEAVYProvider::set_boolean_output_share_directory.
+  void set_boolean_output_share_directory(const std::string& directory);
+  std::string get_boolean_output_share_directory() const;
+
  private:
   Communication::CommunicationLayer& comm_layer_;
   std::size_t my_id_;
@@ -49,10 +49,10 @@
 
 namespace MOTION {
 
-TwoPartyTensorBackend::TwoPartyTensorBackend(Communication::CommunicationLayer& comm_layer,
-                                             std::size_t num_threads,
-                                             bool sync_between_setup_and_online,
-                                             std::shared_ptr<Logger> logger, bool fake_triples)
+TwoPartyTensorBackend::TwoPartyTensorBackend(
+    Communication::CommunicationLayer& comm_layer, std::size_t num_threads,
+    bool sync_between_setup_and_online, std::shared_ptr<Logger> logger, bool fake_triples,
+    std::shared_ptr<LinAlgTripleProvider> linalg_triple_provider)
     : comm_layer_(comm_layer),
       my_id_(comm_layer_.get_my_id()),
       logger_(logger),
@@ -70,13 +70,15 @@ TwoPartyTensorBackend::TwoPartyTensorBackend(Communication::CommunicationLayer&
           logger_)),
       arithmetic_manager_(
           std::make_unique<ArithmeticProviderManager>(comm_layer_, *ot_manager_, logger_)),
-      linalg_triple_provider_(fake_triples ? (std::dynamic_pointer_cast<LinAlgTripleProvider>(
-                                                 std::make_shared<FakeLinAlgTripleProvider>()))
-                                           : (std::dynamic_pointer_cast<LinAlgTripleProvider>(
-                                                 std::make_shared<LinAlgTriplesFromAP>(
-                                                     arithmetic_manager_->get_provider(1 - my_id_),
-                                                     ot_manager_->get_provider(1 - my_id_),
-                                                     run_time_stats_.back(), logger_)))),
+      linalg_triple_provider_(
+          linalg_triple_provider ? linalg_triple_provider
+          : fake_triples
+              ? (std::dynamic_pointer_cast<LinAlgTripleProvider>(
+                    std::make_shared<FakeLinAlgTripleProvider>()))
+              : (std::dynamic_pointer_cast<LinAlgTripleProvider>(
+                    std::make_shared<LinAlgTriplesFromAP>(
+                        arithmetic_manager_->get_provider(1 - my_id_),
+                        ot_manager_->get_provider(1 - my_id_), run_time_stats_.back(), logger_)))),
       mt_provider_(std::make_unique<MTProviderFromOTs>(my_id_, comm_layer_.get_num_parties(), true,
                                                        *arithmetic_manager_, *ot_manager_,
                                                        run_time_stats_.back(), logger_)),
@@ -107,6 +109,15 @@ TwoPartyTensorBackend::~TwoPartyTensorBackend() = default;
 void TwoPartyTensorBackend::run_preprocessing() {
   run_time_stats_.back().record_start<Statistics::RunTimeStats::StatID::preprocessing>();
 
+  if (preprocessing_ran_) {
+    // after clear() only the OT extension needs to be run again, the base
+    // OTs and the providers' setup are reused
+    ot_manager_->run_setup();
+    run_time_stats_.back().record_end<Statistics::RunTimeStats::StatID::preprocessing>();
+    return;
+  }
+  preprocessing_ran_ = true;
+
   motion_base_provider_->setup();
   base_ot_provider_->ComputeBaseOTs();
   mt_provider_->PreSetup();
@@ -128,6 +139,26 @@ void TwoPartyTensorBackend::run() {
   gate_executor_->evaluate_setup_online(run_time_stats_.back());
 }
 
+void TwoPartyTensorBackend::run_asap() { gate_executor_->evaluate(run_time_stats_.back()); }
+
+void TwoPartyTensorBackend::clear() {
+  if (gate_executor_->get_release_dead_tensors()) {
+    throw std::logic_error(
+        "TwoPartyTensorBackend::clear: tensor buffers have been released during the evaluation");
+  }
+  // the other party needs to be done with the previous evaluation ...
+  comm_layer_.sync();
+  gate_register_->clear();
+  ot_manager_->clear();
+  motion_base_provider_->advance_epoch();
+  // ... and must not receive messages of the next one before it has cleared
+  comm_layer_.sync();
+}
+
+void TwoPartyTensorBackend::set_release_dead_tensors(bool enable) noexcept {
+  gate_executor_->set_release_dead_tensors(enable);
+}
+
 tensor::TensorOpFactory& TwoPartyTensorBackend::get_tensor_op_factory(MPCProtocol proto) {
   try {
     return tensor_op_factories_.at(proto);
@@ -153,4 +184,40 @@ const Statistics::RunTimeStats& TwoPartyTensorBackend::get_run_time_stats() cons
   return run_time_stats_.back();
 }
 
+void TwoPartyTensorBackend::set_ot_extension_window_size(std::size_t num_ots) {
+  ot_manager_->set_window_size(num_ots);
+}
+
+void TwoPartyTensorBackend::set_silent_ot_extension(bool enable) {
+  ot_manager_->set_extension_backend(enable
+                                         ? ENCRYPTO::ObliviousTransfer::OTExtensionBackend::silent
+                                         : ENCRYPTO::ObliviousTransfer::OTExtensionBackend::iknp);
+}
+
+void TwoPartyTensorBackend::set_output_share_directory(const std::string& directory,
+                                                       std::size_t fractional_bits) {
+  beavy_provider_->set_output_share_directory(directory, fractional_bits);
+}
+
+void TwoPartyTensorBackend::set_message_compression(bool enable) noexcept {
+  beavy_provider_->set_message_compression(enable);
+  gmw_provider_->set_message_compression(enable);
+  yao_provider_->set_message_compression(enable);
+}
+
+proto::MessageEncodingStatistics TwoPartyTensorBackend::get_message_encoding_statistics()
+    const noexcept {
+  proto::MessageEncodingStatistics stats;
+  for (const proto::CommMixin* provider :
+       {static_cast<const proto::CommMixin*>(beavy_provider_.get()),
+        static_cast<const proto::CommMixin*>(gmw_provider_.get()),
+        static_cast<const proto::CommMixin*>(yao_provider_.get())}) {
+    const auto provider_stats = provider->get_message_encoding_statistics();
+    stats.num_messages_ += provider_stats.num_messages_;
+    stats.num_raw_bytes_ += provider_stats.num_raw_bytes_;
+    stats.num_encoded_bytes_ += provider_stats.num_encoded_bytes_;
+  }
+  return stats;
+}
+
 }  // namespace MOTION
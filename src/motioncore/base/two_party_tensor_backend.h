@@ -23,6 +23,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
@@ -55,6 +56,7 @@ class MotionBaseProvider;
 }
 
 namespace proto {
+struct MessageEncodingStatistics;
 namespace beavy {
 class BEAVYProvider;
 }
@@ -78,17 +80,48 @@ class TwoPartyTensorBackend : public tensor::NetworkBuilder {
  public:
   TwoPartyTensorBackend(Communication::CommunicationLayer&, std::size_t num_threads,
                         bool sync_between_setup_and_online, std::shared_ptr<Logger>,
-                        bool fake_triples = false);
+                        bool fake_triples = false,
+                        // e.g. a PooledLinAlgTripleProvider; replaces the default provider
+                        std::shared_ptr<LinAlgTripleProvider> linalg_triple_provider = nullptr);
   virtual ~TwoPartyTensorBackend();
 
   virtual void run_preprocessing();
   void run();
+  // Interleave setup and online phases following the data dependencies.
+  void run_asap();
+  // Prepare the constructed gates for another evaluation: new inputs can be
+  // supplied via the same promises, and the next run computes fresh
+  // preprocessing material without rebuilding the network.  Throws if the
+  // network contains gates that cannot be evaluated again.
+  void clear();
 
   tensor::TensorOpFactory& get_tensor_op_factory(MPCProtocol) override;
   std::optional<MPCProtocol> convert_via(MPCProtocol src_proto, MPCProtocol dst_proto) override;
 
   const Statistics::RunTimeStats& get_run_time_stats() const noexcept;
 
+  // Free tensor buffers once no gate reads them anymore, see TensorOpExecutor.
+  // The network can then not be cleared and evaluated again.
+  void set_release_dead_tensors(bool enable) noexcept;
+
+  // Expand and transpose the OT extension matrix in windows of num_ots OTs,
+  // 0 extends all OTs at once.  This bounds the scratch space of the matrix
+  // and the receiver's masks in flight, the outputs of all OTs are still kept.
+  // Must match the other party.
+  void set_ot_extension_window_size(std::size_t num_ots);
+
+  // Extend OTs with the silent OT extension instead of IKNP, which sends much
+  // less in the preprocessing.  Must match the other party.
+  void set_silent_ot_extension(bool enable);
+
+  // Store the shares reaching the arithmetic BEAVY output gates in share files
+  // below directory, see BEAVYProvider::set_output_share_directory.
+  void set_output_share_directory(const std::string& directory, std::size_t fractional_bits);
+
+  // Compress the ints messages of all protocols, see CommMixin.
+  void set_message_compression(bool enable) noexcept;
+  proto::MessageEncodingStatistics get_message_encoding_statistics() const noexcept;
+
  protected:
   Communication::CommunicationLayer& comm_layer_;
   std::size_t my_id_;
@@ -99,6 +132,7 @@ class TwoPartyTensorBackend : public tensor::NetworkBuilder {
   std::unordered_map<MPCProtocol, std::reference_wrapper<tensor::TensorOpFactory>>
       tensor_op_factories_;
   std::vector<Statistics::RunTimeStats> run_time_stats_;
+  bool preprocessing_ran_ = false;
 
   std::unique_ptr<Crypto::MotionBaseProvider> motion_base_provider_;
   std::unique_ptr<BaseOTProvider> base_ot_provider_;
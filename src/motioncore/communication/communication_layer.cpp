@@ -22,7 +22,10 @@
 
 #include "communication_layer.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
+#include <iterator>
 #include <functional>
 #include <shared_mutex>
 #include <stdexcept>
@@ -30,12 +33,16 @@
 #include <unordered_map>
 #include <variant>
 
+#include <unistd.h>
+
 #include <flatbuffers/flatbuffers.h>
 #include <fmt/format.h>
 
 #include "dummy_transport.h"
 #include "message.h"
 #include "message_handler.h"
+#include "receive_buffer_pool.h"
+#include "shm_transport.h"
 #include "sync_handler.h"
 #include "tcp_transport.h"
 #include "utility/constants.h"
@@ -65,13 +72,19 @@ struct CommunicationLayer::CommunicationLayerImpl {
   std::atomic<bool> continue_communication_ = true;
 
   std::vector<std::unique_ptr<Transport>> transports_;
+  // shared by the receive threads
+  std::shared_ptr<ReceiveBufferPool> receive_buffer_pool_;
 
   // message type
   using message_t =
       std::variant<std::vector<std::uint8_t>, std::shared_ptr<const std::vector<std::uint8_t>>,
                    flatbuffers::DetachedBuffer>;
 
+  // write all given messages to the transport and clear the vector
+  void flush(std::size_t party_id, std::vector<message_t>& messages);
+
   std::vector<ENCRYPTO::SynchronizedFiberQueue<message_t>> send_queues_;
+  SendPolicy send_policy_;
   std::vector<std::thread> receive_threads_;
   std::vector<std::thread> send_threads_;
 
@@ -92,6 +105,7 @@ CommunicationLayer::CommunicationLayerImpl::CommunicationLayerImpl(
       num_parties_(transports.size()),
       start_sfuture_(start_promise_.get_future().share()),
       transports_(std::move(transports)),
+      receive_buffer_pool_(std::make_shared<ReceiveBufferPool>()),
       send_queues_(num_parties_),
       message_handlers_(num_parties_),
       fallback_message_handlers_(num_parties_),
@@ -110,7 +124,62 @@ CommunicationLayer::CommunicationLayerImpl::CommunicationLayerImpl(
                               fmt::format("recv-{}<->{}", my_id_, party_id));
     ENCRYPTO::thread_set_name(send_threads_.at(party_id),
                               fmt::format("send-{}<->{}", my_id_, party_id));
+    const auto& transport = *transports_.at(party_id);
+    if (const auto cpu = transport.get_receive_cpu(); cpu >= 0) {
+      ENCRYPTO::thread_set_affinity(receive_threads_.at(party_id), cpu);
+    }
+    if (const auto cpu = transport.get_send_cpu(); cpu >= 0) {
+      ENCRYPTO::thread_set_affinity(send_threads_.at(party_id), cpu);
+    }
+  }
+}
+
+namespace {
+
+template <typename Message>
+MessageView get_message_view(const Message& message) {
+  if (message.index() == 0) {
+    // std::vector<std::uint8_t>
+    return {std::get<0>(message).data(), std::get<0>(message).size()};
+  } else if (message.index() == 1) {
+    // std::shared_ptr<const std::vector<std::uint8_t>>
+    return {std::get<1>(message)->data(), std::get<1>(message)->size()};
+  } else {
+    // flatbuffers::DetachedBuffer
+    return {std::get<2>(message).data(), std::get<2>(message).size()};
+  }
+}
+
+}  // namespace
+
+void CommunicationLayer::CommunicationLayerImpl::flush(std::size_t party_id,
+                                                       std::vector<message_t>& messages) {
+  auto& transport = *transports_.at(party_id);
+  std::vector<MessageView> message_views;
+  message_views.reserve(messages.size());
+  std::transform(std::begin(messages), std::end(messages), std::back_inserter(message_views),
+                 [](const auto& message) { return get_message_view(message); });
+  transport.send_messages(message_views);
+
+  if (logger_) {
+    if constexpr (MOTION_DEBUG) {
+      for (const auto& [raw_message, message_size] : message_views) {
+        flatbuffers::Verifier verifier(raw_message, message_size);
+        if (VerifyMessageBuffer(verifier)) {
+          auto fb_message = GetMessage(raw_message);
+          auto message_type = fb_message->message_type();
+          logger_->LogDebug(fmt::format("Sent message of type {} to party {}",
+                                        EnumNameMessageType(message_type), party_id));
+        } else {
+          logger_->LogDebug(
+              fmt::format("Sent message to party {} (could not detect MessageType)", party_id));
+        }
+      }
+    } else {
+      logger_->LogDebug(fmt::format("Sent {} messages to party {}", messages.size(), party_id));
+    }
   }
+  messages.clear();
 }
 
 void CommunicationLayer::CommunicationLayerImpl::send_task(std::size_t party_id) {
@@ -120,55 +189,33 @@ void CommunicationLayer::CommunicationLayerImpl::send_task(std::size_t party_id)
   auto my_start_sfuture = start_sfuture_;
   my_start_sfuture.get();
 
-  while (!queue.closed_and_empty()) {
-    auto tmp_queue = queue.batch_dequeue();
-    if (!tmp_queue.has_value()) {
-      assert(queue.closed());
-      break;
-    }
-    while (!tmp_queue->empty()) {
-      auto& message = tmp_queue->front();
-      if (message.index() == 0) {
-        // std::vector<std::uint8_t>
-        transport.send_message(std::get<0>(message));
-      } else if (message.index() == 1) {
-        // std::shared_ptr<const std::vector<std::uint8_t>>
-        transport.send_message(*std::get<1>(message));
-      } else if (message.index() == 2) {
-        // flatbuffers::DetachedBuffer
-        const auto& detached_buffer = std::get<2>(message);
-        transport.send_message(detached_buffer.data(), detached_buffer.size());
+  // messages are collected until the queue runs dry for flush_timeout_ or
+  // max_flush_size_ bytes are pending, and then written at once
+  std::vector<message_t> pending_messages;
+  std::size_t pending_bytes = 0;
+  while (true) {
+    auto tmp_queue = pending_messages.empty()
+                         ? queue.batch_dequeue()
+                         : queue.batch_dequeue_for(send_policy_.flush_timeout_);
+    if (tmp_queue.has_value()) {
+      while (!tmp_queue->empty()) {
+        pending_bytes += get_message_view(tmp_queue->front()).second;
+        pending_messages.emplace_back(std::move(tmp_queue->front()));
+        tmp_queue->pop();
       }
-      if (logger_) {
-        if constexpr (MOTION_DEBUG) {
-          const std::uint8_t* raw_message = nullptr;
-          std::size_t message_size = 0;
-          if (message.index() == 0) {
-            // std::vector<std::uint8_t>
-            raw_message = std::get<0>(message).data();
-            message_size = std::get<0>(message).size();
-          } else if (message.index() == 1) {
-            raw_message = std::get<1>(message)->data();
-            message_size = std::get<1>(message)->size();
-          } else if (message.index() == 2) {
-            raw_message = std::get<2>(message).data();
-            message_size = std::get<2>(message).size();
-          }
-          flatbuffers::Verifier verifier(raw_message, message_size);
-          if (VerifyMessageBuffer(verifier)) {
-            auto fb_message = GetMessage(raw_message);
-            auto message_type = fb_message->message_type();
-            logger_->LogDebug(fmt::format("Sent message of type {} to party {}",
-                                          EnumNameMessageType(message_type), party_id));
-          } else {
-            logger_->LogDebug(
-                fmt::format("Sent message to party {} (could not detect MessageType)", party_id));
-          }
-        } else {
-          logger_->LogDebug(fmt::format("Sent message to party {}", party_id));
-        }
+      if (pending_bytes >= send_policy_.max_flush_size_) {
+        flush(party_id, pending_messages);
+        pending_bytes = 0;
       }
-      tmp_queue->pop();
+      continue;
+    }
+    // no new messages
+    if (!pending_messages.empty()) {
+      flush(party_id, pending_messages);
+      pending_bytes = 0;
+    }
+    if (queue.closed_and_empty()) {
+      break;
     }
   }
 
@@ -187,9 +234,9 @@ void CommunicationLayer::CommunicationLayerImpl::receive_task(std::size_t party_
   my_start_sfuture.get();
 
   while (continue_communication_) {
-    std::optional<std::vector<std::uint8_t>> raw_message_opt;
+    std::optional<ReceiveBuffer> raw_message_opt;
     try {
-      raw_message_opt = transport.receive_message();
+      raw_message_opt = transport.receive_pooled_message(receive_buffer_pool_);
     } catch (std::runtime_error& e) {
       if (logger_) {
         logger_->LogError(
@@ -207,15 +254,14 @@ void CommunicationLayer::CommunicationLayerImpl::receive_task(std::size_t party_
     }
     auto raw_message = std::move(*raw_message_opt);
 
-    flatbuffers::Verifier verifier(reinterpret_cast<std::uint8_t*>(raw_message.data()),
-                                   raw_message.size());
+    flatbuffers::Verifier verifier(raw_message.data(), raw_message.size());
     if (!VerifyMessageBuffer(verifier)) {
       if (logger_) {
         logger_->LogError(fmt::format("received corrupt message from party {}", party_id));
       }
       auto fbh = fallback_message_handlers_.at(party_id);
       if (fbh) {
-        fbh->received_message(party_id, std::move(raw_message));
+        fbh->received_message(party_id, raw_message.release());
       }
       continue;
     }
@@ -241,11 +287,11 @@ void CommunicationLayer::CommunicationLayerImpl::receive_task(std::size_t party_
     std::shared_lock lock(message_handlers_mutex_);
     auto it = handler_map.find(message_type);
     if (it != handler_map.end()) {
-      it->second->received_message(party_id, std::move(raw_message));
+      it->second->received_pooled_message(party_id, std::move(raw_message));
     } else {
       auto fbh = fallback_message_handlers_.at(party_id);
       if (fbh) {
-        fbh->received_message(party_id, std::move(raw_message));
+        fbh->received_message(party_id, raw_message.release());
       }
       if (logger_) {
         logger_->LogError(fmt::format("dropping message of type {} from party {}",
@@ -529,6 +575,14 @@ void CommunicationLayer::reset_transport_statistics() noexcept {
   }
 }
 
+void CommunicationLayer::set_send_policy(const SendPolicy& send_policy) {
+  if (is_started_) {
+    throw std::logic_error(
+        "changing the send policy is not allowed after the CommunicationLayer has been started");
+  }
+  impl_->send_policy_ = send_policy;
+}
+
 void CommunicationLayer::set_logger(std::shared_ptr<Logger> logger) {
   if (is_started_) {
     throw std::logic_error(
@@ -584,4 +638,24 @@ std::vector<std::unique_ptr<CommunicationLayer>> make_local_tcp_communication_la
   return comm_layers;
 }
 
+std::vector<std::unique_ptr<CommunicationLayer>> make_local_shm_communication_layers(
+    std::size_t num_parties) {
+  static std::atomic<std::size_t> counter = 0;
+  const auto name = fmt::format("motion-{}-{}", getpid(), counter++);
+  std::vector<std::future<std::vector<std::unique_ptr<Transport>>>> futs;
+  for (std::size_t party_id = 0; party_id < num_parties; ++party_id) {
+    futs.emplace_back(std::async(std::launch::async, [party_id, num_parties, &name] {
+      ShmSetupHelper helper(party_id, num_parties, name);
+      return helper.setup_connections();
+    }));
+  }
+  std::vector<std::unique_ptr<CommunicationLayer>> comm_layers;
+  comm_layers.reserve(num_parties);
+  for (std::size_t party_id = 0; party_id < num_parties; ++party_id) {
+    auto transports = futs.at(party_id).get();
+    comm_layers.emplace_back(std::make_unique<CommunicationLayer>(party_id, std::move(transports)));
+  }
+  return comm_layers;
+}
+
 }  // namespace MOTION::Communication
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <functional>
 #include <memory>
@@ -40,6 +41,14 @@ namespace Communication {
 class MessageHandler;
 struct TransportStatistics;
 
+// Controls how queued messages are coalesced before they are written to the
+// transport.  A flush happens when no new message arrives within flush_timeout_
+// or at least max_flush_size_ bytes are pending.
+struct SendPolicy {
+  std::size_t max_flush_size_ = 1 << 20;
+  std::chrono::microseconds flush_timeout_ = std::chrono::microseconds(0);
+};
+
 // Central interface for all communication related functionality
 //
 // Allows to send messages to other parties and to register handlers for
@@ -91,6 +100,8 @@ class CommunicationLayer {
   void reset_transport_statistics() noexcept;
 
   void set_logger(std::shared_ptr<Logger> logger);
+  // has to be called before start()
+  void set_send_policy(const SendPolicy& send_policy);
 
  private:
   struct CommunicationLayerImpl;
@@ -111,5 +122,9 @@ std::vector<std::unique_ptr<CommunicationLayer>> make_dummy_communication_layers
 std::vector<std::unique_ptr<CommunicationLayer>> make_local_tcp_communication_layers(
     std::size_t num_parties, bool ipv6 = true);
 
+// Create a set of communication layers connected by shared memory
+std::vector<std::unique_ptr<CommunicationLayer>> make_local_shm_communication_layers(
+    std::size_t num_parties);
+
 }  // namespace Communication
 }  // namespace MOTION
@@ -45,15 +45,13 @@ DummyTransport::make_transport_pair() {
 void DummyTransport::send_message(std::vector<std::uint8_t>&& message) {
   auto message_size = message.size();
   send_queue_->enqueue(std::move(message));
-  statistics_.num_messages_sent += 1;
-  statistics_.num_bytes_sent += message_size;
+  record_flush(1, message_size);
 }
 
 void DummyTransport::send_message(const std::vector<std::uint8_t>& message) {
   auto message_size = message.size();
   send_queue_->enqueue(message);
-  statistics_.num_messages_sent += 1;
-  statistics_.num_bytes_sent += message_size;
+  record_flush(1, message_size);
 }
 
 void DummyTransport::send_message(const std::uint8_t* message, std::size_t size) {
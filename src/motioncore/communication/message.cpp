@@ -66,6 +66,12 @@ std::string to_string(MessageType message_type) {
       return "MessageType::OTExtensionReceiverCorrections"s;
     case MessageType::OTExtensionSender:
       return "MessageType::OTExtensionSender"s;
+    case MessageType::OTExtensionSilentOTSender:
+      return "MessageType::OTExtensionSilentOTSender"s;
+    case MessageType::OTExtensionSenderWindowAck:
+      return "MessageType::OTExtensionSenderWindowAck"s;
+    case MessageType::LinAlgTripleRound:
+      return "MessageType::LinAlgTripleRound"s;
     case MessageType::BMRInputGate0:
       return "MessageType::BMRInputGate0"s;
     case MessageType::BMRInputGate1:
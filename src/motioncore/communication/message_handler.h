@@ -26,6 +26,7 @@
 #include <cstdint>
 #include <vector>
 
+#include "receive_buffer_pool.h"
 #include "utility/synchronized_queue.h"
 
 namespace MOTION::Communication {
@@ -46,6 +47,12 @@ class MessageHandler {
   // This method may be called concurrently with different values of party_id.
   // The client is responsible for the necessary synchronization.
   virtual void received_message(std::size_t party_id, std::vector<std::uint8_t>&& message) = 0;
+
+  // Variant for messages in a pooled buffer which is reused once the handler
+  // returns.  Handlers which do not keep the message should override this.
+  virtual void received_pooled_message(std::size_t party_id, ReceiveBuffer&& message) {
+    received_message(party_id, message.release());
+  }
 };
 
 // Example message handler which puts received messages into a queue
@@ -39,4 +39,10 @@ flatbuffers::FlatBufferBuilder BuildOTExtensionMessageReceiverMasks(const std::b
 flatbuffers::FlatBufferBuilder BuildOTExtensionMessageReceiverCorrections(const std::byte *buffer,
                                                                           const std::size_t size,
                                                                           const std::size_t i);
+
+flatbuffers::FlatBufferBuilder BuildOTExtensionMessageSilentOTSender(const std::byte *buffer,
+                                                                    const std::size_t size,
+                                                                    const std::size_t i);
+
+flatbuffers::FlatBufferBuilder BuildOTExtensionMessageSenderWindowAck(const std::size_t i);
 }  // namespace MOTION::Communication
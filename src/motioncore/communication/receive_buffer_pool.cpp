@@ -0,0 +1,97 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "receive_buffer_pool.h"
+
+namespace MOTION::Communication {
+
+ReceiveBufferPool::ReceiveBufferPool(std::size_t max_num_buffers, std::size_t min_pooled_size)
+    : max_num_buffers_(max_num_buffers), min_pooled_size_(min_pooled_size) {}
+
+std::vector<std::uint8_t> ReceiveBufferPool::acquire(std::size_t size) {
+  if (size >= min_pooled_size_) {
+    std::scoped_lock lock(mutex_);
+    // smallest buffer which is large enough, but do not waste huge buffers
+    if (auto it = buffers_.lower_bound(size); it != buffers_.end() && it->first <= 2 * size) {
+      auto buffer = std::move(it->second);
+      buffers_.erase(it);
+      ++num_reused_;
+      buffer.resize(size);
+      return buffer;
+    }
+  }
+  return std::vector<std::uint8_t>(size);
+}
+
+void ReceiveBufferPool::release(std::vector<std::uint8_t>&& buffer) {
+  if (buffer.size() < min_pooled_size_) {
+    return;
+  }
+  std::scoped_lock lock(mutex_);
+  if (buffers_.size() == max_num_buffers_) {
+    // keep the larger buffers since they are more expensive to allocate
+    if (max_num_buffers_ == 0 || buffers_.begin()->first >= buffer.size()) {
+      return;
+    }
+    buffers_.erase(buffers_.begin());
+  }
+  const auto size = buffer.size();
+  buffers_.emplace(size, std::move(buffer));
+}
+
+std::size_t ReceiveBufferPool::get_num_pooled() const {
+  std::scoped_lock lock(mutex_);
+  return buffers_.size();
+}
+
+std::size_t ReceiveBufferPool::get_num_reused() const {
+  std::scoped_lock lock(mutex_);
+  return num_reused_;
+}
+
+ReceiveBuffer::ReceiveBuffer(std::vector<std::uint8_t>&& buffer,
+                             std::shared_ptr<ReceiveBufferPool> pool) noexcept
+    : buffer_(std::move(buffer)), pool_(std::move(pool)) {}
+
+ReceiveBuffer& ReceiveBuffer::operator=(ReceiveBuffer&& other) noexcept {
+  if (this != &other) {
+    if (pool_) {
+      pool_->release(std::move(buffer_));
+    }
+    buffer_ = std::move(other.buffer_);
+    pool_ = std::move(other.pool_);
+  }
+  return *this;
+}
+
+ReceiveBuffer::~ReceiveBuffer() {
+  if (pool_) {
+    pool_->release(std::move(buffer_));
+  }
+}
+
+std::vector<std::uint8_t> ReceiveBuffer::release() noexcept {
+  pool_.reset();
+  return std::move(buffer_);
+}
+
+}  // namespace MOTION::Communication
@@ -0,0 +1,81 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace MOTION::Communication {
+
+// Thread-safe pool of buffers for received messages, so that large messages
+// do not need a fresh (page faulting) allocation each time.  Buffers smaller
+// than min_pooled_size are allocated as usual.
+class ReceiveBufferPool {
+ public:
+  explicit ReceiveBufferPool(std::size_t max_num_buffers = 16,
+                             std::size_t min_pooled_size = 1 << 12);
+
+  // returns a buffer of the given size, reusing a pooled one if possible
+  std::vector<std::uint8_t> acquire(std::size_t size);
+  // puts a buffer back into the pool
+  void release(std::vector<std::uint8_t>&& buffer);
+
+  std::size_t get_num_pooled() const;
+  std::size_t get_num_reused() const;
+
+ private:
+  const std::size_t max_num_buffers_;
+  const std::size_t min_pooled_size_;
+  mutable std::mutex mutex_;
+  // size -> buffer, shrinking a buffer does not touch its memory
+  std::multimap<std::size_t, std::vector<std::uint8_t>> buffers_;
+  std::size_t num_reused_ = 0;
+};
+
+// Received message which returns its buffer to the pool when it is destroyed
+class ReceiveBuffer {
+ public:
+  ReceiveBuffer(std::vector<std::uint8_t>&& buffer,
+                std::shared_ptr<ReceiveBufferPool> pool) noexcept;
+  ReceiveBuffer(ReceiveBuffer&& other) noexcept = default;
+  ReceiveBuffer& operator=(ReceiveBuffer&& other) noexcept;
+  ~ReceiveBuffer();
+
+  std::uint8_t* data() noexcept { return buffer_.data(); }
+  const std::uint8_t* data() const noexcept { return buffer_.data(); }
+  std::size_t size() const noexcept { return buffer_.size(); }
+  bool empty() const noexcept { return buffer_.empty(); }
+
+  // take the buffer out of this object, it is then not returned to the pool
+  std::vector<std::uint8_t> release() noexcept;
+
+ private:
+  std::vector<std::uint8_t> buffer_;
+  std::shared_ptr<ReceiveBufferPool> pool_;
+};
+
+}  // namespace MOTION::Communication
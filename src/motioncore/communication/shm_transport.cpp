@@ -0,0 +1,462 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "shm_transport.h"
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <future>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <system_error>
+#include <thread>
+
+#include <emmintrin.h>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+namespace MOTION::Communication {
+
+namespace {
+
+constexpr std::size_t kCacheLineSize = 64;
+// number of polls before a waiting thread goes to sleep
+constexpr std::size_t kNumSpins = 2000;
+constexpr std::uint32_t kMagic = 0x4d4f5449;
+constexpr auto kPollDelay = std::chrono::milliseconds(1);
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+void futex_wait(std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+  // the word is shared with another process, hence no FUTEX_PRIVATE_FLAG
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected, nullptr,
+          nullptr, 0);
+}
+
+void futex_wake(std::atomic<std::uint32_t>& word) {
+  syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr,
+          nullptr, 0);
+}
+
+// Futex which is only signaled if somebody sleeps on it.
+struct Event {
+  std::atomic<std::uint32_t> sequence_{0};
+  std::atomic<std::uint32_t> num_waiting_{0};
+
+  // block until condition() holds
+  template <typename Condition>
+  void wait(Condition condition) {
+    for (std::size_t i = 0; i < kNumSpins; ++i) {
+      if (condition()) {
+        return;
+      }
+      _mm_pause();
+    }
+    while (true) {
+      const auto sequence = sequence_.load();
+      num_waiting_.fetch_add(1);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (condition()) {
+        num_waiting_.fetch_sub(1);
+        return;
+      }
+      futex_wait(sequence_, sequence);
+      num_waiting_.fetch_sub(1);
+    }
+  }
+
+  // to be called after the state checked by condition() has been changed
+  void notify() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (num_waiting_.load() > 0) {
+      sequence_.fetch_add(1);
+      futex_wake(sequence_);
+    }
+  }
+};
+
+// Single producer, single consumer ring buffer of bytes.  head_ and tail_
+// count the bytes written and read so far.  The data follows the header.
+struct Ring {
+  alignas(kCacheLineSize) std::atomic<std::uint64_t> head_{0};
+  alignas(kCacheLineSize) std::atomic<std::uint64_t> tail_{0};
+  alignas(kCacheLineSize) Event data_event_;
+  alignas(kCacheLineSize) Event space_event_;
+  // set by the producer after the last message
+  std::atomic<std::uint32_t> closed_{0};
+  // set by the consumer if it does not read anymore
+  std::atomic<std::uint32_t> reader_closed_{0};
+  std::uint64_t capacity_ = 0;
+
+  std::uint8_t* data() noexcept { return reinterpret_cast<std::uint8_t*>(this) + sizeof(Ring); }
+
+  void write(const std::uint8_t* source, std::size_t size) {
+    while (size > 0) {
+      const auto head = head_.load(std::memory_order_relaxed);
+      auto free = capacity_ - (head - tail_.load(std::memory_order_acquire));
+      if (free == 0) {
+        // let the consumer drain the ring
+        data_event_.notify();
+        space_event_.wait([this, head] {
+          return head - tail_.load(std::memory_order_acquire) < capacity_ ||
+                 reader_closed_.load(std::memory_order_acquire);
+        });
+        if (reader_closed_.load(std::memory_order_acquire)) {
+          throw std::runtime_error("ShmTransport: receiver has been shut down");
+        }
+        continue;
+      }
+      const auto n = std::min(size, free);
+      const auto offset = head % capacity_;
+      const auto first_part = std::min(n, capacity_ - offset);
+      std::copy_n(source, first_part, data() + offset);
+      std::copy_n(source + first_part, n - first_part, data());
+      head_.store(head + n, std::memory_order_release);
+      source += n;
+      size -= n;
+    }
+  }
+
+  // returns false if the ring was closed before size bytes could be read
+  bool read(std::uint8_t* destination, std::size_t size) {
+    while (size > 0) {
+      const auto tail = tail_.load(std::memory_order_relaxed);
+      const auto available = head_.load(std::memory_order_acquire) - tail;
+      if (available == 0) {
+        data_event_.wait([this, tail] {
+          return head_.load(std::memory_order_acquire) != tail ||
+                 closed_.load(std::memory_order_acquire);
+        });
+        if (head_.load(std::memory_order_acquire) == tail) {
+          return false;
+        }
+        continue;
+      }
+      const auto n = std::min(size, available);
+      const auto offset = tail % capacity_;
+      const auto first_part = std::min(n, capacity_ - offset);
+      std::copy_n(data() + offset, first_part, destination);
+      std::copy_n(data(), n - first_part, destination + first_part);
+      tail_.store(tail + n, std::memory_order_release);
+      space_event_.notify();
+      destination += n;
+      size -= n;
+    }
+    return true;
+  }
+
+  void close() {
+    closed_.store(1, std::memory_order_release);
+    data_event_.notify();
+  }
+
+  void close_reader() {
+    reader_closed_.store(1, std::memory_order_release);
+    space_event_.notify();
+  }
+};
+
+enum SegmentState : std::uint32_t { uninitialized = 0, created = 1, connected = 2 };
+
+struct alignas(kCacheLineSize) SegmentHeader {
+  std::atomic<std::uint32_t> state_;
+  std::uint32_t magic_;
+  std::uint64_t ring_size_;
+};
+
+std::size_t get_ring_offset(std::size_t ring_size, std::size_t i) {
+  return sizeof(SegmentHeader) + i * (sizeof(Ring) + ring_size);
+}
+
+std::size_t get_segment_size(std::size_t ring_size) { return get_ring_offset(ring_size, 2); }
+
+[[noreturn]] void throw_errno(const std::string& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+}  // namespace
+
+namespace detail {
+
+// Mapping of a shared memory segment containing two rings.
+struct ShmSegment {
+  ShmSegment(void* address, std::size_t size, bool creator)
+      : address_(address), size_(size), header_(static_cast<SegmentHeader*>(address)) {
+    const auto ring_size = header_->ring_size_;
+    auto* base = static_cast<std::uint8_t*>(address_);
+    auto* ring_0 = reinterpret_cast<Ring*>(base + get_ring_offset(ring_size, 0));
+    auto* ring_1 = reinterpret_cast<Ring*>(base + get_ring_offset(ring_size, 1));
+    // the creator sends on the first ring
+    send_ring_ = creator ? ring_0 : ring_1;
+    receive_ring_ = creator ? ring_1 : ring_0;
+  }
+  ~ShmSegment() { munmap(address_, size_); }
+
+  // read the size of the next message, std::nullopt if the other side has shut down
+  std::optional<std::size_t> read_message_size() {
+    std::uint64_t size;
+    if (!receive_ring_->read(reinterpret_cast<std::uint8_t*>(&size), sizeof(size))) {
+      return std::nullopt;
+    }
+    return size;
+  }
+
+  void read_message_body(std::uint8_t* destination, std::size_t size) {
+    if (!receive_ring_->read(destination, size)) {
+      throw std::runtime_error("ShmTransport: connection closed while receiving a message");
+    }
+  }
+
+  void write_message(const std::uint8_t* message, std::size_t size) {
+    const std::uint64_t message_size = size;
+    send_ring_->write(reinterpret_cast<const std::uint8_t*>(&message_size), sizeof(message_size));
+    send_ring_->write(message, size);
+  }
+
+  void* address_;
+  std::size_t size_;
+  SegmentHeader* header_;
+  Ring* send_ring_;
+  Ring* receive_ring_;
+  std::mutex send_mutex_;
+  std::mutex receive_mutex_;
+};
+
+}  // namespace detail
+
+ShmTransport::ShmTransport(std::unique_ptr<detail::ShmSegment> segment)
+    : segment_(std::move(segment)) {}
+
+ShmTransport::~ShmTransport() = default;
+
+void ShmTransport::send_message(std::vector<std::uint8_t>&& message) {
+  send_message(message.data(), message.size());
+}
+
+void ShmTransport::send_message(const std::vector<std::uint8_t>& message) {
+  send_message(message.data(), message.size());
+}
+
+void ShmTransport::send_message(const std::uint8_t* message, std::size_t size) {
+  std::scoped_lock lock(segment_->send_mutex_);
+  segment_->write_message(message, size);
+  segment_->send_ring_->data_event_.notify();
+  record_flush(1, size + sizeof(std::uint64_t));
+}
+
+void ShmTransport::send_messages(const std::vector<MessageView>& messages) {
+  if (messages.empty()) {
+    return;
+  }
+  std::scoped_lock lock(segment_->send_mutex_);
+  std::size_t num_bytes = 0;
+  for (const auto& [message, size] : messages) {
+    segment_->write_message(message, size);
+    num_bytes += size + sizeof(std::uint64_t);
+  }
+  segment_->send_ring_->data_event_.notify();
+  record_flush(messages.size(), num_bytes);
+}
+
+bool ShmTransport::available() const {
+  const auto& ring = *segment_->receive_ring_;
+  return ring.head_.load(std::memory_order_acquire) != ring.tail_.load(std::memory_order_relaxed);
+}
+
+std::optional<std::vector<std::uint8_t>> ShmTransport::receive_message() {
+  std::scoped_lock lock(segment_->receive_mutex_);
+  auto message_size = segment_->read_message_size();
+  if (!message_size.has_value()) {
+    return std::nullopt;
+  }
+  std::vector<std::uint8_t> message_buffer(*message_size);
+  segment_->read_message_body(message_buffer.data(), message_buffer.size());
+  statistics_.num_bytes_received += message_buffer.size() + sizeof(std::uint64_t);
+  statistics_.num_messages_received += 1;
+  return message_buffer;
+}
+
+std::optional<ReceiveBuffer> ShmTransport::receive_pooled_message(
+    const std::shared_ptr<ReceiveBufferPool>& pool) {
+  std::scoped_lock lock(segment_->receive_mutex_);
+  auto message_size = segment_->read_message_size();
+  if (!message_size.has_value()) {
+    return std::nullopt;
+  }
+  ReceiveBuffer message_buffer(pool->acquire(*message_size), pool);
+  segment_->read_message_body(message_buffer.data(), message_buffer.size());
+  statistics_.num_bytes_received += message_buffer.size() + sizeof(std::uint64_t);
+  statistics_.num_messages_received += 1;
+  return message_buffer;
+}
+
+void ShmTransport::shutdown_send() { segment_->send_ring_->close(); }
+
+void ShmTransport::shutdown() {
+  segment_->send_ring_->close();
+  // wake up a blocked writer on the other side and our own reader
+  segment_->receive_ring_->close_reader();
+  segment_->receive_ring_->close();
+}
+
+namespace {
+
+std::unique_ptr<detail::ShmSegment> create_segment(const std::string& name, std::size_t ring_size,
+                                                   std::chrono::milliseconds timeout) {
+  // remove leftovers of an aborted run
+  shm_unlink(name.c_str());
+  int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+  if (fd < 0) {
+    throw_errno(fmt::format("cannot create shared memory segment {}", name));
+  }
+  const auto size = get_segment_size(ring_size);
+  if (ftruncate(fd, size) != 0) {
+    close(fd);
+    shm_unlink(name.c_str());
+    throw_errno(fmt::format("cannot resize shared memory segment {}", name));
+  }
+  void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (address == MAP_FAILED) {
+    shm_unlink(name.c_str());
+    throw_errno(fmt::format("cannot map shared memory segment {}", name));
+  }
+
+  auto* base = static_cast<std::uint8_t*>(address);
+  auto* header = new (address) SegmentHeader;
+  header->magic_ = kMagic;
+  header->ring_size_ = ring_size;
+  for (std::size_t i = 0; i < 2; ++i) {
+    auto* ring = new (base + get_ring_offset(ring_size, i)) Ring;
+    ring->capacity_ = ring_size;
+  }
+  header->state_.store(SegmentState::created, std::memory_order_release);
+  auto segment = std::make_unique<detail::ShmSegment>(address, size, true);
+
+  // wait for the other party
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (header->state_.load(std::memory_order_acquire) != SegmentState::connected) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      shm_unlink(name.c_str());
+      throw std::runtime_error(fmt::format("timeout while waiting for the other party on {}", name));
+    }
+    std::this_thread::sleep_for(kPollDelay);
+  }
+  shm_unlink(name.c_str());
+  return segment;
+}
+
+std::unique_ptr<detail::ShmSegment> open_segment(const std::string& name, std::size_t ring_size,
+                                                 std::chrono::milliseconds timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  const auto size = get_segment_size(ring_size);
+  for (;; std::this_thread::sleep_for(kPollDelay)) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      throw std::runtime_error(fmt::format("timeout while waiting for the other party on {}", name));
+    }
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+      if (errno == ENOENT) {
+        continue;
+      }
+      throw_errno(fmt::format("cannot open shared memory segment {}", name));
+    }
+    // the segment may not be resized yet
+    struct stat stat_buffer;
+    if (fstat(fd, &stat_buffer) != 0 || static_cast<std::size_t>(stat_buffer.st_size) != size) {
+      close(fd);
+      continue;
+    }
+    void* address = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+      throw_errno(fmt::format("cannot map shared memory segment {}", name));
+    }
+    auto* header = static_cast<SegmentHeader*>(address);
+    if (header->state_.load(std::memory_order_acquire) != SegmentState::created) {
+      // not initialized yet, or taken by someone else
+      munmap(address, size);
+      continue;
+    }
+    if (header->magic_ != kMagic || header->ring_size_ != ring_size) {
+      munmap(address, size);
+      throw std::runtime_error(fmt::format("shared memory segment {} has a different layout", name));
+    }
+    auto segment = std::make_unique<detail::ShmSegment>(address, size, false);
+    header->state_.store(SegmentState::connected, std::memory_order_release);
+    return segment;
+  }
+}
+
+}  // namespace
+
+ShmSetupHelper::ShmSetupHelper(std::size_t my_id, std::size_t num_parties,
+                               const std::string& name, std::size_t ring_size)
+    : my_id_(my_id),
+      num_parties_(num_parties),
+      name_(name),
+      ring_size_((ring_size + kCacheLineSize - 1) / kCacheLineSize * kCacheLineSize) {
+  if (num_parties_ <= 1) {
+    throw std::invalid_argument("specified number of parties: num_parties <= 1");
+  }
+  if (my_id_ >= num_parties_) {
+    throw std::invalid_argument("specified invalid party id: my_id >= num_parties");
+  }
+  if (ring_size_ == 0) {
+    throw std::invalid_argument("specified invalid ring size: 0");
+  }
+}
+
+std::vector<std::unique_ptr<Transport>> ShmSetupHelper::setup_connections() {
+  std::vector<std::future<std::unique_ptr<detail::ShmSegment>>> futs(num_parties_);
+  for (std::size_t party_id = 0; party_id < num_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    const auto name = fmt::format("/{}-{}-{}", name_, std::min(my_id_, party_id),
+                                  std::max(my_id_, party_id));
+    const bool creator = my_id_ < party_id;
+    futs.at(party_id) = std::async(std::launch::async, [this, name, creator] {
+      return creator ? create_segment(name, ring_size_, timeout_)
+                     : open_segment(name, ring_size_, timeout_);
+    });
+  }
+  std::vector<std::unique_ptr<Transport>> result(num_parties_);
+  for (std::size_t party_id = 0; party_id < num_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    result.at(party_id) = std::make_unique<ShmTransport>(futs.at(party_id).get());
+  }
+  return result;
+}
+
+}  // namespace MOTION::Communication
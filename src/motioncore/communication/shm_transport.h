@@ -0,0 +1,89 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "transport.h"
+
+namespace MOTION::Communication {
+
+namespace detail {
+struct ShmSegment;
+}
+
+// Transport between two processes on the same host via a shared memory
+// segment.  The segment contains a ring buffer for each direction, which is
+// written by exactly one producer and read by exactly one consumer without
+// locks.  A blocked reader (writer) sleeps on a futex until data (space) is
+// available.  Messages larger than the ring are streamed through it.
+class ShmTransport : public Transport {
+ public:
+  ShmTransport(std::unique_ptr<detail::ShmSegment> segment);
+  ~ShmTransport();
+
+  void send_message(std::vector<std::uint8_t>&& message) override;
+  void send_message(const std::vector<std::uint8_t>& message) override;
+  void send_message(const std::uint8_t* message, std::size_t size) override;
+  // writes all messages before waking up the receiver
+  void send_messages(const std::vector<MessageView>& messages) override;
+
+  bool available() const override;
+  std::optional<std::vector<std::uint8_t>> receive_message() override;
+  std::optional<ReceiveBuffer> receive_pooled_message(
+      const std::shared_ptr<ReceiveBufferPool>& pool) override;
+  void shutdown_send() override;
+  void shutdown() override;
+
+ private:
+  std::unique_ptr<detail::ShmSegment> segment_;
+};
+
+// Helper class to connect a set of parties running on the same host via
+// shared memory.  For each pair of parties, the one with the smaller ID
+// creates the segment "/<name>-<i>-<j>" and the other one opens it.  The name
+// is removed again once both parties are connected.
+class ShmSetupHelper {
+ public:
+  ShmSetupHelper(std::size_t my_id, std::size_t num_parties, const std::string& name,
+                 std::size_t ring_size = 1 << 24);
+
+  // Establish all connections.
+  // Throws a std::runtime_error if something goes wrong or the other parties
+  // do not show up in time.
+  std::vector<std::unique_ptr<Transport>> setup_connections();
+
+  void set_timeout(std::chrono::milliseconds timeout) noexcept { timeout_ = timeout; }
+
+ private:
+  std::size_t my_id_;
+  std::size_t num_parties_;
+  std::string name_;
+  std::size_t ring_size_;
+  std::chrono::milliseconds timeout_ = std::chrono::minutes(5);
+};
+
+}  // namespace MOTION::Communication
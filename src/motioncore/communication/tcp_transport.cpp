@@ -22,8 +22,12 @@
 
 #include "tcp_transport.h"
 
+#include <algorithm>
 #include <chrono>
+#include <exception>
+#include <functional>
 #include <future>
+#include <limits>
 #include <shared_mutex>
 #include <thread>
 
@@ -36,35 +40,279 @@
 #include <boost/asio/write.hpp>
 #include <boost/system/error_code.hpp>
 
+#if defined(__linux__)
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+
+#include "utility/synchronized_queue.h"
+#include "utility/thread.h"
+
 using boost::asio::ip::tcp;
 
 namespace MOTION::Communication {
 
+namespace {
+
+// messages up to this size are copied into the staging buffer of a flush,
+// larger ones are written from their own memory
+constexpr std::size_t kMaxCopySize = 4096;
+// boost::asio passes at most this many buffers to a single writev
+constexpr std::size_t kMaxBuffersPerWrite = 64;
+constexpr std::size_t kReadBufferSize = 1 << 16;
+
+#if defined(__linux__)
+using tcp_cork = boost::asio::detail::socket_option::boolean<IPPROTO_TCP, TCP_CORK>;
+
+// corks a socket for its lifetime, so that it is uncorked again when a write throws
+class SocketCork {
+ public:
+  SocketCork(tcp::socket& socket, bool enabled) : socket_(socket), enabled_(enabled) {
+    if (enabled_) {
+      boost::system::error_code ec;
+      socket_.set_option(tcp_cork(true), ec);
+    }
+  }
+  ~SocketCork() {
+    if (enabled_) {
+      boost::system::error_code ec;
+      socket_.set_option(tcp_cork(false), ec);
+    }
+  }
+  SocketCork(const SocketCork&) = delete;
+  SocketCork& operator=(const SocketCork&) = delete;
+
+ private:
+  tcp::socket& socket_;
+  bool enabled_;
+};
+#endif
+
+// messages are prefixed with their size as u32, larger sizes are marked by
+// this value and follow as u64
+constexpr std::uint32_t kLargeMessageMarker = std::numeric_limits<std::uint32_t>::max();
+constexpr std::size_t kMaxHeaderSize = sizeof(std::uint32_t) + sizeof(std::uint64_t);
+
+template <typename T>
+void encode_int(T v, std::uint8_t* result) {
+  for (auto i = 0u; i < sizeof(T); ++i) {
+    result[i] = (v >> i * 8) & 0xFF;
+  }
+}
+
+template <typename T>
+T decode_int(const std::uint8_t* v) {
+  T result = 0;
+  for (auto i = 0u; i < sizeof(T); ++i) {
+    result |= T(v[i]) << i * 8;
+  }
+  return result;
+}
+
+std::size_t get_header_size(std::size_t size) {
+  return size < kLargeMessageMarker ? sizeof(std::uint32_t) : kMaxHeaderSize;
+}
+
+// write the size header of a message and return its length
+std::size_t encode_header(std::size_t size, std::uint8_t* header) {
+  if (size < kLargeMessageMarker) {
+    encode_int<std::uint32_t>(size, header);
+    return sizeof(std::uint32_t);
+  }
+  encode_int<std::uint32_t>(kLargeMessageMarker, header);
+  encode_int<std::uint64_t>(size, header + sizeof(std::uint32_t));
+  return kMaxHeaderSize;
+}
+
+// wait for the workers of a striped transfer and rethrow the first error, the workers access the
+// caller's message buffer, so none of them may still run when the caller sees an exception
+void join_stripes(std::vector<std::future<void>>& futures, std::exception_ptr error) {
+  for (auto& future : futures) {
+    try {
+      future.get();
+    } catch (...) {
+      if (!error) {
+        error = std::current_exception();
+      }
+    }
+  }
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace
+
 namespace detail {
 
+// A single connection together with the buffers used for framing messages.
 struct TCPTransportImpl {
   TCPTransportImpl(std::shared_ptr<boost::asio::io_context> io_context, tcp::socket&& socket)
-      : io_context_(io_context), socket_(std::move(socket)) {}
+      : io_context_(io_context), socket_(std::move(socket)) {
+    boost::system::error_code ec;
+    socket_.set_option(tcp::no_delay(true), ec);
+  }
   std::shared_ptr<boost::asio::io_context> io_context_;
   boost::asio::ip::tcp::socket socket_;
   std::shared_mutex socket_mutex_;
+  // reused by write_messages
+  std::vector<std::uint8_t> staging_buffer_;
+  std::vector<boost::asio::const_buffer> buffers_;
+  // read-ahead buffer, so that small messages do not need a system call each
+  std::vector<std::uint8_t> read_buffer_;
+  std::size_t read_begin_ = 0;
+  std::size_t read_end_ = 0;
+
+  // write the given buffers completely, corking the socket if requested
+  template <typename ConstBufferSequence>
+  void write(const ConstBufferSequence& buffers, bool cork = false);
+  // frame all messages into a single vectored write and return the number of bytes written
+  std::size_t write_messages(const std::vector<MessageView>& messages, bool cork_flushes);
+  void write_message(const std::uint8_t* message, std::size_t size);
+
+  void read(std::uint8_t* destination, std::size_t size, boost::system::error_code& ec);
+  // read the size of the next message, std::nullopt if the connection was closed
+  std::optional<std::size_t> read_message_size();
+  void read_message_body(std::uint8_t* destination, std::size_t size);
+  bool available();
 };
 
+template <typename ConstBufferSequence>
+void TCPTransportImpl::write(const ConstBufferSequence& buffers, bool cork) {
+#if defined(__linux__)
+  SocketCork socket_cork(socket_, cork);
+#endif
+  boost::system::error_code ec;
+  boost::asio::write(socket_, buffers, boost::asio::transfer_all(), ec);
+  if (ec) {
+    throw std::runtime_error(fmt::format("Error while writing to socket: {}", ec.message()));
+  }
+}
+
+std::size_t TCPTransportImpl::write_messages(const std::vector<MessageView>& messages,
+                                             bool cork_flushes) {
+  std::size_t staging_size = 0;
+  std::size_t num_bytes = 0;
+  for (const auto& [message, size] : messages) {
+    staging_size += get_header_size(size) + (size <= kMaxCopySize ? size : 0);
+    num_bytes += get_header_size(size) + size;
+  }
+  staging_buffer_.resize(staging_size);
+  buffers_.clear();
+
+  // frame the messages into the staging buffer, each large message splits it
+  auto* staging_ptr = staging_buffer_.data();
+  const auto* chunk_begin = staging_ptr;
+  for (const auto& [message, size] : messages) {
+    staging_ptr += encode_header(size, staging_ptr);
+    if (size <= kMaxCopySize) {
+      staging_ptr = std::copy_n(message, size, staging_ptr);
+    } else {
+      buffers_.emplace_back(chunk_begin, staging_ptr - chunk_begin);
+      buffers_.emplace_back(message, size);
+      chunk_begin = staging_ptr;
+    }
+  }
+  if (staging_ptr != chunk_begin) {
+    buffers_.emplace_back(chunk_begin, staging_ptr - chunk_begin);
+  }
+  write(buffers_, cork_flushes && buffers_.size() > kMaxBuffersPerWrite);
+  return num_bytes;
+}
+
+void TCPTransportImpl::write_message(const std::uint8_t* message, std::size_t size) {
+  std::array<std::uint8_t, kMaxHeaderSize> header;
+  const auto header_size = encode_header(size, header.data());
+  std::array<boost::asio::const_buffer, 2> buffers = {boost::asio::buffer(header, header_size),
+                                                      boost::asio::buffer(message, size)};
+  write(buffers);
+}
+
+void TCPTransportImpl::read(std::uint8_t* destination, std::size_t size,
+                            boost::system::error_code& ec) {
+  const auto num_buffered = std::min(size, read_end_ - read_begin_);
+  destination = std::copy_n(read_buffer_.data() + read_begin_, num_buffered, destination);
+  read_begin_ += num_buffered;
+  size -= num_buffered;
+  if (size == 0) {
+    return;
+  }
+  // large messages are read directly into their destination
+  if (size >= kReadBufferSize / 2) {
+    boost::asio::read(socket_, boost::asio::buffer(destination, size),
+                      boost::asio::transfer_exactly(size), ec);
+    return;
+  }
+  read_buffer_.resize(kReadBufferSize);
+  read_begin_ = 0;
+  read_end_ = 0;
+  while (read_end_ < size) {
+    read_end_ += socket_.read_some(
+        boost::asio::buffer(read_buffer_.data() + read_end_, kReadBufferSize - read_end_), ec);
+    if (ec) {
+      return;
+    }
+  }
+  std::copy_n(read_buffer_.data(), size, destination);
+  read_begin_ = size;
+}
+
+std::optional<std::size_t> TCPTransportImpl::read_message_size() {
+  std::array<std::uint8_t, kMaxHeaderSize> header;
+  boost::system::error_code ec;
+  read(header.data(), sizeof(std::uint32_t), ec);
+  if (!ec && decode_int<std::uint32_t>(header.data()) == kLargeMessageMarker) {
+    read(header.data() + sizeof(std::uint32_t), sizeof(std::uint64_t), ec);
+    if (ec.value() == boost::asio::error::misc_errors::eof) {
+      throw std::runtime_error("Connection closed while reading message size");
+    }
+  }
+  if (ec) {
+    if (ec.value() == boost::asio::error::misc_errors::eof) {
+      // connection has been closed
+      return std::nullopt;
+    }
+    throw std::runtime_error(fmt::format("Error while reading message size from socket: {} ({})",
+                                         ec.message(), ec.value()));
+  }
+  const auto size = decode_int<std::uint32_t>(header.data());
+  if (size == kLargeMessageMarker) {
+    return decode_int<std::uint64_t>(header.data() + sizeof(std::uint32_t));
+  }
+  return size;
+}
+
+void TCPTransportImpl::read_message_body(std::uint8_t* destination, std::size_t size) {
+  boost::system::error_code ec;
+  read(destination, size, ec);
+  if (ec) {
+    throw std::runtime_error(
+        fmt::format("Error while reading message size socket: {} ({})", ec.message(), ec.value()));
+  }
+}
+
+bool TCPTransportImpl::available() {
+  std::scoped_lock lock(socket_mutex_);
+  if (read_end_ > read_begin_) {
+    return true;
+  }
+  auto result = socket_.available();
+  return result > 0;
+}
+
 }  // namespace detail
 
 TCPTransport::TCPTransport(std::unique_ptr<detail::TCPTransportImpl> impl)
     : is_connected_(true), impl_(std::move(impl)) {}
 
 TCPTransport::TCPTransport(TCPTransport&& other)
-    : is_connected_(other.is_connected_), impl_(std::move(other.impl_)) {}
+    : is_connected_(other.is_connected_),
+      cork_flushes_(other.cork_flushes_),
+      impl_(std::move(other.impl_)) {}
 
 TCPTransport::~TCPTransport() = default;
 
-bool TCPTransport::available() const {
-  std::scoped_lock lock(impl_->socket_mutex_);
-  auto result = impl_->socket_.available();
-  return result > 0;
-}
+bool TCPTransport::available() const { return impl_->available(); }
 
 void TCPTransport::shutdown_send() {
   std::scoped_lock lock(impl_->socket_mutex_);
@@ -79,97 +327,278 @@ void TCPTransport::shutdown() {
   impl_->socket_.close(ec);
 }
 
-void TCPTransport::send_message(std::vector<std::uint8_t>&& message) { send_message(message); }
-
-static void u32tou8(std::uint32_t v, std::uint8_t* result) {
-  for (auto i = 0u; i < sizeof(std::uint32_t); ++i) {
-    result[i] = (v >> i * 8) & 0xFF;
+void TCPTransport::set_no_delay(bool no_delay) {
+  std::scoped_lock lock(impl_->socket_mutex_);
+  boost::system::error_code ec;
+  impl_->socket_.set_option(tcp::no_delay(no_delay), ec);
+  if (ec) {
+    throw std::runtime_error(fmt::format("Error while setting TCP_NODELAY: {}", ec.message()));
   }
 }
 
+void TCPTransport::set_cork_flushes(bool cork_flushes) { cork_flushes_ = cork_flushes; }
+
+void TCPTransport::send_message(std::vector<std::uint8_t>&& message) { send_message(message); }
+
 void TCPTransport::send_message(const std::vector<std::uint8_t>& message) {
   send_message(message.data(), message.size());
 }
 
 void TCPTransport::send_message(const std::uint8_t* message, std::size_t size) {
-  if (size > std::numeric_limits<std::uint32_t>::max()) {
-    throw std::runtime_error(fmt::format("Max message size is {} B but tried to send {} B",
-                                         std::numeric_limits<std::uint32_t>::max(), size));
+  std::shared_lock lock(impl_->socket_mutex_);
+  impl_->write_message(message, size);
+  record_flush(1, size + get_header_size(size));
+}
+
+void TCPTransport::send_messages(const std::vector<MessageView>& messages) {
+  if (messages.empty()) {
+    return;
   }
-  std::array<std::uint8_t, sizeof(std::uint32_t)> message_size;
-  u32tou8(size, message_size.data());
+  std::shared_lock lock(impl_->socket_mutex_);
+  const auto num_bytes = impl_->write_messages(messages, cork_flushes_);
+  record_flush(messages.size(), num_bytes);
+}
 
-  std::array<boost::asio::const_buffer, 2> buffers = {boost::asio::buffer(message_size),
-                                                      boost::asio::buffer(message, size)};
+std::optional<std::vector<std::uint8_t>> TCPTransport::receive_message() {
+  std::shared_lock lock(impl_->socket_mutex_);
+  auto message_size = impl_->read_message_size();
+  if (!message_size.has_value()) {
+    return std::nullopt;
+  }
+  std::vector<std::uint8_t> message_buffer(*message_size);
+  impl_->read_message_body(message_buffer.data(), message_buffer.size());
+  statistics_.num_bytes_received += message_buffer.size() + get_header_size(*message_size);
+  statistics_.num_messages_received += 1;
+  return message_buffer;
+}
 
-  boost::system::error_code ec;
+std::optional<ReceiveBuffer> TCPTransport::receive_pooled_message(
+    const std::shared_ptr<ReceiveBufferPool>& pool) {
   std::shared_lock lock(impl_->socket_mutex_);
-  boost::asio::write(impl_->socket_, buffers, boost::asio::transfer_all(), ec);
-  if (ec) {
-    throw std::runtime_error(fmt::format("Error while writing to socket: {}", ec.message()));
+  auto message_size = impl_->read_message_size();
+  if (!message_size.has_value()) {
+    return std::nullopt;
   }
-  statistics_.num_bytes_sent += size + sizeof(uint32_t);
-  statistics_.num_messages_sent += 1;
+  ReceiveBuffer message_buffer(pool->acquire(*message_size), pool);
+  impl_->read_message_body(message_buffer.data(), message_buffer.size());
+  statistics_.num_bytes_received += message_buffer.size() + get_header_size(*message_size);
+  statistics_.num_messages_received += 1;
+  return message_buffer;
 }
 
-static std::uint32_t u8tou32(std::array<std::uint8_t, sizeof(std::uint32_t)>& v) {
-  std::uint32_t result = 0;
-  for (auto i = 0u; i < sizeof(std::uint32_t); ++i) {
-    result += (v[i] << i * 8);
+// Thread which does the work for one stream of a StripedTCPTransport.
+class StripedTCPTransport::StreamWorker {
+ public:
+  StreamWorker(const std::string& name, int cpu) : thread_([this] { run(); }) {
+    ENCRYPTO::thread_set_name(thread_, name);
+    if (cpu >= 0) {
+      ENCRYPTO::thread_set_affinity(thread_, cpu);
+    }
+  }
+  ~StreamWorker() {
+    tasks_.close();
+    thread_.join();
+  }
+
+  std::future<void> submit(std::function<void()> task) {
+    std::packaged_task<void()> packaged_task(std::move(task));
+    auto future = packaged_task.get_future();
+    tasks_.enqueue(std::move(packaged_task));
+    return future;
+  }
+
+ private:
+  void run() {
+    while (auto task = tasks_.dequeue()) {
+      (*task)();
+    }
+  }
+
+  ENCRYPTO::SynchronizedQueue<std::packaged_task<void()>> tasks_;
+  std::thread thread_;
+};
+
+StripedTCPTransport::StripedTCPTransport(
+    std::vector<std::unique_ptr<detail::TCPTransportImpl>>&& streams,
+    const TCPSetupOptions& options)
+    : stripe_threshold_(std::max(options.stripe_threshold_, std::size_t(1))),
+      send_cpu_(options.send_cpus_.empty() ? -1 : options.send_cpus_[0]),
+      receive_cpu_(options.receive_cpus_.empty() ? -1 : options.receive_cpus_[0]),
+      streams_(std::move(streams)) {
+  if (streams_.empty()) {
+    throw std::invalid_argument("StripedTCPTransport needs at least one stream");
+  }
+  auto get_cpu = [](const auto& cpus, std::size_t i) {
+    return i < cpus.size() ? cpus[i] : -1;
+  };
+  // the first stream is served by the calling threads, which are pinned by their owner
+  for (std::size_t i = 1; i < streams_.size(); ++i) {
+    send_workers_.push_back(std::make_unique<StreamWorker>(fmt::format("send-stream-{}", i),
+                                                           get_cpu(options.send_cpus_, i)));
+    receive_workers_.push_back(std::make_unique<StreamWorker>(fmt::format("recv-stream-{}", i),
+                                                              get_cpu(options.receive_cpus_, i)));
   }
-  return result;
 }
 
-std::optional<std::vector<std::uint8_t>> TCPTransport::receive_message() {
-  std::array<std::uint8_t, sizeof(std::uint32_t)> message_size_buffer;
-  boost::system::error_code ec;
-  std::shared_lock lock(impl_->socket_mutex_);
-  impl_->socket_.wait(tcp::socket::wait_read, ec);
-  if (ec) {
-    throw std::runtime_error(
-        fmt::format("Error while wait read on socket: {} ({})", ec.message(), ec.value()));
+StripedTCPTransport::~StripedTCPTransport() = default;
+
+std::pair<std::size_t, std::size_t> StripedTCPTransport::get_stripe(std::size_t size,
+                                                                    std::size_t i) const {
+  const auto stripe_size = (size + streams_.size() - 1) / streams_.size();
+  const auto begin = std::min(size, i * stripe_size);
+  return {begin, std::min(size, begin + stripe_size) - begin};
+}
+
+void StripedTCPTransport::send_striped(const std::uint8_t* message, std::size_t size) {
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 1; i < streams_.size(); ++i) {
+    const auto [offset, length] = get_stripe(size, i);
+    futures.push_back(send_workers_[i - 1]->submit([this, i, data = message + offset, length] {
+      streams_[i]->write(boost::asio::buffer(data, length));
+    }));
   }
-  boost::asio::read(impl_->socket_, boost::asio::buffer(message_size_buffer),
-                    boost::asio::transfer_exactly(message_size_buffer.size()), ec);
-  if (ec) {
-    if (ec.value() == boost::asio::error::misc_errors::eof) {
-      // connection has been closed
-      return std::nullopt;
+  std::array<std::uint8_t, kMaxHeaderSize> header;
+  const auto header_size = encode_header(size, header.data());
+  const auto length = get_stripe(size, 0).second;
+  std::array<boost::asio::const_buffer, 2> buffers = {boost::asio::buffer(header, header_size),
+                                                      boost::asio::buffer(message, length)};
+  std::exception_ptr error;
+  try {
+    streams_[0]->write(buffers);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  join_stripes(futures, error);
+}
+
+void StripedTCPTransport::receive_striped(std::uint8_t* message, std::size_t size) {
+  std::vector<std::future<void>> futures;
+  for (std::size_t i = 1; i < streams_.size(); ++i) {
+    const auto [offset, length] = get_stripe(size, i);
+    futures.push_back(receive_workers_[i - 1]->submit([this, i, data = message + offset, length] {
+      streams_[i]->read_message_body(data, length);
+    }));
+  }
+  std::exception_ptr error;
+  try {
+    streams_[0]->read_message_body(message, get_stripe(size, 0).second);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  join_stripes(futures, error);
+}
+
+void StripedTCPTransport::send_message(std::vector<std::uint8_t>&& message) {
+  send_message(message.data(), message.size());
+}
+
+void StripedTCPTransport::send_message(const std::vector<std::uint8_t>& message) {
+  send_message(message.data(), message.size());
+}
+
+void StripedTCPTransport::send_message(const std::uint8_t* message, std::size_t size) {
+  send_messages({{message, size}});
+}
+
+void StripedTCPTransport::send_messages(const std::vector<MessageView>& messages) {
+  if (messages.empty()) {
+    return;
+  }
+  std::scoped_lock lock(send_mutex_);
+  std::vector<MessageView> small_messages;
+  std::size_t num_bytes = 0;
+  for (const auto& message : messages) {
+    if (message.second < stripe_threshold_ || streams_.size() == 1) {
+      small_messages.push_back(message);
+      continue;
     }
-    throw std::runtime_error(fmt::format("Error while reading message size from socket: {} ({})",
-                                         ec.message(), ec.value()));
+    // keep the order of the messages
+    if (!small_messages.empty()) {
+      num_bytes += streams_[0]->write_messages(small_messages, true);
+      small_messages.clear();
+    }
+    send_striped(message.first, message.second);
+    num_bytes += message.second + get_header_size(message.second);
   }
-  std::uint32_t message_size = u8tou32(message_size_buffer);
-  std::vector<std::uint8_t> message_buffer(message_size);
-  boost::asio::read(impl_->socket_, boost::asio::buffer(message_buffer),
-                    boost::asio::transfer_exactly(message_buffer.size()), ec);
-  if (ec) {
-    throw std::runtime_error(
-        fmt::format("Error while reading message size socket: {} ({})", ec.message(), ec.value()));
+  if (!small_messages.empty()) {
+    num_bytes += streams_[0]->write_messages(small_messages, true);
   }
-  statistics_.num_bytes_received += message_size + sizeof(uint32_t);
-  statistics_.num_messages_received += 1;
+  record_flush(messages.size(), num_bytes);
+}
+
+bool StripedTCPTransport::available() const { return streams_[0]->available(); }
+
+std::optional<std::vector<std::uint8_t>> StripedTCPTransport::receive_message() {
+  std::scoped_lock lock(receive_mutex_);
+  auto message_size = streams_[0]->read_message_size();
+  if (!message_size.has_value()) {
+    return std::nullopt;
+  }
+  std::vector<std::uint8_t> message_buffer(*message_size);
+  receive_message_body(message_buffer.data(), message_buffer.size());
   return message_buffer;
 }
 
+std::optional<ReceiveBuffer> StripedTCPTransport::receive_pooled_message(
+    const std::shared_ptr<ReceiveBufferPool>& pool) {
+  std::scoped_lock lock(receive_mutex_);
+  auto message_size = streams_[0]->read_message_size();
+  if (!message_size.has_value()) {
+    return std::nullopt;
+  }
+  ReceiveBuffer message_buffer(pool->acquire(*message_size), pool);
+  receive_message_body(message_buffer.data(), message_buffer.size());
+  return message_buffer;
+}
+
+void StripedTCPTransport::receive_message_body(std::uint8_t* message, std::size_t size) {
+  if (size < stripe_threshold_ || streams_.size() == 1) {
+    streams_[0]->read_message_body(message, size);
+  } else {
+    receive_striped(message, size);
+  }
+  statistics_.num_bytes_received += size + get_header_size(size);
+  statistics_.num_messages_received += 1;
+}
+
+void StripedTCPTransport::shutdown_send() {
+  for (auto& stream : streams_) {
+    boost::system::error_code ec;
+    stream->socket_.shutdown(tcp::socket::shutdown_send, ec);
+  }
+}
+
+void StripedTCPTransport::shutdown() {
+  for (auto& stream : streams_) {
+    boost::system::error_code ec;
+    stream->socket_.shutdown(tcp::socket::shutdown_both, ec);
+    stream->socket_.close(ec);
+  }
+}
+
 using namespace std::chrono_literals;
 
 struct TCPSetupHelper::TCPSetupImpl {
-  [[nodiscard]] std::map<std::size_t, tcp::socket> accept_task();
-  [[nodiscard]] tcp::socket connect_task(std::size_t other_id, std::string host,
-                                         std::uint16_t port);
+  // (party id, stream) -> socket
+  using socket_map = std::map<std::pair<std::size_t, std::size_t>, tcp::socket>;
+
+  [[nodiscard]] socket_map accept_task();
+  [[nodiscard]] tcp::socket connect_task(std::size_t other_id, std::size_t stream,
+                                         std::string host, std::uint16_t port);
 
   std::size_t my_id_;
   std::size_t num_parties_;
+  TCPSetupOptions options_;
   int num_connect_retries_ = 100; // Updated on 5/4/23
   decltype(1s) retry_delay_ = 3s;
   boost::asio::ip::address bind_address_;
   std::uint16_t bind_port_;
   std::shared_ptr<boost::asio::io_context> io_context_;
-  std::map<std::size_t, tcp::socket> sockets_;
+  socket_map sockets_;
 };
 
-TCPSetupHelper::TCPSetupHelper(std::size_t my_id, const tcp_parties_config& parties_config)
+TCPSetupHelper::TCPSetupHelper(std::size_t my_id, const tcp_parties_config& parties_config,
+                               const TCPSetupOptions& options)
     : my_id_(my_id),
       num_parties_(parties_config.size()),
       parties_config_(parties_config),
@@ -181,10 +610,14 @@ TCPSetupHelper::TCPSetupHelper(std::size_t my_id, const tcp_parties_config& part
   if (my_id_ >= num_parties_) {
     throw std::invalid_argument("specified invalid party id: my_id >= parties_config.size()");
   }
+  if (options.num_streams_ == 0) {
+    throw std::invalid_argument("specified invalid number of streams: 0");
+  }
   boost::system::error_code ec;
   auto my_config = parties_config_[my_id_];
   impl_->my_id_ = my_id_;
   impl_->num_parties_ = num_parties_;
+  impl_->options_ = options;
   impl_->bind_port_ = std::get<1>(my_config);
   impl_->bind_address_ = boost::asio::ip::make_address(std::get<0>(my_config), ec);
   if (ec) {
@@ -198,17 +631,24 @@ TCPSetupHelper::~TCPSetupHelper() = default;
 
 std::vector<std::unique_ptr<Transport>> TCPSetupHelper::setup_connections() {
   auto accept_fut = std::async(std::launch::async, [this] { return impl_->accept_task(); });
+  const auto num_streams = impl_->options_.num_streams_;
   std::vector<std::future<tcp::socket>> futs;
   for (std::size_t party_id = 0; party_id < my_id_; ++party_id) {
     auto party_config = parties_config_.at(party_id);
-    futs.emplace_back(std::async(std::launch::async, [this, party_id, party_config] {
-      return impl_->connect_task(party_id, std::get<0>(party_config), std::get<1>(party_config));
-    }));
+    for (std::size_t stream = 0; stream < num_streams; ++stream) {
+      futs.emplace_back(std::async(std::launch::async, [this, party_id, stream, party_config] {
+        return impl_->connect_task(party_id, stream, std::get<0>(party_config),
+                                   std::get<1>(party_config));
+      }));
+    }
   }
   try {
     impl_->sockets_ = accept_fut.get();
     for (std::size_t party_id = 0; party_id < my_id_; ++party_id) {
-      impl_->sockets_.emplace(party_id, futs.at(party_id).get());
+      for (std::size_t stream = 0; stream < num_streams; ++stream) {
+        impl_->sockets_.emplace(std::make_pair(party_id, stream),
+                                futs.at(party_id * num_streams + stream).get());
+      }
     }
   } catch (std::runtime_error& e) {
     // an error happened => close all other sockets
@@ -225,21 +665,33 @@ std::vector<std::unique_ptr<Transport>> TCPSetupHelper::setup_connections() {
   }
 
   std::vector<std::unique_ptr<Transport>> result(num_parties_);
-  std::for_each(std::begin(impl_->sockets_), std::end(impl_->sockets_), [this, &result](auto& it) {
-    auto transport_impl =
-        std::make_unique<detail::TCPTransportImpl>(impl_->io_context_, std::move(it.second));
-    result.at(it.first) = std::make_unique<TCPTransport>(std::move(transport_impl));
-  });
+  for (std::size_t party_id = 0; party_id < num_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    std::vector<std::unique_ptr<detail::TCPTransportImpl>> streams;
+    for (std::size_t stream = 0; stream < num_streams; ++stream) {
+      streams.push_back(std::make_unique<detail::TCPTransportImpl>(
+          impl_->io_context_, std::move(impl_->sockets_.at({party_id, stream}))));
+    }
+    if (num_streams == 1) {
+      result.at(party_id) = std::make_unique<TCPTransport>(std::move(streams.front()));
+    } else {
+      result.at(party_id) =
+          std::make_unique<StripedTCPTransport>(std::move(streams), impl_->options_);
+    }
+  }
+  impl_->sockets_.clear();
   return result;
 }
 
-std::map<std::size_t, tcp::socket> TCPSetupHelper::TCPSetupImpl::accept_task() {
+TCPSetupHelper::TCPSetupImpl::socket_map TCPSetupHelper::TCPSetupImpl::accept_task() {
   if (my_id_ == num_parties_ - 1) {
     return {};
   }
-  std::map<std::size_t, tcp::socket> sockets;
+  socket_map sockets;
   std::size_t num_accepted = 0;
-  std::size_t expected_connections = num_parties_ - my_id_ - 1;
+  std::size_t expected_connections = (num_parties_ - my_id_ - 1) * options_.num_streams_;
   boost::system::error_code ec;
   tcp::acceptor acceptor(*io_context_, tcp::endpoint(bind_address_, bind_port_),
                          /* reuse_addr = */ true);
@@ -254,7 +706,8 @@ std::map<std::size_t, tcp::socket> TCPSetupHelper::TCPSetupImpl::accept_task() {
       throw std::runtime_error(fmt::format("error occurred on accept: {}\n", ec.message()));
     }
     std::size_t other_id;
-    // receive other id
+    std::size_t stream;
+    // receive other id, the upper half contains the index of the stream
     {
       std::uint64_t received_id;
       boost::asio::read(socket, boost::asio::mutable_buffer(&received_id, sizeof(received_id)), ec);
@@ -262,16 +715,17 @@ std::map<std::size_t, tcp::socket> TCPSetupHelper::TCPSetupImpl::accept_task() {
         socket.close();
         continue;
       }
-      other_id = static_cast<std::size_t>(received_id);
+      other_id = static_cast<std::size_t>(received_id & 0xffffffff);
+      stream = static_cast<std::size_t>(received_id >> 32);
     }
     // validate received id
-    if (other_id <= my_id_ || other_id >= num_parties_) {
+    if (other_id <= my_id_ || other_id >= num_parties_ || stream >= options_.num_streams_) {
       // invalid_id
       socket.close();
       continue;
     }
     // check if we are already connected to this party
-    if (auto it = sockets.find(static_cast<std::size_t>(other_id)); it != sockets.end()) {
+    if (auto it = sockets.find({other_id, stream}); it != sockets.end()) {
       socket.close();
       continue;
     }
@@ -285,14 +739,14 @@ std::map<std::size_t, tcp::socket> TCPSetupHelper::TCPSetupImpl::accept_task() {
       }
     }
     // success
-    sockets.emplace(std::make_pair(other_id, std::move(socket)));
+    sockets.emplace(std::make_pair(other_id, stream), std::move(socket));
     ++num_accepted;
   }
   return sockets;
 }
 
-tcp::socket TCPSetupHelper::TCPSetupImpl::connect_task(std::size_t other_id, std::string host,
-                                                       std::uint16_t port) {
+tcp::socket TCPSetupHelper::TCPSetupImpl::connect_task(std::size_t other_id, std::size_t stream,
+                                                       std::string host, std::uint16_t port) {
   boost::system::error_code ec;
   tcp::socket socket(*io_context_);
   tcp::resolver resolver(*io_context_);
@@ -310,7 +764,7 @@ tcp::socket TCPSetupHelper::TCPSetupImpl::connect_task(std::size_t other_id, std
 
     // send my id to the peer
     {
-      std::uint64_t own_id = static_cast<std::uint64_t>(my_id_);
+      std::uint64_t own_id = static_cast<std::uint64_t>(my_id_) | (std::uint64_t(stream) << 32);
       boost::asio::write(socket, boost::asio::const_buffer(&own_id, sizeof(own_id)), ec);
       if (ec) {
         socket.close();
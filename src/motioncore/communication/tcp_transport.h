@@ -24,6 +24,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string_view>
 #include <vector>
 
@@ -46,20 +47,93 @@ class TCPTransport : public Transport {
   void send_message(std::vector<std::uint8_t>&& message) override;
   void send_message(const std::vector<std::uint8_t>& message) override;
   void send_message(const std::uint8_t* message, std::size_t size) override;
+  // frames all messages into a single vectored write
+  void send_messages(const std::vector<MessageView>& messages) override;
+
+  // disable Nagle's algorithm (default: true), since messages are already coalesced
+  void set_no_delay(bool no_delay);
+  // hold back partial segments while a flush needs several system calls (Linux only,
+  // default: true)
+  void set_cork_flushes(bool cork_flushes);
 
   bool available() const override;
   std::optional<std::vector<std::uint8_t>> receive_message() override;
+  std::optional<ReceiveBuffer> receive_pooled_message(
+      const std::shared_ptr<ReceiveBufferPool>& pool) override;
   void shutdown_send() override;
   void shutdown() override;
 
  private:
   bool is_connected_;
+  bool cork_flushes_ = true;
   std::unique_ptr<detail::TCPTransportImpl> impl_;
 };
 
 using tcp_connection_config = std::pair<std::string, std::uint16_t>;
 using tcp_parties_config = std::vector<tcp_connection_config>;
 
+// Options for the connections created by TCPSetupHelper, which have to be the
+// same for all parties.
+struct TCPSetupOptions {
+  // number of parallel connections per pair of parties, with more than one
+  // StripedTCPTransports are created
+  std::size_t num_streams_ = 1;
+  // messages of at least this size are split across all streams
+  std::size_t stripe_threshold_ = 1 << 20;
+  // CPUs to pin the send and receive threads of stream i to (-1 or missing: no pinning);
+  // stream 0 is served by the threads of the CommunicationLayer, which pins them
+  // via Transport::get_send_cpu/get_receive_cpu
+  std::vector<int> send_cpus_;
+  std::vector<int> receive_cpus_;
+};
+
+// Transport over several TCP connections to the same party.  Small messages
+// are sent over the first connection, large messages are split into one
+// stripe per connection which are sent and received in parallel.
+class StripedTCPTransport : public Transport {
+ public:
+  StripedTCPTransport(std::vector<std::unique_ptr<detail::TCPTransportImpl>>&& streams,
+                      const TCPSetupOptions& options);
+  ~StripedTCPTransport();
+
+  void send_message(std::vector<std::uint8_t>&& message) override;
+  void send_message(const std::vector<std::uint8_t>& message) override;
+  void send_message(const std::uint8_t* message, std::size_t size) override;
+  void send_messages(const std::vector<MessageView>& messages) override;
+
+  bool available() const override;
+  std::optional<std::vector<std::uint8_t>> receive_message() override;
+  std::optional<ReceiveBuffer> receive_pooled_message(
+      const std::shared_ptr<ReceiveBufferPool>& pool) override;
+  void shutdown_send() override;
+  void shutdown() override;
+
+  int get_send_cpu() const noexcept override { return send_cpu_; }
+  int get_receive_cpu() const noexcept override { return receive_cpu_; }
+
+  std::size_t get_num_streams() const noexcept { return streams_.size(); }
+
+ private:
+  class StreamWorker;
+
+  // (offset, size) of the i-th stripe of a message
+  std::pair<std::size_t, std::size_t> get_stripe(std::size_t size, std::size_t i) const;
+  void send_striped(const std::uint8_t* message, std::size_t size);
+  void receive_striped(std::uint8_t* message, std::size_t size);
+  void receive_message_body(std::uint8_t* message, std::size_t size);
+
+  const std::size_t stripe_threshold_;
+  // CPUs for the threads serving stream 0
+  const int send_cpu_;
+  const int receive_cpu_;
+  std::vector<std::unique_ptr<detail::TCPTransportImpl>> streams_;
+  std::mutex send_mutex_;
+  std::mutex receive_mutex_;
+  // workers for the streams 1, ..., n - 1
+  std::vector<std::unique_ptr<StreamWorker>> send_workers_;
+  std::vector<std::unique_ptr<StreamWorker>> receive_workers_;
+};
+
 // Helper class to establish point-to-point TCP connections among a set of
 // parties.  Given the ID of the local party and a collection of host and port
 // for all parties, connections are created as follows: This party tries to
@@ -67,7 +141,8 @@ using tcp_parties_config = std::vector<tcp_connection_config>;
 // parties with larger IDs.
 class TCPSetupHelper {
  public:
-  TCPSetupHelper(std::size_t my_id, const tcp_parties_config& parties_config);
+  TCPSetupHelper(std::size_t my_id, const tcp_parties_config& parties_config,
+                 const TCPSetupOptions& options = {});
 
   // Destructor needs to be defined in implementation due to pimpl
   ~TCPSetupHelper();
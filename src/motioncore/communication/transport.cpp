@@ -22,8 +22,25 @@
 
 #include "transport.h"
 
+#include <algorithm>
+
 namespace MOTION::Communication {
 
+void Transport::send_messages(const std::vector<MessageView>& messages) {
+  for (const auto& [message, size] : messages) {
+    send_message(message, size);
+  }
+}
+
+std::optional<ReceiveBuffer> Transport::receive_pooled_message(
+    const std::shared_ptr<ReceiveBufferPool>& pool) {
+  auto message = receive_message();
+  if (!message.has_value()) {
+    return std::nullopt;
+  }
+  return ReceiveBuffer(std::move(*message), pool);
+}
+
 const TransportStatistics& Transport::get_stats() const { return statistics_; }
 
 void Transport::reset_stats() {
@@ -31,6 +48,17 @@ void Transport::reset_stats() {
   statistics_.num_messages_received = 0;
   statistics_.num_bytes_sent = 0;
   statistics_.num_bytes_received = 0;
+  statistics_.num_flushes = 0;
+  statistics_.max_messages_per_flush = 0;
+  statistics_.max_bytes_per_flush = 0;
+}
+
+void Transport::record_flush(std::size_t num_messages, std::size_t num_bytes) {
+  statistics_.num_messages_sent += num_messages;
+  statistics_.num_bytes_sent += num_bytes;
+  statistics_.num_flushes += 1;
+  statistics_.max_messages_per_flush = std::max(statistics_.max_messages_per_flush, num_messages);
+  statistics_.max_bytes_per_flush = std::max(statistics_.max_bytes_per_flush, num_bytes);
 }
 
 }  // namespace MOTION::Communication
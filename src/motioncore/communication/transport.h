@@ -23,10 +23,15 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
+#include <memory>
 #include <optional>
 #include <stdexcept>
+#include <utility>
 #include <vector>
 
+#include "receive_buffer_pool.h"
+
 namespace MOTION::Communication {
 
 struct TransportStatistics {
@@ -34,8 +39,15 @@ struct TransportStatistics {
   std::size_t num_messages_received = 0;
   std::size_t num_bytes_sent = 0;
   std::size_t num_bytes_received = 0;
+  // number of writes to the underlying transport, each carrying one or more messages
+  std::size_t num_flushes = 0;
+  std::size_t max_messages_per_flush = 0;
+  std::size_t max_bytes_per_flush = 0;
 };
 
+// pointer and size of a message which is not owned
+using MessageView = std::pair<const std::uint8_t*, std::size_t>;
+
 // underlying transport between two parties
 // e.g. a TCP/QUIC/.. connection, or a pair of local queues
 class Transport {
@@ -52,11 +64,17 @@ class Transport {
   virtual void send_message(const std::vector<std::uint8_t>& message) = 0;
   virtual void send_message(const std::uint8_t* message, std::size_t size) = 0;
 
+  // send several messages at once, by default one after another
+  virtual void send_messages(const std::vector<MessageView>& messages);
+
   // check if a new message is available
   virtual bool available() const = 0;
 
   // receive message, possibly blocking
   virtual std::optional<std::vector<std::uint8_t>> receive_message() = 0;
+  // receive message into a buffer from the pool, by default using receive_message()
+  virtual std::optional<ReceiveBuffer> receive_pooled_message(
+      const std::shared_ptr<ReceiveBufferPool>& pool);
 
   // shutdown the outgoing part of the transport to signal end of communication
   virtual void shutdown_send() = 0;
@@ -64,10 +82,17 @@ class Transport {
   // shutdown this transport
   virtual void shutdown() = 0;
 
+  // CPUs the threads calling the send and receive functions should be pinned
+  // to (-1: no pinning)
+  virtual int get_send_cpu() const noexcept { return -1; }
+  virtual int get_receive_cpu() const noexcept { return -1; }
+
   const TransportStatistics& get_stats() const;
   void reset_stats();
 
  protected:
+  void record_flush(std::size_t num_messages, std::size_t num_bytes);
+
   TransportStatistics statistics_;
 };
 
@@ -1,4 +1,6 @@
 #include "compute_server.h"
+#include "share_ingestion_server.h"
+#include <algorithm>
 #include <boost/asio.hpp>
 #include <iostream>
 
@@ -10,6 +12,19 @@ using std::string;
 
 namespace COMPUTE_SERVER {
 
+namespace {
+
+std::vector<Shares> to_shares(const ReceivedTensor& tensor) {
+  std::vector<Shares> data(tensor.public_shares_.size());
+  for (std::size_t i = 0; i < data.size(); ++i) {
+    data[i].Delta = tensor.public_shares_[i];
+    data[i].delta = tensor.secret_shares_[i];
+  }
+  return data;
+}
+
+}  // namespace
+
 string read_(tcp::socket& socket) {
   boost::asio::streambuf buf;
 
@@ -24,36 +39,19 @@ void send_(tcp::socket& socket, const string& message) {
 }
 
 std::vector<std::pair<uint64_t, uint64_t>> get_provider_data(int port_number) {
-  int count = 0;
+  ShareIngestionServer server(port_number, 2, false, UploadFormat::pair);
+  std::vector<ReceivedUpload> uploads;
+  for (int count = 0; count < 2; ++count) {
+    uploads.push_back(server.receive_upload());
+  }
+  // both providers are received concurrently, so restore the order in which they connected
+  std::sort(uploads.begin(), uploads.end(), [](const auto& a, const auto& b) {
+    return a.sequence_number_ < b.sequence_number_;
+  });
   std::vector<std::pair<uint64_t, uint64_t>> ret;
-  while (count < 2) {
-    boost::asio::io_service io_service;
-
-    // listen for new connection
-    tcp::acceptor acceptor_(io_service, tcp::endpoint(tcp::v4(), port_number));
-
-    // socket creation
-    tcp::socket socket_(io_service);
-
-    // waiting for the connection
-    acceptor_.accept(socket_);
-
-    // read operation
-    boost::system::error_code ec;
-    Shares data;
-    read(socket_, buffer(&data, sizeof(data)), ec);
-    // string message = read_(socket_);
-    cout << data.Delta << endl;
-
-    // write operation
-    send_(socket_, "Hello From Server!");
-
-    socket_.close();
-
-    ret.push_back(std::make_pair(data.Delta, data.delta));
-
-    count += 1;
-    cout << count << endl;
+  for (const auto& upload : uploads) {
+    const auto& tensor = upload.tensors_.at(0);
+    ret.push_back(std::make_pair(tensor.public_shares_[0], tensor.secret_shares_[0]));
   }
   return ret;
 }
@@ -79,17 +77,11 @@ std::vector<std::pair<uint64_t, uint64_t>> get_provider_data(int port_number) {
 
 std::vector<Shares> read_struct(tcp::socket& socket, int num_elements) {
   cout << "Before reading of data\n";
-  std::vector<Shares> data;
-  for (int i = 0; i < num_elements; i++) {
-    boost::system::error_code ec;
-    uint64_t arr[2];
-    read(socket, boost::asio::buffer(&arr, sizeof(arr)), ec);
-    Shares temp;
-    temp.Delta = arr[0];
-    // std::cout << temp.Delta << " ";
-    temp.delta = arr[1];
-    // std::cout << temp.delta << "\n";
-    data.push_back(temp);
+  std::vector<Shares> data(num_elements);
+  boost::system::error_code ec;
+  read(socket, boost::asio::buffer(data), ec);
+  if (ec) {
+    std::cout << "Error:" << ec.message() << "\n";
   }
 
   socket.close();
@@ -98,73 +90,39 @@ std::vector<Shares> read_struct(tcp::socket& socket, int num_elements) {
 
 std::vector<Shares> read_struct_vector(tcp::socket& socket, int num_elements) {
   std::cout << "Before reading of data\n";
-  std::vector<Shares> data;
+  // Shares has the layout of the (Delta, delta) pairs on the wire
+  std::vector<Shares> data(num_elements);
   boost::system::error_code ec;
-  uint64_t arr[2 * num_elements];
-  read(socket, boost::asio::buffer(&arr, sizeof(arr)), ec);
+  read(socket, boost::asio::buffer(data), ec);
   if (ec) {
     std::cout << "Error:" << ec.message() << "\n";
   } else {
     cout << "Received successfully \n";
   }
-  int j = 0;
-  cout << "Num element\n";
-  for (int i = 0; i < num_elements; i++) {
-    Shares temp;
-    temp.Delta = arr[j];
-    // std::cout << temp.Delta << " ";
-    j++;
-    temp.delta = arr[j];
-    j++;
-    // std::cout << temp.delta << "\n";
-    data.push_back(temp);
-  }
 
   // socket.close();
   return data;
 }
 
-std::pair<std::vector<Shares>, int> get_provider_dot_product_data(int port_number) {
-  boost::asio::io_service io_service;
-
-  // listen for new connection
-  tcp::acceptor acceptor_(io_service, tcp::endpoint(tcp::v4(), port_number));
-
-  // socket creation
-  tcp::socket socket_(io_service);
-
-  // waiting for the connection
-  acceptor_.accept(socket_);
-
-  // read operation
-  boost::system::error_code ec;
-  int num_elements;
-  read(socket_, boost::asio::buffer(&num_elements, sizeof(num_elements)), ec);
-  if (ec) {
-    cout << ec << "\n";
-  } else {
-    cout << "No Error\n";
-  }
-  // string message = read_(socket_);
-  cout << "The number of elements are :- " << num_elements << endl;
-
-  // write operation
-  const string msg = "Server has received the number of elements \n";
-  boost::asio::write(socket_, boost::asio::buffer(msg));
-  cout << "server sent message to Client!" << endl;
-
-  // Read the data in the reuired format
-  std::vector<Shares> data = read_struct(socket_, num_elements);
-
-  socket_.close();
+Seed sample_seed() {
+  Seed seed;
+  AES128_CTR_RNG::get_thread_instance().random_bytes(seed.data(), seed.size());
+  return seed;
+}
 
-  for (int i = 0; i < num_elements; i++) {
-    std::cout << data[i].Delta << "  " << data[i].delta << " ";
-    std::cout << "\n\n";
-  }
-  std::cout << "Finished reading input \n\n";
+std::vector<uint64_t> expand_seed(const Seed& seed, std::size_t num_elements) {
+  std::vector<uint64_t> data(num_elements);
+  AES128_CTR_RNG rng;
+  rng.set_key(seed.data());
+  rng.random_bytes(reinterpret_cast<std::byte*>(data.data()), num_elements * sizeof(uint64_t));
+  return data;
+}
 
-  return std::make_pair(data, num_elements);
+std::pair<std::vector<Shares>, int> get_provider_dot_product_data(int port_number) {
+  ShareIngestionServer server(port_number, 1, false, UploadFormat::vector);
+  const auto upload = server.receive_upload();
+  const auto& tensor = upload.tensors_.at(0);
+  return std::make_pair(to_shares(tensor), int(tensor.rows_));
 }
 
 /////////////////New function
@@ -206,59 +164,12 @@ int get_actual_answer(int port_number) {
 //////////////// New function end ///////////////////////////////////
 
 std::pair<std::size_t, std::pair<std::vector<Shares>, std::vector<int>>> get_provider_mat_mul_data(
-    int port_number) {
-  boost::asio::io_service io_service;
-
-  // listen for new connection
-  tcp::acceptor acceptor_(io_service, tcp::endpoint(tcp::v4(), port_number));
-
-  // socket creation
-  tcp::socket socket_(io_service);
-
-  // waiting for the connection
-  acceptor_.accept(socket_);
-
-  // Read and write the number of fractional bits
-  boost::system::error_code ec;
-  size_t fractional_bits;
-  read(socket_, boost::asio::buffer(&fractional_bits, sizeof(fractional_bits)), ec);
-  if (ec) {
-    cout << ec << "\n";
-  } else {
-    cout << "No Error\n";
-  }
-
-  const string msg_init = "Server has received the number of fractional bits \n";
-  boost::asio::write(socket_, boost::asio::buffer(msg_init));
-  cout << "server sent message to Client!" << endl;
-
-  // read operation
-  int arr[2];
-  read(socket_, boost::asio::buffer(&arr, sizeof(arr)), ec);
-  std::cout << arr[0] << "\t" << arr[1] << std::endl;
-  if (ec) {
-    cout << ec << "\n";
-  } else {
-    cout << "No Error\n";
-  }
-  std::vector<int> dims;
-  dims.push_back(arr[0]);
-  dims.push_back(arr[1]);
-  int num_elements = arr[0] * arr[1];
-
-  cout << "The number of elements are :- " << num_elements << endl;
-
-  // write operation
-  const string msg = "Server has received the number of elements \n";
-  boost::asio::write(socket_, boost::asio::buffer(msg));
-  cout << "server sent message to Client!" << endl;
-
-  // Read the data in the reuired format
-  std::vector<Shares> data = read_struct(socket_, num_elements);
-
-  std::cout << "Finished reading input \n\n";
-
-  return std::make_pair(fractional_bits, std::make_pair(data, dims));
+    int port_number, bool seed_compressed) {
+  ShareIngestionServer server(port_number, 1, seed_compressed);
+  const auto upload = server.receive_upload();
+  const auto& tensor = upload.tensors_.at(0);
+  std::vector<int> dims = {int(tensor.rows_), int(tensor.cols_)};
+  return std::make_pair(upload.fractional_bits_, std::make_pair(to_shares(tensor), dims));
 }
 
 // std::tuple<int, std::size_t, std::pair<std::vector<Shares>, std::vector<int>>>
@@ -565,87 +476,17 @@ get_provider_mat_mul_const_data(int port_number) {
 //////////////////Function to receive all vectors one shot, Ramya may 3,2023
 std::tuple<int, std::size_t,
            std::pair<std::vector<std::vector<Shares>>, std::vector<std::pair<int, int>>>>
-get_provider_total_data_genr(int port_number) {
-  // cout << "Inside new function \n";
-  boost::asio::io_service io_service;
-
-  // listen for new connection
-  tcp::acceptor acceptor_(io_service, tcp::endpoint(tcp::v4(), port_number));
-
-  // socket creation
-  tcp::socket socket_(io_service);
-
-  // waiting for the connection
-  acceptor_.accept(socket_);
-  boost::system::error_code ec;
-  size_t fractional_bits;
-  int numberOfLayers;
-  const string msg_layer = "Server has received the number of layers expected \n";
-  const string msg_init = "Server has received the number of fractional bits \n";
-  const string msg = "Server has received the number of elements \n";
-  /////////Receiving number of layers to be expected
-  read(socket_, boost::asio::buffer(&numberOfLayers, sizeof(numberOfLayers)), ec);
-  if (ec) {
-    cout << ec << "\n";
-  } else {
-    cout << "No Error. Number of layers: " << numberOfLayers << "\n";
-  }
-
-  boost::asio::write(socket_, boost::asio::buffer(msg_layer));
-  cout << "Server received the number of layers!" << endl;
-
-  ///////////
-
-  // Read and write the number of fractional bits
-  read(socket_, boost::asio::buffer(&fractional_bits, sizeof(fractional_bits)), ec);
-  if (ec) {
-    cout << ec << "\n";
-  } else {
-    cout << "No Error. Number of franctional bits: " << fractional_bits << "\n";
-  }
-
-  boost::asio::write(socket_, boost::asio::buffer(msg_init));
-  cout << "Server sent ack message to Client!" << endl;
-  std::vector<std::pair<int, int>> dims_of_all_shares;
-  std::pair<int, int> dims;
-  int num_elements1;
+get_provider_total_data_genr(int port_number, bool seed_compressed) {
+  ShareIngestionServer server(port_number, 1, seed_compressed, UploadFormat::model);
+  const auto upload = server.receive_upload();
   std::vector<std::vector<Shares>> data;
-  const string msg_data = "Server has received the data.\n";
-  //////////////////////////////// Repeatedly use the following////////////////
-  // read operation
-  for (int i = 0; i < 2*numberOfLayers; i++) {
-    read(socket_, boost::asio::buffer(&dims, sizeof(dims)), ec);
-    if (ec) {
-      cout << ec << "\n";
-    } else {
-      cout << "No Error\n";
-    }
-    std::cout << "Before dims push back \n";
-    dims_of_all_shares.push_back(dims);
-    // dims1.push_back(arr1[1]);
-    std::cout << "After dims push back \n";
-    num_elements1 = dims.first * dims.second;
-    cout << "Rows, columns: " << dims.first << " " << dims.second << endl;
-    cout << "The number of elements are :- " << num_elements1 << endl;
-
-    // write operation
-    boost::asio::write(socket_, boost::asio::buffer(msg));
-    cout << "Server sent message to Client!" << endl;
-
-    // Read the data in the required format
-    cout << "Before read struct vector " << endl;
-    data.push_back(read_struct_vector(socket_, num_elements1));
-    boost::asio::write(socket_, boost::asio::buffer(msg_data));
-    // cout << "Servent sent w1 to Client!" << endl;
-    std::cout << "Finished reading input W1\n";
-  }
-  socket_.close();
-  int i = 1;
-  for(auto iter : dims_of_all_shares) {
-    cout << "Dims " << i << ": " << iter.first << " " << iter.second << endl;
-    i++;  
+  std::vector<std::pair<int, int>> dims_of_all_shares;
+  for (const auto& tensor : upload.tensors_) {
+    data.push_back(to_shares(tensor));
+    dims_of_all_shares.emplace_back(tensor.rows_, tensor.cols_);
   }
-  return {numberOfLayers, fractional_bits, std::make_pair(data, dims_of_all_shares)};
+  const int numberOfLayers = upload.tensors_.size() / 2;
+  return {numberOfLayers, upload.fractional_bits_, std::make_pair(data, dims_of_all_shares)};
 }
 
 }  // namespace COMPUTE_SERVER
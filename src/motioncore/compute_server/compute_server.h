@@ -1,6 +1,9 @@
 #pragma once
+#include <array>
+#include <cstddef>
 #include <boost/asio.hpp>
 #include "compute_server.h"
+#include "crypto/random/aes128_ctr_rng.h"
 
 using namespace boost::asio;
 using ip::tcp;
@@ -10,14 +13,26 @@ namespace COMPUTE_SERVER {
 struct Shares {
   uint64_t Delta, delta;
 };
+static_assert(sizeof(Shares) == 2 * sizeof(uint64_t));
+
+// In the seed compressed format a provider sends a tensor as the seed of the
+// receiving server followed by the public shares (Delta).  The secret shares
+// (delta) are the first elements of the AES-CTR stream keyed with the seed.
+using Seed = std::array<std::byte, AES128_CTR_RNG::key_size>;
+Seed sample_seed();
+std::vector<uint64_t> expand_seed(const Seed& seed, std::size_t num_elements);
 string read_(tcp::socket& socket);
 void send_(tcp::socket& socket, const string& message);
 std::vector<Shares> read_struct(tcp::socket& socket, int num_elements);
 std::vector<Shares> read_struct_vector(tcp::socket& socket, int num_elements);
+// The following receive the uploads of the data providers with a
+// ShareIngestionServer and throw std::runtime_error if a connection fails.
+// get_provider_data returns the pairs of both providers in the order in which
+// they connected.
 std::vector<std::pair<uint64_t, uint64_t>> get_provider_data(int port_number);
 std::pair<std::vector<Shares>, int> get_provider_dot_product_data(int port_number);
 std::pair<std::size_t, std::pair<std::vector<Shares>, std::vector<int>>> get_provider_mat_mul_data(
-    int port_number);
+    int port_number, bool seed_compressed = false);
 std::tuple<int, std::size_t, std::pair<std::vector<Shares>, std::vector<int>>>
     get_provider_mat_mul_data_new(int port_number);
 std::tuple<int, std::size_t,
@@ -27,5 +42,5 @@ std::pair<std::size_t, std::pair<std::vector<Shares>, std::vector<int>>>
     get_provider_mat_mul_const_data(int port_number);
 std::tuple<int, std::size_t,
            std::pair<std::vector<std::vector<Shares>>, std::vector<std::pair<int, int>>>>
-    get_provider_total_data_genr(int port_number);
+    get_provider_total_data_genr(int port_number, bool seed_compressed = false);
 }  // namespace COMPUTE_SERVER
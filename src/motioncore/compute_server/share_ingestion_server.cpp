@@ -0,0 +1,410 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "share_ingestion_server.h"
+
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include <fmt/format.h>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/system/error_code.hpp>
+
+#include "compute_server.h"
+
+namespace COMPUTE_SERVER {
+
+namespace {
+
+// number of (Delta, delta) pairs which are read at once
+constexpr std::size_t kChunkSize = 1 << 13;
+// reject dimensions which would not fit into memory anyway
+constexpr std::size_t kMaxNumElements = std::size_t(1) << 32;
+constexpr int kMaxNumLayers = 1 << 16;
+
+const std::string kNumLayersAck = "Server has received the number of layers expected \n";
+const std::string kFractionalBitsAck = "Server has received the number of fractional bits \n";
+const std::string kDimensionsAck = "Server has received the number of elements \n";
+const std::string kDataAck = "Server has received the data.\n";
+const std::string kPairAck = "Hello From Server!\n";
+
+}  // namespace
+
+class ShareIngestionServer::Session : public std::enable_shared_from_this<Session> {
+ public:
+  Session(ShareIngestionServer& server, boost::asio::ip::tcp::socket&& socket,
+          std::size_t sequence_number)
+      : server_(server), socket_(std::move(socket)) {
+    upload_.sequence_number_ = sequence_number;
+  }
+
+  void start() {
+    switch (server_.format_) {
+      case UploadFormat::matrix:
+        return read_fractional_bits();
+      case UploadFormat::vector:
+        return read_num_elements();
+      case UploadFormat::pair:
+        return begin_tensor(1, 1);
+      case UploadFormat::model:
+        return read_num_layers();
+    }
+  }
+
+ private:
+  void read_num_layers() {
+    boost::asio::async_read(
+        socket_, boost::asio::buffer(&header_, sizeof(header_)),
+        [self = shared_from_this()](auto ec, auto) {
+          if (ec) {
+            return self->fail("reading the number of layers", ec);
+          }
+          if (self->header_ <= 0 || self->header_ > kMaxNumLayers) {
+            return self->fail(fmt::format("invalid number of layers {}", self->header_));
+          }
+          // a weight and a bias matrix per layer
+          self->num_tensors_ = 2 * std::size_t(self->header_);
+          self->write_ack(kNumLayersAck, [self] { self->read_fractional_bits(); });
+        });
+  }
+
+  void read_fractional_bits() {
+    boost::asio::async_read(
+        socket_, boost::asio::buffer(&upload_.fractional_bits_, sizeof(upload_.fractional_bits_)),
+        [self = shared_from_this()](auto ec, auto) {
+          if (ec) {
+            return self->fail("reading the fractional bits", ec);
+          }
+          self->write_ack(kFractionalBitsAck, [self] { self->read_dimensions(); });
+        });
+  }
+
+  void read_dimensions() {
+    boost::asio::async_read(
+        socket_, boost::asio::buffer(dimensions_), [self = shared_from_this()](auto ec, auto) {
+          if (ec) {
+            return self->fail("reading the dimensions", ec);
+          }
+          const auto [rows, cols] = self->dimensions_;
+          if (rows <= 0 || cols <= 0 ||
+              std::size_t(rows) * std::size_t(cols) > kMaxNumElements) {
+            return self->fail(fmt::format("invalid dimensions {}x{}", rows, cols));
+          }
+          self->begin_tensor(rows, cols);
+        });
+  }
+
+  void read_num_elements() {
+    boost::asio::async_read(
+        socket_, boost::asio::buffer(&header_, sizeof(header_)),
+        [self = shared_from_this()](auto ec, auto) {
+          if (ec) {
+            return self->fail("reading the number of elements", ec);
+          }
+          if (self->header_ <= 0) {
+            return self->fail(fmt::format("invalid number of elements {}", self->header_));
+          }
+          self->begin_tensor(self->header_, 1);
+        });
+  }
+
+  // Allocates the next tensor, acknowledges its size and reads its shares.
+  // The provider is only acknowledged once there is room for its upload.
+  void begin_tensor(std::size_t rows, std::size_t cols) {
+    if (!has_slot_) {
+      return server_.acquire_slot([self = shared_from_this(), rows, cols] {
+        self->has_slot_ = true;
+        self->begin_tensor(rows, cols);
+      });
+    }
+    auto& tensor = upload_.tensors_.emplace_back();
+    tensor.rows_ = rows;
+    tensor.cols_ = cols;
+    tensor.public_shares_.resize(rows * cols);
+    tensor.secret_shares_.resize(rows * cols);
+    offset_ = 0;
+    if (server_.format_ == UploadFormat::pair) {
+      return read_shares();
+    }
+    write_ack(kDimensionsAck, [self = shared_from_this()] { self->read_shares(); });
+  }
+
+  void read_shares() {
+    if (server_.seed_compressed_) {
+      return read_seed_compressed_shares();
+    }
+    const auto num_elements = upload_.tensors_.back().public_shares_.size();
+    buffer_.resize(2 * std::min(kChunkSize, num_elements));
+    read_chunk();
+  }
+
+  // Reads the next chunk of interleaved (Delta, delta) pairs and scatters it
+  // into the share buffers.
+  void read_chunk() {
+    const auto num_elements = upload_.tensors_.back().public_shares_.size();
+    if (offset_ == num_elements) {
+      return end_tensor();
+    }
+    const auto chunk_size = std::min(kChunkSize, num_elements - offset_);
+    boost::asio::async_read(
+        socket_, boost::asio::buffer(buffer_.data(), 2 * chunk_size * sizeof(std::uint64_t)),
+        [self = shared_from_this(), chunk_size](auto ec, auto) {
+          if (ec) {
+            return self->fail("reading the shares", ec);
+          }
+          auto& tensor = self->upload_.tensors_.back();
+          auto* Delta = tensor.public_shares_.data() + self->offset_;
+          auto* delta = tensor.secret_shares_.data() + self->offset_;
+          for (std::size_t i = 0; i < chunk_size; ++i) {
+            Delta[i] = self->buffer_[2 * i];
+            delta[i] = self->buffer_[2 * i + 1];
+          }
+          self->offset_ += chunk_size;
+          self->read_chunk();
+        });
+  }
+
+  // The public shares are read directly into the tensor, the secret shares are
+  // expanded from the seed.
+  void read_seed_compressed_shares() {
+    auto& tensor = upload_.tensors_.back();
+    std::array<boost::asio::mutable_buffer, 2> buffers = {
+        boost::asio::buffer(seed_),
+        boost::asio::buffer(tensor.public_shares_.data(),
+                            tensor.public_shares_.size() * sizeof(std::uint64_t))};
+    boost::asio::async_read(socket_, buffers, [self = shared_from_this()](auto ec, auto) {
+      if (ec) {
+        return self->fail("reading the shares", ec);
+      }
+      auto& tensor = self->upload_.tensors_.back();
+      const auto delta = expand_seed(self->seed_, tensor.secret_shares_.size());
+      std::copy(std::begin(delta), std::end(delta), std::begin(tensor.secret_shares_));
+      self->end_tensor();
+    });
+  }
+
+  void end_tensor() {
+    switch (server_.format_) {
+      case UploadFormat::matrix:
+      case UploadFormat::vector:
+        return finish();
+      case UploadFormat::pair:
+        return write_ack(kPairAck, [self = shared_from_this()] { self->finish(); });
+      case UploadFormat::model:
+        return write_ack(kDataAck, [self = shared_from_this()] {
+          if (self->upload_.tensors_.size() == self->num_tensors_) {
+            self->finish();
+          } else {
+            self->read_dimensions();
+          }
+        });
+    }
+  }
+
+  template <typename Continuation>
+  void write_ack(const std::string& message, Continuation&& continuation) {
+    boost::asio::async_write(
+        socket_, boost::asio::buffer(message),
+        [self = shared_from_this(), continuation = std::forward<Continuation>(continuation)](
+            auto ec, auto) {
+          if (ec) {
+            return self->fail("sending an acknowledgment", ec);
+          }
+          continuation();
+        });
+  }
+
+  void finish() {
+    boost::system::error_code ec;
+    socket_.close(ec);
+    has_slot_ = false;
+    server_.complete(std::move(upload_));
+  }
+
+  void fail(const std::string& reason, const boost::system::error_code& ec) {
+    fail(fmt::format("{} failed: {}", reason, ec.message()));
+  }
+
+  void fail(const std::string& reason) {
+    boost::system::error_code ec;
+    socket_.close(ec);
+    if (has_slot_) {
+      has_slot_ = false;
+      server_.release_slot();
+    }
+    server_.fail(upload_.sequence_number_, reason);
+  }
+
+  ShareIngestionServer& server_;
+  boost::asio::ip::tcp::socket socket_;
+  // number of layers or elements, depending on the format
+  int header_;
+  std::array<int, 2> dimensions_;
+  std::size_t num_tensors_ = 1;
+  Seed seed_;
+  std::vector<std::uint64_t> buffer_;
+  std::size_t offset_ = 0;
+  bool has_slot_ = false;
+  ReceivedUpload upload_;
+};
+
+ShareIngestionServer::ShareIngestionServer(std::uint16_t port, std::size_t max_pending_uploads,
+                                           bool seed_compressed, UploadFormat format)
+    : max_pending_uploads_(std::max(max_pending_uploads, std::size_t(1))),
+      seed_compressed_(seed_compressed),
+      format_(format),
+      work_guard_(boost::asio::make_work_guard(io_context_)),
+      acceptor_(io_context_, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), port)),
+      port_(acceptor_.local_endpoint().port()) {
+  accept();
+  io_thread_ = std::thread([this] { io_context_.run(); });
+}
+
+ShareIngestionServer::~ShareIngestionServer() { stop(); }
+
+void ShareIngestionServer::accept() {
+  acceptor_.async_accept([this](auto ec, boost::asio::ip::tcp::socket socket) {
+    if (ec == boost::asio::error::operation_aborted) {
+      return;
+    }
+    if (ec) {
+      std::cerr << "ShareIngestionServer: accept failed: " << ec.message() << "\n";
+    } else {
+      std::make_shared<Session>(*this, std::move(socket), next_sequence_number_++)->start();
+    }
+    accept();
+  });
+}
+
+void ShareIngestionServer::acquire_slot(std::function<void()> resume) {
+  {
+    std::scoped_lock lock(mutex_);
+    if (num_used_slots_ == max_pending_uploads_) {
+      waiting_sessions_.push_back(std::move(resume));
+      return;
+    }
+    ++num_used_slots_;
+  }
+  resume();
+}
+
+void ShareIngestionServer::release_slot() {
+  std::function<void()> resume;
+  {
+    std::scoped_lock lock(mutex_);
+    if (waiting_sessions_.empty()) {
+      --num_used_slots_;
+      return;
+    }
+    // hand the slot over to the next waiting session
+    resume = std::move(waiting_sessions_.front());
+    waiting_sessions_.pop_front();
+  }
+  boost::asio::post(io_context_, std::move(resume));
+}
+
+void ShareIngestionServer::complete(ReceivedUpload&& upload) {
+  {
+    std::scoped_lock lock(mutex_);
+    completed_uploads_.push_back(std::move(upload));
+  }
+  cv_.notify_all();
+}
+
+void ShareIngestionServer::fail(std::size_t sequence_number, const std::string& reason) {
+  std::cerr << fmt::format("ShareIngestionServer: connection {}: {}\n", sequence_number, reason);
+  {
+    std::scoped_lock lock(mutex_);
+    ++num_failed_connections_;
+    last_failure_ = fmt::format("connection {}: {}", sequence_number, reason);
+  }
+  cv_.notify_all();
+}
+
+std::optional<ReceivedUpload> ShareIngestionServer::next_upload() {
+  std::optional<ReceivedUpload> upload;
+  {
+    std::unique_lock lock(mutex_);
+    cv_.wait(lock, [this] { return !completed_uploads_.empty() || stopped_; });
+    if (completed_uploads_.empty()) {
+      return std::nullopt;
+    }
+    upload = std::move(completed_uploads_.front());
+    completed_uploads_.pop_front();
+  }
+  release_slot();
+  return upload;
+}
+
+ReceivedUpload ShareIngestionServer::receive_upload() {
+  std::optional<ReceivedUpload> upload;
+  {
+    std::unique_lock lock(mutex_);
+    cv_.wait(lock, [this] {
+      return !completed_uploads_.empty() || num_reported_failures_ < num_failed_connections_ ||
+             stopped_;
+    });
+    if (completed_uploads_.empty()) {
+      if (num_reported_failures_ < num_failed_connections_) {
+        num_reported_failures_ = num_failed_connections_;
+        throw std::runtime_error("ShareIngestionServer: " + last_failure_);
+      }
+      throw std::runtime_error("ShareIngestionServer: stopped before an upload was complete");
+    }
+    upload = std::move(completed_uploads_.front());
+    completed_uploads_.pop_front();
+  }
+  release_slot();
+  return std::move(*upload);
+}
+
+void ShareIngestionServer::stop() {
+  {
+    std::scoped_lock lock(mutex_);
+    if (stopped_) {
+      return;
+    }
+    stopped_ = true;
+  }
+  cv_.notify_all();
+  boost::asio::post(io_context_, [this] {
+    boost::system::error_code ec;
+    acceptor_.close(ec);
+  });
+  work_guard_.reset();
+  io_context_.stop();
+  if (io_thread_.joinable()) {
+    io_thread_.join();
+  }
+}
+
+std::size_t ShareIngestionServer::get_num_failed_connections() const {
+  std::scoped_lock lock(mutex_);
+  return num_failed_connections_;
+}
+
+}  // namespace COMPUTE_SERVER
@@ -0,0 +1,147 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/align/aligned_allocator.hpp>
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+#include "utility/config.h"
+
+namespace COMPUTE_SERVER {
+
+using AlignedShareBuffer =
+    std::vector<std::uint64_t,
+                boost::alignment::aligned_allocator<std::uint64_t, MOTION::MOTION_ALIGNMENT>>;
+
+// A tensor received by the ShareIngestionServer.
+struct ReceivedTensor {
+  std::size_t rows_;
+  std::size_t cols_;
+  AlignedShareBuffer public_shares_;
+  AlignedShareBuffer secret_shares_;
+};
+
+// All tensors delivered over one connection.
+struct ReceivedUpload {
+  // position of the provider's connection in the order of acceptance
+  std::size_t sequence_number_;
+  // 0 for the formats without fractional bits
+  std::size_t fractional_bits_ = 0;
+  std::vector<ReceivedTensor> tensors_;
+};
+
+// The protocols spoken by the data providers.  The shares are always sent as
+// interleaved (Delta, delta) pairs or, if seed compressed, as the seed
+// followed by the public shares.
+enum class UploadFormat {
+  // fractional bits, dimensions and the shares of one matrix
+  matrix,
+  // number of elements and the shares of one vector
+  vector,
+  // a single pair of shares, acknowledged after it has been received
+  pair,
+  // number of layers, fractional bits, and the dimensions and shares of a
+  // weight and a bias matrix per layer, each acknowledged after its shares
+  model,
+};
+
+// Asynchronous receiver for the uploads of the data providers: accepts any
+// number of concurrent providers on one port.  Each connection delivers one
+// upload in the given format and the shares are streamed in chunks directly
+// into the buffers of the tensors.
+//
+// Uploads are handed out by next_upload() as soon as they are complete.  At
+// most max_pending_uploads uploads are being received or waiting to be
+// consumed, further providers are only acknowledged once a slot is free, and
+// are otherwise held back by TCP flow control.
+class ShareIngestionServer {
+ public:
+  // port 0 selects an ephemeral port, see get_port()
+  ShareIngestionServer(std::uint16_t port, std::size_t max_pending_uploads = 4,
+                       bool seed_compressed = false, UploadFormat format = UploadFormat::matrix);
+  ~ShareIngestionServer();
+  ShareIngestionServer(const ShareIngestionServer&) = delete;
+  ShareIngestionServer& operator=(const ShareIngestionServer&) = delete;
+
+  std::uint16_t get_port() const noexcept { return port_; }
+
+  // Blocks until the next upload is complete.  Returns std::nullopt once the
+  // server is stopped and all completed uploads have been returned.
+  std::optional<ReceivedUpload> next_upload();
+
+  // Like next_upload(), but throws std::runtime_error if a connection fails
+  // or the server is stopped before the next upload is complete.
+  ReceivedUpload receive_upload();
+
+  // Stops accepting and drops all incomplete connections.
+  void stop();
+
+  std::size_t get_num_failed_connections() const;
+
+ private:
+  class Session;
+
+  void accept();
+  // calls resume once a slot for a new upload is available
+  void acquire_slot(std::function<void()> resume);
+  void release_slot();
+  void complete(ReceivedUpload&& upload);
+  void fail(std::size_t sequence_number, const std::string& reason);
+
+  const std::size_t max_pending_uploads_;
+  const bool seed_compressed_;
+  const UploadFormat format_;
+  boost::asio::io_context io_context_;
+  boost::asio::executor_work_guard<boost::asio::io_context::executor_type> work_guard_;
+  boost::asio::ip::tcp::acceptor acceptor_;
+  std::uint16_t port_;
+  std::size_t next_sequence_number_ = 0;
+  std::thread io_thread_;
+
+  mutable std::mutex mutex_;
+  std::condition_variable cv_;
+  std::deque<ReceivedUpload> completed_uploads_;
+  std::deque<std::function<void()>> waiting_sessions_;
+  std::size_t num_used_slots_ = 0;
+  std::size_t num_failed_connections_ = 0;
+  // failures which have been reported by receive_upload()
+  std::size_t num_reported_failures_ = 0;
+  std::string last_failure_;
+  bool stopped_ = false;
+};
+
+}  // namespace COMPUTE_SERVER
@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <array>
 #include "aesni_primitives.h"
+#include "utility/cpu_features.h"
 
 template <int round_constant>
 static __m128i aes_key_expand(__m128i xmm1) {
@@ -89,8 +90,59 @@ void aesni_key_expansion_128(void* round_keys_in) {
   // movdqa 0xa0[rdi], xmm1
 }
 
+// With VAES one instruction runs a round on four blocks, so the CTR mode below
+// first processes as many 16 block batches as possible with 512 bit registers.
+// Returns the number of blocks written, the default version does nothing.
+MOTION_TARGET_DEFAULT
+static std::size_t vaes_ctr_stream_blocks_128(const void*, std::uint64_t*, void*, std::size_t) {
+  return 0;
+}
+
+#if MOTION_HAVE_MULTIVERSIONING
+MOTION_TARGET("avx512f,vaes")
+static std::size_t vaes_ctr_stream_blocks_128(const void* round_keys_in, std::uint64_t* counter_in,
+                                              void* output_in, std::size_t num_blocks) {
+  std::array<__m512i, aes_num_round_keys_128> round_keys;
+  std::array<__m512i, 4> wb;
+  auto counter = *counter_in;
+  auto output = reinterpret_cast<std::byte*>(output_in);
+
+  for (std::size_t k = 0; k < aes_num_round_keys_128; ++k) {
+    round_keys[k] = _mm512_broadcast_i32x4(
+        _mm_load_si128(reinterpret_cast<const __m128i*>(round_keys_in) + k));
+  }
+
+  const auto batch_blocks = num_blocks & ~std::size_t(0b1111);
+  for (std::size_t i = 0; i < batch_blocks; i += 16) {
+    for (std::size_t j = 0; j < 4; ++j) {
+      const auto c = counter + 4 * j;
+      wb[j] = _mm512_set_epi64(0, c + 3, 0, c + 2, 0, c + 1, 0, c);
+    }
+    for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm512_xor_si512(wb[j], round_keys[0]);
+    for (std::size_t k = 1; k < aes_num_round_keys_128 - 1; ++k) {
+      for (std::size_t j = 0; j < 4; ++j) wb[j] = _mm512_aesenc_epi128(wb[j], round_keys[k]);
+    }
+    for (std::size_t j = 0; j < 4; ++j) {
+      wb[j] = _mm512_aesenclast_epi128(wb[j], round_keys[aes_num_round_keys_128 - 1]);
+    }
+    for (std::size_t j = 0; j < 4; ++j) {
+      _mm512_storeu_si512(output + (i + 4 * j) * aes_block_size, wb[j]);
+    }
+    counter += 16;
+  }
+
+  *counter_in = counter;
+  return batch_blocks;
+}
+#endif
+
 void aesni_ctr_stream_blocks_128(const void* round_keys_in, std::uint64_t* counter_in,
                                  void* output_in, std::size_t num_blocks) {
+  const auto vaes_blocks =
+      vaes_ctr_stream_blocks_128(round_keys_in, counter_in, output_in, num_blocks);
+  output_in = reinterpret_cast<std::byte*>(output_in) + vaes_blocks * aes_block_size;
+  num_blocks -= vaes_blocks;
+
   alignas(16) std::array<__m128i, aes_num_round_keys_128> round_keys;
   alignas(16) std::array<__m128i, 4> wb;
   auto counter = *counter_in;
@@ -150,6 +202,10 @@ void aesni_ctr_stream_blocks_128(const void* round_keys_in, std::uint64_t* count
 void aesni_ctr_stream_blocks_128_unaligned(const void* round_keys_in, std::uint64_t* counter_in,
                                            void* output_in, std::size_t num_blocks) {
   // almost the same code as in `aesni_ctr_stream_blocks_128_unaligned`
+  const auto vaes_blocks =
+      vaes_ctr_stream_blocks_128(round_keys_in, counter_in, output_in, num_blocks);
+  output_in = reinterpret_cast<std::byte*>(output_in) + vaes_blocks * aes_block_size;
+  num_blocks -= vaes_blocks;
 
   alignas(16) std::array<__m128i, aes_num_round_keys_128> round_keys;
   alignas(16) std::array<__m128i, 4> wb;
@@ -298,6 +354,62 @@ void aesni_mmo_single(const void* round_keys_in, void* input) {
   _mm_storeu_si128(input_ptr, wb_1);
 }
 
+void aesni_ggm_expand(const void* round_keys_0_in, const void* round_keys_1_in,
+                      const void* parents_in, void* children_out, std::size_t num_parents) {
+  alignas(16) std::array<__m128i, aes_num_round_keys_128> round_keys_0;
+  alignas(16) std::array<__m128i, aes_num_round_keys_128> round_keys_1;
+  alignas(16) std::array<__m128i, 4> x;
+  alignas(16) std::array<__m128i, 4> wb_0;
+  alignas(16) std::array<__m128i, 4> wb_1;
+
+  // copy the round keys onto the stack
+  auto round_keys_0_ptr =
+      reinterpret_cast<const __m128i*>(__builtin_assume_aligned(round_keys_0_in, aes_block_size));
+  auto round_keys_1_ptr =
+      reinterpret_cast<const __m128i*>(__builtin_assume_aligned(round_keys_1_in, aes_block_size));
+  std::copy(round_keys_0_ptr, round_keys_0_ptr + aes_num_round_keys_128, round_keys_0.data());
+  std::copy(round_keys_1_ptr, round_keys_1_ptr + aes_num_round_keys_128, round_keys_1.data());
+  auto parents = reinterpret_cast<const __m128i*>(parents_in);
+  auto children = reinterpret_cast<__m128i*>(children_out);
+
+  // expand four parents at once s.t. eight AES evaluations are in flight
+  std::size_t i = 0;
+  for (; i + 4 <= num_parents; i += 4) {
+    for (std::size_t j = 0; j < 4; ++j) x[j] = _mm_loadu_si128(parents + i + j);
+    for (std::size_t j = 0; j < 4; ++j) {
+      wb_0[j] = _mm_xor_si128(x[j], round_keys_0[0]);
+      wb_1[j] = _mm_xor_si128(x[j], round_keys_1[0]);
+    }
+    for (std::size_t r = 1; r < aes_num_round_keys_128 - 1; ++r) {
+      for (std::size_t j = 0; j < 4; ++j) {
+        wb_0[j] = _mm_aesenc_si128(wb_0[j], round_keys_0[r]);
+        wb_1[j] = _mm_aesenc_si128(wb_1[j], round_keys_1[r]);
+      }
+    }
+    for (std::size_t j = 0; j < 4; ++j) {
+      wb_0[j] = _mm_aesenclast_si128(wb_0[j], round_keys_0[10]);
+      wb_1[j] = _mm_aesenclast_si128(wb_1[j], round_keys_1[10]);
+    }
+    for (std::size_t j = 0; j < 4; ++j) {
+      _mm_storeu_si128(children + 2 * (i + j), _mm_xor_si128(wb_0[j], x[j]));
+      _mm_storeu_si128(children + 2 * (i + j) + 1, _mm_xor_si128(wb_1[j], x[j]));
+    }
+  }
+  for (; i < num_parents; ++i) {
+    x[0] = _mm_loadu_si128(parents + i);
+    wb_0[0] = _mm_xor_si128(x[0], round_keys_0[0]);
+    wb_1[0] = _mm_xor_si128(x[0], round_keys_1[0]);
+    for (std::size_t r = 1; r < aes_num_round_keys_128 - 1; ++r) {
+      wb_0[0] = _mm_aesenc_si128(wb_0[0], round_keys_0[r]);
+      wb_1[0] = _mm_aesenc_si128(wb_1[0], round_keys_1[r]);
+    }
+    wb_0[0] = _mm_aesenclast_si128(wb_0[0], round_keys_0[10]);
+    wb_1[0] = _mm_aesenclast_si128(wb_1[0], round_keys_1[10]);
+    _mm_storeu_si128(children + 2 * i, _mm_xor_si128(wb_0[0], x[0]));
+    _mm_storeu_si128(children + 2 * i + 1, _mm_xor_si128(wb_1[0], x[0]));
+  }
+}
+
 static __m128i aesni_mix_keys(__m128i key_a, __m128i key_b) {
   const __m128i modulus = _mm_set_epi32(0, 0, 0, 0x87);
   const __m128i msb_mask = _mm_set_epi32(0x80000000, 0, 0, 0);
@@ -66,6 +66,17 @@ void aesni_tmmo_batch_4(const void* round_keys, void* input, __uint128_t tweak);
 // * round_keys are 16B aligned
 void aesni_mmo_single(const void* round_keys, void* input);
 
+// Expand the nodes of one level of a GGM tree with the length-doubling PRG
+//   G(x) = (\pi_0(x) ^ x, \pi_1(x) ^ x)
+// where \pi_0 and \pi_1 are AES with the expanded keys `round_keys_0` and
+// `round_keys_1`.  The children of parents[i] are stored at children[2i] and
+// children[2i + 1].
+//
+// * round_keys are 16B aligned
+// * parents and children must not overlap
+void aesni_ggm_expand(const void* round_keys_0, const void* round_keys_1, const void* parents,
+                      void* children, std::size_t num_parents);
+
 // Compute the dual-key cipher A2/D1 by Bellare et al.
 // (https://eprint.iacr.org/2013/426).
 //
@@ -108,11 +108,41 @@ void HalfGateGarbler::batch_garble_and_omp(ENCRYPTO::block128_t* key_cs,
   }
 }
 
+// copy the keys of the input wires into their slots
+static void copy_input_keys(ENCRYPTO::block128_vector& wire_keys,
+                            const ENCRYPTO::block128_vector& input_keys_a,
+                            const ENCRYPTO::block128_vector& input_keys_b, std::size_t num_simd,
+                            const ENCRYPTO::AlgorithmDescription& algo) {
+  for (std::size_t wire_i = 0; wire_i < algo.n_input_wires_parent_a_; ++wire_i) {
+    std::copy_n(input_keys_a.data() + wire_i * num_simd, num_simd,
+                wire_keys.data() + algo.get_wire_slot(wire_i) * num_simd);
+  }
+  if (algo.n_input_wires_parent_b_.has_value()) {
+    const auto wire_offset = algo.n_input_wires_parent_a_;
+    for (std::size_t wire_i = 0; wire_i < *algo.n_input_wires_parent_b_; ++wire_i) {
+      std::copy_n(input_keys_b.data() + wire_i * num_simd, num_simd,
+                  wire_keys.data() + algo.get_wire_slot(wire_offset + wire_i) * num_simd);
+    }
+  }
+}
+
+// copy the keys of the output wires, i.e., the last wires, out of their slots
+static void copy_output_keys(ENCRYPTO::block128_vector& output_keys,
+                             const ENCRYPTO::block128_vector& wire_keys, std::size_t num_simd,
+                             const ENCRYPTO::AlgorithmDescription& algo) {
+  const auto wire_offset = algo.n_wires_ - algo.n_output_wires_;
+  for (std::size_t wire_i = 0; wire_i < algo.n_output_wires_; ++wire_i) {
+    std::copy_n(wire_keys.data() + algo.get_wire_slot(wire_offset + wire_i) * num_simd, num_simd,
+                output_keys.data() + wire_i * num_simd);
+  }
+}
+
 void HalfGateGarbler::garble_circuit(
     ENCRYPTO::block128_vector& output_keys, ENCRYPTO::block128_vector& garbled_tables,
     std::size_t start_index, const ENCRYPTO::block128_vector& input_keys_a,
     const ENCRYPTO::block128_vector& input_keys_b, std::size_t num_simd,
-    const ENCRYPTO::AlgorithmDescription& algo, bool parallel) const {
+    const ENCRYPTO::AlgorithmDescription& algo, bool parallel,
+    const GarbledTablesCallback& tables_ready, std::size_t min_batch_size) const {
   assert(input_keys_a.size() == algo.n_input_wires_parent_a_ * num_simd);
   assert((!algo.n_input_wires_parent_b_.has_value()) ||
          (input_keys_b.size() == *algo.n_input_wires_parent_b_ * num_simd));
@@ -125,19 +155,26 @@ void HalfGateGarbler::garble_circuit(
           return 0;
         }
       });
-  garbled_tables.resize(2 * num_and_gates * num_simd);
-  ENCRYPTO::block128_vector wire_keys(algo.n_wires_ * num_simd);
-  auto it = std::copy_n(input_keys_a.data(), input_keys_a.size(), wire_keys.data());
-  if (algo.n_input_wires_parent_b_.has_value()) {
-    std::copy_n(input_keys_b.data(), input_keys_b.size(), it);
+  const auto and_tables_size = 2 * num_simd;
+  if (tables_ready) {
+    garbled_tables.resize(std::min(num_and_gates, min_batch_size / and_tables_size + 1) *
+                          and_tables_size);
+  } else {
+    garbled_tables.resize(num_and_gates * and_tables_size);
   }
+  // number of blocks which have already been handed to tables_ready
+  std::size_t num_emitted = 0;
+  // the keys of each wire are stored in its slot, which is shared with wires
+  // that are not live at the same time
+  ENCRYPTO::block128_vector wire_keys(algo.get_num_slots() * num_simd);
+  copy_input_keys(wire_keys, input_keys_a, input_keys_b, num_simd, algo);
   assert(algo.n_gates_ == algo.gates_.size());
   for (std::size_t op_i = 0, and_j = 0; op_i < algo.n_gates_; ++op_i) {
     const auto& op = algo.gates_[op_i];
-    const auto* gate_input_keys_a = &wire_keys[op.parent_a_ * num_simd];
-    auto* gate_output_keys = &wire_keys[op.output_wire_ * num_simd];
+    const auto* gate_input_keys_a = &wire_keys[algo.get_wire_slot(op.parent_a_) * num_simd];
+    auto* gate_output_keys = &wire_keys[algo.get_wire_slot(op.output_wire_) * num_simd];
     if (op.parent_b_.has_value()) {
-      const auto* gate_input_keys_b = &wire_keys[*op.parent_b_ * num_simd];
+      const auto* gate_input_keys_b = &wire_keys[algo.get_wire_slot(*op.parent_b_) * num_simd];
       if (op.type_ == ENCRYPTO::PrimitiveOperationType::XOR) {
         if (parallel) {
           __gnu_parallel::transform(gate_input_keys_a, gate_input_keys_a + num_simd,
@@ -148,15 +185,20 @@ void HalfGateGarbler::garble_circuit(
                          gate_output_keys, [](const auto& ka, const auto& kb) { return ka ^ kb; });
         }
       } else if (op.type_ == ENCRYPTO::PrimitiveOperationType::AND) {
+        auto* gate_tables = &garbled_tables[and_j * and_tables_size - num_emitted];
         if (parallel) {
-          batch_garble_and_omp(gate_output_keys, &garbled_tables[and_j * 2 * num_simd], start_index,
-                               gate_input_keys_a, gate_input_keys_b, num_simd);
+          batch_garble_and_omp(gate_output_keys, gate_tables, start_index, gate_input_keys_a,
+                               gate_input_keys_b, num_simd);
         } else {
-          batch_garble_and(gate_output_keys, &garbled_tables[and_j * 2 * num_simd], start_index,
-                           gate_input_keys_a, gate_input_keys_b, num_simd);
+          batch_garble_and(gate_output_keys, gate_tables, start_index, gate_input_keys_a,
+                           gate_input_keys_b, num_simd);
         }
         ++and_j;
         start_index += num_simd;
+        if (tables_ready && and_j * and_tables_size - num_emitted >= min_batch_size) {
+          tables_ready(num_emitted, garbled_tables.data(), and_j * and_tables_size - num_emitted);
+          num_emitted = and_j * and_tables_size;
+        }
       } else {
         throw std::runtime_error("unsupported operation");
       }
@@ -175,8 +217,10 @@ void HalfGateGarbler::garble_circuit(
       }
     }
   }
-  std::copy_n(wire_keys.data() + (algo.n_wires_ - algo.n_output_wires_) * num_simd,
-              algo.n_output_wires_ * num_simd, output_keys.data());
+  if (tables_ready && num_and_gates * and_tables_size > num_emitted) {
+    tables_ready(num_emitted, garbled_tables.data(), num_and_gates * and_tables_size - num_emitted);
+  }
+  copy_output_keys(output_keys, wire_keys, num_simd, algo);
 }
 
 HalfGateEvaluator::HalfGateEvaluator(const HalfGatePublicData& public_data)
@@ -243,23 +287,24 @@ void HalfGateEvaluator::evaluate_circuit(
     ENCRYPTO::block128_vector& output_keys, const ENCRYPTO::block128_vector& garbled_tables,
     std::size_t start_index, const ENCRYPTO::block128_vector& input_keys_a,
     const ENCRYPTO::block128_vector& input_keys_b, std::size_t num_simd,
-    const ENCRYPTO::AlgorithmDescription& algo, bool parallel) const {
+    const ENCRYPTO::AlgorithmDescription& algo, bool parallel,
+    const GarbledTablesWaiter& wait_for_tables) const {
   assert(input_keys_a.size() == algo.n_input_wires_parent_a_ * num_simd);
   assert((!algo.n_input_wires_parent_b_.has_value()) ||
          (input_keys_b.size() == *algo.n_input_wires_parent_b_ * num_simd));
   output_keys.resize(algo.n_output_wires_ * num_simd);
-  ENCRYPTO::block128_vector wire_keys(algo.n_wires_ * num_simd);
-  auto it = std::copy_n(input_keys_a.data(), input_keys_a.size(), wire_keys.data());
-  if (algo.n_input_wires_parent_b_.has_value()) {
-    std::copy_n(input_keys_b.data(), input_keys_b.size(), it);
-  }
+  // the keys of each wire are stored in its slot, which is shared with wires
+  // that are not live at the same time
+  ENCRYPTO::block128_vector wire_keys(algo.get_num_slots() * num_simd);
+  copy_input_keys(wire_keys, input_keys_a, input_keys_b, num_simd, algo);
   assert(algo.n_gates_ == algo.gates_.size());
   for (std::size_t op_i = 0, and_j = 0; op_i < algo.n_gates_; ++op_i) {
     const auto& op = algo.gates_[op_i];
-    const ENCRYPTO::block128_t* gate_input_keys_a = &wire_keys[op.parent_a_ * num_simd];
-    auto* gate_output_keys = &wire_keys[op.output_wire_ * num_simd];
+    const ENCRYPTO::block128_t* gate_input_keys_a =
+        &wire_keys[algo.get_wire_slot(op.parent_a_) * num_simd];
+    auto* gate_output_keys = &wire_keys[algo.get_wire_slot(op.output_wire_) * num_simd];
     if (op.parent_b_.has_value()) {
-      const auto* gate_input_keys_b = &wire_keys[*op.parent_b_ * num_simd];
+      const auto* gate_input_keys_b = &wire_keys[algo.get_wire_slot(*op.parent_b_) * num_simd];
       if (op.type_ == ENCRYPTO::PrimitiveOperationType::XOR) {
         if (parallel) {
           __gnu_parallel::transform(gate_input_keys_a, gate_input_keys_a + num_simd,
@@ -270,6 +315,9 @@ void HalfGateEvaluator::evaluate_circuit(
                          gate_output_keys, [](const auto& ka, const auto& kb) { return ka ^ kb; });
         }
       } else if (op.type_ == ENCRYPTO::PrimitiveOperationType::AND) {
+        if (wait_for_tables) {
+          wait_for_tables((and_j + 1) * 2 * num_simd);
+        }
         if (parallel) {
           batch_evaluate_and_omp(gate_output_keys, &garbled_tables[and_j * 2 * num_simd],
                                  start_index, gate_input_keys_a, gate_input_keys_b, num_simd);
@@ -290,8 +338,7 @@ void HalfGateEvaluator::evaluate_circuit(
       }
     }
   }
-  std::copy_n(wire_keys.data() + (algo.n_wires_ - algo.n_output_wires_) * num_simd,
-              algo.n_output_wires_ * num_simd, output_keys.data());
+  copy_output_keys(output_keys, wire_keys, num_simd, algo);
 }
 
 }  // namespace MOTION::Crypto::garbling
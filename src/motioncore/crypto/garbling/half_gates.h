@@ -22,6 +22,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include "crypto/aes/aesni_primitives.h"
 #include "utility/block.h"
 
@@ -39,6 +41,14 @@ struct HalfGatePublicData {
 using half_gate_t = std::array<ENCRYPTO::block128_t, 2>;
 constexpr std::size_t half_gate_block_size = 2;
 
+// Gets (offset, pointer, number of blocks) of the next range of garbled tables
+// as soon as it is complete.
+using GarbledTablesCallback =
+    std::function<void(std::size_t, const ENCRYPTO::block128_t*, std::size_t)>;
+// Gets a number n of blocks and returns once the first n blocks of the garbled
+// tables are available.
+using GarbledTablesWaiter = std::function<void(std::size_t)>;
+
 class HalfGateGarbler {
  public:
   HalfGateGarbler();
@@ -56,10 +66,15 @@ class HalfGateGarbler {
   void batch_garble_and_omp(ENCRYPTO::block128_t* key_c, ENCRYPTO::block128_t* garbled_table,
                             std::size_t index, const ENCRYPTO::block128_t* key_a,
                             const ENCRYPTO::block128_t* key_b, std::size_t num_gates) const;
+  // If tables_ready is set, the garbled tables are handed to it in batches of
+  // at least min_batch_size blocks while garbling proceeds, and garbled_tables
+  // is only used as a buffer for the current batch.
   void garble_circuit(ENCRYPTO::block128_vector& key_c, ENCRYPTO::block128_vector& garbled_tables,
                       std::size_t index, const ENCRYPTO::block128_vector& key_a,
                       const ENCRYPTO::block128_vector& key_b, std::size_t num_simd,
-                      const ENCRYPTO::AlgorithmDescription&, bool parallel = false) const;
+                      const ENCRYPTO::AlgorithmDescription&, bool parallel = false,
+                      const GarbledTablesCallback& tables_ready = nullptr,
+                      std::size_t min_batch_size = 0) const;
 
  private:
   ENCRYPTO::block128_t offset_;
@@ -89,7 +104,8 @@ class HalfGateEvaluator {
                         const ENCRYPTO::block128_vector& garbled_tables, std::size_t index,
                         const ENCRYPTO::block128_vector& key_a,
                         const ENCRYPTO::block128_vector& key_b, std::size_t num_simd,
-                        const ENCRYPTO::AlgorithmDescription&, bool parallel = false) const;
+                        const ENCRYPTO::AlgorithmDescription&, bool parallel = false,
+                        const GarbledTablesWaiter& wait_for_tables = nullptr) const;
 
  private:
   ENCRYPTO::block128_t hash_key_;
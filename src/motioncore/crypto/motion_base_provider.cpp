@@ -178,6 +178,18 @@ void MotionBaseProvider::setup() {
   }
 }
 
+void MotionBaseProvider::advance_epoch() {
+  wait_setup();
+  ++epoch_;
+  for (std::size_t party_id = 0; party_id < num_parties_; ++party_id) {
+    if (party_id == my_id_) {
+      continue;
+    }
+    my_randomness_generators_.at(party_id)->SetEpoch(epoch_);
+    their_randomness_generators_.at(party_id)->SetEpoch(epoch_);
+  }
+}
+
 std::vector<ENCRYPTO::ReusableFiberFuture<std::vector<std::uint8_t>>>
 MotionBaseProvider::register_for_output_messages(std::size_t gate_id) {
   std::vector<ENCRYPTO::ReusableFiberFuture<std::vector<std::uint8_t>>> futures(num_parties_);
@@ -23,6 +23,7 @@
 #pragma once
 
 #include <atomic>
+#include <cstdint>
 #include <memory>
 #include "utility/enable_wait.h"
 #include "utility/reusable_future.h"
@@ -51,6 +52,8 @@ class MotionBaseProvider : public ENCRYPTO::enable_wait_setup {
   ~MotionBaseProvider();
 
   void setup();
+  // Rekey the randomness generators s.t. gates can be evaluated again.
+  void advance_epoch();
 
   const std::vector<std::uint8_t>& get_aes_fixed_key() const { return aes_fixed_key_; }
   SharingRandomnessGenerator& get_my_randomness_generator(std::size_t party_id) {
@@ -76,6 +79,7 @@ class MotionBaseProvider : public ENCRYPTO::enable_wait_setup {
   std::shared_ptr<HelloMessageHandler> hello_message_handler_;
   std::vector<std::shared_ptr<OutputMessageHandler>> output_message_handlers_;
   std::atomic_flag execute_setup_flag_ = ATOMIC_FLAG_INIT;
+  std::uint64_t epoch_ = 0;
 };
 
 }  // namespace Crypto
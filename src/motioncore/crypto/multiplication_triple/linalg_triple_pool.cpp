@@ -0,0 +1,231 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "linalg_triple_pool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace MOTION {
+
+LinAlgTriplePool::LinAlgTriplePool(std::size_t capacity) : capacity_(capacity) {}
+
+template <typename Map>
+void LinAlgTriplePool::put(Map& triple_map, const typename Map::key_type& key,
+                           typename Map::mapped_type::value_type&& triple) {
+  {
+    std::scoped_lock lock(mutex_);
+    triple_map[key].push_back(std::move(triple));
+  }
+  cv_.notify_all();
+}
+
+template <typename Map>
+typename Map::mapped_type::value_type LinAlgTriplePool::take(Map& triple_map,
+                                                             const typename Map::key_type& key) {
+  typename Map::mapped_type::value_type triple;
+  {
+    std::unique_lock lock(mutex_);
+    auto& queue = triple_map[key];
+    cv_.wait(lock, [this, &queue] { return !queue.empty() || closed_; });
+    if (queue.empty()) {
+      throw std::runtime_error("LinAlgTriplePool has been closed");
+    }
+    triple = std::move(queue.front());
+    queue.pop_front();
+    ++num_taken_;
+  }
+  cv_.notify_all();
+  return triple;
+}
+
+template <typename Map>
+std::size_t LinAlgTriplePool::get_free(const Map& triple_map,
+                                       const typename Map::key_type& key) const {
+  std::scoped_lock lock(mutex_);
+  auto it = triple_map.find(key);
+  if (it == triple_map.end()) {
+    return capacity_;
+  }
+  return capacity_ - std::min(capacity_, it->second.size());
+}
+
+template <typename T>
+void LinAlgTriplePool::put_gemm_triple(const tensor::GemmOp& gemm_op, LinAlgTriple<T>&& triple) {
+  put(get_triples<T>().gemm_, gemm_op, std::move(triple));
+}
+
+template <typename T>
+LinAlgTriplePool::LinAlgTriple<T> LinAlgTriplePool::take_gemm_triple(
+    const tensor::GemmOp& gemm_op) {
+  return take(get_triples<T>().gemm_, gemm_op);
+}
+
+template <typename T>
+std::size_t LinAlgTriplePool::get_free_gemm(const tensor::GemmOp& gemm_op) const {
+  return get_free(get_triples<T>().gemm_, gemm_op);
+}
+
+template <typename T>
+void LinAlgTriplePool::put_conv2d_triple(const tensor::Conv2DOp& conv_op,
+                                         LinAlgTriple<T>&& triple) {
+  put(get_triples<T>().conv2d_, conv_op, std::move(triple));
+}
+
+template <typename T>
+LinAlgTriplePool::LinAlgTriple<T> LinAlgTriplePool::take_conv2d_triple(
+    const tensor::Conv2DOp& conv_op) {
+  return take(get_triples<T>().conv2d_, conv_op);
+}
+
+template <typename T>
+std::size_t LinAlgTriplePool::get_free_conv2d(const tensor::Conv2DOp& conv_op) const {
+  return get_free(get_triples<T>().conv2d_, conv_op);
+}
+
+#define INSTANTIATE(T)                                                                          \
+  template void LinAlgTriplePool::put_gemm_triple<T>(const tensor::GemmOp&, LinAlgTriple<T>&&); \
+  template LinAlgTriplePool::LinAlgTriple<T> LinAlgTriplePool::take_gemm_triple<T>(             \
+      const tensor::GemmOp&);                                                                   \
+  template std::size_t LinAlgTriplePool::get_free_gemm<T>(const tensor::GemmOp&) const;         \
+  template void LinAlgTriplePool::put_conv2d_triple<T>(const tensor::Conv2DOp&,                 \
+                                                       LinAlgTriple<T>&&);                      \
+  template LinAlgTriplePool::LinAlgTriple<T> LinAlgTriplePool::take_conv2d_triple<T>(           \
+      const tensor::Conv2DOp&);                                                                 \
+  template std::size_t LinAlgTriplePool::get_free_conv2d<T>(const tensor::Conv2DOp&) const;
+
+INSTANTIATE(std::uint8_t)
+INSTANTIATE(std::uint16_t)
+INSTANTIATE(std::uint32_t)
+INSTANTIATE(std::uint64_t)
+INSTANTIATE(__uint128_t)
+
+#undef INSTANTIATE
+
+void LinAlgTriplePool::put_relu_triple(std::size_t num_triples, std::size_t bit_size,
+                                       BooleanTriple&& triple) {
+  put(relu_triples_, {num_triples, bit_size}, std::move(triple));
+}
+
+LinAlgTriplePool::BooleanTriple LinAlgTriplePool::take_relu_triple(std::size_t num_triples,
+                                                                   std::size_t bit_size) {
+  return take(relu_triples_, {num_triples, bit_size});
+}
+
+std::size_t LinAlgTriplePool::get_free_relu(std::size_t num_triples, std::size_t bit_size) const {
+  return get_free(relu_triples_, {num_triples, bit_size});
+}
+
+std::size_t LinAlgTriplePool::get_num_taken() const {
+  std::scoped_lock lock(mutex_);
+  return num_taken_;
+}
+
+std::size_t LinAlgTriplePool::get_num_events() const {
+  std::scoped_lock lock(mutex_);
+  return num_taken_ + num_wakeups_;
+}
+
+void LinAlgTriplePool::wait_for_event(std::size_t num_events) const {
+  std::unique_lock lock(mutex_);
+  cv_.wait(lock,
+           [this, num_events] { return num_taken_ + num_wakeups_ > num_events || closed_; });
+}
+
+void LinAlgTriplePool::wake_producer() {
+  {
+    std::scoped_lock lock(mutex_);
+    ++num_wakeups_;
+  }
+  cv_.notify_all();
+}
+
+void LinAlgTriplePool::close() {
+  {
+    std::scoped_lock lock(mutex_);
+    closed_ = true;
+  }
+  cv_.notify_all();
+}
+
+bool LinAlgTriplePool::is_closed() const {
+  std::scoped_lock lock(mutex_);
+  return closed_;
+}
+
+// ---------- PooledLinAlgTripleProvider ----------
+
+PooledLinAlgTripleProvider::PooledLinAlgTripleProvider(std::shared_ptr<LinAlgTriplePool> pool)
+    : pool_(std::move(pool)) {}
+
+void PooledLinAlgTripleProvider::setup() {
+  const auto run_setup_gemm = [this](const auto& count_map, auto& triple_map) {
+    for (const auto& [gemm_op, count] : count_map) {
+      auto& triple_vec = triple_map.at(gemm_op);
+      using T = typename decltype(triple_vec.front().a_)::value_type;
+      triple_vec.reserve(count);
+      for (std::size_t i = 0; i < count; ++i) {
+        triple_vec.push_back(pool_->take_gemm_triple<T>(gemm_op));
+      }
+    }
+  };
+  const auto run_setup_conv = [this](const auto& count_map, auto& triple_map) {
+    for (const auto& [conv_op, count] : count_map) {
+      auto& triple_vec = triple_map.at(conv_op);
+      using T = typename decltype(triple_vec.front().a_)::value_type;
+      triple_vec.reserve(count);
+      for (std::size_t i = 0; i < count; ++i) {
+        triple_vec.push_back(pool_->take_conv2d_triple<T>(conv_op));
+      }
+    }
+  };
+
+  run_setup_gemm(gemm_counts_8_, gemm_triples_8_);
+  run_setup_gemm(gemm_counts_16_, gemm_triples_16_);
+  run_setup_gemm(gemm_counts_32_, gemm_triples_32_);
+  run_setup_gemm(gemm_counts_64_, gemm_triples_64_);
+  run_setup_gemm(gemm_counts_128_, gemm_triples_128_);
+
+  run_setup_conv(conv2d_counts_8_, conv2d_triples_8_);
+  run_setup_conv(conv2d_counts_16_, conv2d_triples_16_);
+  run_setup_conv(conv2d_counts_32_, conv2d_triples_32_);
+  run_setup_conv(conv2d_counts_64_, conv2d_triples_64_);
+  run_setup_conv(conv2d_counts_128_, conv2d_triples_128_);
+
+  for (const auto& [key, count] : relu_counts_) {
+    auto& triple_vec = relu_triples_.at(key);
+    triple_vec.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+      triple_vec.push_back(pool_->take_relu_triple(key.first, key.second));
+    }
+  }
+
+  set_setup_ready();
+}
+
+void PooledLinAlgTripleProvider::registration_hook(const tensor::GemmOp&, std::size_t) {}
+
+void PooledLinAlgTripleProvider::registration_hook(const tensor::Conv2DOp&, std::size_t) {}
+
+void PooledLinAlgTripleProvider::registration_hook_boolean(std::size_t, std::size_t) {}
+
+}  // namespace MOTION
@@ -0,0 +1,141 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include "linalg_triple_provider.h"
+
+namespace MOTION {
+
+// Thread-safe store of pregenerated linear algebra and ReLU triples, filled by
+// a LinAlgTriplePreprocessor and drained by PooledLinAlgTripleProvider.
+//
+// The pool holds at most `capacity` triples per shape.  The producer is
+// expected to check get_free_*() before adding triples, consumers block in
+// take_*() until a triple of the requested shape is available.
+class LinAlgTriplePool {
+ public:
+  template <typename T>
+  using LinAlgTriple = LinAlgTripleProvider::LinAlgTriple<T>;
+  using BooleanTriple = LinAlgTripleProvider::BooleanTriple;
+
+  explicit LinAlgTriplePool(std::size_t capacity);
+
+  std::size_t get_capacity() const noexcept { return capacity_; }
+
+  template <typename T>
+  void put_gemm_triple(const tensor::GemmOp&, LinAlgTriple<T>&&);
+  template <typename T>
+  [[nodiscard]] LinAlgTriple<T> take_gemm_triple(const tensor::GemmOp&);
+  template <typename T>
+  std::size_t get_free_gemm(const tensor::GemmOp&) const;
+
+  template <typename T>
+  void put_conv2d_triple(const tensor::Conv2DOp&, LinAlgTriple<T>&&);
+  template <typename T>
+  [[nodiscard]] LinAlgTriple<T> take_conv2d_triple(const tensor::Conv2DOp&);
+  template <typename T>
+  std::size_t get_free_conv2d(const tensor::Conv2DOp&) const;
+
+  void put_relu_triple(std::size_t num_triples, std::size_t bit_size, BooleanTriple&&);
+  [[nodiscard]] BooleanTriple take_relu_triple(std::size_t num_triples, std::size_t bit_size);
+  std::size_t get_free_relu(std::size_t num_triples, std::size_t bit_size) const;
+
+  // Total number of triples taken from the pool so far.
+  std::size_t get_num_taken() const;
+  // Number of triples taken plus the number of wake_producer() calls.
+  std::size_t get_num_events() const;
+  // Blocks until get_num_events() exceeds num_events or the pool is closed.
+  void wait_for_event(std::size_t num_events) const;
+  // Wakes up a producer blocked in wait_for_event(), e.g. since the producer
+  // has received a message.
+  void wake_producer();
+
+  // Wakes up all waiting threads; take_*() throws if no triple is left.
+  void close();
+  bool is_closed() const;
+
+ private:
+  template <typename T>
+  struct Triples {
+    std::unordered_map<tensor::GemmOp, std::deque<LinAlgTriple<T>>> gemm_;
+    std::unordered_map<tensor::Conv2DOp, std::deque<LinAlgTriple<T>>> conv2d_;
+  };
+
+  template <typename T>
+  Triples<T>& get_triples() {
+    return std::get<Triples<T>>(triples_);
+  }
+  template <typename T>
+  const Triples<T>& get_triples() const {
+    return std::get<Triples<T>>(triples_);
+  }
+
+  // Map is an unordered_map from shapes to deques of triples
+  template <typename Map>
+  void put(Map&, const typename Map::key_type&, typename Map::mapped_type::value_type&&);
+  template <typename Map>
+  typename Map::mapped_type::value_type take(Map&, const typename Map::key_type&);
+  template <typename Map>
+  std::size_t get_free(const Map&, const typename Map::key_type&) const;
+
+  const std::size_t capacity_;
+  mutable std::mutex mutex_;
+  mutable std::condition_variable cv_;
+  std::size_t num_taken_ = 0;
+  std::size_t num_wakeups_ = 0;
+  bool closed_ = false;
+  std::tuple<Triples<std::uint8_t>, Triples<std::uint16_t>, Triples<std::uint32_t>,
+             Triples<std::uint64_t>, Triples<__uint128_t>>
+      triples_;
+  std::unordered_map<std::pair<std::size_t, std::size_t>, std::deque<BooleanTriple>,
+                     utils::size_t_pair_hash>
+      relu_triples_;
+};
+
+// LinAlgTripleProvider which takes the registered triples from a
+// LinAlgTriplePool, so that its setup does not need any communication.
+class PooledLinAlgTripleProvider : public LinAlgTripleProvider {
+ public:
+  explicit PooledLinAlgTripleProvider(std::shared_ptr<LinAlgTriplePool>);
+
+  void setup() override;
+
+ protected:
+  void registration_hook(const tensor::GemmOp&, std::size_t bit_size) override;
+  void registration_hook(const tensor::Conv2DOp&, std::size_t bit_size) override;
+  void registration_hook_boolean(std::size_t num_triples, std::size_t bit_size) override;
+
+ private:
+  std::shared_ptr<LinAlgTriplePool> pool_;
+};
+
+}  // namespace MOTION
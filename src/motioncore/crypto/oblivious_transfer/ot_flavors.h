@@ -103,6 +103,9 @@ class FixedXCOT128Sender : public BasicOTSender {
   // send the sender's messages
   void SendMessages() const;
 
+  // clear stored data s.t. this handle can be used again
+  void clear() noexcept { outputs_computed_ = false; }
+
  private:
   // the correlation function is  f(x) = x ^ correlation_ for all OTs
   block128_t correlation_;
@@ -131,6 +134,12 @@ class FixedXCOT128Receiver : public BasicOTReceiver {
     return outputs_;
   }
 
+  // clear stored data s.t. this handle can be used again
+  void clear() noexcept {
+    outputs_computed_ = false;
+    corrections_sent_ = false;
+  }
+
  private:
   // future for the sender's message
   ReusableFiberFuture<block128_vector> sender_message_future_;
@@ -174,6 +183,9 @@ class XCOTBitSender : public BasicOTSender {
   // send the sender's messages
   void SendMessages() const;
 
+  // clear stored data s.t. this handle can be used again
+  void clear() noexcept { outputs_computed_ = false; }
+
  private:
   // dimension of each sender-input/output
   const std::size_t vector_size_;
@@ -204,6 +216,12 @@ class XCOTBitReceiver : public BasicOTReceiver {
     return outputs_;
   }
 
+  // clear stored data s.t. this handle can be used again
+  void clear() noexcept {
+    outputs_computed_ = false;
+    corrections_sent_ = false;
+  }
+
  private:
   // dimension of each sender-input/output
   const std::size_t vector_size_;
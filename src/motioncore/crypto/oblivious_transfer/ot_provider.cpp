@@ -34,6 +34,7 @@
 #include "data_storage/base_ot_data.h"
 #include "data_storage/ot_extension_data.h"
 #include "ot_flavors.h"
+#include "silent_ot.h"
 #include "statistics/run_time_stats.h"
 #include "utility/bit_matrix.h"
 #include "utility/config.h"
@@ -42,6 +43,10 @@
 
 namespace ENCRYPTO::ObliviousTransfer {
 
+// the IKNP receiver sends the masks of at most this many windows that the
+// sender has not acknowledged yet
+constexpr std::size_t kMaxWindowsInFlight = 2;
+
 OTProvider::OTProvider(std::function<void(flatbuffers::FlatBufferBuilder &&)> Send,
                        MOTION::OTExtensionData &data, std::size_t party_id,
                        std::shared_ptr<MOTION::Logger> logger)
@@ -153,6 +158,11 @@ OTProviderFromOTExtension::OTProviderFromOTExtension(
 }
 
 void OTProviderFromOTExtension::SendSetup() {
+  if (extension_backend_ == OTExtensionBackend::silent) {
+    SilentSendSetup();
+    return;
+  }
+
   if constexpr (MOTION::MOTION_DEBUG) {
     if (logger_) {
       logger_->LogDebug("OTProviderFromOTExtension::SendSetup() start");
@@ -162,8 +172,7 @@ void OTProviderFromOTExtension::SendSetup() {
   // security parameter
   constexpr std::size_t kappa = 128;
 
-  // storage for sender and base OT receiver data
-  const auto &base_ots_rcv = base_ot_data_.GetReceiverData();
+  // storage for sender data
   auto &ot_ext_snd = data_.GetSenderData();
 
   // number of OTs after extension
@@ -179,58 +188,20 @@ void OTProviderFromOTExtension::SendSetup() {
   }
   ot_ext_snd.bit_size_ = bit_size;
 
-  // XXX: index variable?
-  std::size_t i;
-
-  // bit size of the matrix rounded to bytes
-  // XXX: maybe round to blocks?
-  const std::size_t byte_size = MOTION::Helpers::Convert::BitsToBytes(bit_size);
-
   // bit size rounded to blocks
   const auto bit_size_padded = bit_size + kappa - (bit_size % kappa);
 
-  // vector containing the matrix rows
-  // XXX: note that rows/columns are swapped compared to the ALSZ paper
-  std::vector<AlignedBitVector> v(kappa);
+  // the matrix is expanded and transposed in windows of columns s.t. only one
+  // window of it and the masks of kMaxWindowsInFlight windows need to be kept
+  // in memory
+  const std::size_t window_size =
+      window_size_ == 0 ? bit_size_padded
+                        : std::min((window_size_ + kappa - 1) / kappa * kappa, bit_size_padded);
 
-  // PRG which is used to expand the keys we got from the base OTs
-  PRG prgs_var_key;
-  //// fill the rows of the matrix
-  for (i = 0; i < kappa; ++i) {
-    // use the key we got from the base OTs as seed
-    prgs_var_key.SetKey(base_ots_rcv.messages_c_.at(i).data());
-    // change the offset in the output stream since we might have already used
-    // the same base OTs previously
-    prgs_var_key.SetOffset(base_ots_rcv.consumed_offset_);
-    // expand the seed such that it fills one row of the matrix
-    auto row(prgs_var_key.Encrypt(byte_size));
-    v[i] = AlignedBitVector(std::move(row), bit_size_padded);
-  }
+  // blocks of the expanded base OTs used by previous runs of the OT extension
+  const std::size_t base_ot_offset = ot_ext_snd.consumed_offset_base_ots_;
   ot_ext_snd.consumed_offset_base_ots_ += bit_size_padded / kappa;
 
-  // receive the vectors u one by one from the receiver
-  // and xor them to the expanded keys if the corresponding selection bit is 1
-  // transmitted one by one to prevent waiting for finishing all messages to start sending
-  // the vectors can be transmitted in the wrong order
-
-  for (auto it = ot_ext_snd.u_futures_.begin(); it < ot_ext_snd.u_futures_.end(); ++it) {
-    const std::size_t u_id{it->get()};
-    if (base_ots_rcv.c_[u_id]) {
-      const auto &u = ot_ext_snd.u_[u_id];
-      ENCRYPTO::BitSpan bs(v[u_id].GetMutableData().data(), bit_size, true);
-      bs ^= u;
-    }
-  }
-
-  // delete the allocated memory
-  ot_ext_snd.u_ = {};
-
-  // array with pointers to each row of the matrix
-  std::array<const std::byte *, kappa> ptrs;
-  for (i = 0u; i < ptrs.size(); ++i) {
-    ptrs[i] = v[i].GetData().data();
-  }
-
   // pad the vector of bitlength with zeros
   ot_ext_snd.bitlengths_.resize(bit_size_padded, 0);
 
@@ -241,10 +212,16 @@ void OTProviderFromOTExtension::SendSetup() {
   PRG prg_fixed_key;
   prg_fixed_key.SetKey(fixed_key_aes_key.data());
 
-  // transpose the bit matrix
-  // XXX: figure out how the result looks like
-  BitMatrix::SenderTransposeAndEncrypt(ptrs, ot_ext_snd.y0_, ot_ext_snd.y1_, base_ots_rcv.c_,
-                                       prg_fixed_key, bit_size_padded, ot_ext_snd.bitlengths_);
+  for (std::size_t window_offset = 0; window_offset < bit_size_padded;
+       window_offset += window_size) {
+    const auto window_bit_size = std::min(window_size, bit_size_padded - window_offset);
+    ExtendSenderWindow(base_ot_offset, window_offset, window_bit_size, ot_ext_snd.y0_,
+                       ot_ext_snd.y1_, ot_ext_snd.bitlengths_, window_offset, prg_fixed_key);
+    // the receiver waits for this before it sends the masks of a later window
+    if (window_offset + kMaxWindowsInFlight * window_size < bit_size_padded) {
+      Send_(MOTION::Communication::BuildOTExtensionMessageSenderWindowAck(window_offset));
+    }
+  }
   /*
     for (i = 0; i < ot_ext_snd.bitlengths_.size(); ++i) {
       // here we want to store the sender's outputs
@@ -302,14 +279,17 @@ void OTProviderFromOTExtension::SendSetup() {
 }
 
 void OTProviderFromOTExtension::ReceiveSetup() {
+  if (extension_backend_ == OTExtensionBackend::silent) {
+    SilentReceiveSetup();
+    return;
+  }
+
   if constexpr (MOTION::MOTION_DEBUG) {
     if (logger_) {
       logger_->LogDebug("OTProviderFromOTExtension::ReceiveSetup() start");
     }
   }
 
-  // some index variables
-  std::size_t i = 0, j = 0;
   // security parameter and number of base OTs
   constexpr std::size_t kappa = 128;
   // number of OTs and width of the bit matrix
@@ -326,94 +306,430 @@ void OTProviderFromOTExtension::ReceiveSetup() {
   // rounded up to a multiple of the security parameter
   const auto bit_size_padded = bit_size + kappa - (bit_size % kappa);
 
-  // convert to bytes
-  const std::size_t byte_size = MOTION::Helpers::Convert::BitsToBytes(bit_size);
-  // XXX: if byte_size is 0 then bit_size was also zero (or an overflow happened
-  if (byte_size == 0) {
-    return;
-  }
-  // storage for receiver and base OT sender data
-  const auto &base_ots_snd = base_ot_data_.GetSenderData();
+  // the matrix is expanded and transposed in windows of columns s.t. only one
+  // window of it and the masks of kMaxWindowsInFlight windows need to be kept
+  // in memory
+  const std::size_t window_size =
+      window_size_ == 0 ? bit_size_padded
+                        : std::min((window_size_ + kappa - 1) / kappa * kappa, bit_size_padded);
+
+  // storage for receiver data
   auto &ot_ext_rcv = data_.GetReceiverData();
 
   // make random choices (this is precomputation, real inputs are not known yet)
   ot_ext_rcv.random_choices_ =
       std::make_unique<AlignedBitVector>(AlignedBitVector::Random(bit_size));
 
-  // create matrix with kappa rows
+  // blocks of the expanded base OTs used by previous runs of the OT extension
+  const std::size_t base_ot_offset = ot_ext_rcv.consumed_offset_base_ots_;
+  ot_ext_rcv.consumed_offset_base_ots_ += bit_size_padded / kappa;
+
+  // pad the vector of bitlength with zeros
+  ot_ext_rcv.bitlengths_.resize(bit_size_padded, 0);
+
+  motion_base_provider_.setup();
+  const auto &fixed_key_aes_key = motion_base_provider_.get_aes_fixed_key();
+
+  PRG prg_fixed_key;
+  prg_fixed_key.SetKey(fixed_key_aes_key.data());
+
+  for (std::size_t window_offset = 0; window_offset < bit_size_padded;
+       window_offset += window_size) {
+    const auto window_bit_size = std::min(window_size, bit_size_padded - window_offset);
+    // our choices in this window, the padding columns are zero
+    auto choices = ot_ext_rcv.random_choices_->Subset(
+        window_offset, std::min(window_offset + window_bit_size, bit_size));
+    choices.Resize(window_bit_size, true);
+    // the sender buffers the masks of all windows it has not used yet
+    if (window_offset >= kMaxWindowsInFlight * window_size) {
+      ot_ext_rcv.WaitForWindowAck(window_offset - kMaxWindowsInFlight * window_size);
+    }
+    ExtendReceiverWindow(base_ot_offset, window_offset, choices, ot_ext_rcv.outputs_,
+                         ot_ext_rcv.bitlengths_, window_offset, prg_fixed_key);
+  }
+  /*BitMatrix::TransposeUsingBitSlicing(ptrs, bit_size_padded);
+  for (i = 0; i < ot_ext_rcv.outputs_.size(); ++i) {
+    const auto row_i = i % kappa;
+    const auto blk_offset = ((kappa / 8) * (i / kappa));
+    const auto T_row = ptrs.at(row_i) + blk_offset;
+    auto &out = ot_ext_rcv.outputs_.at(i);
+
+    std::unique_lock lock(ot_ext_rcv.bitlengths_mutex_);
+    const std::size_t bitlen = ot_ext_rcv.bitlengths_.at(i);
+    lock.unlock();
+
+    if (bitlen <= kappa) {
+      out = BitVector<>(prg_fixed_key.FixedKeyAES(T_row, i), bitlen);
+    } else {
+      auto seed = prg_fixed_key.FixedKeyAES(T_row, i);
+      prg_var_key.SetKey(seed.data());
+      out = BitVector<>(prg_var_key.Encrypt(MOTION::Helpers::Convert::BitsToBytes(bitlen)), bitlen);
+    }
+  }*/
+
+  {
+    std::scoped_lock(ot_ext_rcv.setup_finished_cond_->GetMutex());
+    ot_ext_rcv.setup_finished_ = true;
+  }
+  ot_ext_rcv.setup_finished_cond_->NotifyAll();
+
+  if constexpr (MOTION::MOTION_DEBUG) {
+    if (logger_) {
+      logger_->LogDebug("OTProviderFromOTExtension::ReceiveSetup() end");
+    }
+  }
+}
+
+void OTProviderFromOTExtension::ExtendSenderWindow(
+    std::size_t base_ot_offset, std::size_t matrix_offset, std::size_t ncols,
+    std::vector<BitVector<>> &y0, std::vector<BitVector<>> &y1,
+    const std::vector<std::size_t> &bitlengths, std::size_t output_offset, PRG &prg_fixed_key) {
+  constexpr std::size_t kappa = 128;
+  const auto &base_ots_rcv = base_ot_data_.GetReceiverData();
+  auto &ot_ext_snd = data_.GetSenderData();
+
+  // PRG which is used to expand the keys we got from the base OTs
+  PRG prgs_var_key;
+
+  // vector containing the matrix rows of the window
+  // XXX: note that rows/columns are swapped compared to the ALSZ paper
   std::vector<AlignedBitVector> v(kappa);
 
-  // PRG we use with the fixed-key AES function
+  // array with pointers to each row of the matrix
+  std::array<const std::byte *, kappa> ptrs;
+
+  //// fill the rows of the matrix
+  for (std::size_t i = 0; i < kappa; ++i) {
+    // use the key we got from the base OTs as seed
+    prgs_var_key.SetKey(base_ots_rcv.messages_c_.at(i).data());
+    // change the offset in the output stream since we might have already used
+    // the same base OTs previously
+    prgs_var_key.SetOffset(base_ots_rcv.consumed_offset_ + base_ot_offset + matrix_offset / kappa);
+    // expand the seed such that it fills one row of the matrix
+    auto row(prgs_var_key.Encrypt(ncols / 8));
+    v[i] = AlignedBitVector(std::move(row), ncols);
+  }
+
+  // take the receiver's masks of this window as they arrive and xor them to
+  // the expanded keys if the corresponding selection bit is 1
+  for (std::size_t i = 0; i < kappa; ++i) {
+    auto u = ot_ext_snd.TakeReceiverMask(matrix_offset + i);
+    assert(u.GetSize() == ncols);
+    if (base_ots_rcv.c_[i]) {
+      v[i] ^= u;
+    }
+  }
+
+  for (std::size_t i = 0; i < kappa; ++i) {
+    ptrs[i] = v[i].GetData().data();
+  }
+
+  // transpose the bit matrix
+  // XXX: figure out how the result looks like
+  BitMatrix::SenderTransposeAndEncrypt(ptrs, y0, y1, base_ots_rcv.c_, prg_fixed_key, ncols,
+                                       bitlengths, output_offset);
+}
+
+void OTProviderFromOTExtension::ExtendReceiverWindow(
+    std::size_t base_ot_offset, std::size_t matrix_offset, const AlignedBitVector &choices,
+    std::vector<BitVector<>> &outputs, const std::vector<std::size_t> &bitlengths,
+    std::size_t output_offset, PRG &prg_fixed_key) {
+  constexpr std::size_t kappa = 128;
+  const auto &base_ots_snd = base_ot_data_.GetSenderData();
+  const auto ncols = choices.GetSize();
 
   // PRG which is used to expand the keys we got from the base OTs
-  PRG prg_fixed_key, prg_var_key;
+  PRG prg_var_key;
+
+  // rows of the matrix in the window
+  std::vector<AlignedBitVector> v(kappa);
+
+  std::array<const std::byte *, kappa> ptrs;
+
   // fill the rows of the matrix
-  for (i = 0; i < kappa; ++i) {
+  for (std::size_t i = 0; i < kappa; ++i) {
     // generate rows of the matrix using the corresponding 0 key
     // T[j] = PRG(s_{j,0})
     prg_var_key.SetKey(base_ots_snd.messages_0_.at(i).data());
     // change the offset in the output stream since we might have already used
     // the same base OTs previously
-    prg_var_key.SetOffset(base_ots_snd.consumed_offset_);
+    prg_var_key.SetOffset(base_ots_snd.consumed_offset_ + base_ot_offset + matrix_offset / kappa);
     // expand the seed such that it fills one row of the matrix
-    auto row(prg_var_key.Encrypt(byte_size));
-    v.at(i) = AlignedBitVector(std::move(row), bit_size);
+    auto row(prg_var_key.Encrypt(ncols / 8));
+    v.at(i) = AlignedBitVector(std::move(row), ncols);
     // take a copy of the row and XOR it with our choices
     auto u = v.at(i);
     // u_j = T[j] XOR r
-    u ^= *ot_ext_rcv.random_choices_;
+    u ^= choices;
 
     // now mask the result with random stream expanded from the 1 key
     // u_j = u_j XOR PRG(s_{j,1})
     prg_var_key.SetKey(base_ots_snd.messages_1_.at(i).data());
-    prg_var_key.SetOffset(base_ots_snd.consumed_offset_);
-    u ^= AlignedBitVector(prg_var_key.Encrypt(byte_size), bit_size);
+    prg_var_key.SetOffset(base_ots_snd.consumed_offset_ + base_ot_offset + matrix_offset / kappa);
+    u ^= AlignedBitVector(prg_var_key.Encrypt(ncols / 8), ncols);
 
     // send this row
-    Send_(MOTION::Communication::BuildOTExtensionMessageReceiverMasks(u.GetData().data(),
-                                                                      u.GetData().size(), i));
+    Send_(MOTION::Communication::BuildOTExtensionMessageReceiverMasks(
+        u.GetData().data(), u.GetData().size(), matrix_offset + i));
   }
-  ot_ext_rcv.consumed_offset_base_ots_ += bit_size_padded / kappa;
 
   // transpose matrix T
-  if (bit_size_padded != bit_size) {
-    for (i = 0u; i < v.size(); ++i) {
-      v.at(i).Resize(bit_size_padded, true);
+  for (std::size_t j = 0; j < ptrs.size(); ++j) {
+    ptrs.at(j) = v.at(j).GetData().data();
+  }
+  BitMatrix::ReceiverTransposeAndEncrypt(ptrs, outputs, prg_fixed_key, ncols, bitlengths,
+                                         output_offset);
+}
+
+// hash a block of the silent OT extension to an OT output of the given bit
+// length in the same way as BitMatrix::SenderTransposeAndEncrypt
+static BitVector<> HashToOTOutput(PRG &prg_fixed_key, PRG &prg_var_key, block128_t x,
+                                  std::size_t bitlen) {
+  constexpr std::size_t kappa = 128;
+  prg_fixed_key.MMO(x.data());
+  if (bitlen <= kappa) {
+    return BitVector<>(x.data(), bitlen);
+  }
+  // string OT with bit length > 128 bit -> expand the hash as seed
+  prg_var_key.SetKey(x.data());
+  return BitVector<>(prg_var_key.Encrypt(MOTION::Helpers::Convert::BitsToBytes(bitlen)), bitlen);
+}
+
+// the two keys of the PRG for the GGM trees are derived from the fixed key
+static void SetGGMKeys(std::array<PRG, 2> &ggm_prgs,
+                       const std::vector<std::uint8_t> &fixed_key_aes_key) {
+  for (std::size_t i = 0; i < ggm_prgs.size(); ++i) {
+    auto key = fixed_key_aes_key;
+    key.at(0) ^= std::uint8_t(1) << i;
+    ggm_prgs[i].SetKey(key.data());
+  }
+}
+
+void OTProviderFromOTExtension::SilentSendSetup() {
+  if constexpr (MOTION::MOTION_DEBUG) {
+    if (logger_) {
+      logger_->LogDebug("OTProviderFromOTExtension::SilentSendSetup() start");
     }
   }
 
-  std::array<const std::byte *, kappa> ptrs;
-  for (j = 0; j < ptrs.size(); ++j) {
-    ptrs.at(j) = v.at(j).GetMutableData().data();
+  constexpr std::size_t kappa = 128;
+  auto &ot_ext_snd = data_.GetSenderData();
+
+  const std::size_t bit_size = sender_provider_.GetNumOTs();
+  if (bit_size == 0) {
+    if constexpr (MOTION::MOTION_DEBUG) {
+      if (logger_) {
+        logger_->LogDebug("OTProviderFromOTExtension::SilentSendSetup() return, nothing to do");
+      }
+    }
+    return;  // no OTs needed
   }
+  ot_ext_snd.bit_size_ = bit_size;
+
+  // the OTs are produced in windows of the same size as for IKNP, each of
+  // which is one instance of the silent OT extension
+  const auto bit_size_padded = bit_size + kappa - (bit_size % kappa);
+  const std::size_t window_size =
+      window_size_ == 0 ? bit_size_padded
+                        : std::min((window_size_ + kappa - 1) / kappa * kappa, bit_size_padded);
+
+  // blocks of the expanded base OTs used by previous runs of the OT extension
+  const std::size_t base_ot_offset = ot_ext_snd.consumed_offset_base_ots_;
+  // columns of the IKNP matrix extended in this run
+  std::size_t matrix_offset = 0;
+
+  ot_ext_snd.bitlengths_.resize(bit_size_padded, 0);
+
+  motion_base_provider_.setup();
+  const auto &fixed_key_aes_key = motion_base_provider_.get_aes_fixed_key();
+  PRG prg_fixed_key, prg_var_key;
+  prg_fixed_key.SetKey(fixed_key_aes_key.data());
+  std::array<PRG, 2> ggm_prgs;
+  SetGGMKeys(ggm_prgs, fixed_key_aes_key);
+
+  for (std::size_t window_offset = 0; window_offset < bit_size_padded;
+       window_offset += window_size) {
+    const auto window_bit_size = std::min(window_size, bit_size_padded - window_offset);
+    const SilentOTParameters params(window_bit_size);
+    if (!params.SavesCommunication()) {
+      ExtendSenderWindow(base_ot_offset, matrix_offset, window_bit_size, ot_ext_snd.y0_,
+                         ot_ext_snd.y1_, ot_ext_snd.bitlengths_, window_offset, prg_fixed_key);
+      matrix_offset += window_bit_size;
+      continue;
+    }
+
+    // random OTs to transfer the level sums of the GGM trees
+    const auto num_base_ots_padded = (params.num_base_ots_ + kappa - 1) / kappa * kappa;
+    const std::vector<std::size_t> base_bitlengths(num_base_ots_padded, kappa);
+    std::vector<BitVector<>> base_y0(params.num_base_ots_), base_y1(params.num_base_ots_);
+    ExtendSenderWindow(base_ot_offset, matrix_offset, num_base_ots_padded, base_y0, base_y1,
+                       base_bitlengths, 0, prg_fixed_key);
+    matrix_offset += num_base_ots_padded;
+
+    // the lsb of delta is set and those of the leaves are cleared s.t. the
+    // receiver's choices are the lsbs of its outputs
+    auto delta = block128_t::make_random();
+    *delta.data() |= std::byte(0x01);
+
+    const auto depth = params.tree_depth_;
+    const std::size_t num_leaves = std::size_t(1) << depth;
+    block128_vector noise(params.code_length_);
+    // the masked level sums of all trees followed by one correction per tree
+    block128_vector message(2 * params.num_base_ots_ + params.num_trees_);
+#pragma omp parallel for
+    for (std::size_t tree_i = 0; tree_i < params.num_trees_; ++tree_i) {
+      auto leaves = noise.data() + tree_i * num_leaves;
+      block128_vector level_sums(2 * depth);
+      ExpandGGMTree(ggm_prgs[0].get_round_keys(), ggm_prgs[1].get_round_keys(),
+                    block128_t::make_random(), depth, leaves, level_sums.data());
+      for (std::size_t level_i = 0; level_i < depth; ++level_i) {
+        const auto ot_i = tree_i * depth + level_i;
+        message[2 * ot_i] = level_sums[2 * level_i] ^ base_y0[ot_i].GetData().data();
+        message[2 * ot_i + 1] = level_sums[2 * level_i + 1] ^ base_y1[ot_i].GetData().data();
+      }
+      auto &correction = message[2 * params.num_base_ots_ + tree_i];
+      correction = delta;
+      for (std::size_t leaf_i = 0; leaf_i < num_leaves; ++leaf_i) {
+        *leaves[leaf_i].data() &= std::byte(0xfe);
+        correction ^= leaves[leaf_i];
+      }
+    }
+    Send_(MOTION::Communication::BuildOTExtensionMessageSilentOTSender(
+        reinterpret_cast<const std::byte *>(message.data()), message.byte_size(), window_offset));
+
+    // q = v * H, the receiver gets q ^ (e * H) * delta
+    block128_vector q(window_bit_size);
+    ExpandAccumulateDualEncode(noise.data(), params.code_length_, q.data(), window_bit_size);
+    for (std::size_t i = 0; i < window_bit_size && window_offset + i < bit_size; ++i) {
+      const auto bitlen = ot_ext_snd.bitlengths_[window_offset + i];
+      ot_ext_snd.y0_[window_offset + i] = HashToOTOutput(prg_fixed_key, prg_var_key, q[i], bitlen);
+      ot_ext_snd.y1_[window_offset + i] =
+          HashToOTOutput(prg_fixed_key, prg_var_key, q[i] ^ delta, bitlen);
+    }
+  }
+  ot_ext_snd.consumed_offset_base_ots_ += matrix_offset / kappa;
+
+  // we are done with the setup for the sender side
+  {
+    std::scoped_lock(ot_ext_snd.setup_finished_cond_->GetMutex());
+    ot_ext_snd.setup_finished_ = true;
+  }
+  ot_ext_snd.setup_finished_cond_->NotifyAll();
+
+  if constexpr (MOTION::MOTION_DEBUG) {
+    if (logger_) {
+      logger_->LogDebug("OTProviderFromOTExtension::SilentSendSetup() end");
+    }
+  }
+}
+
+void OTProviderFromOTExtension::SilentReceiveSetup() {
+  if constexpr (MOTION::MOTION_DEBUG) {
+    if (logger_) {
+      logger_->LogDebug("OTProviderFromOTExtension::SilentReceiveSetup() start");
+    }
+  }
+
+  constexpr std::size_t kappa = 128;
+  auto &ot_ext_rcv = data_.GetReceiverData();
+
+  const std::size_t bit_size = receiver_provider_.GetNumOTs();
+  if (bit_size == 0) {
+    if constexpr (MOTION::MOTION_DEBUG) {
+      if (logger_) {
+        logger_->LogDebug("OTProviderFromOTExtension::SilentReceiveSetup() return, nothing to do");
+      }
+    }
+    return;  // nothing to do
+  }
+
+  const auto bit_size_padded = bit_size + kappa - (bit_size % kappa);
+  const std::size_t window_size =
+      window_size_ == 0 ? bit_size_padded
+                        : std::min((window_size_ + kappa - 1) / kappa * kappa, bit_size_padded);
+
+  // the random choices are determined by the noise, they are set window by window
+  ot_ext_rcv.random_choices_ = std::make_unique<AlignedBitVector>(bit_size);
+
+  // blocks of the expanded base OTs used by previous runs of the OT extension
+  const std::size_t base_ot_offset = ot_ext_rcv.consumed_offset_base_ots_;
+  // columns of the IKNP matrix extended in this run
+  std::size_t matrix_offset = 0;
 
-  // pad the vector of bitlength with zeros
   ot_ext_rcv.bitlengths_.resize(bit_size_padded, 0);
 
   motion_base_provider_.setup();
   const auto &fixed_key_aes_key = motion_base_provider_.get_aes_fixed_key();
+  PRG prg_fixed_key, prg_var_key;
   prg_fixed_key.SetKey(fixed_key_aes_key.data());
-  BitMatrix::ReceiverTransposeAndEncrypt(ptrs, ot_ext_rcv.outputs_, prg_fixed_key, bit_size_padded,
-                                         ot_ext_rcv.bitlengths_);
-  /*BitMatrix::TransposeUsingBitSlicing(ptrs, bit_size_padded);
-  for (i = 0; i < ot_ext_rcv.outputs_.size(); ++i) {
-    const auto row_i = i % kappa;
-    const auto blk_offset = ((kappa / 8) * (i / kappa));
-    const auto T_row = ptrs.at(row_i) + blk_offset;
-    auto &out = ot_ext_rcv.outputs_.at(i);
+  std::array<PRG, 2> ggm_prgs;
+  SetGGMKeys(ggm_prgs, fixed_key_aes_key);
+
+  for (std::size_t window_offset = 0; window_offset < bit_size_padded;
+       window_offset += window_size) {
+    const auto window_bit_size = std::min(window_size, bit_size_padded - window_offset);
+    const SilentOTParameters params(window_bit_size);
+    if (!params.SavesCommunication()) {
+      const auto choices = AlignedBitVector::Random(window_bit_size);
+      ExtendReceiverWindow(base_ot_offset, matrix_offset, choices, ot_ext_rcv.outputs_,
+                           ot_ext_rcv.bitlengths_, window_offset, prg_fixed_key);
+      for (std::size_t i = 0; i < window_bit_size && window_offset + i < bit_size; ++i) {
+        ot_ext_rcv.random_choices_->Set(choices.Get(i), window_offset + i);
+      }
+      matrix_offset += window_bit_size;
+      continue;
+    }
 
-    std::unique_lock lock(ot_ext_rcv.bitlengths_mutex_);
-    const std::size_t bitlen = ot_ext_rcv.bitlengths_.at(i);
-    lock.unlock();
+    // random OTs to receive the level sums of the GGM trees
+    const auto num_base_ots_padded = (params.num_base_ots_ + kappa - 1) / kappa * kappa;
+    const std::vector<std::size_t> base_bitlengths(num_base_ots_padded, kappa);
+    const auto base_choices = AlignedBitVector::Random(num_base_ots_padded);
+    std::vector<BitVector<>> base_outputs(params.num_base_ots_);
+    ExtendReceiverWindow(base_ot_offset, matrix_offset, base_choices, base_outputs,
+                         base_bitlengths, 0, prg_fixed_key);
+    matrix_offset += num_base_ots_padded;
+
+    const auto message = ot_ext_rcv.TakeSilentOTMessage(window_offset);
+    assert(message.size() == 2 * params.num_base_ots_ + params.num_trees_);
+
+    const auto depth = params.tree_depth_;
+    const std::size_t num_leaves = std::size_t(1) << depth;
+    block128_vector noise(params.code_length_);
+#pragma omp parallel for
+    for (std::size_t tree_i = 0; tree_i < params.num_trees_; ++tree_i) {
+      // the choices of the random OTs are the negated bits of the punctured
+      // leaf, s.t. we learn the level sums of the siblings on the path to it
+      std::size_t punctured_index = 0;
+      block128_vector sibling_sums(depth);
+      for (std::size_t level_i = 0; level_i < depth; ++level_i) {
+        const auto ot_i = tree_i * depth + level_i;
+        const bool choice = base_choices.Get(ot_i);
+        punctured_index = (punctured_index << 1) | std::size_t(!choice);
+        sibling_sums[level_i] = message[2 * ot_i + choice] ^ base_outputs[ot_i].GetData().data();
+      }
+      auto leaves = noise.data() + tree_i * num_leaves;
+      ReconstructPuncturedGGMTree(ggm_prgs[0].get_round_keys(), ggm_prgs[1].get_round_keys(),
+                                  punctured_index, depth, sibling_sums.data(), leaves);
+      // the punctured leaf becomes the sender's leaf xor delta
+      auto punctured_leaf = message[2 * params.num_base_ots_ + tree_i];
+      for (std::size_t leaf_i = 0; leaf_i < num_leaves; ++leaf_i) {
+        *leaves[leaf_i].data() &= std::byte(0xfe);
+        punctured_leaf ^= leaves[leaf_i];
+      }
+      leaves[punctured_index] = punctured_leaf;
+    }
 
-    if (bitlen <= kappa) {
-      out = BitVector<>(prg_fixed_key.FixedKeyAES(T_row, i), bitlen);
-    } else {
-      auto seed = prg_fixed_key.FixedKeyAES(T_row, i);
-      prg_var_key.SetKey(seed.data());
-      out = BitVector<>(prg_var_key.Encrypt(MOTION::Helpers::Convert::BitsToBytes(bitlen)), bitlen);
+    // t = w * H = q ^ (e * H) * delta, where e * H are our choices
+    block128_vector t(window_bit_size);
+    ExpandAccumulateDualEncode(noise.data(), params.code_length_, t.data(), window_bit_size);
+    for (std::size_t i = 0; i < window_bit_size && window_offset + i < bit_size; ++i) {
+      const auto bitlen = ot_ext_rcv.bitlengths_[window_offset + i];
+      ot_ext_rcv.random_choices_->Set(bool(*t[i].data() & std::byte(0x01)), window_offset + i);
+      ot_ext_rcv.outputs_[window_offset + i] =
+          HashToOTOutput(prg_fixed_key, prg_var_key, t[i], bitlen);
     }
-  }*/
+  }
+  ot_ext_rcv.consumed_offset_base_ots_ += matrix_offset / kappa;
 
   {
     std::scoped_lock(ot_ext_rcv.setup_finished_cond_->GetMutex());
@@ -423,7 +739,7 @@ void OTProviderFromOTExtension::ReceiveSetup() {
 
   if constexpr (MOTION::MOTION_DEBUG) {
     if (logger_) {
-      logger_->LogDebug("OTProviderFromOTExtension::ReceiveSetup() end");
+      logger_->LogDebug("OTProviderFromOTExtension::SilentReceiveSetup() end");
     }
   }
 }
@@ -1077,7 +1393,7 @@ void OTProviderSender::Clear() {
   }
   {
     std::scoped_lock lock(data_.u_mutex_);
-    data_.num_received_u_ = 0;
+    data_.u_.clear();
   }
 }
 
@@ -1334,6 +1650,16 @@ void OTExtensionMessageHandler::received_message(std::size_t,
       data_.MessageReceived(ot_data, ot_data_size, MOTION::OTExtensionDataType::snd_messages, index_i);
       break;
     }
+    case MOTION::Communication::MessageType::OTExtensionSilentOTSender: {
+      data_.MessageReceived(ot_data, ot_data_size, MOTION::OTExtensionDataType::snd_silent_ot,
+                            index_i);
+      break;
+    }
+    case MOTION::Communication::MessageType::OTExtensionSenderWindowAck: {
+      data_.MessageReceived(ot_data, ot_data_size, MOTION::OTExtensionDataType::snd_window_ack,
+                            index_i);
+      break;
+    }
     default: {
       assert(false);
       break;
@@ -1374,14 +1700,18 @@ OTProviderManager::OTProviderManager(MOTION::Communication::CommunicationLayer &
       },
       {MOTION::Communication::MessageType::OTExtensionReceiverMasks,
        MOTION::Communication::MessageType::OTExtensionReceiverCorrections,
-       MOTION::Communication::MessageType::OTExtensionSender});
+       MOTION::Communication::MessageType::OTExtensionSender,
+       MOTION::Communication::MessageType::OTExtensionSilentOTSender,
+       MOTION::Communication::MessageType::OTExtensionSenderWindowAck});
 }
 
 OTProviderManager::~OTProviderManager() {
   communication_layer_.deregister_message_handler(
       {MOTION::Communication::MessageType::OTExtensionReceiverMasks,
        MOTION::Communication::MessageType::OTExtensionReceiverCorrections,
-       MOTION::Communication::MessageType::OTExtensionSender});
+       MOTION::Communication::MessageType::OTExtensionSender,
+       MOTION::Communication::MessageType::OTExtensionSilentOTSender,
+       MOTION::Communication::MessageType::OTExtensionSenderWindowAck});
 }
 
 void OTProviderManager::run_setup() {
@@ -1421,6 +1751,22 @@ void OTProviderManager::run_setup() {
   }
 }
 
+void OTProviderManager::set_window_size(std::size_t num_ots) {
+  for (auto &provider : providers_) {
+    if (provider) {
+      provider->SetWindowSize(num_ots);
+    }
+  }
+}
+
+void OTProviderManager::set_extension_backend(OTExtensionBackend backend) {
+  for (auto &provider : providers_) {
+    if (provider) {
+      provider->SetExtensionBackend(backend);
+    }
+  }
+}
+
 void OTProviderManager::clear() {
   if constexpr (MOTION::MOTION_DEBUG) {
     logger_->LogDebug("OTProviderManager::clear()");
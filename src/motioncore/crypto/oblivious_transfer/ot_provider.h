@@ -59,6 +59,8 @@ struct RunTimeStats;
 
 namespace ENCRYPTO {
 
+class PRG;
+
 namespace ObliviousTransfer {
 
 enum OTProtocol : uint {
@@ -72,6 +74,12 @@ enum OTProtocol : uint {
   GOT128 = 7
 };
 
+// protocol used to extend the base OTs
+enum class OTExtensionBackend {
+  iknp,    // IKNP OT extension, sends 128 bit per OT
+  silent,  // silent OT extension from dual LPN, see silent_ot.h
+};
+
 class FixedXCOT128Sender;
 class FixedXCOT128Receiver;
 class XCOTBitSender;
@@ -433,6 +441,24 @@ class OTProvider {
 
   void WaitSetup() const;
 
+  /// @param num_ots Number of OTs (rounded up to a multiple of 128) extended at once, 0 means all
+  /// The scratch space for expanding and transposing the OT extension matrix is bounded by the
+  /// window, and the sender acknowledges each window s.t. the receiver's masks of at most two
+  /// windows are in flight.  The outputs of all OTs are still stored until the gates consume
+  /// them.  Both parties need to use the same window size.
+  void SetWindowSize(std::size_t num_ots) noexcept { window_size_ = num_ots; }
+
+  [[nodiscard]] std::size_t GetWindowSize() const noexcept { return window_size_; }
+
+  /// The silent OT extension sends much less than IKNP for large numbers of
+  /// OTs, windows which are too small for it are extended with IKNP.  Both
+  /// parties need to use the same backend.
+  void SetExtensionBackend(OTExtensionBackend backend) noexcept { extension_backend_ = backend; }
+
+  [[nodiscard]] OTExtensionBackend GetExtensionBackend() const noexcept {
+    return extension_backend_;
+  }
+
   void Clear() {
     receiver_provider_.Clear();
     sender_provider_.Clear();
@@ -453,6 +479,8 @@ class OTProvider {
   OTProviderReceiver receiver_provider_;
   OTProviderSender sender_provider_;
   std::shared_ptr<MOTION::Logger> logger_;
+  std::size_t window_size_ = 0;
+  OTExtensionBackend extension_backend_ = OTExtensionBackend::iknp;
 };
 
 class OTProviderFromFile : public OTProvider {
@@ -475,6 +503,24 @@ class OTProviderFromOTExtension final : public OTProvider {
                             std::shared_ptr<MOTION::Logger> logger);
 
  private:
+  void SilentSendSetup();
+
+  void SilentReceiveSetup();
+
+  // Extend the base OTs with IKNP to the ncols columns of the OT extension
+  // matrix starting at column matrix_offset, where base_ot_offset blocks of the
+  // expanded base OTs were used by previous runs.  The outputs are written to
+  // the OTs starting at output_offset.
+  void ExtendSenderWindow(std::size_t base_ot_offset, std::size_t matrix_offset,
+                          std::size_t ncols, std::vector<BitVector<>>& y0,
+                          std::vector<BitVector<>>& y1, const std::vector<std::size_t>& bitlengths,
+                          std::size_t output_offset, PRG& prg_fixed_key);
+
+  void ExtendReceiverWindow(std::size_t base_ot_offset, std::size_t matrix_offset,
+                            const AlignedBitVector& choices, std::vector<BitVector<>>& outputs,
+                            const std::vector<std::size_t>& bitlengths, std::size_t output_offset,
+                            PRG& prg_fixed_key);
+
   const MOTION::BaseOTsData& base_ot_data_;
   MOTION::Crypto::MotionBaseProvider& motion_base_provider_;
 };
@@ -498,6 +544,13 @@ class OTProviderManager : public enable_wait_setup {
   OTProvider& get_provider(std::size_t party_id) { return *providers_.at(party_id); }
   void run_setup();
 
+  // expand and transpose the OT extension matrix in windows of num_ots OTs, see
+  // OTProvider::SetWindowSize
+  void set_window_size(std::size_t num_ots);
+
+  // extend the OTs with the given protocol, see OTProvider::SetExtensionBackend
+  void set_extension_backend(OTExtensionBackend backend);
+
   // reset all data structures for a new round of OTs
   void clear();
 
@@ -0,0 +1,163 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "silent_ot.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+
+#include "crypto/aes/aesni_primitives.h"
+
+namespace ENCRYPTO::ObliviousTransfer {
+
+// minimum noise weight for 128 bit security against linear attacks on codes
+// with a minimum distance of at least 0.1 * code_length, following the
+// estimate of getRegNoiseWeight in libOTe
+constexpr std::size_t kMinNumTrees = 400;
+
+// number of accumulated positions that are added up for each output
+constexpr std::size_t kExpanderWeight = 11;
+
+SilentOTParameters::SilentOTParameters(std::size_t num_ots) : num_ots_(num_ots) {
+  // the deepest trees s.t. there are still at least kMinNumTrees of them
+  tree_depth_ = 1;
+  while ((kMinNumTrees << (tree_depth_ + 1)) <= 2 * num_ots) {
+    ++tree_depth_;
+  }
+  const std::size_t num_leaves = std::size_t(1) << tree_depth_;
+  num_trees_ = std::max(kMinNumTrees, (2 * num_ots + num_leaves - 1) / num_leaves);
+  code_length_ = num_trees_ * num_leaves;
+  num_base_ots_ = num_trees_ * tree_depth_;
+}
+
+bool SilentOTParameters::SavesCommunication() const noexcept {
+  // in blocks: the IKNP OT extension sends one per OT, the silent one extends
+  // the base OTs with IKNP and sends the masked level sums and one correction
+  // per tree
+  const auto num_base_ots_padded = (num_base_ots_ + 127) / 128 * 128;
+  return num_base_ots_padded + 2 * num_base_ots_ + num_trees_ < num_ots_;
+}
+
+void ExpandGGMTree(const void* round_keys_0, const void* round_keys_1, const block128_t& seed,
+                   std::size_t depth, block128_t* leaves, block128_t* level_sums) {
+  assert(depth > 0);
+  // the levels alternate between the leaves and a buffer of half the size s.t.
+  // the last level ends up in the leaves
+  block128_vector buffer(std::size_t(1) << (depth - 1));
+  const block128_t* parents = &seed;
+  for (std::size_t level = 1; level <= depth; ++level) {
+    auto nodes = (depth - level) % 2 == 0 ? leaves : buffer.data();
+    const std::size_t num_nodes = std::size_t(1) << level;
+    aesni_ggm_expand(round_keys_0, round_keys_1, parents, nodes, num_nodes / 2);
+    auto& sum_0 = level_sums[2 * (level - 1)];
+    auto& sum_1 = level_sums[2 * (level - 1) + 1];
+    sum_0.set_to_zero();
+    sum_1.set_to_zero();
+    for (std::size_t i = 0; i < num_nodes; i += 2) {
+      sum_0 ^= nodes[i];
+      sum_1 ^= nodes[i + 1];
+    }
+    parents = nodes;
+  }
+}
+
+void ReconstructPuncturedGGMTree(const void* round_keys_0, const void* round_keys_1,
+                                 std::size_t punctured_index, std::size_t depth,
+                                 const block128_t* sibling_sums, block128_t* leaves) {
+  assert(depth > 0);
+  assert(punctured_index < (std::size_t(1) << depth));
+  block128_vector buffer(std::size_t(1) << (depth - 1));
+  const block128_t* parents = nullptr;
+  for (std::size_t level = 1; level <= depth; ++level) {
+    auto nodes = (depth - level) % 2 == 0 ? leaves : buffer.data();
+    const std::size_t num_nodes = std::size_t(1) << level;
+    if (level > 1) {
+      aesni_ggm_expand(round_keys_0, round_keys_1, parents, nodes, num_nodes / 2);
+    }
+    // the node on the path to the punctured leaf is unknown, hence its
+    // children are garbage, and its sibling is the only unknown node with the
+    // sibling's parity
+    const std::size_t path = punctured_index >> (depth - level);
+    const std::size_t sibling = path ^ 1;
+    nodes[path].set_to_zero();
+    nodes[sibling].set_to_zero();
+    auto sum = sibling_sums[level - 1];
+    for (std::size_t i = sibling & 1; i < num_nodes; i += 2) {
+      sum ^= nodes[i];
+    }
+    nodes[sibling] = sum;
+    parents = nodes;
+  }
+}
+
+// round keys of the public key which determines the expander
+static const std::array<std::byte, aes_round_keys_size_128>& GetExpanderRoundKeys() {
+  alignas(aes_block_size) static const auto round_keys = [] {
+    // fractional digits of pi
+    constexpr std::array<std::uint8_t, aes_key_size_128> key = {
+        0x24, 0x3f, 0x6a, 0x88, 0x85, 0xa3, 0x08, 0xd3,
+        0x13, 0x19, 0x8a, 0x2e, 0x03, 0x70, 0x73, 0x44};
+    alignas(aes_block_size) std::array<std::byte, aes_round_keys_size_128> round_keys;
+    std::transform(std::begin(key), std::end(key), std::begin(round_keys),
+                   [](auto b) { return std::byte(b); });
+    aesni_key_expansion_128(round_keys.data());
+    return round_keys;
+  }();
+  return round_keys;
+}
+
+void ExpandAccumulateDualEncode(block128_t* input, std::size_t code_length, block128_t* output,
+                                std::size_t num_ots) {
+  assert(code_length > 0 && code_length <= (std::size_t(1) << 32));
+
+  // accumulate
+  for (std::size_t i = 1; i < code_length; ++i) {
+    input[i] ^= input[i - 1];
+  }
+
+  // expand: the positions are taken from an AES-CTR stream under a public key,
+  // one block contains four 32 bit positions that are scaled to [0, code_length)
+  constexpr std::size_t chunk_size = 256;
+  constexpr std::size_t blocks_per_chunk = chunk_size * kExpanderWeight / 4;
+  static_assert((chunk_size * kExpanderWeight) % 4 == 0);
+  const auto& round_keys = GetExpanderRoundKeys();
+  const std::size_t num_chunks = (num_ots + chunk_size - 1) / chunk_size;
+#pragma omp parallel for
+  for (std::size_t chunk_i = 0; chunk_i < num_chunks; ++chunk_i) {
+    alignas(aes_block_size) std::array<std::uint32_t, 4 * blocks_per_chunk> positions;
+    std::uint64_t counter = chunk_i * blocks_per_chunk;
+    aesni_ctr_stream_blocks_128(round_keys.data(), &counter, positions.data(), blocks_per_chunk);
+    const auto end = std::min(num_ots, (chunk_i + 1) * chunk_size);
+    auto position = positions.data();
+    for (std::size_t i = chunk_i * chunk_size; i < end; ++i) {
+      auto sum = block128_t::make_zero();
+      for (std::size_t k = 0; k < kExpanderWeight; ++k, ++position) {
+        sum ^= input[(std::uint64_t(*position) * code_length) >> 32];
+      }
+      output[i] = sum;
+    }
+  }
+}
+
+}  // namespace ENCRYPTO::ObliviousTransfer
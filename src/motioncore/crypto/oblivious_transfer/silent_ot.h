@@ -0,0 +1,81 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+
+#include "utility/block.h"
+
+namespace ENCRYPTO::ObliviousTransfer {
+
+// Building blocks of the silent OT extension, a variant of the semi-honest
+// protocol of Boyle et al. (https://eprint.iacr.org/2019/1159) with the
+// expand-accumulate code (https://eprint.iacr.org/2022/1014):
+//
+// - The sender's noise vector v consists of the leaves of num_trees_ GGM trees,
+//   the receiver learns all of them except one per tree from 128 bit OTs on the
+//   xors of the tree levels.  It fills this hole with v_a ^ delta, where delta
+//   is the sender's correlation, s.t. it holds w = v ^ e * delta with a regular
+//   noise vector e.
+// - Both parties compress their vectors with the transposed code, i.e., they
+//   get q = v * H and t = w * H = q ^ (e * H) * delta, which are correlated
+//   OTs with the pseudorandom choices e * H of the receiver under dual LPN.
+
+// Parameters of one instance which yields num_ots_ correlated OTs.
+struct SilentOTParameters {
+  explicit SilentOTParameters(std::size_t num_ots);
+
+  std::size_t num_ots_;
+  // noise weight and number of GGM trees
+  std::size_t num_trees_;
+  std::size_t tree_depth_;
+  // length of the noise vector, num_trees_ * 2^tree_depth_ >= 2 * num_ots_
+  std::size_t code_length_;
+  // number of 128 bit random OTs used for the GGM trees
+  std::size_t num_base_ots_;
+
+  // whether the instance sends less than the IKNP OT extension of num_ots_ OTs
+  [[nodiscard]] bool SavesCommunication() const noexcept;
+};
+
+// Expands a GGM tree from seed into its 2^depth leaves using the PRG of
+// aesni_ggm_expand with the given round keys.  level_sums[2 * (l - 1) + b]
+// is set to the xor of the nodes on level l with an index of parity b.
+void ExpandGGMTree(const void* round_keys_0, const void* round_keys_1, const block128_t& seed,
+                   std::size_t depth, block128_t* leaves, block128_t* level_sums);
+
+// Reconstructs the leaves of a GGM tree except the punctured one, which is
+// set to zero.  sibling_sums[l - 1] is the xor of the nodes on level l whose
+// parity differs from the l-th most significant bit of punctured_index.
+void ReconstructPuncturedGGMTree(const void* round_keys_0, const void* round_keys_1,
+                                 std::size_t punctured_index, std::size_t depth,
+                                 const block128_t* sibling_sums, block128_t* leaves);
+
+// Computes output = input * H with the transposed generator matrix H of the
+// expand-accumulate code: input is accumulated inplace, then each output is
+// the xor of pseudorandom positions of the accumulated vector.  The code is
+// public and fixed for given lengths.
+void ExpandAccumulateDualEncode(block128_t* input, std::size_t code_length, block128_t* output,
+                                std::size_t num_ots);
+
+}  // namespace ENCRYPTO::ObliviousTransfer
@@ -42,6 +42,10 @@ class AES128_CTR_RNG : public RNG {
   // (re)initialize the PRG with a randomly chosen key
   virtual void sample_key();
 
+  // (re)initialize the PRG with the given key of key_size bytes, the output
+  // is then fully determined by the key
+  void set_key(const std::byte* key);
+
   // fill the output buffer with num_bytes random bytes
   virtual void random_bytes(std::byte* output, std::size_t num_bytes);
 
@@ -55,6 +59,7 @@ class AES128_CTR_RNG : public RNG {
   static AES128_CTR_RNG& get_thread_instance() { return thread_instance_; }
 
   static constexpr std::size_t block_size = 16;
+  static constexpr std::size_t key_size = 16;
  private:
   struct AES128_CTR_RNG_State;
   std::unique_ptr<AES128_CTR_RNG_State> state_;
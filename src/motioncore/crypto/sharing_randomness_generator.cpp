@@ -38,7 +38,26 @@ SharingRandomnessGenerator::SharingRandomnessGenerator(std::size_t party_id)
 void SharingRandomnessGenerator::Initialize(
     const std::byte seed[SharingRandomnessGenerator::MASTER_SEED_BYTE_LENGTH]) {
   std::copy(seed, seed + MASTER_SEED_BYTE_LENGTH, std::begin(master_seed_));
+  DeriveKeys();
 
+  {
+    std::scoped_lock lock(initialized_condition_->GetMutex());
+    initialized_ = true;
+  }
+  initialized_condition_->NotifyAll();
+}
+
+void SharingRandomnessGenerator::SetEpoch(std::uint64_t epoch) {
+  initialized_condition_->Wait();
+  std::scoped_lock lock(random_bits_mutex_);
+  epoch_ = epoch;
+  DeriveKeys();
+  random_bits_ = ENCRYPTO::BitVector<>();
+  random_bits_offset_ = 0;
+  random_bits_used_ = 0;
+}
+
+void SharingRandomnessGenerator::DeriveKeys() {
   {
     auto digest = HashKey(master_seed_, KeyType::ArithmeticGMWKey);
     std::copy(digest.data(), digest.data() + AES_KEY_SIZE, raw_key_arithmetic_);
@@ -58,12 +77,6 @@ void SharingRandomnessGenerator::Initialize(
 
   prg_a.SetKey(raw_key_arithmetic_);
   prg_b.SetKey(raw_key_boolean_);
-
-  {
-    std::scoped_lock lock(initialized_condition_->GetMutex());
-    initialized_ = true;
-  }
-  initialized_condition_->NotifyAll();
 }
 
 ENCRYPTO::BitVector<> SharingRandomnessGenerator::GetBits(const std::size_t gate_id,
@@ -125,6 +138,12 @@ std::vector<std::byte> SharingRandomnessGenerator::HashKey(
   std::copy_n(reinterpret_cast<const std::byte *>(&key_type32), sizeof(key_type32),
               std::begin(seed_padded));
   std::copy_n(seed, MASTER_SEED_BYTE_LENGTH, &seed_padded[sizeof(key_type32)]);
+  // the keys of the first epoch are derived as before
+  if (epoch_ > 0) {
+    seed_padded.resize(seed_padded.size() + sizeof(epoch_));
+    std::copy_n(reinterpret_cast<const std::byte *>(&epoch_), sizeof(epoch_),
+                &seed_padded[sizeof(key_type32) + MASTER_SEED_BYTE_LENGTH]);
+  }
   EVP_MD_CTX *mdctx = EVP_MD_CTX_new();
   std::byte digest[EVP_MAX_MD_SIZE];
   unsigned int md_len;
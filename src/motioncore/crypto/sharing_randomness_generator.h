@@ -63,6 +63,10 @@ class SharingRandomnessGenerator {
 
   void Initialize(const std::byte seed[SharingRandomnessGenerator::MASTER_SEED_BYTE_LENGTH]);
 
+  // Derive fresh keys from the master seed s.t. the same gate ids can be used again, e.g., when
+  // a circuit is evaluated multiple times.  Both parties need to use the same epoch.
+  void SetEpoch(std::uint64_t epoch);
+
   ~SharingRandomnessGenerator() = default;
 
   std::vector<std::byte> GetSeed();
@@ -186,6 +190,11 @@ class SharingRandomnessGenerator {
   // use a seed to generate randomness for a new key
   std::vector<std::byte> HashKey(const std::byte seed[AES_KEY_SIZE], const KeyType key_type);
 
+  // derive keys and nonces from the master seed and the current epoch
+  void DeriveKeys();
+
+  std::uint64_t epoch_ = 0;
+
   bool initialized_ = false;
 
   ENCRYPTO::BitVector<> random_bits_;
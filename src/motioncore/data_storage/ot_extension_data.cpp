@@ -40,25 +40,39 @@ OTExtensionReceiverData::OTExtensionReceiverData() {
 OTExtensionSenderData::OTExtensionSenderData() {
   setup_finished_cond_ =
       std::make_unique<ENCRYPTO::FiberCondition>([this]() { return setup_finished_.load(); });
+}
+
+ENCRYPTO::block128_vector OTExtensionReceiverData::TakeSilentOTMessage(std::size_t i) {
+  std::unique_lock lock(silent_ot_messages_mutex_);
+  silent_ot_messages_cond_.wait(lock, [this, i] { return silent_ot_messages_.contains(i); });
+  auto node = silent_ot_messages_.extract(i);
+  return std::move(node.mapped());
+}
+
+void OTExtensionReceiverData::WaitForWindowAck(std::size_t i) {
+  std::unique_lock lock(window_acks_mutex_);
+  window_acks_cond_.wait(lock, [this, i] { return window_acks_.contains(i); });
+  window_acks_.erase(i);
+}
 
-  for (std::size_t i = 0; i < u_promises_.size(); ++i) u_futures_[i] = u_promises_[i].get_future();
+ENCRYPTO::AlignedBitVector OTExtensionSenderData::TakeReceiverMask(std::size_t i) {
+  std::unique_lock lock(u_mutex_);
+  u_cond_.wait(lock, [this, i] { return u_.contains(i); });
+  auto node = u_.extract(i);
+  return std::move(node.mapped());
 }
 
 void OTExtensionData::MessageReceived(const std::uint8_t *message,
-                                      [[maybe_unused]] std::size_t message_size,
+                                      std::size_t message_size,
                                       const OTExtensionDataType type, const std::size_t i) {
   switch (type) {
     case OTExtensionDataType::rcv_masks: {
       {
-        while (sender_data_.bit_size_ == 0) std::this_thread::yield();
+        // the masks span the columns of one window of the matrix
         std::scoped_lock lock(sender_data_.u_mutex_);
-        sender_data_.u_[i] = ENCRYPTO::AlignedBitVector(message, sender_data_.bit_size_);
-        sender_data_.u_promises_[sender_data_.num_received_u_].set_value(i);
-
-        // set to 0 after Clear()
-        sender_data_.num_received_u_++;
+        sender_data_.u_.insert_or_assign(i, ENCRYPTO::AlignedBitVector(message, message_size * 8));
       }
-
+      sender_data_.u_cond_.notify_all();
       break;
     }
     case OTExtensionDataType::rcv_corrections: {
@@ -261,6 +275,24 @@ void OTExtensionData::MessageReceived(const std::uint8_t *message,
       }
       break;
     }
+    case OTExtensionDataType::snd_silent_ot: {
+      assert(message_size % ENCRYPTO::block128_t::size() == 0);
+      {
+        std::scoped_lock lock(receiver_data_.silent_ot_messages_mutex_);
+        receiver_data_.silent_ot_messages_.insert_or_assign(
+            i, ENCRYPTO::block128_vector(message_size / ENCRYPTO::block128_t::size(), message));
+      }
+      receiver_data_.silent_ot_messages_cond_.notify_all();
+      break;
+    }
+    case OTExtensionDataType::snd_window_ack: {
+      {
+        std::scoped_lock lock(receiver_data_.window_acks_mutex_);
+        receiver_data_.window_acks_.insert(i);
+      }
+      receiver_data_.window_acks_cond_.notify_all();
+      break;
+    }
     default: {
       throw std::runtime_error(fmt::format(
           "DataStorage::OTExtensionDataType: unknown data type {}; data_type must be <{}", type,
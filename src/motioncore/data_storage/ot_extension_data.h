@@ -26,6 +26,7 @@
 
 #include <array>
 #include <atomic>
+#include <condition_variable>
 #include <cstddef>
 #include <memory>
 #include <mutex>
@@ -50,7 +51,9 @@ enum OTExtensionDataType : uint {
   rcv_masks = 0,
   rcv_corrections = 1,
   snd_messages = 2,
-  OTExtension_invalid_data_type = 3
+  snd_silent_ot = 3,
+  snd_window_ack = 4,
+  OTExtension_invalid_data_type = 5
 };
 
 enum class OTMsgType {
@@ -132,6 +135,22 @@ struct OTExtensionReceiverData {
   // random choices from OT precomputation
   std::unique_ptr<ENCRYPTO::AlignedBitVector> random_choices_;
 
+  // wait for the sender's message of the silent OT extension for the window
+  // with the given offset and take it out of silent_ot_messages_
+  ENCRYPTO::block128_vector TakeSilentOTMessage(std::size_t i);
+
+  std::unordered_map<std::size_t, ENCRYPTO::block128_vector> silent_ot_messages_;
+  std::mutex silent_ot_messages_mutex_;
+  std::condition_variable silent_ot_messages_cond_;
+
+  // wait until the sender has used our masks of the window with the given
+  // offset, and take the acknowledgement out of window_acks_
+  void WaitForWindowAck(std::size_t i);
+
+  std::unordered_set<std::size_t> window_acks_;
+  std::mutex window_acks_mutex_;
+  std::condition_variable window_acks_cond_;
+
   // how many ots are in each batch?
   std::unordered_map<std::size_t, std::size_t> num_ots_in_batch_;
 
@@ -151,13 +170,16 @@ struct OTExtensionSenderData {
   // width of the bit matrix
   std::atomic<std::size_t> bit_size_{0};
 
-  /// receiver's mask that are needed to construct matrix @param V_
-  std::array<ENCRYPTO::AlignedBitVector, 128> u_;
+  // wait for the receiver's mask with the given index and take it out of u_
+  ENCRYPTO::AlignedBitVector TakeReceiverMask(std::size_t i);
 
-  std::array<ENCRYPTO::ReusableFiberPromise<std::size_t>, 128> u_promises_;
-  std::array<ENCRYPTO::ReusableFiberFuture<std::size_t>, 128> u_futures_;
+  /// receiver's masks that are needed to construct matrix @param V_
+  // indexed by the offset of the window in the matrix plus the row, a mask is
+  // removed once it has been used; the receiver waits for the acknowledgement
+  // of a window before it sends masks two windows ahead of it
+  std::unordered_map<std::size_t, ENCRYPTO::AlignedBitVector> u_;
   std::mutex u_mutex_;
-  std::size_t num_received_u_{0};
+  std::condition_variable u_cond_;
   // matrix of the OT extension scheme
   // XXX: can't we delete this after setup?
   std::shared_ptr<ENCRYPTO::BitMatrix> V_;
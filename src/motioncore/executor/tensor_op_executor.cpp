@@ -25,17 +25,165 @@
 #include <fmt/format.h>
 #include <omp.h>
 #include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <optional>
+#include <unordered_map>
 
 #include "base/gate_register.h"
 #include "executor/execution_context.h"
 #include "gate/new_gate.h"
 #include "statistics/run_time_stats.h"
+#include "tensor/memory_plan.h"
+#include "tensor/tensor.h"
 #include "utility/fiber_thread_pool/fiber_thread_pool.hpp"
 #include "utility/logger.h"
+#include "wire/new_wire.h"
 
 namespace MOTION {
 
+namespace {
+
+// Scheduling state of a gate in the dependency graph.
+struct GateNode {
+  std::vector<std::size_t> predecessors_;
+  std::vector<std::size_t> successors_;
+  // number of predecessors which have not finished their setup phase yet
+  std::atomic<std::size_t> num_pending_setup_;
+  // number of predecessors which have not finished their online phase yet,
+  // plus one for the gate's own setup phase
+  std::atomic<std::size_t> num_pending_online_;
+};
+
+// Connect each gate with the gates producing its input wires.  Wires without a
+// known producer do not create an edge, the consuming gate then simply blocks
+// until the wire becomes ready.
+std::vector<GateNode> build_dependency_graph(const std::vector<std::unique_ptr<NewGate>>& gates) {
+  const auto num_gates = gates.size();
+  std::vector<GateNode> nodes(num_gates);
+
+  std::unordered_map<const NewWire*, std::size_t> producers;
+  for (std::size_t gate_i = 0; gate_i < num_gates; ++gate_i) {
+    for (const auto* wire : gates[gate_i]->get_output_wires()) {
+      producers[wire] = gate_i;
+    }
+  }
+
+  for (std::size_t gate_i = 0; gate_i < num_gates; ++gate_i) {
+    auto& preds = nodes[gate_i].predecessors_;
+    for (const auto* wire : gates[gate_i]->get_input_wires()) {
+      auto it = producers.find(wire);
+      if (it != producers.end() && it->second != gate_i) {
+        preds.push_back(it->second);
+      }
+    }
+    std::sort(std::begin(preds), std::end(preds));
+    preds.erase(std::unique(std::begin(preds), std::end(preds)), std::end(preds));
+    for (auto pred_i : preds) {
+      nodes[pred_i].successors_.push_back(gate_i);
+    }
+    nodes[gate_i].num_pending_setup_ = preds.size();
+    nodes[gate_i].num_pending_online_ = preds.size() + 1;
+  }
+  return nodes;
+}
+
+// Follow the predecessors which finished last, starting from the gate that
+// finished last overall.
+std::vector<std::size_t> compute_critical_path(
+    const std::vector<GateNode>& nodes,
+    const std::vector<Statistics::RunTimeStats::GateTimings>& timings) {
+  std::vector<std::size_t> path;
+  if (nodes.empty()) {
+    return path;
+  }
+  auto finished_before = [&timings](std::size_t a, std::size_t b) {
+    return timings[a].online_.second < timings[b].online_.second;
+  };
+  std::size_t gate_i = 0;
+  for (std::size_t i = 1; i < nodes.size(); ++i) {
+    if (finished_before(gate_i, i)) {
+      gate_i = i;
+    }
+  }
+  while (true) {
+    path.push_back(timings[gate_i].gate_id_);
+    const auto& preds = nodes[gate_i].predecessors_;
+    if (preds.empty()) {
+      break;
+    }
+    gate_i = *std::max_element(std::begin(preds), std::end(preds), finished_before);
+  }
+  std::reverse(std::begin(path), std::end(path));
+  return path;
+}
+
+// Counts for each tensor read by some gate how many of its producer and
+// readers are not done yet, and frees its buffers once this reaches zero.
+// Tensors without readers are the outputs of the network and are kept.
+class TensorReleaser {
+ public:
+  TensorReleaser(const std::vector<std::unique_ptr<NewGate>>& gates)
+      : gate_tensors_(gates.size()) {
+    std::unordered_map<const tensor::Tensor*, std::size_t> tensor_indices;
+    std::unordered_map<const tensor::Tensor*, std::size_t> producers;
+    for (std::size_t gate_i = 0; gate_i < gates.size(); ++gate_i) {
+      for (const auto* wire : gates[gate_i]->get_output_wires()) {
+        if (const auto* tensor = dynamic_cast<const tensor::Tensor*>(wire)) {
+          producers.emplace(tensor, gate_i);
+        }
+      }
+    }
+    std::vector<std::size_t> counts;
+    auto add = [&](std::size_t gate_i, const tensor::Tensor* tensor) {
+      auto [it, inserted] = tensor_indices.emplace(tensor, tensors_.size());
+      if (inserted) {
+        tensors_.push_back(tensor);
+        counts.push_back(0);
+      }
+      auto& gate_tensors = gate_tensors_[gate_i];
+      if (std::find(std::begin(gate_tensors), std::end(gate_tensors), it->second) ==
+          std::end(gate_tensors)) {
+        gate_tensors.push_back(it->second);
+        ++counts[it->second];
+      }
+    };
+    for (std::size_t gate_i = 0; gate_i < gates.size(); ++gate_i) {
+      for (const auto* wire : gates[gate_i]->get_input_wires()) {
+        const auto* tensor = dynamic_cast<const tensor::Tensor*>(wire);
+        if (tensor == nullptr) {
+          continue;
+        }
+        add(gate_i, tensor);
+        if (auto it = producers.find(tensor); it != producers.end()) {
+          add(it->second, tensor);
+        }
+      }
+    }
+    num_pending_ = std::vector<std::atomic<std::size_t>>(tensors_.size());
+    for (std::size_t tensor_i = 0; tensor_i < tensors_.size(); ++tensor_i) {
+      num_pending_[tensor_i] = counts[tensor_i];
+    }
+  }
+
+  // to be called when the last phase of a gate is done
+  void gate_finished(std::size_t gate_i) {
+    for (auto tensor_i : gate_tensors_[gate_i]) {
+      if (--num_pending_[tensor_i] == 0) {
+        // the tensors are owned by the gates and not const themselves
+        const_cast<tensor::Tensor*>(tensors_[tensor_i])->release_buffers();
+      }
+    }
+  }
+
+ private:
+  std::vector<const tensor::Tensor*> tensors_;
+  std::vector<std::atomic<std::size_t>> num_pending_;
+  std::vector<std::vector<std::size_t>> gate_tensors_;
+};
+
+}  // namespace
+
 TensorOpExecutor::TensorOpExecutor(GateRegister& reg, std::function<void(void)> preprocessing_fctn,
                                    bool sync_between_setup_and_online,
                                    std::function<void(void)> sync_fctn, std::size_t num_threads,
@@ -72,6 +220,15 @@ void TensorOpExecutor::evaluate_setup_online(Statistics::RunTimeStats& stats) {
 
   preprocessing_fctn_();
 
+  auto& gates = register_.get_gates();
+  if (logger_) {
+    logger_->LogInfo(tensor::plan_tensor_memory(gates).print_human_readable());
+  }
+  std::optional<TensorReleaser> releaser;
+  if (release_dead_tensors_) {
+    releaser.emplace(gates);
+  }
+
   if (logger_) {
     logger_->LogInfo(
         "Start evaluating the circuit gates sequentially (online after all finished setup)");
@@ -106,11 +263,15 @@ void TensorOpExecutor::evaluate_setup_online(Statistics::RunTimeStats& stats) {
 
   if (register_.get_num_gates_with_online()) {
     // evaluate the online phase of all the gates
-    for (auto& gate : register_.get_gates()) {
+    for (std::size_t gate_i = 0; gate_i < gates.size(); ++gate_i) {
+      auto& gate = gates[gate_i];
       if (gate->need_online()) {
         gate->evaluate_online_with_context(exec_ctx);
         register_.increment_gate_online_counter();
       }
+      if (releaser) {
+        releaser->gate_finished(gate_i);
+      }
     }
     register_.wait_online();
   }
@@ -128,7 +289,132 @@ void TensorOpExecutor::evaluate_setup_online(Statistics::RunTimeStats& stats) {
 }
 
 void TensorOpExecutor::evaluate(Statistics::RunTimeStats& stats) {
-  throw std::logic_error("not implemented");
+  if (num_threads_ > 0) {
+    if (logger_) {
+      logger_->LogInfo(fmt::format("Set OpenMP threads to {}", num_threads_));
+    }
+    omp_set_num_threads(num_threads_);
+  }
+
+  ExecutionContext exec_ctx{.num_threads_ = num_threads_,
+                            .fpool_ = std::make_unique<ENCRYPTO::FiberThreadPool>(
+                                std::max(std::size_t{2}, num_threads_))};
+
+  stats.record_start<Statistics::RunTimeStats::StatID::evaluate>();
+
+  preprocessing_fctn_();
+
+  auto& gates = register_.get_gates();
+  auto nodes = build_dependency_graph(gates);
+  if (logger_) {
+    logger_->LogInfo(tensor::plan_tensor_memory(gates).print_human_readable());
+  }
+  std::optional<TensorReleaser> releaser;
+  if (release_dead_tensors_) {
+    releaser.emplace(gates);
+  }
+  auto& timings = stats.gate_timings_;
+  timings.resize(gates.size());
+  for (std::size_t gate_i = 0; gate_i < gates.size(); ++gate_i) {
+    timings[gate_i].gate_id_ = gates[gate_i]->get_gate_id();
+  }
+
+  if (logger_) {
+    logger_->LogInfo(
+        "Start evaluating the circuit gates in dependency order (setup and online interleaved)");
+  }
+
+  // A gate's setup is posted once all its predecessors finished their setup,
+  // its online phase once its own setup and all its predecessors' online
+  // phases are done.  Gates without setup/online phase complete immediately.
+  std::function<void(std::size_t)> schedule_setup;
+  std::function<void(std::size_t)> schedule_online;
+
+  auto finish_setup = [&](std::size_t gate_i) {
+    for (auto succ_i : nodes[gate_i].successors_) {
+      if (--nodes[succ_i].num_pending_setup_ == 0) {
+        schedule_setup(succ_i);
+      }
+    }
+    if (--nodes[gate_i].num_pending_online_ == 0) {
+      schedule_online(gate_i);
+    }
+  };
+  auto finish_online = [&](std::size_t gate_i) {
+    if (releaser) {
+      releaser->gate_finished(gate_i);
+    }
+    for (auto succ_i : nodes[gate_i].successors_) {
+      if (--nodes[succ_i].num_pending_online_ == 0) {
+        schedule_online(succ_i);
+      }
+    }
+  };
+
+  schedule_setup = [&](std::size_t gate_i) {
+    if (!gates[gate_i]->need_setup()) {
+      timings[gate_i].setup_.first = timings[gate_i].setup_.second = stats.get_time();
+      finish_setup(gate_i);
+      return;
+    }
+    exec_ctx.fpool_->post([&, gate_i] {
+      timings[gate_i].setup_.first = stats.get_time();
+      gates[gate_i]->evaluate_setup_with_context(exec_ctx);
+      timings[gate_i].setup_.second = stats.get_time();
+      register_.increment_gate_setup_counter();
+      finish_setup(gate_i);
+    });
+  };
+  schedule_online = [&](std::size_t gate_i) {
+    if (!gates[gate_i]->need_online()) {
+      timings[gate_i].online_.first = timings[gate_i].online_.second = stats.get_time();
+      finish_online(gate_i);
+      return;
+    }
+    exec_ctx.fpool_->post([&, gate_i] {
+      timings[gate_i].online_.first = stats.get_time();
+      gates[gate_i]->evaluate_online_with_context(exec_ctx);
+      timings[gate_i].online_.second = stats.get_time();
+      register_.increment_gate_online_counter();
+      finish_online(gate_i);
+    });
+  };
+
+  stats.record_start<Statistics::RunTimeStats::StatID::gates_setup>();
+  stats.record_start<Statistics::RunTimeStats::StatID::gates_online>();
+
+  // collect the roots before posting anything, since the counters are
+  // decremented concurrently as soon as the first gates are running
+  std::vector<std::size_t> roots;
+  for (std::size_t gate_i = 0; gate_i < nodes.size(); ++gate_i) {
+    if (nodes[gate_i].num_pending_setup_ == 0) {
+      roots.push_back(gate_i);
+    }
+  }
+  for (auto gate_i : roots) {
+    schedule_setup(gate_i);
+  }
+
+  if (register_.get_num_gates_with_setup()) {
+    register_.wait_setup();
+  }
+  stats.record_end<Statistics::RunTimeStats::StatID::gates_setup>();
+  if (register_.get_num_gates_with_online()) {
+    register_.wait_online();
+  }
+  stats.record_end<Statistics::RunTimeStats::StatID::gates_online>();
+
+  if (logger_) {
+    logger_->LogInfo("Finished with the online phase of the circuit gates");
+  }
+
+  stats.record_end<Statistics::RunTimeStats::StatID::evaluate>();
+  exec_ctx.fpool_->join();
+
+  stats.critical_path_ = compute_critical_path(nodes, timings);
+  if (logger_) {
+    logger_->LogDebug(stats.print_critical_path());
+  }
 }
 
 }  // namespace MOTION
@@ -46,15 +46,24 @@ class TensorOpExecutor {
   // Run the setup phases first for all gates before starting with the online
   // phases.
   void evaluate_setup_online(Statistics::RunTimeStats& stats);
-  // Run setup and online phase of each gate as soon as possible.
+  // Run setup and online phase of each gate as soon as possible, i.e., as
+  // soon as the gates producing its inputs have finished the respective phase.
+  // Per-gate timings and the critical path are recorded in the stats.
   void evaluate(Statistics::RunTimeStats& stats);
 
+  // Free the buffers of a tensor as soon as its producer and all gates reading
+  // it are done, s.t. the memory usage follows the tensors' lifetimes.  The
+  // gates can then not be evaluated again.
+  void set_release_dead_tensors(bool enable) noexcept { release_dead_tensors_ = enable; }
+  bool get_release_dead_tensors() const noexcept { return release_dead_tensors_; }
+
  private:
   GateRegister& register_;
   std::function<void()> preprocessing_fctn_;
   std::function<void()> sync_fctn_;
   std::size_t num_threads_;
   bool sync_between_setup_and_online_ = false;
+  bool release_dead_tensors_ = false;
   std::shared_ptr<Logger> logger_;
 };
 
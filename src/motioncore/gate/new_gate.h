@@ -24,6 +24,8 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <stdexcept>
+#include <vector>
 
 #include "utility/enable_wait.h"
 #include "utility/fiber_condition.h"
@@ -31,6 +33,7 @@
 namespace MOTION {
 
 struct ExecutionContext;
+class NewWire;
 enum class MPCProtocol : unsigned int;
 
 class NewGate : public ENCRYPTO::enable_wait_setup, public ENCRYPTO::enable_wait_online {
@@ -45,6 +48,17 @@ class NewGate : public ENCRYPTO::enable_wait_setup, public ENCRYPTO::enable_wait
   virtual void evaluate_setup_with_context(ExecutionContext&) { evaluate_setup(); }
   virtual void evaluate_online_with_context(ExecutionContext&) { evaluate_online(); }
   std::size_t get_gate_id() const noexcept { return gate_id_; }
+  // Wires/tensors read resp. written by this gate.  Used by executors to
+  // derive the dependencies between gates.  Gates that do not report them are
+  // scheduled without waiting and block on their inputs themselves.
+  virtual std::vector<const NewWire*> get_input_wires() const { return {}; }
+  virtual std::vector<const NewWire*> get_output_wires() const { return {}; }
+  // Reset the gate s.t. it can be evaluated again with fresh inputs and fresh
+  // preprocessing material.  Buffers are kept allocated.  Gates that do not
+  // support this throw.
+  virtual void clear() {
+    throw std::logic_error("this gate does not support being evaluated again");
+  }
 
  protected:
   NewGate(std::size_t gate_id) noexcept : gate_id_(gate_id) {}
@@ -23,6 +23,8 @@
 #include "beavy_provider.h"
 
 #include <cstdint>
+#include <cstdlib>
+#include <stdexcept>
 #include <unordered_map>
 
 #include "base/gate_register.h"
@@ -69,6 +71,19 @@ BEAVYProvider::BEAVYProvider(Communication::CommunicationLayer& communication_la
 
 BEAVYProvider::~BEAVYProvider() = default;
 
+std::string BEAVYProvider::get_boolean_output_share_directory() const {
+  if (!boolean_output_share_directory_.empty()) {
+    return boolean_output_share_directory_;
+  }
+  const char* base_dir = std::getenv("BASE_DIR");
+  if (base_dir == nullptr) {
+    throw std::runtime_error(
+        "no directory for the boolean output shares given and BASE_DIR is not set");
+  }
+  return fmt::format("{}/build_debwithrelinfo_gcc/server{}/Boolean_Output_Shares", base_dir,
+                     my_id_);
+}
+
 void BEAVYProvider::setup() {
   motion_base_provider_.wait_setup();
   // TODO wait for ot setup
@@ -1178,6 +1193,10 @@ tensor::TensorCP BEAVYProvider::make_tensor_avgpool_op(const tensor::AveragePool
 }
 
 tensor::TensorCP BEAVYProvider::make_tensor_relu_op(const tensor::TensorCP in) {
+  if (in->get_protocol() == MPCProtocol::ArithmeticBEAVY) {
+    // multiply with the negated sign bit instead of converting the whole input
+    return make_tensor_relu_op(make_tensor_msb_op(in), in);
+  }
   const auto input_tensor = std::dynamic_pointer_cast<const BooleanBEAVYTensor>(in);
   assert(input_tensor != nullptr);
   auto gate_id = gate_register_.get_next_gate_id();
@@ -1209,8 +1228,8 @@ tensor::TensorCP BEAVYProvider::make_tensor_relu_op(const tensor::TensorCP in_bo
       in_arith->get_protocol() != MPCProtocol::ArithmeticBEAVY) {
     throw std::invalid_argument("expected Boolean and arithmetic BEAVY, respectively");
   }
-  const auto bit_size = in_bool->get_bit_size();
-  if (bit_size != in_arith->get_bit_size()) {
+  const auto bit_size = in_arith->get_bit_size();
+  if (in_bool->get_bit_size() != bit_size && in_bool->get_bit_size() != 1) {
     throw std::invalid_argument("bit size mismatch");
   }
   switch (bit_size) {
@@ -1237,6 +1256,45 @@ tensor::TensorCP BEAVYProvider::make_tensor_maxpool_op(const tensor::MaxPoolOp&
   return output;
 }
 
+tensor::TensorCP BEAVYProvider::make_tensor_argmax_op(const tensor::TensorCP in) {
+  const auto input_tensor = std::dynamic_pointer_cast<const BooleanBEAVYTensor>(in);
+  assert(input_tensor != nullptr);
+  auto gate_id = gate_register_.get_next_gate_id();
+  auto tensor_op = std::make_unique<BooleanBEAVYTensorArgMax>(gate_id, *this, input_tensor);
+  auto output = tensor_op->get_output_tensor();
+  gate_register_.register_gate(std::move(tensor_op));
+  return output;
+}
+
+tensor::TensorCP BEAVYProvider::make_tensor_msb_op(const tensor::TensorCP input) {
+  if (input->get_protocol() != MPCProtocol::ArithmeticBEAVY) {
+    throw std::invalid_argument("expected arithmetic BEAVY tensor");
+  }
+  auto bit_size = input->get_bit_size();
+  std::unique_ptr<NewGate> gate;
+  auto gate_id = gate_register_.get_next_gate_id();
+  tensor::TensorCP output;
+  const auto make_op = [this, input, gate_id, &output](auto dummy_arg) {
+    using T = decltype(dummy_arg);
+    auto tensor_op = std::make_unique<ArithmeticBEAVYTensorMsb<T>>(
+        gate_id, *this, std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<T>>(input));
+    output = tensor_op->get_output_tensor();
+    return tensor_op;
+  };
+  switch (bit_size) {
+    case 32:
+      gate = make_op(std::uint32_t{});
+      break;
+    case 64:
+      gate = make_op(std::uint64_t{});
+      break;
+    default:
+      throw std::logic_error(fmt::format("unexpected bit size {}", bit_size));
+  }
+  gate_register_.register_gate(std::move(gate));
+  return output;
+}
+
 // Functions defined to perform constant operations (addnl)
 tensor::TensorCP BEAVYProvider::make_tensor_negate(const tensor::TensorCP in) {
   auto bit_size = in->get_bit_size();
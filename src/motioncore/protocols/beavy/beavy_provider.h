@@ -23,6 +23,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "base/gate_factory.h"
@@ -103,6 +104,29 @@ class BEAVYProvider : public GateFactory,
 
   bool get_fake_setup() const noexcept { return fake_setup_; }
 
+  // Directory where the arithmetic tensor output gates store this party's
+  // shares of their input as binary share file <dir>/server<id>/outputshare_<id>
+  // for the next layer.  Empty (default): no files are written.
+  void set_output_share_directory(std::string directory, std::size_t fractional_bits) {
+    output_share_directory_ = std::move(directory);
+    output_share_fractional_bits_ = fractional_bits;
+  }
+  const std::string& get_output_share_directory() const noexcept {
+    return output_share_directory_;
+  }
+  std::size_t get_output_share_fractional_bits() const noexcept {
+    return output_share_fractional_bits_;
+  }
+
+  // Directory where the boolean output gates store this party's shares as
+  // text file output_share_for_server<id>_gate<gate id>.txt.  Defaults to
+  // $BASE_DIR/build_debwithrelinfo_gcc/server<id>/Boolean_Output_Shares, the
+  // getter throws if neither is set.
+  void set_boolean_output_share_directory(std::string directory) {
+    boolean_output_share_directory_ = std::move(directory);
+  }
+  std::string get_boolean_output_share_directory() const;
+
   // Implementation of GateFactors interface
 
   // Boolean inputs
@@ -224,6 +248,8 @@ class BEAVYProvider : public GateFactory,
   tensor::TensorCP make_tensor_relu_op(const tensor::TensorCP, const tensor::TensorCP) override;
   tensor::TensorCP make_tensor_maxpool_op(const tensor::MaxPoolOp&,
                                           const tensor::TensorCP) override;
+  tensor::TensorCP make_tensor_argmax_op(const tensor::TensorCP) override;
+  tensor::TensorCP make_tensor_msb_op(const tensor::TensorCP) override;
   tensor::TensorCP make_tensor_avgpool_op(const tensor::AveragePoolOp&, const tensor::TensorCP,
                                           std::size_t fractional_bits = 0) override;
   //Functions defined to perform constant operations (addnl)
@@ -334,6 +360,9 @@ class BEAVYProvider : public GateFactory,
   std::size_t next_input_id_;
   std::shared_ptr<Logger> logger_;
   bool fake_setup_;
+  std::string output_share_directory_;
+  std::size_t output_share_fractional_bits_ = 0;
+  std::string boolean_output_share_directory_;
 };
 
 }  // namespace proto::beavy
@@ -351,24 +351,12 @@ void BooleanBEAVYOutputGate::evaluate_online() {
 
   std::ofstream output_file;
 
-  std::string p = getenv("BASE_DIR");
-  if (my_id == 0) {
-    p += "/build_debwithrelinfo_gcc/server0/Boolean_Output_Shares";
-    if (!fs::is_directory(p)) {
-      std::filesystem::create_directories(p);
-    }
-    p += "/output_share_for_server0_gate";
-    p += std::to_string(gate_id_);
-    p += ".txt";
-  } else {
-    p += "/build_debwithrelinfo_gcc/server1/Boolean_Output_Shares";
-    if (!fs::is_directory(p)) {
-      std::filesystem::create_directories(p);
-    }
-    p += "/output_share_for_server1_gate";
-    p += std::to_string(gate_id_);
-    p += ".txt";
+  const fs::path directory = beavy_provider_.get_boolean_output_share_directory();
+  if (!fs::is_directory(directory)) {
+    std::filesystem::create_directories(directory);
   }
+  const auto p =
+      directory / fmt::format("output_share_for_server{}_gate{}.txt", my_id, gate_id_);
 
   output_file.open(p);
 
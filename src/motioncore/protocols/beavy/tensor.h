@@ -25,6 +25,7 @@
 #include "tensor/tensor.h"
 #include "utility/bit_vector.h"
 #include "utility/enable_wait.h"
+#include "utility/helpers.h"
 #include "utility/type_traits.hpp"
 #include "utility/typedefs.h"
 
@@ -40,6 +41,13 @@ class ArithmeticBEAVYTensor : public tensor::Tensor, public ENCRYPTO::enable_wai
   const std::vector<T>& get_public_share() const { return public_share_; };
   std::vector<T>& get_secret_share() { return secret_share_; };
   const std::vector<T>& get_secret_share() const { return secret_share_; };
+  std::size_t get_buffer_size() const noexcept override {
+    return 2 * get_dimensions().get_data_size() * sizeof(T);
+  }
+  void release_buffers() noexcept override {
+    public_share_ = {};
+    secret_share_ = {};
+  }
 
  private:
   using is_enabled_ = ENCRYPTO::is_unsigned_int_t<T>;
@@ -72,6 +80,15 @@ class BooleanBEAVYTensor : public tensor::Tensor, public ENCRYPTO::enable_wait_s
   const std::vector<ENCRYPTO::BitVector<>>& get_secret_share() const noexcept {
     return secret_share_;
   }
+  std::size_t get_buffer_size() const noexcept override {
+    return 2 * bit_size_ * Helpers::Convert::BitsToBytes(get_dimensions().get_data_size());
+  }
+  void release_buffers() noexcept override {
+    for (std::size_t bit_j = 0; bit_j < bit_size_; ++bit_j) {
+      public_share_[bit_j] = ENCRYPTO::BitVector<>();
+      secret_share_[bit_j] = ENCRYPTO::BitVector<>();
+    }
+  }
 
  private:
   std::size_t bit_size_;
@@ -22,9 +22,6 @@
 
 #include "tensor_op.h"
 
-#include <stdlib.h>
-#include <fstream>
-#include <iostream>
 #include <parallel/algorithm>
 #include <stdexcept>
 
@@ -45,6 +42,7 @@
 #include "utility/helpers.h"
 #include "utility/linear_algebra.h"
 #include "utility/logger.h"
+#include "utility/share_file.h"
 #include "wire.h"
 
 namespace MOTION::proto::beavy {
@@ -137,6 +135,12 @@ void ArithmeticBEAVYTensorInputSender<T>::evaluate_online() {
   }
 }
 
+template <typename T>
+void ArithmeticBEAVYTensorInputSender<T>::clear() {
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 template class ArithmeticBEAVYTensorInputSender<std::uint32_t>;
 template class ArithmeticBEAVYTensorInputSender<std::uint64_t>;
 
@@ -210,6 +214,12 @@ void ArithmeticBEAVYTensorInputReceiver<T>::evaluate_online() {
   }
 }
 
+template <typename T>
+void ArithmeticBEAVYTensorInputReceiver<T>::clear() {
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 template class ArithmeticBEAVYTensorInputReceiver<std::uint32_t>;
 template class ArithmeticBEAVYTensorInputReceiver<std::uint64_t>;
 
@@ -317,6 +327,12 @@ void ArithmeticBEAVYTensorInputShares<T>::evaluate_online() {
   }
 }
 
+template <typename T>
+void ArithmeticBEAVYTensorInputShares<T>::clear() {
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 template class ArithmeticBEAVYTensorInputShares<std::uint32_t>;
 template class ArithmeticBEAVYTensorInputShares<std::uint64_t>;
 
@@ -385,124 +401,25 @@ void ArithmeticBEAVYTensorOutput<T>::evaluate_online() {
     }
   }
 
-  // std::string filename = std::filesystem::current_path();
-  // std::string filename_config = std::filesystem::current_path();
-  std::string homedir = getenv("BASE_DIR");
-  std::cout << homedir << std::endl;
-  std::string filename = homedir + "/build_debwithrelinfo_gcc";
-  std::string filename_config = homedir + "/build_debwithrelinfo_gcc";
-  // std::cout << filename << "\n";
-  std::ofstream file, file_config;
-
   auto my_id = beavy_provider_.get_my_id();
+  input_->wait_online();
+  const auto& public_share = input_->get_public_share();
+  const auto& my_secret_share = input_->get_secret_share();
   if (output_owner_ == my_id) {
-    std::cout << "my_id is:" << my_id << "\n";
-    input_->wait_online();
-    const auto& public_share = input_->get_public_share();
-    const auto& new_secret_share = input_->get_secret_share();
     assert(public_share.size() == input_->get_dimensions().get_data_size());
     assert(secret_shares_.size() == input_->get_dimensions().get_data_size());
     __gnu_parallel::transform(std::begin(public_share), std::end(public_share),
                               std::begin(secret_shares_), std::begin(secret_shares_), std::minus{});
-
     output_promise_.set_value(std::move(secret_shares_));
-
-    std::vector<std::uint64_t> publicshare1;
-
-    for (auto i = public_share.begin(); i != public_share.end(); i++) {
-      publicshare1.push_back(*i);
-    }
-    std::vector<std::uint64_t> secretshare1;
-
-    for (auto i = new_secret_share.begin(); i != new_secret_share.end(); i++) {
-      secretshare1.push_back(*i);
-    }
-
-    // plugging output shares into a file for calculation for argmax for server 0
-
-    // creation of target file path
-    std::string file_ = filename + "/server1/outputshare_1";
-    // std::cout << file_ << "\n";
-
-    filename_config += "/file_config_input1";
-
-    file_config.open(filename_config, std::ios_base::out);
-    // assert(file_config);
-
-    file_config << file_;
-
-    file.open(file_, std::ios_base::out);
-    // assert(file);
-
-    if (!file) {
-      std::cerr << " Error in reading file\n";
-    }
-
-    file << publicshare1.size() << " ";
-    file << "1"
-         << "\n";
-
-    for (auto i = 0; i < publicshare1.size(); i++) {
-      file << publicshare1[i];
-
-      file << " ";
-
-      file << secretshare1[i];
-      file << "\n";
-    }
-
-    file.close();
-
   }
 
-  else {
-    // plugging output shares into a file for calculation for argmax for server 1
-    std::cout << "my_id is:" << my_id << "\n";
-    // creation of target file path
-
-    std::string file_ = filename + "/server0/outputshare_0";
-    // std::cout << file_ << "\n";
-
-    filename_config += "/file_config_input0";
-
-    file_config.open(filename_config, std::ios_base::out);
-    // assert(file_config);
-
-    file_config << file_;
-
-    file.open(file_, std::ios_base::out);
-
-    if (!file) {
-      std::cerr << " Error in reading file\n";
-    }
-
-    input_->wait_online();
-    const auto& public_share0 = input_->get_public_share();
-    const auto& new_secret_share0 = input_->get_secret_share();
-    std::vector<std::uint64_t> publicshare2;
-
-    for (auto i = public_share0.begin(); i != public_share0.end(); i++) {
-      publicshare2.push_back(*i);
-    }
-    std::vector<std::uint64_t> secretshare2;
-
-    for (auto i = new_secret_share0.begin(); i != new_secret_share0.end(); i++) {
-      secretshare2.push_back(*i);
-    }
-
-    file << publicshare2.size() << " ";
-    file << "1"
-         << "\n";
-
-    for (auto i = 0; i < publicshare2.size(); i++) {
-      file << publicshare2[i];
-      file << " ";
-
-      file << secretshare2[i];
-      file << "\n";
-    }
-
-    file.close();
+  // keep this party's shares for the next layer, which is run as a separate program
+  const auto& output_share_directory = beavy_provider_.get_output_share_directory();
+  if (!output_share_directory.empty()) {
+    const auto path =
+        fmt::format("{}/server{}/outputshare_{}", output_share_directory, my_id, my_id);
+    write_share_file<T>(path, my_id, beavy_provider_.get_output_share_fractional_bits(),
+                        public_share.size(), 1, public_share, my_secret_share);
   }
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
@@ -524,6 +441,11 @@ ENCRYPTO::ReusableFiberFuture<std::vector<T>> ArithmeticBEAVYTensorOutput<T>::ge
   }
 }
 
+template <typename T>
+void ArithmeticBEAVYTensorOutput<T>::clear() {
+  // the shares are recomputed and the output promise is set again in each run
+}
+
 template class ArithmeticBEAVYTensorOutput<std::uint32_t>;
 template class ArithmeticBEAVYTensorOutput<std::uint64_t>;
 
@@ -589,9 +511,112 @@ void ArithmeticBEAVYTensorFlatten<T>::evaluate_online() {
   }
 }
 
+template <typename T>
+void ArithmeticBEAVYTensorFlatten<T>::clear() {
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 template class ArithmeticBEAVYTensorFlatten<std::uint32_t>;
 template class ArithmeticBEAVYTensorFlatten<std::uint64_t>;
 
+namespace {
+
+// The online phase of a BEAVY multiplication computes
+//   [Delta_y]_i = [delta_y]_i + [delta_ab]_i + Delta_a * Delta_b
+//                 - Delta_a * [delta_b]_i - [delta_a]_i * Delta_b,
+// where Delta_a * Delta_b is only added by one party.  The products are
+// refactored into
+//   Delta_a * (Delta_b - [delta_b]_i) - [delta_a]_i * Delta_b,
+// which is evaluated as a single product of operands concatenated along the
+// inner dimension:
+//   [Delta_a | -[delta_a]_i] * [Delta_b - [delta_b]_i ; Delta_b].
+
+template <typename T>
+void make_fused_gemm_operands(const tensor::GemmOp& gemm_op, const std::vector<T>& Delta_a,
+                              const std::vector<T>& delta_a_share, const std::vector<T>& Delta_b,
+                              const std::vector<T>& delta_b_share, bool add_Delta_ab,
+                              std::vector<T>& fused_A, std::vector<T>& fused_B) {
+  const auto [dim_l, dim_n] = gemm_op.output_shape_;
+  const auto dim_m = gemm_op.transA_ ? gemm_op.input_A_shape_[0] : gemm_op.input_A_shape_[1];
+  // row-major l x 2m and 2m x n matrices
+  fused_A.resize(dim_l * 2 * dim_m);
+  fused_B.resize(2 * dim_m * dim_n);
+  for (std::size_t i = 0; i < dim_l; ++i) {
+    for (std::size_t k = 0; k < dim_m; ++k) {
+      const auto idx = gemm_op.transA_ ? k * dim_l + i : i * dim_m + k;
+      fused_A[i * 2 * dim_m + k] = Delta_a[idx];
+      fused_A[i * 2 * dim_m + dim_m + k] = -delta_a_share[idx];
+    }
+  }
+  for (std::size_t k = 0; k < dim_m; ++k) {
+    for (std::size_t j = 0; j < dim_n; ++j) {
+      const auto idx = gemm_op.transB_ ? j * dim_m + k : k * dim_n + j;
+      fused_B[k * dim_n + j] = (add_Delta_ab ? Delta_b[idx] : T(0)) - delta_b_share[idx];
+      fused_B[(dim_m + k) * dim_n + j] = Delta_b[idx];
+    }
+  }
+}
+
+// Same as above for a convolution, where the inputs are concatenated along the
+// input channels.
+template <typename T>
+tensor::Conv2DOp make_fused_conv2d_operands(const tensor::Conv2DOp& conv_op,
+                                            const std::vector<T>& Delta_a,
+                                            const std::vector<T>& delta_a_share,
+                                            const std::vector<T>& Delta_b,
+                                            const std::vector<T>& delta_b_share, bool add_Delta_ab,
+                                            std::vector<T>& fused_input,
+                                            std::vector<T>& fused_kernel) {
+  const auto input_size = Delta_a.size();
+  fused_input.resize(2 * input_size);
+  std::copy(std::begin(Delta_a), std::end(Delta_a), std::begin(fused_input));
+  std::transform(std::begin(delta_a_share), std::end(delta_a_share),
+                 std::begin(fused_input) + input_size, std::negate{});
+
+  // the kernel has shape (output channels, input channels, height, width)
+  const auto num_output_channels = conv_op.kernel_shape_[0];
+  const auto filter_size = Delta_b.size() / num_output_channels;
+  fused_kernel.resize(2 * Delta_b.size());
+  for (std::size_t c = 0; c < num_output_channels; ++c) {
+    auto* fused_filter = fused_kernel.data() + 2 * c * filter_size;
+    for (std::size_t x = 0; x < filter_size; ++x) {
+      const auto idx = c * filter_size + x;
+      fused_filter[x] = (add_Delta_ab ? Delta_b[idx] : T(0)) - delta_b_share[idx];
+      fused_filter[filter_size + x] = Delta_b[idx];
+    }
+  }
+
+  auto fused_conv_op = conv_op;
+  fused_conv_op.input_shape_[0] *= 2;
+  fused_conv_op.kernel_shape_[1] *= 2;
+  return fused_conv_op;
+}
+
+// Adds the online product to [Delta_y]_i and, if requested, truncates the
+// result and adds [delta_y]_i in the same pass.
+template <typename T>
+void add_online_product(std::vector<T>& Delta_y_share, const std::vector<T>& product,
+                        const std::vector<T>& delta_y_share, std::size_t fractional_bits,
+                        bool party_0) {
+  const auto size = Delta_y_share.size();
+  if (fractional_bits == 0) {
+#pragma omp parallel for
+    for (std::size_t i = 0; i < size; ++i) {
+      Delta_y_share[i] += product[i];
+    }
+  } else {
+#pragma omp parallel for
+    for (std::size_t i = 0; i < size; ++i) {
+      Delta_y_share[i] = fixed_point::truncate_shared(Delta_y_share[i] + product[i],
+                                                      fractional_bits, party_0) +
+                         delta_y_share[i];
+    }
+  }
+}
+
+}  // namespace
+
 template <typename T>
 ArithmeticBEAVYTensorConv2D<T>::ArithmeticBEAVYTensorConv2D(
     std::size_t gate_id, BEAVYProvider& beavy_provider, tensor::Conv2DOp conv_op,
@@ -711,36 +736,20 @@ void ArithmeticBEAVYTensorConv2D<T>::evaluate_online() {
   const auto& Delta_b = kernel_->get_public_share();
   const auto& delta_a_share = input_->get_secret_share();
   const auto& delta_b_share = kernel_->get_secret_share();
-  std::vector<T> tmp(output_size);
+  const bool my_job = beavy_provider_.is_my_job(gate_id_);
 
   // after setup phase, `Delta_y_share_` contains [delta_y]_i + [delta_ab]_i
 
-  // [Delta_y]_i -= Delta_a * [delta_b]_i
-  convolution(conv_op_, Delta_a.data(), delta_b_share.data(), tmp.data());
-  __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_), std::begin(tmp),
-                            std::begin(Delta_y_share_), std::minus{});
-
-  // [Delta_y]_i -= Delta_b * [delta_a]_i
-  convolution(conv_op_, delta_a_share.data(), Delta_b.data(), tmp.data());
-  __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_), std::begin(tmp),
-                            std::begin(Delta_y_share_), std::minus{});
-
-  // [Delta_y]_i += Delta_ab (== Delta_a * Delta_b)
-  if (beavy_provider_.is_my_job(gate_id_)) {
-    convolution(conv_op_, Delta_a.data(), Delta_b.data(), tmp.data());
-    __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_), std::begin(tmp),
-                              std::begin(Delta_y_share_), std::plus{});
-  }
-
-  if (fractional_bits_ > 0) {
-    fixed_point::truncate_shared<T>(Delta_y_share_.data(), fractional_bits_, Delta_y_share_.size(),
-                                    beavy_provider_.is_my_job(gate_id_));
-    // [Delta_y]_i += [delta_y]_i
-    __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
-                              std::begin(output_->get_secret_share()), std::begin(Delta_y_share_),
-                              std::plus{});
-    // NB: happens in setup phase if no truncation is requested
-  }
+  // [Delta_y]_i += Delta_ab - Delta_a * [delta_b]_i - [delta_a]_i * Delta_b
+  // (Delta_ab only if it is my job)
+  std::vector<T> fused_input, fused_kernel;
+  const auto fused_conv_op = make_fused_conv2d_operands(
+      conv_op_, Delta_a, delta_a_share, Delta_b, delta_b_share, my_job, fused_input, fused_kernel);
+  std::vector<T> product(output_size);
+  convolution(fused_conv_op, fused_input.data(), fused_kernel.data(), product.data());
+  // [delta_y]_i is added in the setup phase if no truncation is requested
+  add_online_product(Delta_y_share_, product, output_->get_secret_share(), fractional_bits_,
+                     my_job);
 
   // broadcast [Delta_y]_i
   beavy_provider_.broadcast_ints_message(gate_id_, Delta_y_share_);
@@ -760,6 +769,18 @@ void ArithmeticBEAVYTensorConv2D<T>::evaluate_online() {
   }
 }
 
+template <typename T>
+void ArithmeticBEAVYTensorConv2D<T>::clear() {
+  if (!beavy_provider_.get_fake_setup()) {
+    conv_input_side_->clear();
+    conv_kernel_side_->clear();
+  }
+  // reclaim the buffer which was moved into the output in the online phase
+  Delta_y_share_.swap(output_->get_public_share());
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 template class ArithmeticBEAVYTensorConv2D<std::uint32_t>;
 template class ArithmeticBEAVYTensorConv2D<std::uint64_t>;
 
@@ -886,36 +907,22 @@ void ArithmeticBEAVYTensorGemm<T>::evaluate_online() {
   const auto& Delta_b = input_B_->get_public_share();
   const auto& delta_a_share = input_A_->get_secret_share();
   const auto& delta_b_share = input_B_->get_secret_share();
-  std::vector<T> tmp(output_size);
+  const bool my_job = beavy_provider_.is_my_job(gate_id_);
 
   // after setup phase, `Delta_y_share_` contains [delta_y]_i + [delta_ab]_i
 
-  // [Delta_y]_i -= Delta_a * [delta_b]_i
-  matrix_multiply(gemm_op_, Delta_a.data(), delta_b_share.data(), tmp.data());
-  __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_), std::begin(tmp),
-                            std::begin(Delta_y_share_), std::minus{});
-
-  // [Delta_y]_i -= Delta_b * [delta_a]_i
-  matrix_multiply(gemm_op_, delta_a_share.data(), Delta_b.data(), tmp.data());
-  __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_), std::begin(tmp),
-                            std::begin(Delta_y_share_), std::minus{});
-
-  // [Delta_y]_i += Delta_ab (== Delta_a * Delta_b)
-  if (beavy_provider_.is_my_job(gate_id_)) {
-    matrix_multiply(gemm_op_, Delta_a.data(), Delta_b.data(), tmp.data());
-    __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_), std::begin(tmp),
-                              std::begin(Delta_y_share_), std::plus{});
-  }
-
-  if (fractional_bits_ > 0) {
-    fixed_point::truncate_shared<T>(Delta_y_share_.data(), fractional_bits_, Delta_y_share_.size(),
-                                    beavy_provider_.is_my_job(gate_id_));
-    // [Delta_y]_i += [delta_y]_i
-    __gnu_parallel::transform(std::begin(Delta_y_share_), std::end(Delta_y_share_),
-                              std::begin(output_->get_secret_share()), std::begin(Delta_y_share_),
-                              std::plus{});
-    // NB: happens in setup phase if no truncation is requested
-  }
+  // [Delta_y]_i += Delta_ab - Delta_a * [delta_b]_i - [delta_a]_i * Delta_b
+  // (Delta_ab only if it is my job)
+  std::vector<T> fused_A, fused_B;
+  make_fused_gemm_operands(gemm_op_, Delta_a, delta_a_share, Delta_b, delta_b_share, my_job,
+                           fused_A, fused_B);
+  const auto [dim_l, dim_n] = gemm_op_.output_shape_;
+  const auto dim_m = fused_A.size() / dim_l;
+  std::vector<T> product(output_size);
+  matrix_multiply(dim_l, dim_m, dim_n, fused_A.data(), fused_B.data(), product.data());
+  // [delta_y]_i is added in the setup phase if no truncation is requested
+  add_online_product(Delta_y_share_, product, output_->get_secret_share(), fractional_bits_,
+                     my_job);
 
   // broadcast [Delta_y]_i
   beavy_provider_.broadcast_ints_message(gate_id_, Delta_y_share_);
@@ -935,6 +942,18 @@ void ArithmeticBEAVYTensorGemm<T>::evaluate_online() {
   }
 }
 
+template <typename T>
+void ArithmeticBEAVYTensorGemm<T>::clear() {
+  if (!beavy_provider_.get_fake_setup()) {
+    mm_lhs_side_->clear();
+    mm_rhs_side_->clear();
+  }
+  // reclaim the buffer which was moved into the output in the online phase
+  Delta_y_share_.swap(output_->get_public_share());
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 template class ArithmeticBEAVYTensorGemm<std::uint32_t>;
 template class ArithmeticBEAVYTensorGemm<std::uint64_t>;
 
@@ -1501,6 +1520,14 @@ void ArithmeticBEAVYTensorNegate<T>::evaluate_online() {
   }
 }
 
+template <typename T>
+void ArithmeticBEAVYTensorNegate<T>::clear() {
+  // reclaim the buffer which was moved into the output in the online phase
+  Delta_y_.swap(output_->get_public_share());
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 template class ArithmeticBEAVYTensorNegate<std::uint32_t>;
 template class ArithmeticBEAVYTensorNegate<std::uint64_t>;
 
@@ -1694,6 +1721,14 @@ void ArithmeticBEAVYTensorAdd<T>::evaluate_online() {
   }
 }
 
+template <typename T>
+void ArithmeticBEAVYTensorAdd<T>::clear() {
+  // reclaim the buffer which was moved into the output in the online phase
+  Delta_y_.swap(output_->get_public_share());
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 template class ArithmeticBEAVYTensorAdd<std::uint32_t>;
 template class ArithmeticBEAVYTensorAdd<std::uint64_t>;
 
@@ -1864,6 +1899,318 @@ void ArithmeticBEAVYTensorSplit<T>::evaluate_online() {
 template class ArithmeticBEAVYTensorSplit<std::uint32_t>;
 template class ArithmeticBEAVYTensorSplit<std::uint64_t>;
 
+namespace {
+
+// Bits 2t and 2t+1 of a 32 bit word hold the (less than, equal) pair of the
+// t-th entry of a 1-out-of-16 table.
+constexpr std::array<std::uint32_t, 4> make_segment_masks() {
+  std::array<std::uint32_t, 4> masks{};
+  for (std::size_t i = 0; i < 4; ++i) {
+    for (std::size_t t = 0; t < 16; ++t) {
+      if ((t >> i) & 1) {
+        masks[i] |= std::uint32_t(3) << (2 * t);
+      }
+    }
+  }
+  return masks;
+}
+
+constexpr std::array<std::uint32_t, 16> make_less_than_words() {
+  std::array<std::uint32_t, 16> words{};
+  for (std::size_t u = 0; u < 16; ++u) {
+    for (std::size_t t = 0; t < u; ++t) {
+      words[u] |= std::uint32_t(1) << (2 * t);
+    }
+  }
+  return words;
+}
+
+constexpr auto segment_masks = make_segment_masks();
+constexpr auto less_than_words = make_less_than_words();
+
+// read the 32 bit output of the i-th random OT in a byte order independent way
+std::uint32_t get_ot_word(const ENCRYPTO::BitVector<>& outputs, std::size_t i) {
+  const auto& data = outputs.GetData();
+  std::uint32_t word = 0;
+  for (std::size_t k = 0; k < 4; ++k) {
+    word |= std::to_integer<std::uint32_t>(data[4 * i + k]) << (8 * k);
+  }
+  return word;
+}
+
+}  // namespace
+
+template <typename T>
+ArithmeticBEAVYTensorMsb<T>::ArithmeticBEAVYTensorMsb(std::size_t gate_id,
+                                                      BEAVYProvider& beavy_provider,
+                                                      const ArithmeticBEAVYTensorCP<T> input)
+    : NewGate(gate_id),
+      beavy_provider_(beavy_provider),
+      data_size_(input->get_dimensions().get_data_size()),
+      my_job_(beavy_provider_.is_my_job(gate_id_)),
+      input_(std::move(input)),
+      output_(std::make_shared<BooleanBEAVYTensor>(input_->get_dimensions(), 1)) {
+  static_assert(num_chunks_ >= 2 && (num_chunks_ & (num_chunks_ - 1)) == 0);
+  const auto my_id = beavy_provider_.get_my_id();
+  const auto num_leaves = num_chunks_ * data_size_;
+  const auto num_nodes = (num_chunks_ - 1) * data_size_;
+  auto& otp = beavy_provider_.get_ot_manager().get_provider(1 - my_id);
+  if (my_job_) {
+    rot_sender_ = otp.RegisterSendROT(chunk_bits_ * num_leaves, 32, true);
+    choices_future_ = beavy_provider_.register_for_bits_message(1 - my_id, gate_id_,
+                                                                chunk_bits_ * num_leaves, 1);
+  } else {
+    rot_receiver_ = otp.RegisterReceiveROT(chunk_bits_ * num_leaves, 32, true);
+    table_future_ = beavy_provider_.register_for_ints_message<std::uint32_t>(1 - my_id, gate_id_,
+                                                                            num_leaves, 2);
+  }
+  ot_sender_ = otp.RegisterSendXCOTBit(num_nodes, 2);
+  ot_receiver_ = otp.RegisterReceiveXCOTBit(num_nodes, 2);
+  for (std::size_t level = 0, n = num_chunks_ / 2; n > 0; ++level, n /= 2) {
+    and_futures_.emplace_back(beavy_provider_.register_for_bits_message(
+        1 - my_id, gate_id_, 3 * n * data_size_, 3 + level));
+  }
+  share_future_ = beavy_provider_.register_for_bits_message(1 - my_id, gate_id_, data_size_);
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format("Gate {}: ArithmeticBEAVYTensorMsb created", gate_id_));
+    }
+  }
+}
+
+template <typename T>
+ArithmeticBEAVYTensorMsb<T>::~ArithmeticBEAVYTensorMsb() = default;
+
+template <typename T>
+void ArithmeticBEAVYTensorMsb<T>::evaluate_setup() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: ArithmeticBEAVYTensorMsb<T>::evaluate_setup start", gate_id_));
+    }
+  }
+
+  output_->get_secret_share()[0] = ENCRYPTO::BitVector<>::Random(data_size_);
+  output_->set_setup_ready();
+
+  const auto my_id = beavy_provider_.get_my_id();
+  const auto num_leaves = num_chunks_ * data_size_;
+  const auto num_nodes = (num_chunks_ - 1) * data_size_;
+
+  // AND triples for the inner nodes: both products of a node share the operand a
+  triple_a_ = ENCRYPTO::BitVector<>::Random(num_nodes);
+  triple_b_ = ENCRYPTO::BitVector<>::Random(2 * num_nodes);
+  ot_receiver_->SetChoices(triple_a_);
+  ot_receiver_->SendCorrections();
+  ENCRYPTO::BitVector<> ot_inputs(2 * num_nodes);
+  for (std::size_t node_i = 0; node_i < num_nodes; ++node_i) {
+    ot_inputs.Set(triple_b_.Get(node_i), 2 * node_i);
+    ot_inputs.Set(triple_b_.Get(num_nodes + node_i), 2 * node_i + 1);
+  }
+  ot_sender_->SetCorrelations(std::move(ot_inputs));
+  ot_sender_->SendMessages();
+
+  // leaves: random 1-out-of-16 OTs where the receiver already fixes its choice
+  leaf_pads_.resize(num_leaves);
+  if (my_job_) {
+    leaf_data_ = Helpers::RandomVector<std::uint8_t>(num_leaves);
+    rot_sender_->ComputeOutputs();
+    const auto ot_outputs = rot_sender_->GetOutputs();
+    const auto& m0 = ot_outputs.first;
+    const auto& m1 = ot_outputs.second;
+    const auto choices = choices_future_.get();
+#pragma omp parallel for
+    for (std::size_t leaf_i = 0; leaf_i < num_leaves; ++leaf_i) {
+      std::uint32_t pad = 0;
+      for (std::size_t bit_j = 0; bit_j < chunk_bits_; ++bit_j) {
+        const auto ot_i = chunk_bits_ * leaf_i + bit_j;
+        const auto select = choices.Get(ot_i) ? ~segment_masks[bit_j] : segment_masks[bit_j];
+        pad ^= (get_ot_word(m0, ot_i) & ~select) | (get_ot_word(m1, ot_i) & select);
+      }
+      leaf_pads_[leaf_i] = pad;
+      leaf_data_[leaf_i] &= 3;
+    }
+  } else {
+    input_->wait_setup();
+    const auto& sshare = input_->get_secret_share();
+    rot_receiver_->ComputeOutputs();
+    const auto& ot_outputs = rot_receiver_->GetOutputs();
+    const auto& ot_choices = rot_receiver_->GetChoices();
+    ENCRYPTO::BitVector<> choices(chunk_bits_ * num_leaves);
+    msb_v_ = ENCRYPTO::BitVector<>(data_size_);
+    leaf_data_.resize(num_leaves);
+    for (std::size_t int_i = 0; int_i < data_size_; ++int_i) {
+      // v = -[delta]_i, compare (2^(l-1) - 1) - (v mod 2^(l-1)) with the other lower bits
+      const T v = -sshare[int_i];
+      msb_v_.Set(v >> (bit_size_ - 1), int_i);
+      const T w = ~v & (T(-1) >> 1);
+      for (std::size_t chunk_j = 0; chunk_j < num_chunks_; ++chunk_j) {
+        const auto leaf_i = int_i * num_chunks_ + chunk_j;
+        const auto w_j = static_cast<std::uint8_t>((w >> (chunk_bits_ * chunk_j)) & 15);
+        std::uint32_t pad = 0;
+        for (std::size_t bit_j = 0; bit_j < chunk_bits_; ++bit_j) {
+          const auto ot_i = chunk_bits_ * leaf_i + bit_j;
+          choices.Set(((w_j >> bit_j) & 1) != ot_choices.Get(ot_i), ot_i);
+          pad ^= get_ot_word(ot_outputs, ot_i) >> (2 * w_j);
+        }
+        leaf_data_[leaf_i] = w_j;
+        leaf_pads_[leaf_i] = pad & 3;
+      }
+    }
+    beavy_provider_.send_bits_message(1 - my_id, gate_id_, choices, 1);
+  }
+
+  ot_sender_->ComputeOutputs();
+  ot_receiver_->ComputeOutputs();
+  const auto& ot_snd_out = ot_sender_->GetOutputs();
+  const auto& ot_rcv_out = ot_receiver_->GetOutputs();
+  triple_c_ = ENCRYPTO::BitVector<>(2 * num_nodes);
+  for (std::size_t node_i = 0; node_i < num_nodes; ++node_i) {
+    const bool a = triple_a_.Get(node_i);
+    for (std::size_t k = 0; k < 2; ++k) {
+      const bool b = triple_b_.Get(k * num_nodes + node_i);
+      const bool c = (a && b) != ot_snd_out.Get(2 * node_i + k) != ot_rcv_out.Get(2 * node_i + k);
+      triple_c_.Set(c, k * num_nodes + node_i);
+    }
+  }
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: ArithmeticBEAVYTensorMsb<T>::evaluate_setup end", gate_id_));
+    }
+  }
+}
+
+template <typename T>
+void ArithmeticBEAVYTensorMsb<T>::evaluate_online() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: ArithmeticBEAVYTensorMsb<T>::evaluate_online start", gate_id_));
+    }
+  }
+
+  const auto my_id = beavy_provider_.get_my_id();
+  const auto num_leaves = num_chunks_ * data_size_;
+  const auto num_nodes = (num_chunks_ - 1) * data_size_;
+  std::vector<ENCRYPTO::BitVector<>> lt_shares(num_chunks_, ENCRYPTO::BitVector<>(data_size_));
+  std::vector<ENCRYPTO::BitVector<>> eq_shares(num_chunks_, ENCRYPTO::BitVector<>(data_size_));
+  ENCRYPTO::BitVector<> msb_share;
+
+  // leaves: shares of [w_j < u_j] and [w_j == u_j] for each chunk
+  if (my_job_) {
+    input_->wait_online();
+    const auto& pshare = input_->get_public_share();
+    const auto& sshare = input_->get_secret_share();
+    std::vector<std::uint32_t> table(num_leaves);
+    msb_share = ENCRYPTO::BitVector<>(data_size_);
+    for (std::size_t int_i = 0; int_i < data_size_; ++int_i) {
+      const T u = pshare[int_i] - sshare[int_i];
+      msb_share.Set(u >> (bit_size_ - 1), int_i);
+      const T u_low = u & (T(-1) >> 1);
+      for (std::size_t chunk_j = 0; chunk_j < num_chunks_; ++chunk_j) {
+        const auto leaf_i = int_i * num_chunks_ + chunk_j;
+        const auto u_j = (u_low >> (chunk_bits_ * chunk_j)) & 15;
+        const auto r = leaf_data_[leaf_i];
+        table[leaf_i] = leaf_pads_[leaf_i] ^ less_than_words[u_j] ^
+                        (std::uint32_t(2) << (2 * u_j)) ^ ((r & 1) ? 0x55555555 : 0) ^
+                        ((r & 2) ? 0xAAAAAAAA : 0);
+        lt_shares[chunk_j].Set(r & 1, int_i);
+        eq_shares[chunk_j].Set(r & 2, int_i);
+      }
+    }
+    beavy_provider_.send_ints_message(1 - my_id, gate_id_, table, 2);
+  } else {
+    const auto table = table_future_.get();
+    for (std::size_t int_i = 0; int_i < data_size_; ++int_i) {
+      for (std::size_t chunk_j = 0; chunk_j < num_chunks_; ++chunk_j) {
+        const auto leaf_i = int_i * num_chunks_ + chunk_j;
+        const auto entry = (table[leaf_i] >> (2 * leaf_data_[leaf_i])) ^ leaf_pads_[leaf_i];
+        lt_shares[chunk_j].Set(entry & 1, int_i);
+        eq_shares[chunk_j].Set(entry & 2, int_i);
+      }
+    }
+    msb_share = msb_v_;
+  }
+
+  // inner nodes: lt = lt_hi ^ (eq_hi & lt_lo), eq = eq_hi & eq_lo
+  std::size_t offset = 0;
+  for (std::size_t level = 0, n = num_chunks_ / 2; n > 0; ++level, n /= 2) {
+    const auto size = n * data_size_;
+    const auto a = triple_a_.Subset(offset, offset + size);
+    const auto b_lt = triple_b_.Subset(offset, offset + size);
+    const auto b_eq = triple_b_.Subset(num_nodes + offset, num_nodes + offset + size);
+    ENCRYPTO::BitVector<> d, e_lt, e_eq;
+    for (std::size_t node_i = 0; node_i < n; ++node_i) {
+      d.Append(eq_shares[2 * node_i + 1]);
+      e_lt.Append(lt_shares[2 * node_i]);
+      e_eq.Append(eq_shares[2 * node_i]);
+    }
+    d ^= a;
+    e_lt ^= b_lt;
+    e_eq ^= b_eq;
+    auto message = d;
+    message.Append(e_lt);
+    message.Append(e_eq);
+    beavy_provider_.send_bits_message(1 - my_id, gate_id_, message, 3 + level);
+    const auto other_message = and_futures_[level].get();
+    d ^= other_message.Subset(0, size);
+    e_lt ^= other_message.Subset(size, 2 * size);
+    e_eq ^= other_message.Subset(2 * size, 3 * size);
+    auto z_lt = triple_c_.Subset(offset, offset + size) ^ (d & b_lt) ^ (e_lt & a);
+    auto z_eq =
+        triple_c_.Subset(num_nodes + offset, num_nodes + offset + size) ^ (d & b_eq) ^ (e_eq & a);
+    if (my_job_) {
+      z_lt ^= d & e_lt;
+      z_eq ^= d & e_eq;
+    }
+    for (std::size_t node_i = 0; node_i < n; ++node_i) {
+      lt_shares[node_i] =
+          lt_shares[2 * node_i + 1] ^ z_lt.Subset(node_i * data_size_, (node_i + 1) * data_size_);
+      eq_shares[node_i] = z_eq.Subset(node_i * data_size_, (node_i + 1) * data_size_);
+    }
+    offset += size;
+  }
+
+  // msb(x) = msb(u) ^ msb(v) ^ carry
+  msb_share ^= lt_shares[0];
+  msb_share ^= output_->get_secret_share()[0];
+  beavy_provider_.send_bits_message(1 - my_id, gate_id_, msb_share);
+  msb_share ^= share_future_.get();
+  output_->get_public_share()[0] = std::move(msb_share);
+  output_->set_online_ready();
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: ArithmeticBEAVYTensorMsb<T>::evaluate_online end", gate_id_));
+    }
+  }
+}
+
+template <typename T>
+void ArithmeticBEAVYTensorMsb<T>::clear() {
+  if (my_job_) {
+    rot_sender_->clear();
+  } else {
+    rot_receiver_->clear();
+  }
+  ot_sender_->clear();
+  ot_receiver_->clear();
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
+template class ArithmeticBEAVYTensorMsb<std::uint32_t>;
+template class ArithmeticBEAVYTensorMsb<std::uint64_t>;
+
 template <typename T>
 BooleanToArithmeticBEAVYTensorConversion<T>::BooleanToArithmeticBEAVYTensorConversion(
     std::size_t gate_id, BEAVYProvider& beavy_provider, const BooleanBEAVYTensorCP input)
@@ -2188,7 +2535,9 @@ BooleanXArithmeticBEAVYTensorRelu<T>::BooleanXArithmeticBEAVYTensorRelu(
   if (input_bool_->get_dimensions() != input_arith_->get_dimensions()) {
     throw std::invalid_argument("dimension mismatch");
   }
-  if (input_bool_->get_bit_size() != input_arith_->get_bit_size()) {
+  // only the MSB is used, so a sign bit tensor of bit size 1 is fine, too
+  if (input_bool_->get_bit_size() != input_arith_->get_bit_size() &&
+      input_bool_->get_bit_size() != 1) {
     throw std::invalid_argument("bit size mismatch");
   }
   const auto my_id = beavy_provider_.get_my_id();
@@ -2232,7 +2581,7 @@ void BooleanXArithmeticBEAVYTensorRelu<T>::evaluate_setup() {
   input_arith_->wait_setup();
   const auto& int_sshare = input_arith_->get_secret_share();
   assert(int_sshare.size() == data_size_);
-  const auto& msb_sshare = input_bool_->get_secret_share()[bit_size_ - 1];
+  const auto& msb_sshare = input_bool_->get_secret_share().back();
   assert(msb_sshare.GetSize() == data_size_);
 
   std::vector<T> msb_sshare_as_ints(data_size_);
@@ -2301,7 +2650,7 @@ void BooleanXArithmeticBEAVYTensorRelu<T>::evaluate_online() {
   const auto& int_sshare = input_arith_->get_secret_share();
   const auto& int_pshare = input_arith_->get_public_share();
   assert(int_pshare.size() == data_size_);
-  const auto& msb_pshare = input_bool_->get_public_share()[bit_size_ - 1];
+  const auto& msb_pshare = input_bool_->get_public_share().back();
   assert(msb_pshare.GetSize() == data_size_);
 
   const auto& sshare = output_->get_secret_share();
@@ -2336,6 +2685,14 @@ void BooleanXArithmeticBEAVYTensorRelu<T>::evaluate_online() {
   }
 }
 
+template <typename T>
+void BooleanXArithmeticBEAVYTensorRelu<T>::clear() {
+  mult_int_side_->clear();
+  mult_bit_side_->clear();
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 template class BooleanXArithmeticBEAVYTensorRelu<std::uint32_t>;
 template class BooleanXArithmeticBEAVYTensorRelu<std::uint64_t>;
 
@@ -2593,4 +2950,215 @@ void BooleanBEAVYTensorMaxPool::evaluate_online_with_context(ExecutionContext& e
   }
 }
 
+BooleanBEAVYTensorArgMax::BooleanBEAVYTensorArgMax(std::size_t gate_id,
+                                                   BEAVYProvider& beavy_provider,
+                                                   const BooleanBEAVYTensorCP input)
+    : NewGate(gate_id),
+      beavy_provider_(beavy_provider),
+      bit_size_(input->get_bit_size()),
+      batch_size_(input->get_dimensions().batch_size_),
+      num_elements_(input->get_dimensions().get_data_size() / batch_size_),
+      input_(input),
+      output_(std::make_shared<BooleanBEAVYTensor>(input->get_dimensions(), 1)),
+      argmax_algo_(beavy_provider_.get_circuit_loader().load_argmax_circuit(
+          bit_size_, num_elements_, true)) {
+  // the circuit is evaluated once per batch entry with the batch as SIMD values
+  input_wires_.resize(bit_size_ * num_elements_);
+  std::generate(std::begin(input_wires_), std::end(input_wires_), [this] {
+    auto w = std::make_shared<BooleanBEAVYWire>(batch_size_);
+    w->get_secret_share().Resize(batch_size_);
+    w->get_public_share().Resize(batch_size_);
+    return w;
+  });
+  {
+    WireVector in(bit_size_ * num_elements_);
+    std::transform(std::begin(input_wires_), std::end(input_wires_), std::begin(in),
+                   [](auto w) { return std::dynamic_pointer_cast<BooleanBEAVYWire>(w); });
+    auto [gates, out] = construct_circuit(beavy_provider_, argmax_algo_, in);
+    gates_ = std::move(gates);
+    assert(out.size() == num_elements_);
+    output_wires_.resize(num_elements_);
+    std::transform(std::begin(out), std::end(out), std::begin(output_wires_),
+                   [](auto w) { return std::dynamic_pointer_cast<BooleanBEAVYWire>(w); });
+  }
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format("Gate {}: BooleanBEAVYTensorArgMax created", gate_id_));
+    }
+  }
+}
+
+// Element i of batch entry b is stored at position b * num_elements + i of the
+// tensor and becomes SIMD value b of the i-th input of the circuit.
+template <bool setup>
+static void argmax_prepare_wires(std::size_t bit_size, std::size_t batch_size,
+                                 std::size_t num_elements, BooleanBEAVYWireVector& circuit_wires,
+                                 const std::vector<ENCRYPTO::BitVector<>>& input_shares) {
+#pragma omp parallel for
+  for (std::size_t bit_j = 0; bit_j < bit_size; ++bit_j) {
+    const auto& in_share = input_shares[bit_j];
+    for (std::size_t elem_i = 0; elem_i < num_elements; ++elem_i) {
+      auto& wire = circuit_wires[elem_i * bit_size + bit_j];
+      auto& bv = setup ? wire->get_secret_share() : wire->get_public_share();
+      for (std::size_t batch_k = 0; batch_k < batch_size; ++batch_k) {
+        bv.Set(in_share.Get(batch_k * num_elements + elem_i), batch_k);
+      }
+    }
+  }
+  for (auto& wire : circuit_wires) {
+    if constexpr (setup) {
+      wire->set_setup_ready();
+    } else {
+      wire->set_online_ready();
+    }
+  }
+}
+
+template <bool setup>
+static void argmax_collect_output(std::size_t batch_size, std::size_t num_elements,
+                                  BooleanBEAVYWireVector& circuit_wires,
+                                  ENCRYPTO::BitVector<>& output_share) {
+  output_share.Resize(batch_size * num_elements);
+  for (std::size_t elem_i = 0; elem_i < num_elements; ++elem_i) {
+    auto& wire = circuit_wires[elem_i];
+    if constexpr (setup) {
+      wire->wait_setup();
+    } else {
+      wire->wait_online();
+    }
+    const auto& bv = setup ? wire->get_secret_share() : wire->get_public_share();
+    for (std::size_t batch_k = 0; batch_k < batch_size; ++batch_k) {
+      output_share.Set(bv.Get(batch_k), batch_k * num_elements + elem_i);
+    }
+  }
+}
+
+void BooleanBEAVYTensorArgMax::evaluate_setup() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: BooleanBEAVYTensorArgMax::evaluate_setup start", gate_id_));
+    }
+  }
+
+  input_->wait_setup();
+
+  argmax_prepare_wires<true>(bit_size_, batch_size_, num_elements_, input_wires_,
+                             input_->get_secret_share());
+
+  for (auto& gate : gates_) {
+    // should work since its a Boolean circuit consisting of AND, XOR, INV gates
+    gate->evaluate_setup();
+  }
+
+  argmax_collect_output<true>(batch_size_, num_elements_, output_wires_,
+                              output_->get_secret_share()[0]);
+  output_->set_setup_ready();
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: BooleanBEAVYTensorArgMax::evaluate_setup end", gate_id_));
+    }
+  }
+}
+
+void BooleanBEAVYTensorArgMax::evaluate_setup_with_context(ExecutionContext& exec_ctx) {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format(
+          "Gate {}: BooleanBEAVYTensorArgMax::evaluate_setup_with_context start", gate_id_));
+    }
+  }
+
+  input_->wait_setup();
+
+  argmax_prepare_wires<true>(bit_size_, batch_size_, num_elements_, input_wires_,
+                             input_->get_secret_share());
+
+  for (auto& gate : gates_) {
+    exec_ctx.fpool_->post([&] { gate->evaluate_setup(); });
+  }
+
+  argmax_collect_output<true>(batch_size_, num_elements_, output_wires_,
+                              output_->get_secret_share()[0]);
+  output_->set_setup_ready();
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format(
+          "Gate {}: BooleanBEAVYTensorArgMax::evaluate_setup_with_context end", gate_id_));
+    }
+  }
+}
+
+void BooleanBEAVYTensorArgMax::evaluate_online() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: BooleanBEAVYTensorArgMax::evaluate_online start", gate_id_));
+    }
+  }
+
+  input_->wait_online();
+
+  argmax_prepare_wires<false>(bit_size_, batch_size_, num_elements_, input_wires_,
+                              input_->get_public_share());
+
+  for (auto& gate : gates_) {
+    // should work since its a Boolean circuit consisting of AND, XOR, INV gates
+    gate->evaluate_online();
+  }
+
+  argmax_collect_output<false>(batch_size_, num_elements_, output_wires_,
+                               output_->get_public_share()[0]);
+  output_->set_online_ready();
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: BooleanBEAVYTensorArgMax::evaluate_online end", gate_id_));
+    }
+  }
+}
+
+void BooleanBEAVYTensorArgMax::evaluate_online_with_context(ExecutionContext& exec_ctx) {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format(
+          "Gate {}: BooleanBEAVYTensorArgMax::evaluate_online_with_context start", gate_id_));
+    }
+  }
+
+  input_->wait_online();
+
+  argmax_prepare_wires<false>(bit_size_, batch_size_, num_elements_, input_wires_,
+                              input_->get_public_share());
+
+  for (auto& gate : gates_) {
+    exec_ctx.fpool_->post([&] { gate->evaluate_online(); });
+  }
+
+  argmax_collect_output<false>(batch_size_, num_elements_, output_wires_,
+                               output_->get_public_share()[0]);
+  output_->set_online_ready();
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = beavy_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format(
+          "Gate {}: BooleanBEAVYTensorArgMax::evaluate_online_with_context end", gate_id_));
+    }
+  }
+}
+
 }  // namespace MOTION::proto::beavy
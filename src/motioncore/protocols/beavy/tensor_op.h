@@ -38,6 +38,8 @@ template <typename T>
 class ACOTSender;
 template <typename T>
 class ACOTReceiver;
+class ROTSender;
+class ROTReceiver;
 class XCOTBitSender;
 class XCOTBitReceiver;
 }  // namespace ObliviousTransfer
@@ -80,6 +82,8 @@ class ArithmeticBEAVYTensorInputSender : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   std::shared_ptr<const ArithmeticBEAVYTensor<T>> get_output_tensor() const noexcept {
     return output_;
   }
@@ -102,6 +106,8 @@ class ArithmeticBEAVYTensorInputReceiver : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   std::shared_ptr<const ArithmeticBEAVYTensor<T>> get_output_tensor() const noexcept {
     return output_;
   }
@@ -126,6 +132,8 @@ class ArithmeticBEAVYTensorInputShares : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   std::shared_ptr<const ArithmeticBEAVYTensor<T>> get_output_tensor() const noexcept {
     return output_;
   }
@@ -149,6 +157,8 @@ class ArithmeticBEAVYTensorOutput : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
   ENCRYPTO::ReusableFiberFuture<std::vector<T>> get_output_future();
 
  private:
@@ -169,6 +179,9 @@ class ArithmeticBEAVYTensorFlatten : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticBEAVYTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -189,6 +202,11 @@ class ArithmeticBEAVYTensorConv2D : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_input_wires() const override {
+    return {input_.get(), kernel_.get(), bias_.get()};
+  }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticBEAVYTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -216,6 +234,11 @@ class ArithmeticBEAVYTensorGemm : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_input_wires() const override {
+    return {input_A_.get(), input_B_.get()};
+  }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticBEAVYTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -243,6 +266,10 @@ class ArithmeticBEAVYTensorJoin : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override {
+    return {input_A_.get(), input_B_.get()};
+  }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticBEAVYTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -269,6 +296,10 @@ class ArithmeticBEAVYTensorMul : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override {
+    return {input_A_.get(), input_B_.get()};
+  }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticBEAVYTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -293,6 +324,8 @@ class ArithmeticBEAVYTensorAveragePool : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticBEAVYTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -319,6 +352,9 @@ class ArithmeticBEAVYTensorNegate : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticBEAVYTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -343,6 +379,8 @@ class ArithmeticBEAVYTensorConstMul : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticBEAVYTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -368,6 +406,11 @@ class ArithmeticBEAVYTensorAdd : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_input_wires() const override {
+    return {input_A_.get(), input_B_.get()};
+  }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticBEAVYTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -392,6 +435,11 @@ class ArithmeticBEAVYTensorSplit : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override {
+    return {output_0_.get(), output_1_.get(), output_2_.get(), output_3_.get(), output_4_.get(),
+            output_5_.get(), output_6_.get(), output_7_.get(), output_8_.get(), output_9_.get()};
+  }
   const ArithmeticBEAVYTensorP<T>& get_output_tensor_0() const { return output_0_; }
   const ArithmeticBEAVYTensorP<T>& get_output_tensor_1() const { return output_1_; }
   const ArithmeticBEAVYTensorP<T>& get_output_tensor_2() const { return output_2_; }
@@ -428,6 +476,59 @@ class ArithmeticBEAVYTensorSplit : public NewGate {
   std::unique_ptr<MOTION::MatrixMultiplicationLHS<T>> mm_lhs_side_;
 };
 
+// Computes only the most significant bit of each element of an arithmetic
+// tensor.  With x = u + v, where u = Delta - [delta]_0 is held by the party
+// doing the job and v = -[delta]_1 by the other one, the MSB is
+// msb(u) ^ msb(v) ^ carry, and the carry into the MSB is a comparison of the
+// lower bits.  It is computed as a tree of millionaires' comparisons on 4 bit
+// chunks: the leaves use 1-out-of-16 OTs derived from random OTs during the
+// setup, the inner nodes need log2(bit_size / 4) rounds of ANDs.  The output
+// is a Boolean tensor of bit size 1.
+template <typename T>
+class ArithmeticBEAVYTensorMsb : public NewGate {
+ public:
+  ArithmeticBEAVYTensorMsb(std::size_t gate_id, BEAVYProvider&,
+                           const ArithmeticBEAVYTensorCP<T> input);
+  ~ArithmeticBEAVYTensorMsb();
+  bool need_setup() const noexcept override { return true; }
+  bool need_online() const noexcept override { return true; }
+  void evaluate_setup() override;
+  void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
+  const BooleanBEAVYTensorP& get_output_tensor() const { return output_; }
+
+ private:
+  static constexpr auto bit_size_ = ENCRYPTO::bit_size_v<T>;
+  static constexpr std::size_t chunk_bits_ = 4;
+  static constexpr std::size_t num_chunks_ = bit_size_ / chunk_bits_;
+  BEAVYProvider& beavy_provider_;
+  const std::size_t data_size_;
+  const bool my_job_;
+  const ArithmeticBEAVYTensorCP<T> input_;
+  BooleanBEAVYTensorP output_;
+  // random OTs for the leaves of the comparison tree
+  std::unique_ptr<ENCRYPTO::ObliviousTransfer::ROTSender> rot_sender_;
+  std::unique_ptr<ENCRYPTO::ObliviousTransfer::ROTReceiver> rot_receiver_;
+  // OTs for the AND triples of the inner nodes
+  std::unique_ptr<ENCRYPTO::ObliviousTransfer::XCOTBitSender> ot_sender_;
+  std::unique_ptr<ENCRYPTO::ObliviousTransfer::XCOTBitReceiver> ot_receiver_;
+  // per (element, chunk): the pads of all 16 table entries, or of the chosen one
+  std::vector<std::uint32_t> leaf_pads_;
+  // per (element, chunk): the random leaf shares, or the chunks of the comparand
+  std::vector<std::uint8_t> leaf_data_;
+  // triples (a, b_lt, b_eq, c_lt, c_eq) with a shared a for each inner node
+  ENCRYPTO::BitVector<> triple_a_;
+  ENCRYPTO::BitVector<> triple_b_;
+  ENCRYPTO::BitVector<> triple_c_;
+  ENCRYPTO::BitVector<> msb_v_;
+  ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>> choices_future_;
+  ENCRYPTO::ReusableFiberFuture<std::vector<std::uint32_t>> table_future_;
+  std::vector<ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>>> and_futures_;
+  ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>> share_future_;
+};
+
 template <typename T>
 class BooleanToArithmeticBEAVYTensorConversion : public NewGate {
  public:
@@ -438,6 +539,8 @@ class BooleanToArithmeticBEAVYTensorConversion : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   ArithmeticBEAVYTensorCP<T> get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -461,6 +564,8 @@ class BooleanBEAVYTensorRelu : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const BooleanBEAVYTensorP& get_output_tensor() const { return output_; }
 
  private:
@@ -485,6 +590,11 @@ class BooleanXArithmeticBEAVYTensorRelu : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_input_wires() const override {
+    return {input_bool_.get(), input_arith_.get()};
+  }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticBEAVYTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -511,6 +621,8 @@ class BooleanBEAVYTensorMaxPool : public NewGate {
   void evaluate_setup_with_context(ExecutionContext&) override;
   void evaluate_online() override;
   void evaluate_online_with_context(ExecutionContext&) override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const BooleanBEAVYTensorP& get_output_tensor() const { return output_; }
 
  private:
@@ -526,4 +638,32 @@ class BooleanBEAVYTensorMaxPool : public NewGate {
   std::vector<std::unique_ptr<NewGate>> gates_;
 };
 
+// Computes a one-hot encoding of the position of the maximum of each batch
+// entry with a tournament of comparisons of depth log2(n).
+class BooleanBEAVYTensorArgMax : public NewGate {
+ public:
+  BooleanBEAVYTensorArgMax(std::size_t gate_id, BEAVYProvider&, const BooleanBEAVYTensorCP input);
+  bool need_setup() const noexcept override { return true; }
+  bool need_online() const noexcept override { return true; }
+  void evaluate_setup() override;
+  void evaluate_setup_with_context(ExecutionContext&) override;
+  void evaluate_online() override;
+  void evaluate_online_with_context(ExecutionContext&) override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
+  const BooleanBEAVYTensorP& get_output_tensor() const { return output_; }
+
+ private:
+  BEAVYProvider& beavy_provider_;
+  const std::size_t bit_size_;
+  const std::size_t batch_size_;
+  const std::size_t num_elements_;
+  const BooleanBEAVYTensorCP input_;
+  const BooleanBEAVYTensorP output_;
+  const ENCRYPTO::AlgorithmDescription& argmax_algo_;
+  BooleanBEAVYWireVector input_wires_;
+  BooleanBEAVYWireVector output_wires_;
+  std::vector<std::unique_ptr<NewGate>> gates_;
+};
+
 }  // namespace MOTION::proto::beavy
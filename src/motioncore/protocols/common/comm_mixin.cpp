@@ -22,7 +22,9 @@
 
 #include "comm_mixin.h"
 
+#include <algorithm>
 #include <cstdint>
+#include <functional>
 #include <unordered_map>
 
 #include <boost/functional/hash.hpp>
@@ -31,11 +33,16 @@
 #include "communication/fbs_headers/comm_mixin_gate_message_generated.h"
 #include "communication/message.h"
 #include "communication/message_handler.h"
+#include "utility/compression.h"
 #include "utility/constants.h"
 #include "utility/logger.h"
 
 namespace {
 
+// flags of CommMixinGateMessage::encoding
+constexpr std::uint8_t encoding_packed = 1;
+constexpr std::uint8_t encoding_lz = 2;
+
 struct SizeTPairHash {
   std::size_t operator()(const std::pair<std::size_t, std::size_t>& p) const {
     std::size_t seed = 0;
@@ -53,8 +60,15 @@ struct CommMixin::GateMessageHandler : public Communication::MessageHandler {
   GateMessageHandler(std::size_t num_parties, Communication::MessageType gate_message_type,
                      std::shared_ptr<Logger> logger);
   void received_message(std::size_t, std::vector<std::uint8_t>&& raw_message) override;
+  // the payload is deserialized directly from the pooled buffer
+  void received_pooled_message(std::size_t, Communication::ReceiveBuffer&& raw_message) override;
+  void handle_message(std::size_t party_id, const std::uint8_t* raw_message, std::size_t size);
 
   enum class MsgValueType { bit, block, uint8, uint16, uint32, uint64 };
+  static std::size_t get_byte_size(std::size_t num_elements, MsgValueType type);
+  // decode a packed and/or compressed payload, returns false if it is malformed
+  static bool decode_payload(const Communication::CommMixinGateMessage& message,
+                             MsgValueType type, std::vector<std::uint8_t>& output);
 
   template <typename T>
   constexpr static CommMixin::GateMessageHandler::MsgValueType get_msg_value_type();
@@ -62,6 +76,10 @@ struct CommMixin::GateMessageHandler : public Communication::MessageHandler {
   // KeyType = (gate_id, msg_num)
   using KeyType = std::pair<std::size_t, std::size_t>;
 
+  // fulfill the promise for a complete message
+  void set_value(std::size_t party_id, const KeyType& key, MsgValueType type,
+                 std::size_t num_elements, const std::uint8_t* data);
+
   // KeyType -> (size, type)
   std::unordered_map<KeyType, std::pair<std::size_t, MsgValueType>, SizeTPairHash>
       expected_messages_;
@@ -86,6 +104,16 @@ struct CommMixin::GateMessageHandler : public Communication::MessageHandler {
       KeyType, ENCRYPTO::ReusableFiberPromise<std::vector<std::uint64_t>>, SizeTPairHash>>
       uint64_promises_;
 
+  // gets the byte offset and the bytes of a chunk
+  using ChunkConsumer = std::function<void(std::size_t, const std::uint8_t*, std::size_t)>;
+  // [KeyType -> consumer] for messages which are received chunk by chunk
+  std::vector<std::unordered_map<KeyType, ChunkConsumer, SizeTPairHash>> chunk_consumers_;
+  // [KeyType -> (buffer, number of bytes received)] for chunked messages which
+  // are passed on as a whole
+  std::vector<std::unordered_map<KeyType, std::pair<std::vector<std::uint8_t>, std::size_t>,
+                                 SizeTPairHash>>
+      partial_messages_;
+
   template <typename T>
   std::vector<
       std::unordered_map<KeyType, ENCRYPTO::ReusableFiberPromise<std::vector<T>>, SizeTPairHash>>&
@@ -98,7 +126,9 @@ struct CommMixin::GateMessageHandler : public Communication::MessageHandler {
 template <typename T>
 constexpr CommMixin::GateMessageHandler::MsgValueType
 CommMixin::GateMessageHandler::get_msg_value_type() {
-  if constexpr (std::is_same_v<T, std::uint8_t>) {
+  if constexpr (std::is_same_v<T, ENCRYPTO::block128_t>) {
+    return CommMixin::GateMessageHandler::MsgValueType::block;
+  } else if constexpr (std::is_same_v<T, std::uint8_t>) {
     return CommMixin::GateMessageHandler::MsgValueType::uint8;
   } else if constexpr (std::is_same_v<T, std::uint16_t>) {
     return CommMixin::GateMessageHandler::MsgValueType::uint16;
@@ -147,15 +177,28 @@ CommMixin::GateMessageHandler::GateMessageHandler(std::size_t num_parties,
       uint16_promises_(num_parties),
       uint32_promises_(num_parties),
       uint64_promises_(num_parties),
+      chunk_consumers_(num_parties),
+      partial_messages_(num_parties),
       gate_message_type_(gate_message_type),
       logger_(logger) {}
 
 void CommMixin::GateMessageHandler::received_message(std::size_t party_id,
                                                      std::vector<std::uint8_t>&& raw_message) {
-  assert(!raw_message.empty());
-  auto message = Communication::GetMessage(raw_message.data());
+  handle_message(party_id, raw_message.data(), raw_message.size());
+}
+
+void CommMixin::GateMessageHandler::received_pooled_message(
+    std::size_t party_id, Communication::ReceiveBuffer&& raw_message) {
+  handle_message(party_id, raw_message.data(), raw_message.size());
+}
+
+void CommMixin::GateMessageHandler::handle_message(std::size_t party_id,
+                                                   const std::uint8_t* raw_message,
+                                                   std::size_t size) {
+  assert(size > 0);
+  auto message = Communication::GetMessage(raw_message);
   {
-    flatbuffers::Verifier verifier(raw_message.data(), raw_message.size());
+    flatbuffers::Verifier verifier(raw_message, size);
     if (!message->Verify(verifier)) {
       throw std::runtime_error("received malformed Message");
       // TODO: log and drop instead
@@ -181,8 +224,10 @@ void CommMixin::GateMessageHandler::received_message(std::size_t party_id,
   }
   auto gate_id = gate_message->gate_id();
   auto msg_num = gate_message->msg_num();
-  auto payload = gate_message->payload();
-  auto it = expected_messages_.find({gate_id, msg_num});
+  auto chunk_offset = gate_message->chunk_offset();
+  auto encoding = gate_message->encoding();
+  const KeyType key{gate_id, msg_num};
+  auto it = expected_messages_.find(key);
   if (it == expected_messages_.end()) {
     logger_->LogError(fmt::format("received unexpected {} for gate {}, dropping",
                                   EnumNameMessageType(gate_message_type_), gate_id));
@@ -190,81 +235,174 @@ void CommMixin::GateMessageHandler::received_message(std::size_t party_id,
   }
   auto expected_size = it->second.first;
   auto type = it->second.second;
+  auto byte_size = get_byte_size(expected_size, type);
+  const std::uint8_t* payload = gate_message->payload()->data();
+  std::size_t payload_size =
+      encoding == 0 ? gate_message->payload()->size() : gate_message->decoded_size();
+  if (chunk_offset > byte_size || payload_size > byte_size - chunk_offset) {
+    logger_->LogError(fmt::format(
+        "received {} for gate {} (msg_num {}) of size {} at offset {} while expecting size {}, "
+        "dropping",
+        EnumNameMessageType(gate_message_type_), gate_id, msg_num, payload_size, chunk_offset,
+        byte_size));
+    return;
+  }
 
-  auto set_value_helper = [this, party_id, gate_id, msg_num, expected_size, payload](
-                              auto& map_vec, auto type_tag) {
-    auto byte_size = expected_size * sizeof(type_tag);
-    if (byte_size != payload->size()) {
+  std::vector<std::uint8_t> decoded_payload;
+  if (encoding != 0) {
+    if (!decode_payload(*gate_message, type, decoded_payload)) {
       logger_->LogError(fmt::format(
-          "received {} for gate {} (msg_num {}) of size {} while expecting size {}, dropping",
-          EnumNameMessageType(gate_message_type_), gate_id, msg_num, payload->size(), byte_size));
+          "received {} for gate {} (msg_num {}) with malformed encoded payload, dropping",
+          EnumNameMessageType(gate_message_type_), gate_id, msg_num));
       return;
     }
-    auto& promise_map = map_vec[party_id];
-    auto& promise = promise_map.at({gate_id, msg_num});
-    auto ptr = reinterpret_cast<const decltype(type_tag)*>(payload->data());
-    try {
-      promise.set_value(std::vector(ptr, ptr + expected_size));
-    } catch (std::future_error& e) {
-      logger_->LogError(fmt::format(
-          "unable to fulfill promise ({}) for {} (ints) for gate {} (msg_num {}), dropping",
-          e.what(), EnumNameMessageType(gate_message_type_), gate_id, msg_num));
-    }
-  };
+    payload = decoded_payload.data();
+  }
+
+  if (auto consumer_it = chunk_consumers_[party_id].find(key);
+      consumer_it != chunk_consumers_[party_id].end()) {
+    consumer_it->second(chunk_offset, payload, payload_size);
+    return;
+  }
+
+  // common case: the message was not split
+  if (payload_size == byte_size) {
+    set_value(party_id, key, type, expected_size, payload);
+    return;
+  }
+
+  auto& partial_message = partial_messages_[party_id][key];
+  auto& [buffer, num_bytes_received] = partial_message;
+  buffer.resize(byte_size);
+  std::copy_n(payload, payload_size, buffer.data() + chunk_offset);
+  num_bytes_received += payload_size;
+  if (num_bytes_received == byte_size) {
+    auto message = std::move(buffer);
+    partial_messages_[party_id].erase(key);
+    set_value(party_id, key, type, expected_size, message.data());
+  }
+}
 
+std::size_t CommMixin::GateMessageHandler::get_byte_size(std::size_t num_elements,
+                                                         MsgValueType type) {
   switch (type) {
-    case MsgValueType::bit: {
-      auto byte_size = Helpers::Convert::BitsToBytes(expected_size);
-      if (byte_size != payload->size()) {
-        logger_->LogError(fmt::format(
-            "received {} for gate {} (msg_num {}) of size {} while expecting size {}, dropping",
-            EnumNameMessageType(gate_message_type_), gate_id, msg_num, payload->size(), byte_size));
-        return;
-      }
-      auto& promise = bits_promises_[party_id].at({gate_id, msg_num});
-      try {
-        promise.set_value(ENCRYPTO::BitVector(payload->data(), expected_size));
-      } catch (std::future_error& e) {
-        logger_->LogError(fmt::format(
-            "unable to fulfill promise ({}) for {} (bits) for gate {} (msg_num {}), dropping",
-            e.what(), EnumNameMessageType(gate_message_type_), gate_id, msg_num));
-      }
-      break;
-    }
-    case MsgValueType::block: {
-      auto byte_size = 16 * expected_size;
-      if (byte_size != payload->size()) {
-        logger_->LogError(fmt::format(
-            "received {} for gate {} (msg_num {}) of size {} while expecting size {}, dropping",
-            EnumNameMessageType(gate_message_type_), gate_id, msg_num, payload->size(), byte_size));
-        return;
-      }
-      auto& promise = blocks_promises_[party_id].at({gate_id, msg_num});
-      try {
-        promise.set_value(ENCRYPTO::block128_vector(expected_size, payload->data()));
-      } catch (std::future_error& e) {
-        logger_->LogError(fmt::format(
-            "unable to fulfill promise ({}) for {} (blocks) for gate {} (msg_num {}), dropping",
-            e.what(), EnumNameMessageType(gate_message_type_), gate_id, msg_num));
-      }
-      break;
+    case MsgValueType::bit:
+      return Helpers::Convert::BitsToBytes(num_elements);
+    case MsgValueType::block:
+      return 16 * num_elements;
+    case MsgValueType::uint8:
+      return num_elements;
+    case MsgValueType::uint16:
+      return sizeof(std::uint16_t) * num_elements;
+    case MsgValueType::uint32:
+      return sizeof(std::uint32_t) * num_elements;
+    case MsgValueType::uint64:
+      return sizeof(std::uint64_t) * num_elements;
+  }
+  return 0;
+}
+
+bool CommMixin::GateMessageHandler::decode_payload(
+    const Communication::CommMixinGateMessage& message, MsgValueType type,
+    std::vector<std::uint8_t>& output) {
+  const auto encoding = message.encoding();
+  const auto bit_size = message.bit_size();
+  const auto decoded_size = message.decoded_size();
+  const auto payload = message.payload();
+  if ((encoding & ~(encoding_packed | encoding_lz)) != 0) {
+    return false;
+  }
+  output.resize(decoded_size);
+  if ((encoding & encoding_packed) == 0) {
+    return utils::lz_decompress(payload->data(), payload->size(), output.data(), decoded_size);
+  }
+
+  if (type == MsgValueType::bit || type == MsgValueType::block) {
+    return false;
+  }
+  const auto element_size = get_byte_size(1, type);
+  if (bit_size == 0 || bit_size > 8 * element_size || decoded_size % element_size != 0) {
+    return false;
+  }
+  const auto num_elements = decoded_size / element_size;
+  const auto packed_size = utils::packed_size(num_elements, bit_size);
+  const std::uint8_t* packed = payload->data();
+  std::vector<std::uint8_t> buffer;
+  if ((encoding & encoding_lz) != 0) {
+    buffer.resize(packed_size);
+    if (!utils::lz_decompress(payload->data(), payload->size(), buffer.data(), packed_size)) {
+      return false;
     }
-    case MsgValueType::uint8: {
-      set_value_helper(uint8_promises_, std::uint8_t{});
+    packed = buffer.data();
+  } else if (payload->size() != packed_size) {
+    return false;
+  }
+
+  auto unpack = [packed, num_elements, bit_size, &output](auto type_tag) {
+    utils::unpack_bits(packed, num_elements, bit_size,
+                       reinterpret_cast<decltype(type_tag)*>(output.data()));
+  };
+  switch (type) {
+    case MsgValueType::uint8:
+      unpack(std::uint8_t{});
       break;
-    }
-    case MsgValueType::uint16: {
-      set_value_helper(uint16_promises_, std::uint16_t{});
+    case MsgValueType::uint16:
+      unpack(std::uint16_t{});
       break;
-    }
-    case MsgValueType::uint32: {
-      set_value_helper(uint32_promises_, std::uint32_t{});
+    case MsgValueType::uint32:
+      unpack(std::uint32_t{});
       break;
-    }
-    case MsgValueType::uint64: {
-      set_value_helper(uint64_promises_, std::uint64_t{});
+    case MsgValueType::uint64:
+      unpack(std::uint64_t{});
       break;
+    default:
+      return false;
+  }
+  return true;
+}
+
+void CommMixin::GateMessageHandler::set_value(std::size_t party_id, const KeyType& key,
+                                              MsgValueType type, std::size_t num_elements,
+                                              const std::uint8_t* data) {
+  const auto [gate_id, msg_num] = key;
+  auto set_value_helper = [this, party_id, &key, num_elements, data](auto& map_vec,
+                                                                      auto type_tag) {
+    auto& promise = map_vec[party_id].at(key);
+    auto ptr = reinterpret_cast<const decltype(type_tag)*>(data);
+    promise.emplace_value(ptr, ptr + num_elements);
+  };
+
+  try {
+    switch (type) {
+      case MsgValueType::bit: {
+        bits_promises_[party_id].at(key).emplace_value(data, num_elements);
+        break;
+      }
+      case MsgValueType::block: {
+        blocks_promises_[party_id].at(key).emplace_value(num_elements, data);
+        break;
+      }
+      case MsgValueType::uint8: {
+        set_value_helper(uint8_promises_, std::uint8_t{});
+        break;
+      }
+      case MsgValueType::uint16: {
+        set_value_helper(uint16_promises_, std::uint16_t{});
+        break;
+      }
+      case MsgValueType::uint32: {
+        set_value_helper(uint32_promises_, std::uint32_t{});
+        break;
+      }
+      case MsgValueType::uint64: {
+        set_value_helper(uint64_promises_, std::uint64_t{});
+        break;
+      }
     }
+  } catch (std::future_error& e) {
+    logger_->LogError(
+        fmt::format("unable to fulfill promise ({}) for {} for gate {} (msg_num {}), dropping",
+                    e.what(), EnumNameMessageType(gate_message_type_), gate_id, msg_num));
   }
 }
 
@@ -284,48 +422,148 @@ CommMixin::CommMixin(Communication::CommunicationLayer& communication_layer,
 
 CommMixin::~CommMixin() { communication_layer_.deregister_message_handler({gate_message_type_}); }
 
-flatbuffers::FlatBufferBuilder CommMixin::build_gate_message(std::size_t gate_id,
-                                                             std::size_t msg_num,
-                                                             const std::uint8_t* message,
-                                                             std::size_t size) const {
+void CommMixin::set_max_chunk_size(std::size_t max_chunk_size) {
+  // flatbuffers are limited to 2 GiB
+  max_chunk_size_ = std::clamp<std::size_t>(max_chunk_size, 16, 1 << 30) / 16 * 16;
+}
+
+MessageEncodingStatistics CommMixin::get_message_encoding_statistics() const noexcept {
+  return {num_ints_messages_.load(), num_raw_bytes_.load(), num_encoded_bytes_.load()};
+}
+
+flatbuffers::FlatBufferBuilder CommMixin::build_gate_message(
+    std::size_t gate_id, std::size_t msg_num, const std::uint8_t* message, std::size_t size,
+    std::size_t chunk_offset, std::uint8_t encoding, std::size_t bit_size,
+    std::size_t decoded_size) const {
   flatbuffers::FlatBufferBuilder builder;
   auto vector = builder.CreateVector(message, size);
-  auto root = Communication::CreateCommMixinGateMessage(builder, gate_id, msg_num, vector);
+  auto root = Communication::CreateCommMixinGateMessage(builder, gate_id, msg_num, vector,
+                                                        chunk_offset, encoding, bit_size,
+                                                        decoded_size);
   builder.Finish(root);
   return Communication::BuildMessage(gate_message_type_, builder.GetBufferPointer(),
                                      builder.GetSize());
 }
 
-template <typename T>
-flatbuffers::FlatBufferBuilder CommMixin::build_gate_message(std::size_t gate_id,
-                                                             std::size_t msg_num,
-                                                             const std::vector<T>& vector) const {
-  return build_gate_message(gate_id, msg_num, reinterpret_cast<const std::uint8_t*>(vector.data()),
-                            sizeof(T) * vector.size());
+void CommMixin::send_gate_message(std::optional<std::size_t> party_id, std::size_t gate_id,
+                                  std::size_t msg_num, const std::uint8_t* message,
+                                  std::size_t size, std::size_t byte_offset) const {
+  // each chunk is sent as soon as it is built, so that the receiver can start processing
+  std::size_t chunk_offset = 0;
+  do {
+    const auto chunk_size = std::min(size - chunk_offset, max_chunk_size_);
+    auto chunk = build_gate_message(gate_id, msg_num, message + chunk_offset, chunk_size,
+                                    byte_offset + chunk_offset);
+    if (party_id.has_value()) {
+      communication_layer_.send_message(*party_id, std::move(chunk));
+    } else {
+      communication_layer_.broadcast_message(std::move(chunk));
+    }
+    chunk_offset += chunk_size;
+  } while (chunk_offset < size);
 }
 
-flatbuffers::FlatBufferBuilder CommMixin::build_gate_message(
-    std::size_t gate_id, std::size_t msg_num, const ENCRYPTO::BitVector<>& message) const {
-  auto vector = message.GetData();
-  return build_gate_message(gate_id, msg_num, reinterpret_cast<const std::uint8_t*>(vector.data()),
-                            vector.size());
+template <typename T>
+void CommMixin::send_ints_gate_message(std::optional<std::size_t> party_id, std::size_t gate_id,
+                                       std::size_t msg_num, const std::vector<T>& message,
+                                       std::size_t bit_size) const {
+  const auto raw_size = sizeof(T) * message.size();
+  const bool pack = bit_size > 0 && bit_size < 8 * sizeof(T);
+  num_ints_messages_ += 1;
+  num_raw_bytes_ += raw_size;
+  if (!pack && !compress_messages_) {
+    num_encoded_bytes_ += raw_size;
+    send_gate_message(party_id, gate_id, msg_num,
+                      reinterpret_cast<const std::uint8_t*>(message.data()), raw_size);
+    return;
+  }
+
+  // chunks are encoded independently, their offsets refer to the decoded message
+  const auto max_chunk_elements = max_chunk_size_ / sizeof(T);
+  std::vector<std::uint8_t> packed;
+  std::size_t offset = 0;
+  do {
+    const auto num_elements = std::min(message.size() - offset, max_chunk_elements);
+    const auto decoded_size = sizeof(T) * num_elements;
+    const auto* payload = reinterpret_cast<const std::uint8_t*>(message.data() + offset);
+    auto payload_size = decoded_size;
+    std::uint8_t encoding = 0;
+    if (pack) {
+      packed.resize(utils::packed_size(num_elements, bit_size));
+      utils::pack_bits(message.data() + offset, num_elements, bit_size, packed.data());
+      payload = packed.data();
+      payload_size = packed.size();
+      encoding |= encoding_packed;
+    }
+    std::optional<std::vector<std::uint8_t>> compressed;
+    if (compress_messages_) {
+      compressed = utils::lz_compress(payload, payload_size);
+      if (compressed.has_value()) {
+        payload = compressed->data();
+        payload_size = compressed->size();
+        encoding |= encoding_lz;
+      }
+    }
+    num_encoded_bytes_ += payload_size;
+    auto chunk = build_gate_message(gate_id, msg_num, payload, payload_size, sizeof(T) * offset,
+                                    encoding, pack ? bit_size : 0, decoded_size);
+    if (party_id.has_value()) {
+      communication_layer_.send_message(*party_id, std::move(chunk));
+    } else {
+      communication_layer_.broadcast_message(std::move(chunk));
+    }
+    offset += num_elements;
+  } while (offset < message.size());
 }
 
-flatbuffers::FlatBufferBuilder CommMixin::build_gate_message(
-    std::size_t gate_id, std::size_t msg_num, const ENCRYPTO::block128_vector& message) const {
-  auto data = message.data();
-  return build_gate_message(gate_id, msg_num, reinterpret_cast<const std::uint8_t*>(data),
-                            16 * message.size());
+template <typename T, typename Chunk>
+std::shared_ptr<MessageChunkQueue<Chunk>> CommMixin::register_for_message_chunks(
+    std::size_t party_id, std::size_t gate_id, std::size_t num_elements, std::size_t msg_num) {
+  assert(party_id != my_id_);
+  auto& mh = *message_handler_;
+  auto queue = std::make_shared<MessageChunkQueue<Chunk>>();
+  auto [_, success] = mh.expected_messages_.insert(
+      {std::make_pair(gate_id, msg_num),
+       std::make_pair(num_elements, GateMessageHandler::get_msg_value_type<T>())});
+  if (!success) {
+    throw std::logic_error(
+        fmt::format("tried to register twice for message {} for gate {}", msg_num, gate_id));
+  }
+  auto consumer = [queue](std::size_t byte_offset, const std::uint8_t* data, std::size_t size) {
+    const auto num_chunk_elements = size / sizeof(T);
+    if constexpr (std::is_same_v<Chunk, ENCRYPTO::block128_vector>) {
+      queue->enqueue({byte_offset / sizeof(T), Chunk(num_chunk_elements, data)});
+    } else {
+      auto ptr = reinterpret_cast<const T*>(data);
+      queue->enqueue({byte_offset / sizeof(T), Chunk(ptr, ptr + num_chunk_elements)});
+    }
+  };
+  {
+    auto& consumer_map = mh.chunk_consumers_.at(party_id);
+    auto [_, success] = consumer_map.insert({std::make_pair(gate_id, msg_num), consumer});
+    assert(success);
+  }
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    if (logger_) {
+      logger_->LogTrace(fmt::format("Gate {}: registered for chunks of message {} of size {}",
+                                    gate_id, msg_num, num_elements));
+    }
+  }
+  return queue;
 }
 
 void CommMixin::broadcast_bits_message(std::size_t gate_id, const ENCRYPTO::BitVector<>& message,
                                        std::size_t msg_num) const {
-  communication_layer_.broadcast_message(build_gate_message(gate_id, msg_num, message));
+  const auto& data = message.GetData();
+  send_gate_message(std::nullopt, gate_id, msg_num,
+                    reinterpret_cast<const std::uint8_t*>(data.data()), data.size());
 }
 
 void CommMixin::send_bits_message(std::size_t party_id, std::size_t gate_id,
                                   const ENCRYPTO::BitVector<>& message, std::size_t msg_num) const {
-  communication_layer_.send_message(party_id, build_gate_message(gate_id, msg_num, message));
+  const auto& data = message.GetData();
+  send_gate_message(party_id, gate_id, msg_num, reinterpret_cast<const std::uint8_t*>(data.data()),
+                    data.size());
 }
 
 [[nodiscard]] std::vector<ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>>>
@@ -390,13 +628,22 @@ CommMixin::register_for_bits_message(std::size_t party_id, std::size_t gate_id,
 void CommMixin::broadcast_blocks_message(std::size_t gate_id,
                                          const ENCRYPTO::block128_vector& message,
                                          std::size_t msg_num) const {
-  communication_layer_.broadcast_message(build_gate_message(gate_id, msg_num, message));
+  send_gate_message(std::nullopt, gate_id, msg_num,
+                    reinterpret_cast<const std::uint8_t*>(message.data()), 16 * message.size());
 }
 
 void CommMixin::send_blocks_message(std::size_t party_id, std::size_t gate_id,
                                     const ENCRYPTO::block128_vector& message,
                                     std::size_t msg_num) const {
-  communication_layer_.send_message(party_id, build_gate_message(gate_id, msg_num, message));
+  send_gate_message(party_id, gate_id, msg_num,
+                    reinterpret_cast<const std::uint8_t*>(message.data()), 16 * message.size());
+}
+
+void CommMixin::send_blocks_message_part(std::size_t party_id, std::size_t gate_id,
+                                         const ENCRYPTO::block128_t* part, std::size_t num_blocks,
+                                         std::size_t offset, std::size_t msg_num) const {
+  send_gate_message(party_id, gate_id, msg_num, reinterpret_cast<const std::uint8_t*>(part),
+                    16 * num_blocks, 16 * offset);
 }
 
 [[nodiscard]] std::vector<ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector>>
@@ -458,35 +705,47 @@ CommMixin::register_for_blocks_message(std::size_t party_id, std::size_t gate_id
   return future;
 }
 
+[[nodiscard]] std::shared_ptr<MessageChunkQueue<ENCRYPTO::block128_vector>>
+CommMixin::register_for_blocks_message_chunks(std::size_t party_id, std::size_t gate_id,
+                                              std::size_t num_blocks, std::size_t msg_num) {
+  return register_for_message_chunks<ENCRYPTO::block128_t, ENCRYPTO::block128_vector>(
+      party_id, gate_id, num_blocks, msg_num);
+}
+
 template <typename T>
 void CommMixin::broadcast_ints_message(std::size_t gate_id, const std::vector<T>& message,
-                                       std::size_t msg_num) const {
-  communication_layer_.broadcast_message(build_gate_message(gate_id, msg_num, message));
+                                       std::size_t msg_num, std::size_t bit_size) const {
+  send_ints_gate_message(std::nullopt, gate_id, msg_num, message, bit_size);
 }
 
 template void CommMixin::broadcast_ints_message(std::size_t, const std::vector<std::uint8_t>&,
-                                                std::size_t) const;
+                                                std::size_t, std::size_t) const;
 template void CommMixin::broadcast_ints_message(std::size_t, const std::vector<std::uint16_t>&,
-                                                std::size_t) const;
+                                                std::size_t, std::size_t) const;
 template void CommMixin::broadcast_ints_message(std::size_t, const std::vector<std::uint32_t>&,
-                                                std::size_t) const;
+                                                std::size_t, std::size_t) const;
 template void CommMixin::broadcast_ints_message(std::size_t, const std::vector<std::uint64_t>&,
-                                                std::size_t) const;
+                                                std::size_t, std::size_t) const;
 
 template <typename T>
 void CommMixin::send_ints_message(std::size_t party_id, std::size_t gate_id,
-                                  const std::vector<T>& message, std::size_t msg_num) const {
-  communication_layer_.send_message(party_id, build_gate_message(gate_id, msg_num, message));
+                                  const std::vector<T>& message, std::size_t msg_num,
+                                  std::size_t bit_size) const {
+  send_ints_gate_message(party_id, gate_id, msg_num, message, bit_size);
 }
 
 template void CommMixin::send_ints_message(std::size_t, std::size_t,
-                                           const std::vector<std::uint8_t>&, std::size_t) const;
+                                           const std::vector<std::uint8_t>&, std::size_t,
+                                           std::size_t) const;
 template void CommMixin::send_ints_message(std::size_t, std::size_t,
-                                           const std::vector<std::uint16_t>&, std::size_t) const;
+                                           const std::vector<std::uint16_t>&, std::size_t,
+                                           std::size_t) const;
 template void CommMixin::send_ints_message(std::size_t, std::size_t,
-                                           const std::vector<std::uint32_t>&, std::size_t) const;
+                                           const std::vector<std::uint32_t>&, std::size_t,
+                                           std::size_t) const;
 template void CommMixin::send_ints_message(std::size_t, std::size_t,
-                                           const std::vector<std::uint64_t>&, std::size_t) const;
+                                           const std::vector<std::uint64_t>&, std::size_t,
+                                           std::size_t) const;
 
 template <typename T>
 [[nodiscard]] std::vector<ENCRYPTO::ReusableFiberFuture<std::vector<T>>>
@@ -568,4 +827,20 @@ template ENCRYPTO::ReusableFiberFuture<std::vector<std::uint32_t>>
 template ENCRYPTO::ReusableFiberFuture<std::vector<std::uint64_t>>
     CommMixin::register_for_ints_message(std::size_t, std::size_t, std::size_t, std::size_t);
 
+template <typename T>
+[[nodiscard]] std::shared_ptr<MessageChunkQueue<std::vector<T>>>
+CommMixin::register_for_ints_message_chunks(std::size_t party_id, std::size_t gate_id,
+                                            std::size_t num_elements, std::size_t msg_num) {
+  return register_for_message_chunks<T, std::vector<T>>(party_id, gate_id, num_elements, msg_num);
+}
+
+template std::shared_ptr<MessageChunkQueue<std::vector<std::uint8_t>>>
+    CommMixin::register_for_ints_message_chunks(std::size_t, std::size_t, std::size_t, std::size_t);
+template std::shared_ptr<MessageChunkQueue<std::vector<std::uint16_t>>>
+    CommMixin::register_for_ints_message_chunks(std::size_t, std::size_t, std::size_t, std::size_t);
+template std::shared_ptr<MessageChunkQueue<std::vector<std::uint32_t>>>
+    CommMixin::register_for_ints_message_chunks(std::size_t, std::size_t, std::size_t, std::size_t);
+template std::shared_ptr<MessageChunkQueue<std::vector<std::uint64_t>>>
+    CommMixin::register_for_ints_message_chunks(std::size_t, std::size_t, std::size_t, std::size_t);
+
 }  // namespace MOTION::proto
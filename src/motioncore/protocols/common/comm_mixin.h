@@ -22,11 +22,14 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <optional>
 
 #include "utility/bit_vector.h"
 #include "utility/block.h"
 #include "utility/reusable_future.h"
+#include "utility/synchronized_queue.h"
 
 namespace MOTION {
 
@@ -39,12 +42,44 @@ enum class MessageType : std::uint8_t;
 
 namespace proto {
 
+// Part of a message which is received in several chunks, the offset is
+// counted in elements.
+template <typename T>
+struct MessageChunk {
+  std::size_t offset_;
+  T data_;
+};
+
+// Queue of chunks in the order of their arrival.  It is never closed, consumers
+// know how many elements to expect in total.
+template <typename T>
+using MessageChunkQueue = ENCRYPTO::SynchronizedFiberQueue<MessageChunk<T>>;
+
+// Sizes of the sent ints messages before and after encoding.
+struct MessageEncodingStatistics {
+  std::size_t num_messages_ = 0;
+  std::size_t num_raw_bytes_ = 0;
+  std::size_t num_encoded_bytes_ = 0;
+};
+
 class CommMixin {
  public:
   CommMixin(Communication::CommunicationLayer&, Communication::MessageType,
             std::shared_ptr<Logger>);
   ~CommMixin();
 
+  // Messages with larger payloads are sent in several chunks.  Chunks are
+  // multiples of 16 B, so that no element is split across chunks.
+  static constexpr std::size_t default_max_chunk_size = 1 << 24;
+  void set_max_chunk_size(std::size_t max_chunk_size);
+  std::size_t get_max_chunk_size() const noexcept { return max_chunk_size_; }
+
+  // Try to compress ints messages before sending them.  The encoding is
+  // stored in each message, so the receiving side needs no configuration.
+  void set_message_compression(bool enable) noexcept { compress_messages_ = enable; }
+  bool get_message_compression() const noexcept { return compress_messages_; }
+  MessageEncodingStatistics get_message_encoding_statistics() const noexcept;
+
   void broadcast_bits_message(std::size_t gate_id, const ENCRYPTO::BitVector<>& message,
                               std::size_t msg_num = 0) const;
   void send_bits_message(std::size_t party_id, std::size_t gate_id,
@@ -63,13 +98,24 @@ class CommMixin {
   [[nodiscard]] ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector>
   register_for_blocks_message(std::size_t party_id, std::size_t gate_id, std::size_t num_bits,
                               std::size_t msg_num = 0);
+  // Send a part of a blocks message, starting at the given offset (in blocks).
+  // Together, the parts need to cover the whole message.
+  void send_blocks_message_part(std::size_t party_id, std::size_t gate_id,
+                                const ENCRYPTO::block128_t* part, std::size_t num_blocks,
+                                std::size_t offset, std::size_t msg_num = 0) const;
+  // Receive the message chunk by chunk as it arrives instead of waiting for all of it.
+  [[nodiscard]] std::shared_ptr<MessageChunkQueue<ENCRYPTO::block128_vector>>
+  register_for_blocks_message_chunks(std::size_t party_id, std::size_t gate_id,
+                                     std::size_t num_blocks, std::size_t msg_num = 0);
 
+  // If bit_size is smaller than the width of T, only the lowest bit_size bits
+  // of each element are sent, i.e., the values are received modulo 2^bit_size.
   template <typename T>
   void broadcast_ints_message(std::size_t gate_id, const std::vector<T>& message,
-                              std::size_t msg_num = 0) const;
+                              std::size_t msg_num = 0, std::size_t bit_size = 0) const;
   template <typename T>
   void send_ints_message(std::size_t party_id, std::size_t gate_id, const std::vector<T>& message,
-                         std::size_t msg_num = 0) const;
+                         std::size_t msg_num = 0, std::size_t bit_size = 0) const;
   template <typename T>
   [[nodiscard]] std::vector<ENCRYPTO::ReusableFiberFuture<std::vector<T>>>
   register_for_ints_messages(std::size_t gate_id, std::size_t num_elements,
@@ -77,24 +123,44 @@ class CommMixin {
   template <typename T>
   [[nodiscard]] ENCRYPTO::ReusableFiberFuture<std::vector<T>> register_for_ints_message(
       std::size_t party_id, std::size_t gate_id, std::size_t num_elements, std::size_t msg_num = 0);
+  template <typename T>
+  [[nodiscard]] std::shared_ptr<MessageChunkQueue<std::vector<T>>> register_for_ints_message_chunks(
+      std::size_t party_id, std::size_t gate_id, std::size_t num_elements, std::size_t msg_num = 0);
 
  private:
   flatbuffers::FlatBufferBuilder build_gate_message(std::size_t gate_id, std::size_t msg_num,
-                                                    const std::uint8_t* message,
-                                                    std::size_t size) const;
+                                                    const std::uint8_t* message, std::size_t size,
+                                                    std::size_t chunk_offset,
+                                                    std::uint8_t encoding = 0,
+                                                    std::size_t bit_size = 0,
+                                                    std::size_t decoded_size = 0) const;
+  // send the message in chunks to party_id, or to all parties if it is std::nullopt,
+  // the message may be a part of a larger one starting at byte_offset
+  void send_gate_message(std::optional<std::size_t> party_id, std::size_t gate_id,
+                         std::size_t msg_num, const std::uint8_t* message, std::size_t size,
+                         std::size_t byte_offset = 0) const;
+  // like send_gate_message, but the chunks are packed and/or compressed if requested
   template <typename T>
-  flatbuffers::FlatBufferBuilder build_gate_message(std::size_t gate_id, std::size_t msg_num,
-                                                    const std::vector<T>& vector) const;
-  flatbuffers::FlatBufferBuilder build_gate_message(std::size_t gate_id, std::size_t msg_num,
-                                                    const ENCRYPTO::BitVector<>& message) const;
-  flatbuffers::FlatBufferBuilder build_gate_message(std::size_t gate_id, std::size_t msg_num,
-                                                    const ENCRYPTO::block128_vector& message) const;
+  void send_ints_gate_message(std::optional<std::size_t> party_id, std::size_t gate_id,
+                              std::size_t msg_num, const std::vector<T>& message,
+                              std::size_t bit_size) const;
+  // Chunk is a vector of num_elements elements of type T
+  template <typename T, typename Chunk>
+  std::shared_ptr<MessageChunkQueue<Chunk>> register_for_message_chunks(std::size_t party_id,
+                                                                        std::size_t gate_id,
+                                                                        std::size_t num_elements,
+                                                                        std::size_t msg_num);
 
   struct GateMessageHandler;
   Communication::CommunicationLayer& communication_layer_;
   Communication::MessageType gate_message_type_;
   std::size_t my_id_;
   std::size_t num_parties_;
+  std::size_t max_chunk_size_ = default_max_chunk_size;
+  bool compress_messages_ = false;
+  mutable std::atomic<std::size_t> num_ints_messages_ = 0;
+  mutable std::atomic<std::size_t> num_raw_bytes_ = 0;
+  mutable std::atomic<std::size_t> num_encoded_bytes_ = 0;
   std::shared_ptr<GateMessageHandler> message_handler_;
   std::shared_ptr<Logger> logger_;
 };
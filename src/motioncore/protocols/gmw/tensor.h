@@ -25,6 +25,7 @@
 #include "tensor/tensor.h"
 #include "utility/bit_vector.h"
 #include "utility/enable_wait.h"
+#include "utility/helpers.h"
 #include "utility/type_traits.hpp"
 #include "utility/typedefs.h"
 
@@ -38,6 +39,10 @@ class ArithmeticGMWTensor : public tensor::Tensor {
   std::size_t get_bit_size() const noexcept override { return ENCRYPTO::bit_size_v<T>; }
   std::vector<T>& get_share() noexcept { return data_; }
   const std::vector<T>& get_share() const noexcept { return data_; }
+  std::size_t get_buffer_size() const noexcept override {
+    return get_dimensions().get_data_size() * sizeof(T);
+  }
+  void release_buffers() noexcept override { data_ = {}; }
 
  private:
   using is_enabled_ = ENCRYPTO::is_unsigned_int_t<T>;
@@ -63,6 +68,14 @@ class BooleanGMWTensor : public tensor::Tensor {
   std::size_t get_bit_size() const noexcept override { return bit_size_; }
   std::vector<ENCRYPTO::BitVector<>>& get_share() noexcept { return data_; }
   const std::vector<ENCRYPTO::BitVector<>>& get_share() const noexcept { return data_; }
+  std::size_t get_buffer_size() const noexcept override {
+    return bit_size_ * Helpers::Convert::BitsToBytes(get_dimensions().get_data_size());
+  }
+  void release_buffers() noexcept override {
+    for (auto& bv : data_) {
+      bv = ENCRYPTO::BitVector<>();
+    }
+  }
 
  private:
   std::size_t bit_size_;
@@ -57,6 +57,7 @@ class ArithmeticGMWTensorInputSender : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   std::shared_ptr<const ArithmeticGMWTensor<T>> get_output_tensor() const noexcept {
     return output_;
   }
@@ -78,6 +79,7 @@ class ArithmeticGMWTensorInputReceiver : public NewGate {
   bool need_online() const noexcept override { return false; }
   void evaluate_setup() override;
   void evaluate_online() override {}
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   std::shared_ptr<const ArithmeticGMWTensor<T>> get_output_tensor() const noexcept {
     return output_;
   }
@@ -98,6 +100,7 @@ class ArithmeticGMWTensorOutput : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override {}
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
   ENCRYPTO::ReusableFiberFuture<std::vector<T>> get_output_future();
 
  private:
@@ -117,6 +120,8 @@ class ArithmeticGMWTensorFlatten : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override {}
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticGMWTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -136,6 +141,10 @@ class ArithmeticGMWTensorConv2D : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override {}
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override {
+    return {input_.get(), kernel_.get(), bias_.get()};
+  }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticGMWTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -160,6 +169,10 @@ class ArithmeticGMWTensorGemm : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override {}
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override {
+    return {input_A_.get(), input_B_.get()};
+  }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticGMWTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -182,6 +195,8 @@ class ArithmeticGMWTensorSqr : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override {}
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticGMWTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -203,6 +218,8 @@ class ArithmeticGMWTensorAveragePool : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override {}
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticGMWTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -224,6 +241,8 @@ class BooleanToArithmeticGMWTensorConversion : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override {}
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   gmw::ArithmeticGMWTensorCP<T> get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -243,6 +262,8 @@ class BooleanGMWTensorRelu : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override {}
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const BooleanGMWTensorP& get_output_tensor() const { return output_; }
 
  private:
@@ -265,6 +286,10 @@ class BooleanXArithmeticGMWTensorRelu : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override {}
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override {
+    return {input_bool_.get(), input_arith_.get()};
+  }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const ArithmeticGMWTensorP<T>& get_output_tensor() const { return output_; }
 
  private:
@@ -287,6 +312,8 @@ class BooleanGMWTensorMaxPool : public NewGate {
   void evaluate_setup() override {}
   void evaluate_online() override;
   void evaluate_online_with_context(ExecutionContext&) override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   const BooleanGMWTensorP& get_output_tensor() const { return output_; }
 
  private:
@@ -39,6 +39,10 @@ class YaoTensor : public tensor::Tensor, public ENCRYPTO::enable_wait_setup {
   std::size_t get_bit_size() const noexcept override { return bit_size_; }
   ENCRYPTO::block128_vector& get_keys() noexcept { return keys_; }
   const ENCRYPTO::block128_vector& get_keys() const noexcept { return keys_; }
+  std::size_t get_buffer_size() const noexcept override {
+    return bit_size_ * get_dimensions().get_data_size() * sizeof(ENCRYPTO::block128_t);
+  }
+  void release_buffers() noexcept override { keys_ = ENCRYPTO::block128_vector(); }
 
  private:
   std::size_t bit_size_;
@@ -681,6 +681,13 @@ void ArithmeticBEAVYToYaoTensorConversionGarbler<T>::evaluate_online() {
   }
 }
 
+template <typename T>
+void ArithmeticBEAVYToYaoTensorConversionGarbler<T>::clear() {
+  ot_sender_->clear();
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 template class ArithmeticBEAVYToYaoTensorConversionGarbler<std::uint32_t>;
 template class ArithmeticBEAVYToYaoTensorConversionGarbler<std::uint64_t>;
 
@@ -810,6 +817,13 @@ void ArithmeticBEAVYToYaoTensorConversionEvaluator<T>::evaluate_online() {
   }
 }
 
+template <typename T>
+void ArithmeticBEAVYToYaoTensorConversionEvaluator<T>::clear() {
+  ot_receiver_->clear();
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 template class ArithmeticBEAVYToYaoTensorConversionEvaluator<std::uint32_t>;
 template class ArithmeticBEAVYToYaoTensorConversionEvaluator<std::uint64_t>;
 
@@ -940,6 +954,12 @@ void YaoToArithmeticBEAVYTensorConversionGarbler<T>::evaluate_online() {
   }
 }
 
+template <typename T>
+void YaoToArithmeticBEAVYTensorConversionGarbler<T>::clear() {
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 template class YaoToArithmeticBEAVYTensorConversionGarbler<std::uint32_t>;
 template class YaoToArithmeticBEAVYTensorConversionGarbler<std::uint64_t>;
 
@@ -1094,6 +1114,12 @@ void YaoToArithmeticBEAVYTensorConversionEvaluator<T>::evaluate_online() {
   }
 }
 
+template <typename T>
+void YaoToArithmeticBEAVYTensorConversionEvaluator<T>::clear() {
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 template class YaoToArithmeticBEAVYTensorConversionEvaluator<std::uint32_t>;
 template class YaoToArithmeticBEAVYTensorConversionEvaluator<std::uint64_t>;
 
@@ -1268,7 +1294,6 @@ YaoTensorReluGarbler::YaoTensorReluGarbler(std::size_t gate_id, YaoProvider& yao
       input_(input),
       output_(std::make_shared<YaoTensor>(input->get_dimensions(), bit_size_)),
       relu_algo_(yao_provider_.get_circuit_loader().load_relu_circuit(bit_size_)) {
-  garbled_tables_.resize(data_size_ * (bit_size_ - 1));
   output_->get_keys().resize(bit_size_);
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
@@ -1289,9 +1314,8 @@ void YaoTensorReluGarbler::evaluate_setup() {
   }
 
   // garble ReLU circuit
-  yao_provider_.create_garbled_circuit(gate_id_, data_size_, relu_algo_, input_->get_keys(), {},
-                                       garbled_tables_, output_->get_keys(), true);
-  yao_provider_.send_blocks_message(gate_id_, std::move(garbled_tables_));
+  yao_provider_.send_garbled_circuit(gate_id_, data_size_, relu_algo_, input_->get_keys(), {},
+                                     output_->get_keys(), true);
   output_->set_setup_ready();
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
@@ -1302,6 +1326,11 @@ void YaoTensorReluGarbler::evaluate_setup() {
   }
 }
 
+void YaoTensorReluGarbler::clear() {
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 YaoTensorReluEvaluator::YaoTensorReluEvaluator(std::size_t gate_id, YaoProvider& yao_provider,
                                                const YaoTensorCP input)
     : NewGate(gate_id),
@@ -1311,8 +1340,8 @@ YaoTensorReluEvaluator::YaoTensorReluEvaluator(std::size_t gate_id, YaoProvider&
       input_(input),
       output_(std::make_shared<YaoTensor>(input->get_dimensions(), bit_size_)),
       relu_algo_(yao_provider_.get_circuit_loader().load_relu_circuit(bit_size_)) {
-  garbled_tables_future_ =
-      yao_provider_.register_for_blocks_message(gate_id, 2 * (bit_size_ - 1) * data_size_);
+  garbled_tables_queue_ = yao_provider_.register_for_blocks_message_chunks(
+      gate_id, 2 * (bit_size_ - 1) * data_size_);
   output_->get_keys().resize(bit_size_ * data_size_);
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
@@ -1333,9 +1362,8 @@ void YaoTensorReluEvaluator::evaluate_online() {
   }
 
   // evaluate ReLU circuit
-  const auto garbled_tables = garbled_tables_future_.get();
   yao_provider_.evaluate_garbled_circuit(gate_id_, data_size_, relu_algo_, input_->get_keys(), {},
-                                         garbled_tables, output_->get_keys(), true);
+                                         *garbled_tables_queue_, output_->get_keys(), true);
   output_->set_online_ready();
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
@@ -1347,6 +1375,11 @@ void YaoTensorReluEvaluator::evaluate_online() {
   }
 }
 
+void YaoTensorReluEvaluator::clear() {
+  output_->reset_setup_ready();
+  output_->reset_online_ready();
+}
+
 // MaxPool
 
 YaoTensorMaxPoolGarbler::YaoTensorMaxPoolGarbler(std::size_t gate_id, YaoProvider& yao_provider,
@@ -1385,9 +1418,8 @@ void YaoTensorMaxPoolGarbler::evaluate_setup() {
   ENCRYPTO::block128_vector in_keys;
   ENCRYPTO::block128_vector out_keys;
   maxpool_rearrange_keys_in(in_keys, input_->get_keys(), bit_size_, maxpool_op_);
-  yao_provider_.create_garbled_circuit(gate_id_, maxpool_op_.compute_output_size(), maxpool_algo_,
-                                       in_keys, {}, garbled_tables_, out_keys, true);
-  yao_provider_.send_blocks_message(gate_id_, std::move(garbled_tables_));
+  yao_provider_.send_garbled_circuit(gate_id_, maxpool_op_.compute_output_size(), maxpool_algo_,
+                                     in_keys, {}, out_keys, true);
   maxpool_rearrange_keys_out(output_->get_keys(), out_keys, bit_size_, maxpool_op_);
 
   output_->set_setup_ready();
@@ -1415,7 +1447,8 @@ YaoTensorMaxPoolEvaluator::YaoTensorMaxPoolEvaluator(std::size_t gate_id, YaoPro
           bit_size_, maxpool_op_.compute_kernel_size())) {
   const std::size_t num_and_gates =
       (2 * bit_size_) * (maxpool_op_.compute_kernel_size() - 1) * maxpool_op_.compute_output_size();
-  garbled_tables_future_ = yao_provider_.register_for_blocks_message(gate_id, 2 * num_and_gates);
+  garbled_tables_queue_ =
+      yao_provider_.register_for_blocks_message_chunks(gate_id, 2 * num_and_gates);
   output_->get_keys().resize(bit_size_);
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
@@ -1436,12 +1469,11 @@ void YaoTensorMaxPoolEvaluator::evaluate_online() {
   }
 
   // evaluate MaxPool circuit
-  const auto garbled_tables = garbled_tables_future_.get();
   ENCRYPTO::block128_vector in_keys;
   ENCRYPTO::block128_vector out_keys;
   maxpool_rearrange_keys_in(in_keys, input_->get_keys(), bit_size_, maxpool_op_);
   yao_provider_.evaluate_garbled_circuit(gate_id_, maxpool_op_.compute_output_size(), maxpool_algo_,
-                                         in_keys, {}, garbled_tables, out_keys, true);
+                                         in_keys, {}, *garbled_tables_queue_, out_keys, true);
   maxpool_rearrange_keys_out(output_->get_keys(), out_keys, bit_size_, maxpool_op_);
   output_->set_online_ready();
 
@@ -1454,6 +1486,114 @@ void YaoTensorMaxPoolEvaluator::evaluate_online() {
   }
 }
 
+// ArgMax
+
+static std::size_t count_and_gates(const ENCRYPTO::AlgorithmDescription& algo) {
+  return std::count_if(std::begin(algo.gates_), std::end(algo.gates_), [](const auto& op) {
+    return op.type_ == ENCRYPTO::PrimitiveOperationType::AND;
+  });
+}
+
+YaoTensorArgMaxGarbler::YaoTensorArgMaxGarbler(std::size_t gate_id, YaoProvider& yao_provider,
+                                               const YaoTensorCP input)
+    : NewGate(gate_id),
+      yao_provider_(yao_provider),
+      bit_size_(input->get_bit_size()),
+      batch_size_(input->get_dimensions().batch_size_),
+      num_elements_(input->get_dimensions().get_data_size() / batch_size_),
+      input_(input),
+      output_(std::make_shared<YaoTensor>(input->get_dimensions(), 1)),
+      argmax_algo_(yao_provider_.get_circuit_loader().load_argmax_circuit(bit_size_,
+                                                                          num_elements_)) {
+  output_->get_keys().resize(batch_size_ * num_elements_);
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = yao_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format("Gate {}: YaoTensorArgMaxGarbler created", gate_id_));
+    }
+  }
+}
+
+void YaoTensorArgMaxGarbler::evaluate_setup() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = yao_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: YaoTensorArgMaxGarbler::evaluate_setup start", gate_id_));
+    }
+  }
+
+  // garble ArgMax circuit
+  ENCRYPTO::block128_vector in_keys;
+  ENCRYPTO::block128_vector out_keys;
+  argmax_rearrange_keys_in(in_keys, input_->get_keys(), bit_size_, batch_size_, num_elements_);
+  yao_provider_.send_garbled_circuit(gate_id_, batch_size_, argmax_algo_, in_keys, {}, out_keys,
+                                     true);
+  argmax_rearrange_keys_out(output_->get_keys(), out_keys, batch_size_, num_elements_);
+
+  output_->set_setup_ready();
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = yao_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: YaoTensorArgMaxGarbler::evaluate_setup end", gate_id_));
+    }
+  }
+}
+
+YaoTensorArgMaxEvaluator::YaoTensorArgMaxEvaluator(std::size_t gate_id, YaoProvider& yao_provider,
+                                                   const YaoTensorCP input)
+    : NewGate(gate_id),
+      yao_provider_(yao_provider),
+      bit_size_(input->get_bit_size()),
+      batch_size_(input->get_dimensions().batch_size_),
+      num_elements_(input->get_dimensions().get_data_size() / batch_size_),
+      input_(input),
+      output_(std::make_shared<YaoTensor>(input->get_dimensions(), 1)),
+      argmax_algo_(yao_provider_.get_circuit_loader().load_argmax_circuit(bit_size_,
+                                                                          num_elements_)) {
+  const std::size_t num_and_gates = count_and_gates(argmax_algo_) * batch_size_;
+  garbled_tables_queue_ =
+      yao_provider_.register_for_blocks_message_chunks(gate_id, 2 * num_and_gates);
+  output_->get_keys().resize(batch_size_ * num_elements_);
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = yao_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(fmt::format("Gate {}: YaoTensorArgMaxEvaluator created", gate_id_));
+    }
+  }
+}
+
+void YaoTensorArgMaxEvaluator::evaluate_online() {
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = yao_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: YaoTensorArgMaxEvaluator::evaluate_online start", gate_id_));
+    }
+  }
+
+  // evaluate ArgMax circuit
+  ENCRYPTO::block128_vector in_keys;
+  ENCRYPTO::block128_vector out_keys;
+  argmax_rearrange_keys_in(in_keys, input_->get_keys(), bit_size_, batch_size_, num_elements_);
+  yao_provider_.evaluate_garbled_circuit(gate_id_, batch_size_, argmax_algo_, in_keys, {},
+                                         *garbled_tables_queue_, out_keys, true);
+  argmax_rearrange_keys_out(output_->get_keys(), out_keys, batch_size_, num_elements_);
+  output_->set_online_ready();
+
+  if constexpr (MOTION_VERBOSE_DEBUG) {
+    auto logger = yao_provider_.get_logger();
+    if (logger) {
+      logger->LogTrace(
+          fmt::format("Gate {}: YaoTensorArgMaxEvaluator::evaluate_online end", gate_id_));
+    }
+  }
+}
+
 // GT
 
 YaoTensorGTGarbler::YaoTensorGTGarbler(std::size_t gate_id, YaoProvider& yao_provider,
@@ -1492,9 +1632,8 @@ void YaoTensorGTGarbler::evaluate_setup() {
   ENCRYPTO::block128_vector in_keys;
   ENCRYPTO::block128_vector out_keys;
   maxpool_rearrange_keys_in(in_keys, input_->get_keys(), bit_size_, maxpool_op_);
-  yao_provider_.create_garbled_circuit(gate_id_, maxpool_op_.compute_output_size(), maxpool_algo_,
-                                       in_keys, {}, garbled_tables_, out_keys, true);
-  yao_provider_.send_blocks_message(gate_id_, std::move(garbled_tables_));
+  yao_provider_.send_garbled_circuit(gate_id_, maxpool_op_.compute_output_size(), maxpool_algo_,
+                                     in_keys, {}, out_keys, true);
   maxpool_rearrange_keys_out(output_->get_keys(), out_keys, bit_size_, maxpool_op_);
 
   output_->set_setup_ready();
@@ -1522,7 +1661,8 @@ YaoTensorGTEvaluator::YaoTensorGTEvaluator(std::size_t gate_id, YaoProvider& yao
           bit_size_, maxpool_op_.compute_kernel_size())) {
   const std::size_t num_and_gates =
       (2 * bit_size_) * (maxpool_op_.compute_kernel_size() - 1) * maxpool_op_.compute_output_size();
-  garbled_tables_future_ = yao_provider_.register_for_blocks_message(gate_id, 2 * num_and_gates);
+  garbled_tables_queue_ =
+      yao_provider_.register_for_blocks_message_chunks(gate_id, 2 * num_and_gates);
   output_->get_keys().resize(bit_size_);
 
   if constexpr (MOTION_VERBOSE_DEBUG) {
@@ -1543,12 +1683,11 @@ void YaoTensorGTEvaluator::evaluate_online() {
   }
 
   // evaluate MaxPool circuit
-  const auto garbled_tables = garbled_tables_future_.get();
   ENCRYPTO::block128_vector in_keys;
   ENCRYPTO::block128_vector out_keys;
   maxpool_rearrange_keys_in(in_keys, input_->get_keys(), bit_size_, maxpool_op_);
   yao_provider_.evaluate_garbled_circuit(gate_id_, maxpool_op_.compute_output_size(), maxpool_algo_,
-                                         in_keys, {}, garbled_tables, out_keys, true);
+                                         in_keys, {}, *garbled_tables_queue_, out_keys, true);
   maxpool_rearrange_keys_out(output_->get_keys(), out_keys, bit_size_, maxpool_op_);
   output_->set_online_ready();
 
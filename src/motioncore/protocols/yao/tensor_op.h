@@ -24,6 +24,7 @@
 
 #include "gate/new_gate.h"
 #include "protocols/beavy/tensor.h"
+#include "protocols/common/comm_mixin.h"
 #include "protocols/gmw/tensor.h"
 #include "tensor.h"
 #include "tensor/tensor_op.h"
@@ -54,6 +55,8 @@ class ArithmeticGMWToYaoTensorConversionGarbler : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   YaoTensorCP get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -79,6 +82,8 @@ class ArithmeticGMWToYaoTensorConversionEvaluator : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override {}
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   YaoTensorCP get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -105,6 +110,8 @@ class YaoToArithmeticGMWTensorConversionGarbler : public NewGate {
   bool need_online() const noexcept override { return false; }
   void evaluate_setup() override;
   void evaluate_online() override {}
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   gmw::ArithmeticGMWTensorCP<T> get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -128,6 +135,8 @@ class YaoToArithmeticGMWTensorConversionEvaluator : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   gmw::ArithmeticGMWTensorCP<T> get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -150,6 +159,8 @@ class YaoToBooleanGMWTensorConversionGarbler : public NewGate {
   bool need_online() const noexcept override { return false; }
   void evaluate_setup() override;
   void evaluate_online() override {}
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   gmw::BooleanGMWTensorCP get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -168,6 +179,8 @@ class YaoToBooleanGMWTensorConversionEvaluator : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override {}
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   gmw::BooleanGMWTensorCP get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -188,6 +201,9 @@ class ArithmeticBEAVYToYaoTensorConversionGarbler : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   YaoTensorCP get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -213,6 +229,9 @@ class ArithmeticBEAVYToYaoTensorConversionEvaluator : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   YaoTensorCP get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -239,6 +258,9 @@ class YaoToArithmeticBEAVYTensorConversionGarbler : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   beavy::ArithmeticBEAVYTensorCP<T> get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -263,6 +285,9 @@ class YaoToArithmeticBEAVYTensorConversionEvaluator : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   beavy::ArithmeticBEAVYTensorCP<T> get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -287,6 +312,8 @@ class YaoToBooleanBEAVYTensorConversionGarbler : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   beavy::BooleanBEAVYTensorCP get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -306,6 +333,8 @@ class YaoToBooleanBEAVYTensorConversionEvaluator : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override;
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   beavy::BooleanBEAVYTensorCP get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -323,6 +352,9 @@ class YaoTensorReluGarbler : public NewGate {
   bool need_online() const noexcept override { return false; }
   void evaluate_setup() override;
   void evaluate_online() override {}
+  void clear() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   YaoTensorCP get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -331,7 +363,6 @@ class YaoTensorReluGarbler : public NewGate {
   const std::size_t data_size_;
   const YaoTensorCP input_;
   const YaoTensorP output_;
-  ENCRYPTO::block128_vector garbled_tables_;
   const ENCRYPTO::AlgorithmDescription& relu_algo_;
 };
 
@@ -342,6 +373,9 @@ class YaoTensorReluEvaluator : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override {}
   void evaluate_online() override;
+  void clear() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   YaoTensorCP get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -350,7 +384,7 @@ class YaoTensorReluEvaluator : public NewGate {
   const std::size_t data_size_;
   const YaoTensorCP input_;
   const YaoTensorP output_;
-  ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbled_tables_future_;
+  std::shared_ptr<MessageChunkQueue<ENCRYPTO::block128_vector>> garbled_tables_queue_;
   const ENCRYPTO::AlgorithmDescription& relu_algo_;
 };
 
@@ -362,6 +396,8 @@ class YaoTensorMaxPoolGarbler : public NewGate {
   bool need_online() const noexcept override { return false; }
   void evaluate_setup() override;
   void evaluate_online() override {}
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   YaoTensorCP get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -371,7 +407,6 @@ class YaoTensorMaxPoolGarbler : public NewGate {
   const std::size_t data_size_;
   const YaoTensorCP input_;
   const YaoTensorP output_;
-  ENCRYPTO::block128_vector garbled_tables_;
   const ENCRYPTO::AlgorithmDescription& maxpool_algo_;
 };
 
@@ -383,6 +418,8 @@ class YaoTensorMaxPoolEvaluator : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override {}
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   YaoTensorCP get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -392,10 +429,55 @@ class YaoTensorMaxPoolEvaluator : public NewGate {
   const std::size_t data_size_;
   const YaoTensorCP input_;
   const YaoTensorP output_;
-  ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbled_tables_future_;
+  std::shared_ptr<MessageChunkQueue<ENCRYPTO::block128_vector>> garbled_tables_queue_;
   const ENCRYPTO::AlgorithmDescription& maxpool_algo_;
 };
 
+// One-hot encoding of the position of the maximum of each batch entry, see
+// CircuitLoader::load_argmax_circuit.
+class YaoTensorArgMaxGarbler : public NewGate {
+ public:
+  YaoTensorArgMaxGarbler(std::size_t gate_id, YaoProvider&, const YaoTensorCP input);
+  bool need_setup() const noexcept override { return true; }
+  bool need_online() const noexcept override { return false; }
+  void evaluate_setup() override;
+  void evaluate_online() override {}
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
+  YaoTensorCP get_output_tensor() const noexcept { return output_; }
+
+ private:
+  YaoProvider& yao_provider_;
+  const std::size_t bit_size_;
+  const std::size_t batch_size_;
+  const std::size_t num_elements_;
+  const YaoTensorCP input_;
+  const YaoTensorP output_;
+  const ENCRYPTO::AlgorithmDescription& argmax_algo_;
+};
+
+class YaoTensorArgMaxEvaluator : public NewGate {
+ public:
+  YaoTensorArgMaxEvaluator(std::size_t gate_id, YaoProvider&, const YaoTensorCP input);
+  bool need_setup() const noexcept override { return false; }
+  bool need_online() const noexcept override { return true; }
+  void evaluate_setup() override {}
+  void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
+  YaoTensorCP get_output_tensor() const noexcept { return output_; }
+
+ private:
+  YaoProvider& yao_provider_;
+  const std::size_t bit_size_;
+  const std::size_t batch_size_;
+  const std::size_t num_elements_;
+  const YaoTensorCP input_;
+  const YaoTensorP output_;
+  std::shared_ptr<MessageChunkQueue<ENCRYPTO::block128_vector>> garbled_tables_queue_;
+  const ENCRYPTO::AlgorithmDescription& argmax_algo_;
+};
+
 class YaoTensorGTGarbler : public NewGate {
  public:
   YaoTensorGTGarbler(std::size_t gate_id, YaoProvider&, tensor::MaxPoolOp,
@@ -404,6 +486,8 @@ class YaoTensorGTGarbler : public NewGate {
   bool need_online() const noexcept override { return false; }
   void evaluate_setup() override;
   void evaluate_online() override {}
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   YaoTensorCP get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -413,7 +497,6 @@ class YaoTensorGTGarbler : public NewGate {
   const std::size_t data_size_;
   const YaoTensorCP input_;
   const YaoTensorP output_;
-  ENCRYPTO::block128_vector garbled_tables_;
   const ENCRYPTO::AlgorithmDescription& maxpool_algo_;
 };
 
@@ -425,6 +508,8 @@ class YaoTensorGTEvaluator : public NewGate {
   bool need_online() const noexcept override { return true; }
   void evaluate_setup() override {}
   void evaluate_online() override;
+  std::vector<const NewWire*> get_input_wires() const override { return {input_.get()}; }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
   YaoTensorCP get_output_tensor() const noexcept { return output_; }
 
  private:
@@ -434,7 +519,7 @@ class YaoTensorGTEvaluator : public NewGate {
   const std::size_t data_size_;
   const YaoTensorCP input_;
   const YaoTensorP output_;
-  ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> garbled_tables_future_;
+  std::shared_ptr<MessageChunkQueue<ENCRYPTO::block128_vector>> garbled_tables_queue_;
   const ENCRYPTO::AlgorithmDescription& maxpool_algo_;
 };
 
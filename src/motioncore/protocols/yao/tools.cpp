@@ -104,4 +104,27 @@ void maxpool_rearrange_keys_out(ENCRYPTO::block128_vector& dst,
           .shuffle(Eigen::array<Eigen::Index, 4>{0, 3, 2, 1});
 }
 
+void argmax_rearrange_keys_in(ENCRYPTO::block128_vector& dst, const ENCRYPTO::block128_vector& src,
+                              std::size_t bit_size, std::size_t batch_size,
+                              std::size_t num_elements) {
+  using TensorType3C = Eigen::Tensor<const ENCRYPTO::block128_t, 3, Eigen::RowMajor>;
+  using TensorType3 = Eigen::Tensor<ENCRYPTO::block128_t, 3, Eigen::RowMajor>;
+  if (bit_size * batch_size * num_elements != src.size()) {
+    throw std::invalid_argument("vector size mismatch");
+  }
+  const auto num_bits = static_cast<Eigen::Index>(bit_size);
+  const auto num_batch = static_cast<Eigen::Index>(batch_size);
+  const auto num_elem = static_cast<Eigen::Index>(num_elements);
+  dst.resize(src.size());
+  Eigen::TensorMap<TensorType3C> tensor_src(src.data(), num_bits, num_batch, num_elem);
+  Eigen::TensorMap<TensorType3> tensor_dst(dst.data(), num_elem, num_bits, num_batch);
+  tensor_dst = tensor_src.shuffle(Eigen::array<Eigen::Index, 3>{2, 0, 1});
+}
+
+void argmax_rearrange_keys_out(ENCRYPTO::block128_vector& dst,
+                               const ENCRYPTO::block128_vector& src, std::size_t batch_size,
+                               std::size_t num_elements) {
+  transpose_keys(dst, src, num_elements, batch_size);
+}
+
 }  // namespace MOTION::proto::yao
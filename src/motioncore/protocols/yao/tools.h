@@ -47,4 +47,15 @@ void maxpool_rearrange_keys_out(ENCRYPTO::block128_vector& dst,
                                 const ENCRYPTO::block128_vector& keys, std::size_t bit_size,
                                 const tensor::MaxPoolOp&);
 
+// (bit, batch entry, element) -> (element, bit, batch entry), i.e., the batch
+// entries become the SIMD values of the argmax circuit
+void argmax_rearrange_keys_in(ENCRYPTO::block128_vector& dst,
+                              const ENCRYPTO::block128_vector& keys, std::size_t bit_size,
+                              std::size_t batch_size, std::size_t num_elements);
+
+// (element, batch entry) -> (batch entry, element)
+void argmax_rearrange_keys_out(ENCRYPTO::block128_vector& dst,
+                               const ENCRYPTO::block128_vector& keys, std::size_t batch_size,
+                               std::size_t num_elements);
+
 }  // namespace MOTION::proto::yao
@@ -23,6 +23,8 @@
 #include "yao_provider.h"
 
 #include <fmt/format.h>
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <type_traits>
 
@@ -430,6 +432,11 @@ ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector> YaoProvider::register_f
   return CommMixin::register_for_blocks_message(1 - my_id_, gate_id, num_blocks);
 }
 
+std::shared_ptr<MessageChunkQueue<ENCRYPTO::block128_vector>>
+YaoProvider::register_for_blocks_message_chunks(std::size_t gate_id, std::size_t num_blocks) {
+  return CommMixin::register_for_blocks_message_chunks(1 - my_id_, gate_id, num_blocks);
+}
+
 ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>> YaoProvider::register_for_bits_message(
     std::size_t gate_id, std::size_t num_bits) {
   return CommMixin::register_for_bits_message(1 - my_id_, gate_id, num_bits);
@@ -477,6 +484,56 @@ void YaoProvider::evaluate_garbled_circuit(std::size_t gate_id, std::size_t num_
                                   num_simd, algo, parallel);
 }
 
+void YaoProvider::send_garbled_circuit(std::size_t gate_id, std::size_t num_simd,
+                                       const ENCRYPTO::AlgorithmDescription& algo,
+                                       const ENCRYPTO::block128_vector& input_keys_a,
+                                       const ENCRYPTO::block128_vector& input_keys_b,
+                                       ENCRYPTO::block128_vector& output_keys,
+                                       bool parallel) const {
+  assert(hg_garbler_);
+  ENCRYPTO::block128_vector tables_buffer;
+  const auto send_tables = [this, gate_id](std::size_t offset, const ENCRYPTO::block128_t* tables,
+                                           std::size_t num_blocks) {
+    CommMixin::send_blocks_message_part(1 - my_id_, gate_id, tables, num_blocks, offset);
+  };
+  hg_garbler_->garble_circuit(output_keys, tables_buffer, gate_id, input_keys_a, input_keys_b,
+                              num_simd, algo, parallel, send_tables, garbling_batch_size_);
+}
+
+void YaoProvider::evaluate_garbled_circuit(
+    std::size_t gate_id, std::size_t num_simd, const ENCRYPTO::AlgorithmDescription& algo,
+    const ENCRYPTO::block128_vector& input_keys_a, const ENCRYPTO::block128_vector& input_keys_b,
+    MessageChunkQueue<ENCRYPTO::block128_vector>& tables_queue,
+    ENCRYPTO::block128_vector& output_keys, bool parallel) const {
+  assert(hg_evaluator_);
+  const auto num_and_gates =
+      std::count_if(std::begin(algo.gates_), std::end(algo.gates_), [](const auto& op) {
+        return op.type_ == ENCRYPTO::PrimitiveOperationType::AND;
+      });
+  ENCRYPTO::block128_vector tables(garbled_table_size * num_and_gates * num_simd);
+  // the chunks may arrive out of order, track the complete prefix of the tables
+  std::size_t num_available = 0;
+  std::map<std::size_t, std::size_t> pending_chunks;
+  const auto wait_for_tables = [&](std::size_t num_blocks) {
+    while (num_available < num_blocks) {
+      auto chunk = tables_queue.dequeue();
+      if (!chunk.has_value()) {
+        throw std::runtime_error(
+            fmt::format("Gate {}: garbled tables stopped before they were complete", gate_id));
+      }
+      std::copy_n(chunk->data_.data(), chunk->data_.size(), tables.data() + chunk->offset_);
+      pending_chunks.emplace(chunk->offset_, chunk->data_.size());
+      for (auto it = pending_chunks.begin();
+           it != pending_chunks.end() && it->first == num_available;
+           it = pending_chunks.erase(it)) {
+        num_available += it->second;
+      }
+    }
+  };
+  hg_evaluator_->evaluate_circuit(output_keys, tables, gate_id, input_keys_a, input_keys_b,
+                                  num_simd, algo, parallel, wait_for_tables);
+}
+
 static std::vector<std::shared_ptr<NewWire>> cast_wires(gmw::BooleanGMWWireVector&& wires) {
   return std::vector<std::shared_ptr<NewWire>>(std::begin(wires), std::end(wires));
 }
@@ -1112,6 +1169,23 @@ tensor::TensorCP YaoProvider::make_tensor_maxpool_op(const tensor::MaxPoolOp& ma
   return output;
 }
 
+tensor::TensorCP YaoProvider::make_tensor_argmax_op(const tensor::TensorCP in) {
+  const auto input_tensor = std::dynamic_pointer_cast<const YaoTensor>(in);
+  assert(input_tensor != nullptr);
+  auto gate_id = gate_register_.get_next_gate_id();
+  tensor::TensorCP output;
+  if (role_ == Role::garbler) {
+    auto tensor_op = std::make_unique<YaoTensorArgMaxGarbler>(gate_id, *this, input_tensor);
+    output = tensor_op->get_output_tensor();
+    gate_register_.register_gate(std::move(tensor_op));
+  } else {
+    auto tensor_op = std::make_unique<YaoTensorArgMaxEvaluator>(gate_id, *this, input_tensor);
+    output = tensor_op->get_output_tensor();
+    gate_register_.register_gate(std::move(tensor_op));
+  }
+  return output;
+}
+
 tensor::TensorCP YaoProvider::make_tensor_gt_op(const tensor::MaxPoolOp& maxpool_op,
                                                      const tensor::TensorCP in) {
   const auto input_tensor = std::dynamic_pointer_cast<const YaoTensor>(in);
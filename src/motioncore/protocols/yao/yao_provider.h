@@ -142,6 +142,8 @@ class YaoProvider : public GateFactory,
   void send_bits_message(std::size_t gate_id, const ENCRYPTO::BitVector<>& message) const;
   [[nodiscard]] ENCRYPTO::ReusableFiberFuture<ENCRYPTO::block128_vector>
   register_for_blocks_message(std::size_t gate_id, std::size_t num_blocks);
+  [[nodiscard]] std::shared_ptr<MessageChunkQueue<ENCRYPTO::block128_vector>>
+  register_for_blocks_message_chunks(std::size_t gate_id, std::size_t num_blocks);
   [[nodiscard]] ENCRYPTO::ReusableFiberFuture<ENCRYPTO::BitVector<>> register_for_bits_message(
       std::size_t gate_id, std::size_t num_bits);
   void create_garbled_tables(std::size_t gate_id, const ENCRYPTO::block128_vector& keys_a,
@@ -163,6 +165,27 @@ class YaoProvider : public GateFactory,
                                 const ENCRYPTO::block128_vector& input_keys_b,
                                 const ENCRYPTO::block128_vector& tables,
                                 ENCRYPTO::block128_vector& keys_out, bool parallel = false) const;
+  // Garbles the circuit and sends the garbled tables (message 0) to the
+  // evaluator in batches while the garbling proceeds.
+  void send_garbled_circuit(std::size_t gate_id, std::size_t num_simd,
+                            const ENCRYPTO::AlgorithmDescription&,
+                            const ENCRYPTO::block128_vector& input_keys_a,
+                            const ENCRYPTO::block128_vector& input_keys_b,
+                            ENCRYPTO::block128_vector& keys_out, bool parallel = false) const;
+  // Evaluates the circuit as far as its garbled tables, registered with
+  // register_for_blocks_message_chunks, have arrived.
+  void evaluate_garbled_circuit(std::size_t gate_id, std::size_t num_simd,
+                                const ENCRYPTO::AlgorithmDescription&,
+                                const ENCRYPTO::block128_vector& input_keys_a,
+                                const ENCRYPTO::block128_vector& input_keys_b,
+                                MessageChunkQueue<ENCRYPTO::block128_vector>& tables_queue,
+                                ENCRYPTO::block128_vector& keys_out, bool parallel = false) const;
+  // number of blocks of garbled tables which send_garbled_circuit sends at once
+  static constexpr std::size_t default_garbling_batch_size = 1 << 16;
+  void set_garbling_batch_size(std::size_t num_blocks) noexcept {
+    garbling_batch_size_ = num_blocks;
+  }
+  std::size_t get_garbling_batch_size() const noexcept { return garbling_batch_size_; }
   constexpr static std::size_t garbled_table_size = 2;
 
   Crypto::MotionBaseProvider& get_motion_base_provider() const noexcept {
@@ -214,6 +237,7 @@ class YaoProvider : public GateFactory,
   using TensorOpFactory::make_tensor_relu_op;
   tensor::TensorCP make_tensor_maxpool_op(const tensor::MaxPoolOp&,
                                           const tensor::TensorCP) override;
+  tensor::TensorCP make_tensor_argmax_op(const tensor::TensorCP) override;
   tensor::TensorCP make_tensor_gt_op(const tensor::MaxPoolOp&,
                                           const tensor::TensorCP) override;
 
@@ -230,6 +254,7 @@ class YaoProvider : public GateFactory,
   std::size_t my_id_;
   Role role_;
   bool setup_ran_;
+  std::size_t garbling_batch_size_ = default_garbling_batch_size;
   std::shared_ptr<Logger> logger_;
 };
 
@@ -32,6 +32,7 @@
 #include <boost/json.hpp>
 
 #include "communication/transport.h"
+#include "utility/cpu_features.h"
 #include "utility/runtime_info.h"
 #include "utility/version.h"
 using namespace std;
@@ -146,6 +147,7 @@ void AccumulatedCommunicationStats::add(const Communication::TransportStatistics
   accumulators_[idx_num_messages_received](stats.num_messages_received);
   accumulators_[idx_num_bytes_sent](stats.num_bytes_sent);
   accumulators_[idx_num_bytes_received](stats.num_bytes_received);
+  accumulators_[idx_num_flushes](stats.num_flushes);
   ++count_;
 }
 
@@ -160,10 +162,12 @@ std::string AccumulatedCommunicationStats::print_human_readable() const {
   std::stringstream ss;
   std::cout << "AccumulatedCommunicationStats::print_human_readable()\n";
   ss << "Communication with each other party:\n"
-     << fmt::format("Sent: {:0.3f} MiB in {:d} messages\n",
+     << fmt::format("Sent: {:0.3f} MiB in {:d} messages ({:d} flushes)\n",
                     boost::accumulators::mean(accumulators_[idx_num_bytes_sent]) / 1048576,
                     static_cast<std::size_t>(
-                        boost::accumulators::mean(accumulators_[idx_num_messages_sent])))
+                        boost::accumulators::mean(accumulators_[idx_num_messages_sent])),
+                    static_cast<std::size_t>(
+                        boost::accumulators::mean(accumulators_[idx_num_flushes])))
      << fmt::format("Received: {:0.3f} MiB in {:d} messages\n",
                     boost::accumulators::mean(accumulators_[idx_num_bytes_received]) / 1048576,
                     static_cast<std::size_t>(
@@ -177,6 +181,8 @@ json::object AccumulatedCommunicationStats::to_json() const {
        static_cast<std::size_t>(boost::accumulators::mean(accumulators_[idx_num_bytes_sent]))},
       {"num_messages_sent",
        static_cast<std::size_t>(boost::accumulators::mean(accumulators_[idx_num_messages_sent]))},
+      {"num_flushes",
+       static_cast<std::size_t>(boost::accumulators::mean(accumulators_[idx_num_flushes]))},
       {"bytes_received",
        static_cast<std::size_t>(boost::accumulators::mean(accumulators_[idx_num_bytes_received]))},
       {"num_messages_received", static_cast<std::size_t>(boost::accumulators::mean(
@@ -187,7 +193,9 @@ std::string print_motion_info() {
   std::stringstream ss;
   ss << fmt::format("MOTION version: {} @ {}\n", get_git_version(), get_git_branch())
      << fmt::format("invocation: {}\n", get_cmdline())
-     << fmt::format("by {}@{}, PID {}\n", get_username(), get_hostname(), get_pid());
+     << fmt::format("by {}@{}, PID {}\n", get_username(), get_hostname(), get_pid())
+     << fmt::format("SIMD kernels: {}{}\n", to_string(get_simd_isa()),
+                    get_vaes_support() ? ", AES with VAES" : "");
   return ss.str();
 }
 
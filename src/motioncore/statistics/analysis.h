@@ -69,9 +69,10 @@ struct AccumulatedCommunicationStats {
   static constexpr std::size_t idx_num_messages_received = 1;
   static constexpr std::size_t idx_num_bytes_sent = 2;
   static constexpr std::size_t idx_num_bytes_received = 3;
+  static constexpr std::size_t idx_num_flushes = 4;
 
   std::size_t count_ = 0;
-  std::array<accumulator_type, 4> accumulators_;
+  std::array<accumulator_type, 5> accumulators_;
 
   void add(const Communication::TransportStatistics& stats);
   void add(const std::vector<Communication::TransportStatistics>& stats);
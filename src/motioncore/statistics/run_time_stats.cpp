@@ -21,6 +21,7 @@
 // SOFTWARE.
 
 #include <fmt/format.h>
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 #include "run_time_stats.h"
@@ -66,5 +67,31 @@ std::string RunTimeStats::print_human_readable() const {
   return ss.str();
 }
 
+std::string RunTimeStats::print_critical_path() const {
+  if (critical_path_.empty()) {
+    return "no critical path recorded\n";
+  }
+  const auto t0 = get(StatID::gates_setup).first;
+  auto offset_ms = [t0](auto tp) {
+    return std::chrono::duration<double, std::milli>(tp - t0).count();
+  };
+
+  std::stringstream ss;
+  ss << fmt::format("Critical path ({} gates)\n", critical_path_.size())
+     << fmt::format("{:>8} {:>12} {:>12} {:>12} {:>12}\n", "gate", "setup [ms]", "online [ms]",
+                    "start [ms]", "end [ms]");
+  for (auto gate_id : critical_path_) {
+    const auto it = std::find_if(gate_timings_.cbegin(), gate_timings_.cend(),
+                                 [gate_id](const auto& gt) { return gt.gate_id_ == gate_id; });
+    if (it == gate_timings_.cend()) {
+      continue;
+    }
+    ss << fmt::format("{:>8} {:12.3f} {:12.3f} {:12.3f} {:12.3f}\n", gate_id,
+                      compute_ms(it->setup_), compute_ms(it->online_),
+                      offset_ms(it->setup_.first), offset_ms(it->online_.second));
+  }
+  return ss.str();
+}
+
 }  // namespace Statistics
 }  // namespace MOTION
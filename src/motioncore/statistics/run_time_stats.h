@@ -26,6 +26,7 @@
 #include <chrono>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace MOTION {
 namespace Statistics {
@@ -69,8 +70,19 @@ struct RunTimeStats {
   const time_point_pair& get(StatID id) const;
 
   std::string print_human_readable() const;
+  std::string print_critical_path() const;
 
   std::array<time_point_pair, static_cast<std::size_t>(StatID::MAX) + 1> data_;
+
+  // per-gate timings recorded by the dependency-driven executor
+  struct GateTimings {
+    std::size_t gate_id_;
+    time_point_pair setup_;
+    time_point_pair online_;
+  };
+  std::vector<GateTimings> gate_timings_;
+  // gate ids on the longest dependency chain, from first to last gate
+  std::vector<std::size_t> critical_path_;
 };
 
 }  // namespace Statistics
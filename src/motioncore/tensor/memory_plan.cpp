@@ -0,0 +1,129 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "memory_plan.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+#include <fmt/format.h>
+
+#include "gate/new_gate.h"
+#include "tensor.h"
+
+namespace MOTION::tensor {
+
+std::string TensorMemoryPlan::print_human_readable() const {
+  constexpr double MiB = 1024.0 * 1024.0;
+  return fmt::format(
+      "Tensor memory: {} tensors, planned peak {:.3f} MiB, without reuse {:.3f} MiB "
+      "({} byte alignment)",
+      entries_.size(), peak_bytes_ / MiB, total_bytes_ / MiB, alignment_);
+}
+
+TensorMemoryPlan plan_tensor_memory(const std::vector<std::unique_ptr<NewGate>>& gates,
+                                    std::size_t alignment) {
+  const auto num_gates = gates.size();
+  TensorMemoryPlan plan;
+  plan.alignment_ = alignment;
+  auto& entries = plan.entries_;
+  const auto round_up = [alignment](std::size_t n) {
+    return (n + alignment - 1) / alignment * alignment;
+  };
+  const auto first_step_of = [num_gates, &gates](std::size_t gate_i) {
+    return gates[gate_i]->need_setup() ? gate_i : num_gates + gate_i;
+  };
+  const auto last_step_of = [num_gates, &gates](std::size_t gate_i) {
+    return gates[gate_i]->need_online() ? num_gates + gate_i : gate_i;
+  };
+
+  // lifetimes
+  std::unordered_map<const Tensor*, std::size_t> entry_indices;
+  for (std::size_t gate_i = 0; gate_i < num_gates; ++gate_i) {
+    for (const auto* wire : gates[gate_i]->get_output_wires()) {
+      const auto* tensor = dynamic_cast<const Tensor*>(wire);
+      if (tensor == nullptr || entry_indices.contains(tensor)) {
+        continue;
+      }
+      entry_indices.emplace(tensor, entries.size());
+      entries.push_back({.tensor_ = tensor,
+                         .size_ = round_up(tensor->get_buffer_size()),
+                         .offset_ = 0,
+                         .first_step_ = first_step_of(gate_i),
+                         .last_step_ = last_step_of(gate_i)});
+    }
+  }
+  std::vector<bool> has_readers(entries.size(), false);
+  for (std::size_t gate_i = 0; gate_i < num_gates; ++gate_i) {
+    for (const auto* wire : gates[gate_i]->get_input_wires()) {
+      auto it = entry_indices.find(dynamic_cast<const Tensor*>(wire));
+      if (it == entry_indices.end()) {
+        continue;
+      }
+      auto& entry = entries[it->second];
+      entry.last_step_ = std::max(entry.last_step_, last_step_of(gate_i));
+      has_readers[it->second] = true;
+    }
+  }
+  for (std::size_t entry_i = 0; entry_i < entries.size(); ++entry_i) {
+    if (!has_readers[entry_i]) {
+      entries[entry_i].last_step_ = 2 * num_gates;
+    }
+  }
+
+  // greedy placement, largest buffers first
+  std::vector<std::size_t> order(entries.size());
+  std::iota(std::begin(order), std::end(order), 0);
+  std::stable_sort(std::begin(order), std::end(order), [&entries](auto a, auto b) {
+    return entries[a].size_ > entries[b].size_;
+  });
+  std::vector<std::size_t> placed;
+  std::vector<const TensorMemoryPlanEntry*> conflicts;
+  for (auto entry_i : order) {
+    auto& entry = entries[entry_i];
+    conflicts.clear();
+    for (auto other_i : placed) {
+      const auto& other = entries[other_i];
+      if (other.first_step_ <= entry.last_step_ && entry.first_step_ <= other.last_step_) {
+        conflicts.push_back(&other);
+      }
+    }
+    std::sort(std::begin(conflicts), std::end(conflicts),
+              [](auto a, auto b) { return a->offset_ < b->offset_; });
+    // take the first gap between the live buffers which is large enough
+    std::size_t offset = 0;
+    for (const auto* other : conflicts) {
+      if (offset + entry.size_ <= other->offset_) {
+        break;
+      }
+      offset = std::max(offset, other->offset_ + other->size_);
+    }
+    entry.offset_ = offset;
+    placed.push_back(entry_i);
+    plan.peak_bytes_ = std::max(plan.peak_bytes_, offset + entry.size_);
+    plan.total_bytes_ += entry.size_;
+  }
+  return plan;
+}
+
+}  // namespace MOTION::tensor
@@ -0,0 +1,77 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace MOTION {
+
+class NewGate;
+
+namespace tensor {
+
+class Tensor;
+
+// Placement a tensor's share buffers would get in an arena that is shared by
+// all tensors of a network run.
+struct TensorMemoryPlanEntry {
+  const Tensor* tensor_;
+  // buffer size in bytes, rounded up to the alignment
+  std::size_t size_;
+  std::size_t offset_;
+  // first and last step (see plan_tensor_memory) in which the tensor is alive
+  std::size_t first_step_;
+  std::size_t last_step_;
+};
+
+struct TensorMemoryPlan {
+  std::vector<TensorMemoryPlanEntry> entries_;
+  // size of the arena if the memory of dead tensors is reused
+  std::size_t peak_bytes_ = 0;
+  // size of all buffers together, i.e., without any reuse
+  std::size_t total_bytes_ = 0;
+  std::size_t alignment_ = 0;
+
+  std::string print_human_readable() const;
+};
+
+// Compute the lifetimes of the tensors produced by the gates and assign them
+// offsets s.t. tensors which are alive at the same time do not overlap.  The
+// lifetimes follow the schedule of TensorOpExecutor::evaluate_setup_online:
+// step i is the setup phase of gate i, step n + i its online phase.  A tensor
+// lives from the first phase of its producer until the last phase of its last
+// reader, tensors without readers are outputs and live until the end.
+//
+// The tensors still allocate their buffers themselves, the plan only tells how
+// much memory an arena with this layout would need (TensorOpExecutor logs it).
+// The actual memory usage follows the lifetimes if the executor releases dead
+// tensors, see TensorOpExecutor::set_release_dead_tensors.
+TensorMemoryPlan plan_tensor_memory(const std::vector<std::unique_ptr<NewGate>>& gates,
+                                    std::size_t alignment = 64);
+
+}  // namespace tensor
+
+}  // namespace MOTION
@@ -57,6 +57,10 @@ class Tensor : public NewWire {
   std::size_t get_num_dimensions() const noexcept { return 4; }
   const TensorDimensions& get_dimensions() const noexcept { return dimensions_; }
   // virtual std::size_t get_dimension(std::size_t) const = 0;
+  // Number of bytes occupied by this party's shares.
+  virtual std::size_t get_buffer_size() const noexcept = 0;
+  // Free the share buffers once no gate reads the tensor anymore.
+  virtual void release_buffers() noexcept = 0;
  private:
   const TensorDimensions dimensions_;
 };
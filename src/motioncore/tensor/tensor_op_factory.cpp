@@ -134,6 +134,15 @@ tensor::TensorCP TensorOpFactory::make_tensor_maxpool_op(const tensor::MaxPoolOp
       fmt::format("{} does not support the MaxPool operation", get_provider_name()));
 }
 
+tensor::TensorCP TensorOpFactory::make_tensor_argmax_op(const tensor::TensorCP) {
+  throw std::logic_error(
+      fmt::format("{} does not support the ArgMax operation", get_provider_name()));
+}
+
+tensor::TensorCP TensorOpFactory::make_tensor_msb_op(const tensor::TensorCP) {
+  throw std::logic_error(fmt::format("{} does not support the MSB operation", get_provider_name()));
+}
+
 tensor::TensorCP TensorOpFactory::make_tensor_avgpool_op(const tensor::AveragePoolOp&,
                                                          const tensor::TensorCP, std::size_t) {
   throw std::logic_error(
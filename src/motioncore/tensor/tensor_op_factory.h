@@ -88,11 +88,16 @@ class TensorOpFactory {
                                                std::size_t truncate_bits = 0);
   virtual tensor::TensorCP make_tensor_sqr_op(const tensor::TensorCP input,
                                               std::size_t truncate_bits = 0);
+  // for arithmetic inputs, this may compute only the sign bit instead of converting the input
   virtual tensor::TensorCP make_tensor_relu_op(const tensor::TensorCP input);
   virtual tensor::TensorCP make_tensor_relu_op(const tensor::TensorCP input_bool,
                                                const tensor::TensorCP input_arith);
   virtual tensor::TensorCP make_tensor_maxpool_op(const tensor::MaxPoolOp& maxpool_op,
                                                   const tensor::TensorCP input);
+  // one-hot encoding (bit size 1) of the position of the maximum in each batch entry
+  virtual tensor::TensorCP make_tensor_argmax_op(const tensor::TensorCP input);
+  // sign bit (bit size 1) of each element of an arithmetic tensor
+  virtual tensor::TensorCP make_tensor_msb_op(const tensor::TensorCP input);
   virtual tensor::TensorCP make_tensor_avgpool_op(const tensor::AveragePoolOp& avgpool_op,
                                                   const tensor::TensorCP input,
                                                   std::size_t truncate_bits);
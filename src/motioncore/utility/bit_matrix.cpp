@@ -31,6 +31,7 @@
 
 #include "crypto/pseudo_random_generator.h"
 #include "helpers.h"
+#include "utility/cpu_features.h"
 
 namespace ENCRYPTO {
 void BitMatrix::Transpose() {
@@ -395,92 +396,72 @@ void BitMatrix::Transpose128x128InPlace(std::array<std::uint64_t*, 128>& rows_64
 // Enquiries about further applications and development opportunities are
 // welcome.
 
-void BitMatrix::TransposeUsingBitSlicing(std::array<std::byte*, 128>& matrix, std::size_t ncols) {
-#define INP(r, c)                                     \
-  reinterpret_cast<const std::uint8_t* __restrict__>( \
-      __builtin_assume_aligned(matrix.at(r), 16))[c / 8]
-#define OUT(r, c) out[(r)*nrows / 8 + (c) / 8]
-
-  constexpr std::uint64_t nrows = 128;
-  std::vector<std::byte, boost::alignment::aligned_allocator<std::byte, 16>> out(
-      ((nrows * ncols) + 7) / 8, std::byte{0});
-
-  uint64_t rr, cc;
-  int i;
-
-  assert(nrows % 8 == 0 && ncols % 8 == 0);
+#define INP(r, c) reinterpret_cast<const std::uint8_t* __restrict__>(matrix[r])[(c) / 8]
 
-  // constexpr auto block_size = nrows * nrows;
-  // const auto num_blocks = nrows * ncols / block_size;
-
-//#define MOTION_AVX2
-#if defined(MOTION_AVX512)
-  // TODO: not tested yet
-  __m512i vec;
-  for (rr = 0; rr <= nrows - 32; rr += 8) {
-    for (cc = 0; cc < ncols; cc += 64) {
-      vec = _mm512_set_epi8(
-          INP(rr + 56, cc), INP(rr + 57, cc), INP(rr + 58, cc), INP(rr + 59, cc), INP(rr + 60, cc),
-          INP(rr + 61, cc), INP(rr + 62, cc), INP(rr + 63, cc), INP(rr + 48, cc), INP(rr + 49, cc),
-          INP(rr + 50, cc), INP(rr + 51, cc), INP(rr + 52, cc), INP(rr + 53, cc), INP(rr + 54, cc),
-          INP(rr + 55, cc), INP(rr + 39, cc), INP(rr + 40, cc), INP(rr + 41, cc), INP(rr + 42, cc),
-          INP(rr + 43, cc), INP(rr + 44, cc), INP(rr + 45, cc), INP(rr + 46, cc), INP(rr + 32, cc),
-          INP(rr + 33, cc), INP(rr + 34, cc), INP(rr + 35, cc), INP(rr + 36, cc), INP(rr + 37, cc),
-          INP(rr + 38, cc), INP(rr + 39, cc), INP(rr + 24, cc), INP(rr + 25, cc), INP(rr + 26, cc),
-          INP(rr + 27, cc), INP(rr + 28, cc), INP(rr + 29, cc), INP(rr + 30, cc), INP(rr + 31, cc),
-          INP(rr + 16, cc), INP(rr + 17, cc), INP(rr + 18, cc), INP(rr + 19, cc), INP(rr + 20, cc),
-          INP(rr + 21, cc), INP(rr + 22, cc), INP(rr + 23, cc), INP(rr + 8, cc), INP(rr + 9, cc),
-          INP(rr + 10, cc), INP(rr + 11, cc), INP(rr + 12, cc), INP(rr + 13, cc), INP(rr + 14, cc),
-          INP(rr + 15, cc), INP(rr + 0, cc), INP(rr + 1, cc), INP(rr + 2, cc), INP(rr + 3, cc),
-          INP(rr + 4, cc), INP(rr + 5, cc), INP(rr + 6, cc), INP(rr + 7, cc));
-      for (i = 0; i < 64; vec = _mm512_slli_epi64(vec, 1), ++i) {
-        OUT(cc + i, rr) = _mm512_movepi64_mask(vec);
+// Transposes the columns [c_begin, c_end) of the 128 rows of matrix, column c
+// is written to the 16 bytes at out[c - c_begin].  The AVX2 version takes 32
+// instead of 16 rows at once, see utility/cpu_features.h for the dispatch.
+MOTION_TARGET_DEFAULT
+static void TransposeColumnsOf128Rows(const std::byte* const* matrix, std::size_t c_begin,
+                                      std::size_t c_end, std::byte* const* out) {
+  assert(c_begin % 8 == 0 && c_end % 8 == 0);
+  __m128i vec;
+  // Do the main body in 16x8 blocks:
+  for (std::size_t r = 0; r < 128; r += 16) {
+    for (std::size_t c = c_begin; c < c_end; c += 8) {
+      vec = _mm_set_epi8(INP(r + 15, c), INP(r + 14, c), INP(r + 13, c), INP(r + 12, c),
+                         INP(r + 11, c), INP(r + 10, c), INP(r + 9, c), INP(r + 8, c),
+                         INP(r + 7, c), INP(r + 6, c), INP(r + 5, c), INP(r + 4, c),
+                         INP(r + 3, c), INP(r + 2, c), INP(r + 1, c), INP(r + 0, c));
+      for (int i = 8; i > 0; vec = _mm_slli_epi64(vec, 1), --i) {
+        *reinterpret_cast<std::uint16_t* __restrict__>(out[c - c_begin + i - 1] + r / 8) =
+            _mm_movemask_epi8(vec);
       }
     }
   }
-#elif defined(MOTION_AVX2)
+}
+
+#if MOTION_HAVE_MULTIVERSIONING
+MOTION_TARGET("avx2")
+static void TransposeColumnsOf128Rows(const std::byte* const* matrix, std::size_t c_begin,
+                                      std::size_t c_end, std::byte* const* out) {
+  assert(c_begin % 8 == 0 && c_end % 8 == 0);
   __m256i vec;
-  for (rr = 0; rr <= nrows - 32; rr += 32) {
-    for (cc = 0; cc < ncols; cc += 8) {
-      vec = _mm256_set_epi8(INP(rr + 24, cc), INP(rr + 25, cc), INP(rr + 26, cc), INP(rr + 27, cc),
-                            INP(rr + 28, cc), INP(rr + 29, cc), INP(rr + 30, cc), INP(rr + 31, cc),
-                            INP(rr + 16, cc), INP(rr + 17, cc), INP(rr + 18, cc), INP(rr + 19, cc),
-                            INP(rr + 20, cc), INP(rr + 21, cc), INP(rr + 22, cc), INP(rr + 23, cc),
-                            INP(rr + 8, cc), INP(rr + 9, cc), INP(rr + 10, cc), INP(rr + 11, cc),
-                            INP(rr + 12, cc), INP(rr + 13, cc), INP(rr + 14, cc), INP(rr + 15, cc),
-                            INP(rr + 0, cc), INP(rr + 1, cc), INP(rr + 2, cc), INP(rr + 3, cc),
-                            INP(rr + 4, cc), INP(rr + 5, cc), INP(rr + 6, cc), INP(rr + 7, cc));
-      for (i = 0; i < 8; vec = _mm256_slli_epi64(vec, 1), ++i) {
-        *(uint32_t*)&OUT(cc + i, rr) = _mm256_movemask_epi8(vec);
-        // const auto pos = ((cc + i) % nrows) * num_blocks * 16 + (cc / nrows) * 16 + rr / 8;
-        //*(uint16_t*)&out[pos] = _mm_movemask_epi8(vec);
-      }
-    }
-  }
-#else
-  __m128i vec;
-  // Do the main body in 16x8 blocks:
-  for (rr = 0; rr <= nrows - 16; rr += 16) {
-    for (cc = 0; cc < ncols; cc += 8) {
-      // vec = _mm_set_epi8(INP(rr + 8, cc), INP(rr + 9, cc), INP(rr + 10, cc), INP(rr + 11, cc),
-      //                    INP(rr + 12, cc), INP(rr + 13, cc), INP(rr + 14, cc), INP(rr + 15, cc),
-      //                    INP(rr + 0, cc), INP(rr + 1, cc), INP(rr + 2, cc), INP(rr + 3, cc),
-      //                    INP(rr + 4, cc), INP(rr + 5, cc), INP(rr + 6, cc), INP(rr + 7, cc));
-      vec = _mm_set_epi8(INP(rr + 15, cc), INP(rr + 14, cc), INP(rr + 13, cc), INP(rr + 12, cc),
-                         INP(rr + 11, cc), INP(rr + 10, cc), INP(rr + 9, cc), INP(rr + 8, cc),
-                         INP(rr + 7, cc), INP(rr + 6, cc), INP(rr + 5, cc), INP(rr + 4, cc),
-                         INP(rr + 3, cc), INP(rr + 2, cc), INP(rr + 1, cc), INP(rr + 0, cc));
-      // for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-      for (i = 8; i > 0; vec = _mm_slli_epi64(vec, 1), --i) {
-        // *(uint16_t * __restrict__) & OUT(cc + i, rr) = _mm_movemask_epi8(vec);
-        *(uint16_t * __restrict__) & OUT(cc + i - 1, rr) = _mm_movemask_epi8(vec);
-        // const auto pos = ((cc + i) % nrows) * num_blocks * 16 + (cc / nrows) * 16 + rr / 8;
-        //*(uint16_t*)&out[pos] = _mm_movemask_epi8(vec);
+  // Do the main body in 32x8 blocks:
+  for (std::size_t r = 0; r < 128; r += 32) {
+    for (std::size_t c = c_begin; c < c_end; c += 8) {
+      vec = _mm256_set_epi8(INP(r + 31, c), INP(r + 30, c), INP(r + 29, c), INP(r + 28, c),
+                            INP(r + 27, c), INP(r + 26, c), INP(r + 25, c), INP(r + 24, c),
+                            INP(r + 23, c), INP(r + 22, c), INP(r + 21, c), INP(r + 20, c),
+                            INP(r + 19, c), INP(r + 18, c), INP(r + 17, c), INP(r + 16, c),
+                            INP(r + 15, c), INP(r + 14, c), INP(r + 13, c), INP(r + 12, c),
+                            INP(r + 11, c), INP(r + 10, c), INP(r + 9, c), INP(r + 8, c),
+                            INP(r + 7, c), INP(r + 6, c), INP(r + 5, c), INP(r + 4, c),
+                            INP(r + 3, c), INP(r + 2, c), INP(r + 1, c), INP(r + 0, c));
+      for (int i = 8; i > 0; vec = _mm256_slli_epi64(vec, 1), --i) {
+        *reinterpret_cast<std::uint32_t* __restrict__>(out[c - c_begin + i - 1] + r / 8) =
+            _mm256_movemask_epi8(vec);
       }
     }
   }
+}
 #endif
 
+#undef INP
+
+void BitMatrix::TransposeUsingBitSlicing(std::array<std::byte*, 128>& matrix, std::size_t ncols) {
+  constexpr std::uint64_t nrows = 128;
+  std::vector<std::byte, boost::alignment::aligned_allocator<std::byte, 16>> out(
+      ((nrows * ncols) + 7) / 8, std::byte{0});
+
+  assert(nrows % 8 == 0 && ncols % 8 == 0);
+
+  std::vector<std::byte*> out_rows(ncols);
+  for (std::size_t j = 0; j < ncols; ++j) {
+    out_rows[j] = out.data() + j * nrows / 8;
+  }
+  TransposeColumnsOf128Rows(matrix.data(), 0, ncols, out_rows.data());
+
   for (auto j = 0ull; j < ncols; ++j) {
     std::copy(reinterpret_cast<const std::byte* __restrict__>(out.data()) + j * 16,
               reinterpret_cast<const std::byte* __restrict__>(out.data()) + (j + 1) * 16,
@@ -488,112 +469,47 @@ void BitMatrix::TransposeUsingBitSlicing(std::array<std::byte*, 128>& matrix, st
                   __builtin_assume_aligned(matrix.at(j % nrows), 16)) +
                   (j / nrows) * 16);
   }
-
-  // for (auto j = 0ull; j < nrows; ++j) {
-  // std::copy(out.data() + j * 16 * num_blocks, out.data() + (j + 1) * 16 * num_blocks,
-  //          reinterpret_cast<std::uint8_t*>(matrix.at(j)));
-  // }
 }
 
 void BitMatrix::SenderTransposeAndEncrypt(const std::array<const std::byte*, 128>& matrix,
                                           std::vector<BitVector<>>& y0,
                                           std::vector<BitVector<>>& y1, const BitVector<> choices,
                                           PRG& prg_fixed_key, const std::size_t ncols,
-                                          const std::vector<std::size_t>& bitlengths) {
+                                          const std::vector<std::size_t>& bitlengths,
+                                          const std::size_t column_offset) {
   constexpr std::size_t kappa{128}, nrows{128};
-#define INP(r, c)                                     \
-  reinterpret_cast<const std::uint8_t* __restrict__>( \
-      __builtin_assume_aligned(matrix.at(r), 16))[c / 8]
   assert(y0.size() == y1.size());
+  assert(column_offset % kappa == 0);
 
-  const std::size_t original_size{y0.size()}, difference{ncols - original_size};
-  if (difference) {
-    y0.resize(ncols);
-    y1.resize(ncols);
+  // columns beyond the registered OTs are padding and are not encrypted
+  const std::size_t original_size{y0.size()};
+  if (original_size < column_offset + ncols) {
+    y0.resize(column_offset + ncols);
+    y1.resize(column_offset + ncols);
   }
 
-  for (auto& bv : y0) bv = BitVector(std::vector<std::byte>(kappa / 8), kappa);
-
-  std::uint64_t r{0}, c{0};
-  int i{0};
+  for (auto j = column_offset; j < column_offset + ncols; ++j) {
+    y0[j] = BitVector(std::vector<std::byte>(kappa / 8), kappa);
+  }
 
   assert(nrows % 8 == 0 && ncols % 8 == 0);
 
-//#define MOTION_AVX2
-#if defined(MOTION_AVX512)
-  // TODO: not tested yet
-  __m512i vec;
-  for (rr = 0; rr <= nrows - 32; rr += 8) {
-    for (cc = 0; cc < ncols; cc += 64) {
-      vec = _mm512_set_epi8(
-          INP(rr + 56, cc), INP(rr + 57, cc), INP(rr + 58, cc), INP(rr + 59, cc), INP(rr + 60, cc),
-          INP(rr + 61, cc), INP(rr + 62, cc), INP(rr + 63, cc), INP(rr + 48, cc), INP(rr + 49, cc),
-          INP(rr + 50, cc), INP(rr + 51, cc), INP(rr + 52, cc), INP(rr + 53, cc), INP(rr + 54, cc),
-          INP(rr + 55, cc), INP(rr + 39, cc), INP(rr + 40, cc), INP(rr + 41, cc), INP(rr + 42, cc),
-          INP(rr + 43, cc), INP(rr + 44, cc), INP(rr + 45, cc), INP(rr + 46, cc), INP(rr + 32, cc),
-          INP(rr + 33, cc), INP(rr + 34, cc), INP(rr + 35, cc), INP(rr + 36, cc), INP(rr + 37, cc),
-          INP(rr + 38, cc), INP(rr + 39, cc), INP(rr + 24, cc), INP(rr + 25, cc), INP(rr + 26, cc),
-          INP(rr + 27, cc), INP(rr + 28, cc), INP(rr + 29, cc), INP(rr + 30, cc), INP(rr + 31, cc),
-          INP(rr + 16, cc), INP(rr + 17, cc), INP(rr + 18, cc), INP(rr + 19, cc), INP(rr + 20, cc),
-          INP(rr + 21, cc), INP(rr + 22, cc), INP(rr + 23, cc), INP(rr + 8, cc), INP(rr + 9, cc),
-          INP(rr + 10, cc), INP(rr + 11, cc), INP(rr + 12, cc), INP(rr + 13, cc), INP(rr + 14, cc),
-          INP(rr + 15, cc), INP(rr + 0, cc), INP(rr + 1, cc), INP(rr + 2, cc), INP(rr + 3, cc),
-          INP(rr + 4, cc), INP(rr + 5, cc), INP(rr + 6, cc), INP(rr + 7, cc));
-      for (i = 0; i < 64; vec = _mm512_slli_epi64(vec, 1), ++i) {
-        OUT(cc + i, rr) = _mm512_movepi64_mask(vec);
-      }
-    }
-  }
-#elif defined(MOTION_AVX2)
-  __m256i vec;
-  for (rr = 0; rr <= nrows - 32; rr += 32) {
-    for (cc = 0; cc < ncols; cc += 8) {
-      vec = _mm256_set_epi8(INP(rr + 24, cc), INP(rr + 25, cc), INP(rr + 26, cc), INP(rr + 27, cc),
-                            INP(rr + 28, cc), INP(rr + 29, cc), INP(rr + 30, cc), INP(rr + 31, cc),
-                            INP(rr + 16, cc), INP(rr + 17, cc), INP(rr + 18, cc), INP(rr + 19, cc),
-                            INP(rr + 20, cc), INP(rr + 21, cc), INP(rr + 22, cc), INP(rr + 23, cc),
-                            INP(rr + 8, cc), INP(rr + 9, cc), INP(rr + 10, cc), INP(rr + 11, cc),
-                            INP(rr + 12, cc), INP(rr + 13, cc), INP(rr + 14, cc), INP(rr + 15, cc),
-                            INP(rr + 0, cc), INP(rr + 1, cc), INP(rr + 2, cc), INP(rr + 3, cc),
-                            INP(rr + 4, cc), INP(rr + 5, cc), INP(rr + 6, cc), INP(rr + 7, cc));
-      for (i = 0; i < 8; vec = _mm256_slli_epi64(vec, 1), ++i) {
-        *(uint32_t*)&OUT(cc + i, rr) = _mm256_movemask_epi8(vec);
-        // const auto pos = ((cc + i) % nrows) * num_blocks * 16 + (cc / nrows) * 16 + rr / 8;
-        //*(uint16_t*)&out[pos] = _mm_movemask_epi8(vec);
-      }
-    }
-  }
-#else
-  __m128i vec;
   PRG prg_var_key;
+  std::array<std::byte*, nrows> out_rows;
   // process 128x128 blocks
-  while (c < ncols) {
-    auto c_old{c};
-    for (r = 0; r <= nrows - 16; r += 16) {
-      for (c = c_old; c == c_old || (c % 128 != 0); c += 8) {
-        // vec = _mm_set_epi8(INP(r + 8, c), INP(r + 9, c), INP(r + 10, c), INP(r + 11, c),
-        //                    INP(r + 12, c), INP(r + 13, c), INP(r + 14, c), INP(r + 15, c),
-        //                    INP(r + 0, c), INP(r + 1, c), INP(r + 2, c), INP(r + 3, c),
-        //                    INP(r + 4, c), INP(r + 5, c), INP(r + 6, c), INP(r + 7, c));
-        vec = _mm_set_epi8(INP(r + 15, c), INP(r + 14, c), INP(r + 13, c), INP(r + 12, c),
-                           INP(r + 11, c), INP(r + 10, c), INP(r + 9, c), INP(r + 8, c),
-                           INP(r + 7, c), INP(r + 6, c), INP(r + 5, c), INP(r + 4, c),
-                           INP(r + 3, c), INP(r + 2, c), INP(r + 1, c), INP(r + 0, c));
-        // for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-        for (i = 8; i > 0; vec = _mm_slli_epi64(vec, 1), --i) {
-          // *reinterpret_cast<std::uint16_t* __restrict__>(y0[c + i].GetMutableData().data() +
-          *reinterpret_cast<std::uint16_t* __restrict__>(y0[c + i - 1].GetMutableData().data() +
-                                                         r / 8) = _mm_movemask_epi8(vec);
-        }
-      }
+  for (std::size_t c_begin = 0; c_begin < ncols; c_begin += nrows) {
+    const auto c_end = std::min(c_begin + nrows, ncols);
+    for (auto c = c_begin; c < c_end; ++c) {
+      out_rows[c - c_begin] = y0[column_offset + c].GetMutableData().data();
     }
-    // XXX
-    for (; c_old < c && c_old < original_size; ++c_old) {
-      auto& out0 = y0[c_old];
-      auto& out1 = y1[c_old];
+    TransposeColumnsOf128Rows(matrix.data(), c_begin, c_end, out_rows.data());
+
+    for (auto c = c_begin; c < c_end && column_offset + c < original_size; ++c) {
+      auto& out0 = y0[column_offset + c];
+      auto& out1 = y1[column_offset + c];
 
       // bit length of the OT
-      const auto bitlen = bitlengths[c_old];
+      const auto bitlen = bitlengths[column_offset + c];
 
       out1 = choices ^ out0;
       assert(out0.GetSize() == 128);
@@ -619,115 +535,53 @@ void BitMatrix::SenderTransposeAndEncrypt(const std::array<const std::byte*, 128
       }
     }
   }
-#endif
 }
 
 void BitMatrix::ReceiverTransposeAndEncrypt(const std::array<const std::byte*, 128>& matrix,
                                             std::vector<BitVector<>>& out, PRG& prg_fixed_key,
                                             const std::size_t ncols,
-                                            const std::vector<std::size_t>& bitlengths) {
+                                            const std::vector<std::size_t>& bitlengths,
+                                            const std::size_t column_offset) {
   constexpr std::size_t kappa{128}, nrows{128};
-#define INP(r, c)                                     \
-  reinterpret_cast<const std::uint8_t* __restrict__>( \
-      __builtin_assume_aligned(matrix.at(r), 16))[c / 8]
+  assert(column_offset % kappa == 0);
 
-  const std::size_t original_size{out.size()}, difference{ncols - original_size};
-  if (difference) {
-    out.resize(ncols);
+  // columns beyond the registered OTs are padding and are not encrypted
+  const std::size_t original_size{out.size()};
+  if (original_size < column_offset + ncols) {
+    out.resize(column_offset + ncols);
   }
 
-  for (auto& bv : out) bv = BitVector(std::vector<std::byte>(kappa / 8), kappa);
-
-  std::uint64_t r{0}, c{0};
-  int i{0};
+  for (auto j = column_offset; j < column_offset + ncols; ++j) {
+    out[j] = BitVector(std::vector<std::byte>(kappa / 8), kappa);
+  }
 
   assert(nrows % 8 == 0 && ncols % 8 == 0);
 
-//#define MOTION_AVX2
-#if defined(MOTION_AVX512)
-  // TODO: not tested yet
-  __m512i vec;
-  for (rr = 0; rr <= nrows - 32; rr += 8) {
-    for (cc = 0; cc < ncols; cc += 64) {
-      vec = _mm512_set_epi8(
-          INP(rr + 56, cc), INP(rr + 57, cc), INP(rr + 58, cc), INP(rr + 59, cc), INP(rr + 60, cc),
-          INP(rr + 61, cc), INP(rr + 62, cc), INP(rr + 63, cc), INP(rr + 48, cc), INP(rr + 49, cc),
-          INP(rr + 50, cc), INP(rr + 51, cc), INP(rr + 52, cc), INP(rr + 53, cc), INP(rr + 54, cc),
-          INP(rr + 55, cc), INP(rr + 39, cc), INP(rr + 40, cc), INP(rr + 41, cc), INP(rr + 42, cc),
-          INP(rr + 43, cc), INP(rr + 44, cc), INP(rr + 45, cc), INP(rr + 46, cc), INP(rr + 32, cc),
-          INP(rr + 33, cc), INP(rr + 34, cc), INP(rr + 35, cc), INP(rr + 36, cc), INP(rr + 37, cc),
-          INP(rr + 38, cc), INP(rr + 39, cc), INP(rr + 24, cc), INP(rr + 25, cc), INP(rr + 26, cc),
-          INP(rr + 27, cc), INP(rr + 28, cc), INP(rr + 29, cc), INP(rr + 30, cc), INP(rr + 31, cc),
-          INP(rr + 16, cc), INP(rr + 17, cc), INP(rr + 18, cc), INP(rr + 19, cc), INP(rr + 20, cc),
-          INP(rr + 21, cc), INP(rr + 22, cc), INP(rr + 23, cc), INP(rr + 8, cc), INP(rr + 9, cc),
-          INP(rr + 10, cc), INP(rr + 11, cc), INP(rr + 12, cc), INP(rr + 13, cc), INP(rr + 14, cc),
-          INP(rr + 15, cc), INP(rr + 0, cc), INP(rr + 1, cc), INP(rr + 2, cc), INP(rr + 3, cc),
-          INP(rr + 4, cc), INP(rr + 5, cc), INP(rr + 6, cc), INP(rr + 7, cc));
-      for (i = 0; i < 64; vec = _mm512_slli_epi64(vec, 1), ++i) {
-        OUT(cc + i, rr) = _mm512_movepi64_mask(vec);
-      }
-    }
-  }
-#elif defined(MOTION_AVX2)
-  __m256i vec;
-  for (rr = 0; rr <= nrows - 32; rr += 32) {
-    for (cc = 0; cc < ncols; cc += 8) {
-      vec = _mm256_set_epi8(INP(rr + 24, cc), INP(rr + 25, cc), INP(rr + 26, cc), INP(rr + 27, cc),
-                            INP(rr + 28, cc), INP(rr + 29, cc), INP(rr + 30, cc), INP(rr + 31, cc),
-                            INP(rr + 16, cc), INP(rr + 17, cc), INP(rr + 18, cc), INP(rr + 19, cc),
-                            INP(rr + 20, cc), INP(rr + 21, cc), INP(rr + 22, cc), INP(rr + 23, cc),
-                            INP(rr + 8, cc), INP(rr + 9, cc), INP(rr + 10, cc), INP(rr + 11, cc),
-                            INP(rr + 12, cc), INP(rr + 13, cc), INP(rr + 14, cc), INP(rr + 15, cc),
-                            INP(rr + 0, cc), INP(rr + 1, cc), INP(rr + 2, cc), INP(rr + 3, cc),
-                            INP(rr + 4, cc), INP(rr + 5, cc), INP(rr + 6, cc), INP(rr + 7, cc));
-      for (i = 0; i < 8; vec = _mm256_slli_epi64(vec, 1), ++i) {
-        *(uint32_t*)&OUT(cc + i, rr) = _mm256_movemask_epi8(vec);
-        // const auto pos = ((cc + i) % nrows) * num_blocks * 16 + (cc / nrows) * 16 + rr / 8;
-        //*(uint16_t*)&out[pos] = _mm_movemask_epi8(vec);
-      }
-    }
-  }
-#else
-  __m128i vec;
   PRG prg_var_key;
+  std::array<std::byte*, nrows> out_rows;
   // process 128x128 blocks
-  while (c < ncols) {
-    auto c_old{c};
-    for (r = 0; r <= nrows - 16; r += 16) {
-      for (c = c_old; c == c_old || (c % 128 != 0); c += 8) {
-        // vec = _mm_set_epi8(INP(r + 8, c), INP(r + 9, c), INP(r + 10, c), INP(r + 11, c),
-        //                    INP(r + 12, c), INP(r + 13, c), INP(r + 14, c), INP(r + 15, c),
-        //                    INP(r + 0, c), INP(r + 1, c), INP(r + 2, c), INP(r + 3, c),
-        //                    INP(r + 4, c), INP(r + 5, c), INP(r + 6, c), INP(r + 7, c));
-        vec = _mm_set_epi8(INP(r + 15, c), INP(r + 14, c), INP(r + 13, c), INP(r + 12, c),
-                           INP(r + 11, c), INP(r + 10, c), INP(r + 9, c), INP(r + 8, c),
-                           INP(r + 7, c), INP(r + 6, c), INP(r + 5, c), INP(r + 4, c),
-                           INP(r + 3, c), INP(r + 2, c), INP(r + 1, c), INP(r + 0, c));
-        // for (i = 0; i < 8; vec = _mm_slli_epi64(vec, 1), ++i) {
-        for (i = 8; i > 0; vec = _mm_slli_epi64(vec, 1), --i) {
-          // *reinterpret_cast<std::uint16_t* __restrict__>(out[c + i].GetMutableData().data() +
-          *reinterpret_cast<std::uint16_t* __restrict__>(out[c + i - 1].GetMutableData().data() +
-                                                         r / 8) = _mm_movemask_epi8(vec);
-        }
-      }
+  for (std::size_t c_begin = 0; c_begin < ncols; c_begin += nrows) {
+    const auto c_end = std::min(c_begin + nrows, ncols);
+    for (auto c = c_begin; c < c_end; ++c) {
+      out_rows[c - c_begin] = out[column_offset + c].GetMutableData().data();
     }
-    // XXX
-    for (; c_old < c && c_old < original_size; ++c_old) {
-        auto &o = out[c_old];
-        assert(o.GetSize() == 128);
-        const std::size_t bitlen = bitlengths[c_old];
-
-        if (bitlen <= kappa) {
-          prg_fixed_key.MMO(o.GetMutableData().data());
-          o.Resize(bitlen);
-        } else {
-          prg_fixed_key.MMO(o.GetMutableData().data());
-          prg_var_key.SetKey(o.GetData().data());
-          o = BitVector<>(prg_var_key.Encrypt(MOTION::Helpers::Convert::BitsToBytes(bitlen)), bitlen);
-        }
+    TransposeColumnsOf128Rows(matrix.data(), c_begin, c_end, out_rows.data());
+
+    for (auto c = c_begin; c < c_end && column_offset + c < original_size; ++c) {
+      auto& o = out[column_offset + c];
+      assert(o.GetSize() == 128);
+      const std::size_t bitlen = bitlengths[column_offset + c];
+
+      if (bitlen <= kappa) {
+        prg_fixed_key.MMO(o.GetMutableData().data());
+        o.Resize(bitlen);
+      } else {
+        prg_fixed_key.MMO(o.GetMutableData().data());
+        prg_var_key.SetKey(o.GetData().data());
+        o = BitVector<>(prg_var_key.Encrypt(MOTION::Helpers::Convert::BitsToBytes(bitlen)), bitlen);
+      }
     }
   }
-#endif
 }
 
 bool BitMatrix::operator==(const BitMatrix& other) {
@@ -119,16 +119,21 @@ class BitMatrix {
   static void TransposeUsingBitSlicing(std::array<std::byte*, 128>& matrix,
                                        std::size_t num_columns);
 
+  // The matrix may be a window of the OT extension matrix starting at column
+  // column_offset (a multiple of 128), its outputs are then written to
+  // y0/y1 resp. out starting at this position.
   static void SenderTransposeAndEncrypt(const std::array<const std::byte*, 128>& matrix,
                                         std::vector<BitVector<>>& y0, std::vector<BitVector<>>& y1,
                                         const BitVector<> choices, PRG& prg_fixed_key,
                                         const std::size_t ncols,
-                                        const std::vector<std::size_t>& bitlengths);
+                                        const std::vector<std::size_t>& bitlengths,
+                                        const std::size_t column_offset = 0);
 
   static void ReceiverTransposeAndEncrypt(const std::array<const std::byte*, 128>& matrix,
                                           std::vector<BitVector<>>& out, PRG& prg_fixed_key,
                                           const std::size_t ncols,
-                                          const std::vector<std::size_t>& bitlengths);
+                                          const std::vector<std::size_t>& bitlengths,
+                                          const std::size_t column_offset = 0);
 
   bool operator==(const BitMatrix& other);
 
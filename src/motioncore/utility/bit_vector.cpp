@@ -24,6 +24,7 @@
 
 #include "bit_vector.h"
 #include "crypto/random/aes128_ctr_rng.h"
+#include "utility/cpu_features.h"
 
 namespace ENCRYPTO {
 
@@ -88,59 +89,58 @@ inline bool AlignedEQImpl(const T* ptr1, const U* ptr2, const std::size_t byte_s
   return std::equal(ptr1_cast, ptr1_cast + byte_size, ptr2_cast);
 }
 
+// The bulk bitwise operations are cloned for AVX2 and AVX-512, see
+// utility/cpu_features.h.  They use unaligned loads, which are as fast as
+// aligned ones on aligned data, so the Aligned* variants just forward to them.
+MOTION_TARGET_CLONES
+static void XORBytes(const std::byte* in, std::byte* res, const std::size_t byte_size) {
+  for (std::size_t i = 0; i < byte_size; ++i) {
+    res[i] ^= in[i];
+  }
+}
+
+MOTION_TARGET_CLONES
+static void ANDBytes(const std::byte* in, std::byte* res, const std::size_t byte_size) {
+  for (std::size_t i = 0; i < byte_size; ++i) {
+    res[i] &= in[i];
+  }
+}
+
+MOTION_TARGET_CLONES
+static void ORBytes(const std::byte* in, std::byte* res, const std::size_t byte_size) {
+  for (std::size_t i = 0; i < byte_size; ++i) {
+    res[i] |= in[i];
+  }
+}
+
 template <typename T, typename U>
 inline void XORImpl(const T* in, U* res, const std::size_t byte_size) {
-  const auto in_cast{reinterpret_cast<const std::byte*>(in)};
-  auto res_cast{reinterpret_cast<std::byte*>(res)};
-  std::transform(in_cast, in_cast + byte_size, res_cast, res_cast,
-                 [](const std::byte& a, const std::byte& b) { return a ^ b; });
+  XORBytes(reinterpret_cast<const std::byte*>(in), reinterpret_cast<std::byte*>(res), byte_size);
 }
 
-// TODO: check how good this is vectorized
 template <typename T, typename U>
 inline void AlignedXORImpl(const T* in, U* res, const std::size_t byte_size) {
-  const auto in_cast{
-      reinterpret_cast<const std::byte*>(__builtin_assume_aligned(in, MOTION::MOTION_ALIGNMENT))};
-  auto res_cast{
-      reinterpret_cast<std::byte*>(__builtin_assume_aligned(res, MOTION::MOTION_ALIGNMENT))};
-  std::transform(in_cast, in_cast + byte_size, res_cast, res_cast,
-                 [](const std::byte& a, const std::byte& b) { return a ^ b; });
+  XORImpl(in, res, byte_size);
 }
 
 template <typename T, typename U>
 inline void ANDImpl(const T* in, U* res, const std::size_t byte_size) {
-  const auto in_cast{reinterpret_cast<const std::byte*>(in)};
-  auto res_cast{reinterpret_cast<std::byte*>(res)};
-  std::transform(in_cast, in_cast + byte_size, res_cast, res_cast,
-                 [](const std::byte& a, const std::byte& b) { return a & b; });
+  ANDBytes(reinterpret_cast<const std::byte*>(in), reinterpret_cast<std::byte*>(res), byte_size);
 }
 
 template <typename T, typename U>
 inline void AlignedANDImpl(const T* in, U* res, const std::size_t byte_size) {
-  const auto in_cast{
-      reinterpret_cast<const std::byte*>(__builtin_assume_aligned(in, MOTION::MOTION_ALIGNMENT))};
-  auto res_cast{
-      reinterpret_cast<std::byte*>(__builtin_assume_aligned(res, MOTION::MOTION_ALIGNMENT))};
-  std::transform(in_cast, in_cast + byte_size, res_cast, res_cast,
-                 [](const std::byte& a, const std::byte& b) { return a & b; });
+  ANDImpl(in, res, byte_size);
 }
 
 template <typename T, typename U>
 inline void ORImpl(const T* in, U* res, const std::size_t byte_size) {
-  const auto in_cast{reinterpret_cast<const std::byte*>(in)};
-  auto res_cast{reinterpret_cast<std::byte*>(res)};
-  std::transform(in_cast, in_cast + byte_size, res_cast, res_cast,
-                 [](const std::byte& a, const std::byte& b) { return a | b; });
+  ORBytes(reinterpret_cast<const std::byte*>(in), reinterpret_cast<std::byte*>(res), byte_size);
 }
 
 template <typename T, typename U>
 inline void AlignedORImpl(const T* in, U* res, const std::size_t byte_size) {
-  const auto in_cast{
-      reinterpret_cast<const std::byte*>(__builtin_assume_aligned(in, MOTION::MOTION_ALIGNMENT))};
-  auto res_cast{
-      reinterpret_cast<std::byte*>(__builtin_assume_aligned(res, MOTION::MOTION_ALIGNMENT))};
-  std::transform(in_cast, in_cast + byte_size, res_cast, res_cast,
-                 [](const std::byte& a, const std::byte& b) { return a | b; });
+  ORImpl(in, res, byte_size);
 }
 
 inline void CopyImpl(const std::size_t from, const std::size_t to, std::byte* src, std::byte* dst) {
@@ -494,9 +494,7 @@ BitVector<Allocator1>& BitVector<Allocator1>::operator&=(
 
   Resize(max_bit_size, true);
 
-  for (auto i = 0ull; i < min_byte_size; ++i) {
-    data_vector_.at(i) &= other.GetData().at(i);
-  }
+  ANDImpl(other.GetData().data(), data_vector_.data(), min_byte_size);
   return *this;
 }
 
@@ -528,9 +526,7 @@ BitVector<Allocator1>& BitVector<Allocator1>::operator^=(
     const BitVector<Allocator2>& other) noexcept {
   auto min_byte_size = std::min(data_vector_.size(), other.data_vector_.size());
 
-  std::transform(data_vector_.cbegin(), data_vector_.cbegin() + min_byte_size,
-                 other.data_vector_.cbegin(), data_vector_.begin(),
-                 [](auto a, auto b) { return a ^ b; });
+  XORImpl(other.data_vector_.data(), data_vector_.data(), min_byte_size);
 
   return *this;
 }
@@ -567,9 +563,7 @@ BitVector<Allocator1>& BitVector<Allocator1>::operator|=(
 
   Resize(max_bit_size, true);
 
-  for (auto i = 0ull; i < min_byte_size; ++i) {
-    data_vector_.at(i) |= other.GetData().at(i);
-  }
+  ORImpl(other.GetData().data(), data_vector_.data(), min_byte_size);
 
   if (min_byte_size == max_byte_size) {
     for (auto i = min_byte_size; i < max_byte_size; ++i) {
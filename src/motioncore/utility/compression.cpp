@@ -0,0 +1,226 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "compression.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr std::size_t min_match = 4;
+constexpr std::size_t max_offset = 0xffff;
+constexpr std::size_t hash_bits = 12;
+
+std::uint32_t read32(const std::uint8_t* ptr) {
+  std::uint32_t value;
+  std::memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+std::size_t hash(std::uint32_t value) { return (value * 2654435761u) >> (32 - hash_bits); }
+
+// lengths which do not fit into the 4 bit token are continued in 255 steps
+void write_length(std::vector<std::uint8_t>& output, std::size_t length) {
+  for (; length >= 255; length -= 255) {
+    output.push_back(255);
+  }
+  output.push_back(static_cast<std::uint8_t>(length));
+}
+
+// match_length == 0 marks the last sequence, which consists only of literals
+void write_sequence(std::vector<std::uint8_t>& output, const std::uint8_t* literals,
+                    std::size_t num_literals, std::size_t offset, std::size_t match_length) {
+  const auto literals_token = std::min<std::size_t>(num_literals, 15);
+  const auto match_token =
+      match_length == 0 ? 0 : std::min<std::size_t>(match_length - min_match, 15);
+  output.push_back(static_cast<std::uint8_t>(literals_token << 4 | match_token));
+  if (literals_token == 15) {
+    write_length(output, num_literals - 15);
+  }
+  output.insert(std::end(output), literals, literals + num_literals);
+  if (match_length == 0) {
+    return;
+  }
+  output.push_back(static_cast<std::uint8_t>(offset & 0xff));
+  output.push_back(static_cast<std::uint8_t>(offset >> 8));
+  if (match_token == 15) {
+    write_length(output, match_length - min_match - 15);
+  }
+}
+
+}  // namespace
+
+namespace MOTION::utils {
+
+template <typename T>
+void pack_bits(const T* input, std::size_t num_elements, std::size_t bit_size,
+               std::uint8_t* output) {
+  const std::uint64_t mask =
+      bit_size == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bit_size) - 1;
+  std::uint64_t word = 0;
+  std::size_t word_bits = 0;
+  for (std::size_t i = 0; i < num_elements; ++i) {
+    const std::uint64_t value = static_cast<std::uint64_t>(input[i]) & mask;
+    word |= value << word_bits;
+    if (word_bits + bit_size >= 64) {
+      std::memcpy(output, &word, sizeof(word));
+      output += sizeof(word);
+      // bits of value which did not fit into the word
+      word = word_bits == 0 ? 0 : value >> (64 - word_bits);
+      word_bits = word_bits + bit_size - 64;
+    } else {
+      word_bits += bit_size;
+    }
+  }
+  std::memcpy(output, &word, (word_bits + 7) / 8);
+}
+
+template <typename T>
+void unpack_bits(const std::uint8_t* input, std::size_t num_elements, std::size_t bit_size,
+                 T* output) {
+  const std::uint64_t mask =
+      bit_size == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bit_size) - 1;
+  const auto* input_end = input + packed_size(num_elements, bit_size);
+  std::uint64_t word = 0;
+  std::size_t word_bits = 0;
+  for (std::size_t i = 0; i < num_elements; ++i) {
+    if (word_bits >= bit_size) {
+      output[i] = static_cast<T>(word & mask);
+      word = bit_size == 64 ? 0 : word >> bit_size;
+      word_bits -= bit_size;
+      continue;
+    }
+    std::uint64_t next = 0;
+    const auto num_bytes = std::min<std::size_t>(sizeof(next), input_end - input);
+    std::memcpy(&next, input, num_bytes);
+    input += num_bytes;
+    // bit_size - word_bits bits are taken from the next word
+    const auto num_used = bit_size - word_bits;
+    output[i] = static_cast<T>((word | (word_bits == 0 ? next : next << word_bits)) & mask);
+    word = num_used == 64 ? 0 : next >> num_used;
+    word_bits = 8 * num_bytes - num_used;
+  }
+}
+
+template void pack_bits(const std::uint8_t*, std::size_t, std::size_t, std::uint8_t*);
+template void pack_bits(const std::uint16_t*, std::size_t, std::size_t, std::uint8_t*);
+template void pack_bits(const std::uint32_t*, std::size_t, std::size_t, std::uint8_t*);
+template void pack_bits(const std::uint64_t*, std::size_t, std::size_t, std::uint8_t*);
+template void unpack_bits(const std::uint8_t*, std::size_t, std::size_t, std::uint8_t*);
+template void unpack_bits(const std::uint8_t*, std::size_t, std::size_t, std::uint16_t*);
+template void unpack_bits(const std::uint8_t*, std::size_t, std::size_t, std::uint32_t*);
+template void unpack_bits(const std::uint8_t*, std::size_t, std::size_t, std::uint64_t*);
+
+std::optional<std::vector<std::uint8_t>> lz_compress(const std::uint8_t* input, std::size_t size) {
+  if (size < 2 * min_match) {
+    return std::nullopt;
+  }
+  std::vector<std::uint8_t> output;
+  output.reserve(size);
+  // last position of each hashed 4 byte sequence
+  std::vector<std::size_t> table(std::size_t(1) << hash_bits, 0);
+  std::size_t anchor = 0;
+  std::size_t num_misses = 0;
+  for (std::size_t pos = 0; pos + min_match <= size;) {
+    const auto value = read32(input + pos);
+    auto& entry = table[hash(value)];
+    const auto candidate = entry;
+    entry = pos;
+    if (candidate >= pos || pos - candidate > max_offset || read32(input + candidate) != value) {
+      // skip faster over incompressible data
+      pos += 1 + (num_misses++ >> 6);
+      continue;
+    }
+    num_misses = 0;
+    std::size_t match_length = min_match;
+    while (pos + match_length < size &&
+           input[candidate + match_length] == input[pos + match_length]) {
+      ++match_length;
+    }
+    write_sequence(output, input + anchor, pos - anchor, pos - candidate, match_length);
+    pos += match_length;
+    anchor = pos;
+    if (output.size() >= size) {
+      return std::nullopt;
+    }
+  }
+  write_sequence(output, input + anchor, size - anchor, 0, 0);
+  if (output.size() >= size) {
+    return std::nullopt;
+  }
+  return output;
+}
+
+bool lz_decompress(const std::uint8_t* input, std::size_t input_size, std::uint8_t* output,
+                   std::size_t size) {
+  std::size_t in_pos = 0;
+  std::size_t out_pos = 0;
+  auto read_length = [input, input_size, &in_pos](std::size_t& length) {
+    std::uint8_t byte;
+    do {
+      if (in_pos >= input_size) {
+        return false;
+      }
+      byte = input[in_pos++];
+      length += byte;
+    } while (byte == 255);
+    return true;
+  };
+  while (in_pos < input_size) {
+    const auto token = input[in_pos++];
+    std::size_t num_literals = token >> 4;
+    if (num_literals == 15 && !read_length(num_literals)) {
+      return false;
+    }
+    if (num_literals > input_size - in_pos || num_literals > size - out_pos) {
+      return false;
+    }
+    std::copy_n(input + in_pos, num_literals, output + out_pos);
+    in_pos += num_literals;
+    out_pos += num_literals;
+    if (in_pos == input_size) {
+      // last sequence
+      return out_pos == size;
+    }
+    if (input_size - in_pos < 2) {
+      return false;
+    }
+    const std::size_t offset = input[in_pos] | (input[in_pos + 1] << 8);
+    in_pos += 2;
+    std::size_t match_length = token & 15;
+    if (match_length == 15 && !read_length(match_length)) {
+      return false;
+    }
+    match_length += min_match;
+    if (offset == 0 || offset > out_pos || match_length > size - out_pos) {
+      return false;
+    }
+    // source and destination may overlap
+    for (std::size_t i = 0; i < match_length; ++i, ++out_pos) {
+      output[out_pos] = output[out_pos - offset];
+    }
+  }
+  return false;
+}
+
+}  // namespace MOTION::utils
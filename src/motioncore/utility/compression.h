@@ -0,0 +1,57 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace MOTION::utils {
+
+// Number of bytes required to store num_elements values of bit_size bits each.
+constexpr std::size_t packed_size(std::size_t num_elements, std::size_t bit_size) {
+  return (num_elements * bit_size + 7) / 8;
+}
+
+// Store the lowest bit_size bits of each element back to back.  The output
+// buffer needs to hold packed_size(num_elements, bit_size) bytes.
+template <typename T>
+void pack_bits(const T* input, std::size_t num_elements, std::size_t bit_size,
+               std::uint8_t* output);
+
+// Inverse of pack_bits, the upper bits of the elements are zero.
+template <typename T>
+void unpack_bits(const std::uint8_t* input, std::size_t num_elements, std::size_t bit_size,
+                 T* output);
+
+// Simple LZ77 byte codec in the spirit of LZ4.  Returns std::nullopt if the
+// data cannot be compressed.
+std::optional<std::vector<std::uint8_t>> lz_compress(const std::uint8_t* input, std::size_t size);
+
+// Decompress exactly size bytes into output.  Returns false if the input is
+// malformed.
+bool lz_decompress(const std::uint8_t* input, std::size_t input_size, std::uint8_t* output,
+                   std::size_t size);
+
+}  // namespace MOTION::utils
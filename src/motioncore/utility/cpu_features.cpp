@@ -0,0 +1,79 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "cpu_features.h"
+
+namespace MOTION {
+
+SimdIsa get_simd_isa() {
+  // the same checks as the resolvers of MOTION_TARGET_CLONES
+  static const SimdIsa isa = [] {
+#if defined(__AVX512F__)
+    return SimdIsa::avx512;
+#elif MOTION_HAVE_MULTIVERSIONING && !defined(__clang__) && __GNUC__ >= 12
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("x86-64-v4")) {
+      return SimdIsa::avx512;
+    } else if (__builtin_cpu_supports("x86-64-v3")) {
+      return SimdIsa::avx2;
+    }
+    return SimdIsa::generic;
+#elif MOTION_HAVE_MULTIVERSIONING
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+      return SimdIsa::avx512;
+    } else if (__builtin_cpu_supports("avx2")) {
+      return SimdIsa::avx2;
+    }
+    return SimdIsa::generic;
+#elif defined(__AVX2__)
+    return SimdIsa::avx2;
+#else
+    return SimdIsa::generic;
+#endif
+  }();
+  return isa;
+}
+
+bool get_vaes_support() {
+#if MOTION_HAVE_MULTIVERSIONING
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("vaes");
+#else
+  return false;
+#endif
+}
+
+std::string_view to_string(SimdIsa isa) {
+  switch (isa) {
+    case SimdIsa::generic:
+      return "generic x86-64";
+    case SimdIsa::avx2:
+      return "AVX2";
+    case SimdIsa::avx512:
+      return "AVX-512";
+  }
+  return "unknown";
+}
+
+}  // namespace MOTION
@@ -0,0 +1,67 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#pragma once
+
+#include <string_view>
+
+// Hot kernels are compiled in several variants, and the dynamic loader picks
+// the best one for the CPU at startup (via ifunc), so that a generic x86-64
+// build still uses AVX2 or AVX-512 where available.
+//
+// MOTION_TARGET_CLONES lets the compiler vectorize plain loops for each ISA
+// level.  Kernels written with intrinsics are instead declared several times
+// with MOTION_TARGET_DEFAULT and MOTION_TARGET(...) (function multiversioning).
+#if defined(__GNUC__) && defined(__x86_64__)
+#define MOTION_HAVE_MULTIVERSIONING 1
+#define MOTION_TARGET(isa) __attribute__((target(isa)))
+#define MOTION_TARGET_DEFAULT __attribute__((target("default")))
+#if !defined(__clang__) && __GNUC__ >= 12
+#define MOTION_TARGET_CLONES \
+  __attribute__((target_clones("arch=x86-64-v4", "arch=x86-64-v3", "default")))
+#elif !defined(__clang__)
+#define MOTION_TARGET_CLONES \
+  __attribute__((target_clones("arch=skylake-avx512", "avx2", "default")))
+#else
+#define MOTION_TARGET_CLONES
+#endif
+#else
+#define MOTION_HAVE_MULTIVERSIONING 0
+#define MOTION_TARGET(isa)
+#define MOTION_TARGET_DEFAULT
+#define MOTION_TARGET_CLONES
+#endif
+
+namespace MOTION {
+
+enum class SimdIsa { generic, avx2, avx512 };
+
+// ISA level of the kernel variants chosen on this CPU
+SimdIsa get_simd_isa();
+
+// whether the AES kernels use the vectorized AES instructions (VAES)
+bool get_vaes_support();
+
+std::string_view to_string(SimdIsa);
+
+}  // namespace MOTION
@@ -98,6 +98,15 @@ void decode(F* dst, const I* src, std::size_t fractional_bits, std::size_t n) {
 }
 
 // Truncation protocol by Mohassel and Zhang (https://eprint.iacr.org/2017/396).
+template <typename T>
+T truncate_shared(T x, std::size_t fractional_bits, bool party_0) {
+  if (party_0) {
+    return x >> fractional_bits;
+  } else {
+    return -((-x) >> fractional_bits);
+  }
+}
+
 template <typename T>
 void truncate_shared(T* buffer, std::size_t fractional_bits, std::size_t n, bool party_0) {
   if (party_0) {
@@ -28,6 +28,7 @@
 #include <thread>
 
 #include "condition.h"
+#include "cpu_features.h"
 
 namespace MOTION::Helpers {
 
@@ -55,6 +56,28 @@ std::string ToString(MPCProtocol p) {
 
 namespace Compare {}  // namespace Compare
 
+#define MOTION_DEFINE_ARRAY_OP(NAME, OP, T)                                               \
+  MOTION_TARGET_CLONES static void NAME##Impl(const T* a, const T* b, T* result,         \
+                                              std::size_t n) {                           \
+    for (std::size_t j = 0; j < n; ++j) {                                                \
+      result[j] = a[j] OP b[j];                                                          \
+    }                                                                                    \
+  }                                                                                      \
+  void NAME(const T* a, const T* b, T* result, std::size_t n) { NAME##Impl(a, b, result, n); }
+
+#define MOTION_DEFINE_ARRAY_OPS(T)       \
+  MOTION_DEFINE_ARRAY_OP(AddArrays, +, T) \
+  MOTION_DEFINE_ARRAY_OP(SubArrays, -, T) \
+  MOTION_DEFINE_ARRAY_OP(MulArrays, *, T)
+
+MOTION_DEFINE_ARRAY_OPS(std::uint8_t)
+MOTION_DEFINE_ARRAY_OPS(std::uint16_t)
+MOTION_DEFINE_ARRAY_OPS(std::uint32_t)
+MOTION_DEFINE_ARRAY_OPS(std::uint64_t)
+
+#undef MOTION_DEFINE_ARRAY_OPS
+#undef MOTION_DEFINE_ARRAY_OP
+
 std::size_t DivideAndCeil(std::size_t dividend, std::size_t divisor) {
   assert(divisor != 0);
   return 1 + ((dividend - 1) / divisor);
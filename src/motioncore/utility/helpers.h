@@ -69,6 +69,53 @@ inline std::vector<T> FromByteVector(const flatbuffers::Vector<std::uint8_t> &bu
   return result;
 }
 
+// Element-wise arithmetic modulo 2^k on arrays of length n.  The overloads for
+// the native integer types are compiled for several ISAs in helpers.cpp and
+// dispatched at load time (see utility/cpu_features.h).  result may alias a or b.
+void AddArrays(const std::uint8_t *a, const std::uint8_t *b, std::uint8_t *result, std::size_t n);
+void AddArrays(const std::uint16_t *a, const std::uint16_t *b, std::uint16_t *result,
+               std::size_t n);
+void AddArrays(const std::uint32_t *a, const std::uint32_t *b, std::uint32_t *result,
+               std::size_t n);
+void AddArrays(const std::uint64_t *a, const std::uint64_t *b, std::uint64_t *result,
+               std::size_t n);
+void SubArrays(const std::uint8_t *a, const std::uint8_t *b, std::uint8_t *result, std::size_t n);
+void SubArrays(const std::uint16_t *a, const std::uint16_t *b, std::uint16_t *result,
+               std::size_t n);
+void SubArrays(const std::uint32_t *a, const std::uint32_t *b, std::uint32_t *result,
+               std::size_t n);
+void SubArrays(const std::uint64_t *a, const std::uint64_t *b, std::uint64_t *result,
+               std::size_t n);
+void MulArrays(const std::uint8_t *a, const std::uint8_t *b, std::uint8_t *result, std::size_t n);
+void MulArrays(const std::uint16_t *a, const std::uint16_t *b, std::uint16_t *result,
+               std::size_t n);
+void MulArrays(const std::uint32_t *a, const std::uint32_t *b, std::uint32_t *result,
+               std::size_t n);
+void MulArrays(const std::uint64_t *a, const std::uint64_t *b, std::uint64_t *result,
+               std::size_t n);
+
+// fallbacks for other types, e.g., __uint128_t
+template <typename T>
+inline void AddArrays(const T *a, const T *b, T *result, std::size_t n) {
+  for (std::size_t j = 0; j < n; ++j) {
+    result[j] = a[j] + b[j];
+  }
+}
+
+template <typename T>
+inline void SubArrays(const T *a, const T *b, T *result, std::size_t n) {
+  for (std::size_t j = 0; j < n; ++j) {
+    result[j] = a[j] - b[j];
+  }
+}
+
+template <typename T>
+inline void MulArrays(const T *a, const T *b, T *result, std::size_t n) {
+  for (std::size_t j = 0; j < n; ++j) {
+    result[j] = a[j] * b[j];
+  }
+}
+
 template <typename T>
 inline std::vector<T> AddVectors(std::vector<std::vector<T>> &vectors) {
   if (vectors.size() == 0) {
@@ -80,9 +127,7 @@ inline std::vector<T> AddVectors(std::vector<std::vector<T>> &vectors) {
   for (auto i = 1ull; i < vectors.size(); ++i) {
     auto &v = vectors.at(i);
     assert(v.size() == result.size());  // expect the vectors to be of the same size
-    for (auto j = 0ull; j < result.size(); ++j) {
-      result.at(j) += v.at(j);  // TODO: implement using AVX2 and AVX512
-    }
+    AddArrays(result.data(), v.data(), result.data(), result.size());
   }
   return result;
 }
@@ -98,11 +143,8 @@ inline std::vector<T> AddVectors(const std::vector<T> &a, const std::vector<T> &
   if (a.size() == 0) {
     return {};
   }  // if empty input vector
-  std::vector<T> result = a;
-#pragma omp simd
-  for (auto j = 0ull; j < result.size(); ++j) {
-    result.at(j) += b.at(j);  // TODO: implement using AVX2 and AVX512
-  }
+  std::vector<T> result(a.size());
+  AddArrays(a.data(), b.data(), result.data(), result.size());
   return result;
 }
 
@@ -113,11 +155,7 @@ inline std::vector<T> RestrictAddVectors(const std::vector<T> &a, const std::vec
     return {};
   }  // if empty input vector
   std::vector<T> result(a.size());
-  const T *__restrict__ a_ptr{a.data()};
-  const T *__restrict__ b_ptr{b.data()};
-  T *__restrict__ r_ptr{result.data()};
-  std::transform(a_ptr, a_ptr + a.size(), b_ptr, r_ptr,
-                 [](const T &a_var, const T &b_var) { return a_var + b_var; });
+  AddArrays(a.data(), b.data(), result.data(), result.size());
   return result;
 }
 
@@ -128,11 +166,7 @@ inline std::vector<T> RestrictMulVectors(const std::vector<T> &a, const std::vec
     return {};
   }  // if empty input vector
   std::vector<T> result(a.size());
-  const T *__restrict__ a_ptr{a.data()};
-  const T *__restrict__ b_ptr{b.data()};
-  T *__restrict__ r_ptr{result.data()};
-  std::transform(a_ptr, a_ptr + a.size(), b_ptr, r_ptr,
-                 [](const T &a_var, const T &b_var) { return a_var * b_var; });
+  MulArrays(a.data(), b.data(), result.data(), result.size());
   return result;
 }
 
@@ -143,11 +177,7 @@ inline std::vector<T> RestrictSubVectors(const std::vector<T> &a, const std::vec
     return {};
   }  // if empty input vector
   std::vector<T> result(a.size());
-  const T *__restrict__ a_ptr{a.data()};
-  const T *__restrict__ b_ptr{b.data()};
-  T *__restrict__ r_ptr{result.data()};
-  std::transform(a_ptr, a_ptr + a.size(), b_ptr, r_ptr,
-                 [](const T &a_var, const T &b_var) { return a_var - b_var; });
+  SubArrays(a.data(), b.data(), result.data(), result.size());
   return result;
 }
 
@@ -157,10 +187,8 @@ inline std::vector<T> SubVectors(const std::vector<T> &a, const std::vector<T> &
   if (a.size() == 0) {
     return {};
   }  // if empty input vector
-  std::vector<T> result = a;
-  for (auto j = 0ull; j < result.size(); ++j) {
-    result.at(j) -= b.at(j);  // TODO: implement using AVX2 and AVX512
-  }
+  std::vector<T> result(a.size());
+  SubArrays(a.data(), b.data(), result.data(), result.size());
   return result;
 }
 
@@ -243,11 +271,8 @@ inline std::vector<T> MultiplyVectors(std::vector<T> a, std::vector<T> b) {
   if (a.size() == 0) {
     return {};
   }  // if empty input vector
-  std::vector<T> result = a;
-
-  for (auto j = 0ull; j < result.size(); ++j) {
-    result.at(j) *= b.at(j);  // TODO: implement using AVX2 and AVX512
-  }
+  std::vector<T> result(a.size());
+  MulArrays(a.data(), b.data(), result.data(), result.size());
   return result;
 }
 
@@ -45,6 +45,7 @@
 #include <ctime>
 
 #include "utility/constants.h"
+#include "utility/cpu_features.h"
 
 namespace logging = boost::log;
 namespace keywords = boost::log::keywords;
@@ -85,6 +86,9 @@ Logger::Logger(std::size_t my_id, boost::log::trivial::severity_level severity_l
   logging::core::get()->set_filter(logging::trivial::severity >= severity_level);
   logging::add_common_attributes();
   logger_ = std::make_unique<logger_type>(keywords::channel = my_id);
+
+  LogInfo(fmt::format("SIMD kernels: {}{}", to_string(get_simd_isa()),
+                      get_vaes_support() ? ", AES with VAES" : ""));
 }
 
 Logger::~Logger() {
@@ -50,16 +50,16 @@ class ReusableSharedState {
     }
   }
 
-  // set value
-  template <typename Arg>
-  void set(Arg&& arg) {
+  // set value, constructed from the given arguments
+  template <typename... Args>
+  void set(Args&&... args) {
     {
       std::scoped_lock lock(mutex_);
       if (contains_value_) {
         throw std::future_error(std::future_errc::promise_already_satisfied);
       }
-      // construct R from argument in the allocated value_storage
-      new (&value_storage_) R(std::forward<Arg>(arg));
+      // construct R from arguments in the allocated value_storage
+      new (&value_storage_) R(std::forward<Args>(args)...);
       contains_value_ = true;
     }
     cv_.notify_all();
@@ -235,6 +235,15 @@ class ReusablePromise {
     shared_state_->set(std::move(value));
   }
 
+  // construct the value directly in the shared state
+  template <typename... Args>
+  void emplace_value(Args&&... args) {
+    if (!shared_state_) {
+      throw std::future_error(std::future_errc::no_state);
+    }
+    shared_state_->set(std::forward<Args>(args)...);
+  }
+
   // returns future associated with the shared state of the promise
   ReusableFuture<R, MutexType, CVType> get_future() {
     if (!shared_state_) {
@@ -0,0 +1,254 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "share_file.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <fmt/format.h>
+
+#include "utility/type_traits.hpp"
+
+namespace MOTION {
+
+namespace {
+
+// FNV-1a over 64 bit words, the trailing bytes are hashed separately.
+class Checksum {
+ public:
+  void update(const std::byte* data, std::size_t size) {
+    const auto num_words = size / sizeof(std::uint64_t);
+    for (std::size_t i = 0; i < num_words; ++i) {
+      std::uint64_t word;
+      std::memcpy(&word, data + i * sizeof(std::uint64_t), sizeof(word));
+      hash_ = (hash_ ^ word) * kPrime;
+    }
+    for (std::size_t i = num_words * sizeof(std::uint64_t); i < size; ++i) {
+      hash_ = (hash_ ^ std::to_integer<std::uint64_t>(data[i])) * kPrime;
+    }
+  }
+  std::uint64_t get() const noexcept { return hash_; }
+
+ private:
+  static constexpr std::uint64_t kOffsetBasis = 0xcbf29ce484222325;
+  static constexpr std::uint64_t kPrime = 0x100000001b3;
+  std::uint64_t hash_ = kOffsetBasis;
+};
+
+std::uint64_t compute_checksum(ShareFileHeader header, const std::byte* payload,
+                               std::size_t payload_size) {
+  header.checksum_ = 0;
+  Checksum checksum;
+  checksum.update(reinterpret_cast<const std::byte*>(&header), sizeof(header));
+  checksum.update(payload, payload_size);
+  return checksum.get();
+}
+
+}  // namespace
+
+template <typename T>
+void write_share_file(const std::string& path, std::size_t party_id, std::size_t fractional_bits,
+                      std::size_t rows, std::size_t cols, std::span<const T> public_shares,
+                      std::span<const T> secret_shares) {
+  static_assert(std::is_unsigned_v<T>);
+  const auto num_elements = rows * cols;
+  if (public_shares.size() != num_elements || secret_shares.size() != num_elements) {
+    throw std::invalid_argument(
+        fmt::format("write_share_file: expected {} shares, got {} public and {} secret shares",
+                    num_elements, public_shares.size(), secret_shares.size()));
+  }
+
+  ShareFileHeader header;
+  header.magic_ = ShareFileHeader::kMagic;
+  header.version_ = ShareFileHeader::kVersion;
+  header.party_id_ = party_id;
+  header.bit_size_ = ENCRYPTO::bit_size_v<T>;
+  header.fractional_bits_ = fractional_bits;
+  header.rows_ = rows;
+  header.cols_ = cols;
+  header.checksum_ = 0;
+  Checksum checksum;
+  checksum.update(reinterpret_cast<const std::byte*>(&header), sizeof(header));
+  checksum.update(reinterpret_cast<const std::byte*>(public_shares.data()),
+                  public_shares.size_bytes());
+  checksum.update(reinterpret_cast<const std::byte*>(secret_shares.data()),
+                  secret_shares.size_bytes());
+  header.checksum_ = checksum.get();
+
+  std::ofstream file(path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+  if (!file) {
+    throw std::runtime_error(fmt::format("write_share_file: unable to open {}", path));
+  }
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(public_shares.data()), public_shares.size_bytes());
+  file.write(reinterpret_cast<const char*>(secret_shares.data()), secret_shares.size_bytes());
+  file.close();
+  if (!file) {
+    throw std::runtime_error(fmt::format("write_share_file: error while writing {}", path));
+  }
+}
+
+template void write_share_file<std::uint32_t>(const std::string&, std::size_t, std::size_t,
+                                              std::size_t, std::size_t,
+                                              std::span<const std::uint32_t>,
+                                              std::span<const std::uint32_t>);
+template void write_share_file<std::uint64_t>(const std::string&, std::size_t, std::size_t,
+                                              std::size_t, std::size_t,
+                                              std::span<const std::uint64_t>,
+                                              std::span<const std::uint64_t>);
+
+MappedShareFile::MappedShareFile(const std::string& path) : data_(MAP_FAILED), size_(0) {
+  int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd == -1) {
+    throw std::runtime_error(fmt::format("MappedShareFile: unable to open {}", path));
+  }
+  struct stat st;
+  if (::fstat(fd, &st) == -1) {
+    ::close(fd);
+    throw std::runtime_error(fmt::format("MappedShareFile: unable to stat {}", path));
+  }
+  size_ = st.st_size;
+  if (size_ < sizeof(ShareFileHeader)) {
+    ::close(fd);
+    throw std::runtime_error(fmt::format("MappedShareFile: {} is too small", path));
+  }
+  data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data_ == MAP_FAILED) {
+    throw std::runtime_error(fmt::format("MappedShareFile: unable to map {}", path));
+  }
+  // the shares are read sequentially
+  ::madvise(data_, size_, MADV_SEQUENTIAL);
+
+  header_ = reinterpret_cast<const ShareFileHeader*>(data_);
+  payload_ = reinterpret_cast<const std::byte*>(data_) + sizeof(ShareFileHeader);
+  const auto fail = [this, &path](const std::string& reason) {
+    ::munmap(data_, size_);
+    throw std::runtime_error(fmt::format("MappedShareFile: {}: {}", path, reason));
+  };
+  if (header_->magic_ != ShareFileHeader::kMagic) {
+    fail("not a share file");
+  }
+  if (header_->version_ != ShareFileHeader::kVersion) {
+    fail(fmt::format("unsupported version {}", header_->version_));
+  }
+  if (header_->bit_size_ != 32 && header_->bit_size_ != 64) {
+    fail(fmt::format("unsupported bit size {}", header_->bit_size_));
+  }
+  const auto payload_size = 2 * get_num_elements() * (header_->bit_size_ / 8);
+  if (size_ != sizeof(ShareFileHeader) + payload_size) {
+    fail(fmt::format("expected {} bytes of shares, got {}", payload_size,
+                     size_ - sizeof(ShareFileHeader)));
+  }
+  if (compute_checksum(*header_, payload_, payload_size) != header_->checksum_) {
+    fail("checksum mismatch");
+  }
+}
+
+MappedShareFile::~MappedShareFile() { ::munmap(data_, size_); }
+
+template <typename T>
+void MappedShareFile::check_bit_size() const {
+  if (header_->bit_size_ != ENCRYPTO::bit_size_v<T>) {
+    throw std::logic_error(fmt::format("MappedShareFile: file contains {} bit shares, requested {}",
+                                       header_->bit_size_, ENCRYPTO::bit_size_v<T>));
+  }
+}
+
+template <typename T>
+std::span<const T> MappedShareFile::get_public_shares() const {
+  check_bit_size<T>();
+  return {reinterpret_cast<const T*>(payload_), get_num_elements()};
+}
+
+template <typename T>
+std::span<const T> MappedShareFile::get_secret_shares() const {
+  check_bit_size<T>();
+  return {reinterpret_cast<const T*>(payload_) + get_num_elements(), get_num_elements()};
+}
+
+template std::span<const std::uint32_t> MappedShareFile::get_public_shares() const;
+template std::span<const std::uint64_t> MappedShareFile::get_public_shares() const;
+template std::span<const std::uint32_t> MappedShareFile::get_secret_shares() const;
+template std::span<const std::uint64_t> MappedShareFile::get_secret_shares() const;
+
+bool MappedShareFile::is_share_file(const std::string& path) {
+  std::ifstream file(path, std::ios_base::in | std::ios_base::binary);
+  std::array<char, 8> magic;
+  if (!file.read(magic.data(), magic.size())) {
+    return false;
+  }
+  return magic == ShareFileHeader::kMagic;
+}
+
+template <typename T>
+ShareFileContents<T> read_share_file(const std::string& path) {
+  ShareFileContents<T> contents;
+  if (MappedShareFile::is_share_file(path)) {
+    MappedShareFile file(path);
+    const auto& header = file.get_header();
+    contents.party_id_ = header.party_id_;
+    contents.fractional_bits_ = header.fractional_bits_;
+    contents.rows_ = header.rows_;
+    contents.cols_ = header.cols_;
+    const auto public_shares = file.template get_public_shares<T>();
+    const auto secret_shares = file.template get_secret_shares<T>();
+    contents.public_shares_.assign(std::begin(public_shares), std::end(public_shares));
+    contents.secret_shares_.assign(std::begin(secret_shares), std::end(secret_shares));
+    return contents;
+  }
+
+  std::ifstream file(path);
+  if (!file) {
+    throw std::runtime_error(fmt::format("read_share_file: unable to open {}", path));
+  }
+  contents.party_id_ = 0;
+  contents.fractional_bits_ = 0;
+  if (!(file >> contents.rows_ >> contents.cols_)) {
+    throw std::runtime_error(
+        fmt::format("read_share_file: unable to read dimensions from {}", path));
+  }
+  const auto num_elements = contents.rows_ * contents.cols_;
+  contents.public_shares_.resize(num_elements);
+  contents.secret_shares_.resize(num_elements);
+  for (std::size_t i = 0; i < num_elements; ++i) {
+    if (!(file >> contents.public_shares_[i] >> contents.secret_shares_[i])) {
+      throw std::runtime_error(
+          fmt::format("read_share_file: {} contains less than {} shares", path, num_elements));
+    }
+  }
+  return contents;
+}
+
+template ShareFileContents<std::uint32_t> read_share_file(const std::string&);
+template ShareFileContents<std::uint64_t> read_share_file(const std::string&);
+
+}  // namespace MOTION
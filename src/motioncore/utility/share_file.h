@@ -0,0 +1,111 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace MOTION {
+
+// Binary container for the BEAVY shares of a matrix.  The file consists of a
+// ShareFileHeader followed by the rows * cols public shares (Delta) and then
+// the rows * cols secret shares (delta), each stored as little-endian
+// integers of bit_size_ bits in row-major order.
+struct ShareFileHeader {
+  static constexpr std::array<char, 8> kMagic = {'M', 'O', 'T', 'I', 'O', 'N', 'S', 'H'};
+  static constexpr std::uint32_t kVersion = 1;
+
+  std::array<char, 8> magic_;
+  std::uint32_t version_;
+  std::uint32_t party_id_;
+  std::uint32_t bit_size_;
+  std::uint32_t fractional_bits_;
+  std::uint64_t rows_;
+  std::uint64_t cols_;
+  // checksum over the header (with checksum_ = 0) and the payload
+  std::uint64_t checksum_;
+};
+static_assert(sizeof(ShareFileHeader) == 48);
+
+// Shares read from a share file, see read_share_file.
+template <typename T>
+struct ShareFileContents {
+  std::size_t party_id_;
+  std::size_t fractional_bits_;
+  std::size_t rows_;
+  std::size_t cols_;
+  std::vector<T> public_shares_;
+  std::vector<T> secret_shares_;
+};
+
+// Writes the shares as binary share file.  Throws std::runtime_error on failure.
+template <typename T>
+void write_share_file(const std::string& path, std::size_t party_id, std::size_t fractional_bits,
+                      std::size_t rows, std::size_t cols, std::span<const T> public_shares,
+                      std::span<const T> secret_shares);
+
+// Read-only memory mapping of a binary share file.  The header and the
+// checksum are verified on construction, a std::runtime_error is thrown if
+// the file is not a valid share file.
+class MappedShareFile {
+ public:
+  explicit MappedShareFile(const std::string& path);
+  ~MappedShareFile();
+  MappedShareFile(const MappedShareFile&) = delete;
+  MappedShareFile& operator=(const MappedShareFile&) = delete;
+
+  const ShareFileHeader& get_header() const noexcept { return *header_; }
+  std::size_t get_num_elements() const noexcept { return header_->rows_ * header_->cols_; }
+
+  // Views into the mapping, valid as long as this object lives.  T must match
+  // the bit size stored in the header.
+  template <typename T>
+  std::span<const T> get_public_shares() const;
+  template <typename T>
+  std::span<const T> get_secret_shares() const;
+
+  // Check whether the file starts with the share file magic.
+  static bool is_share_file(const std::string& path);
+
+ private:
+  template <typename T>
+  void check_bit_size() const;
+
+  void* data_;
+  std::size_t size_;
+  const ShareFileHeader* header_;
+  const std::byte* payload_;
+};
+
+// Reads shares from a binary share file or, for files which do not start with
+// the magic, from the legacy text format "<rows> <cols>" followed by one
+// "<Delta> <delta>" pair per element.  Text files carry no party id and
+// number of fractional bits, these are set to 0.
+template <typename T>
+ShareFileContents<T> read_share_file(const std::string& path);
+
+}  // namespace MOTION
@@ -24,6 +24,7 @@
 
 #include <boost/fiber/condition_variable.hpp>
 #include <boost/fiber/mutex.hpp>
+#include <chrono>
 #include <future>
 #include <iostream>
 #include <mutex>
@@ -39,8 +40,9 @@ namespace ENCRYPTO {
  * such that items can be enqueued/dequeued by different threads.  The queue
  * can be customized with different synchronization primitives, e.g.,
  * std::mutex and fibers::mutex, via template parameters.  Elements can be
- * dequeued one-by-one (dequeue) or all at once (batch_dequeue).  The queue can
- * be closed which signals consumers that no further elements will be inserted.
+ * dequeued one-by-one (dequeue) or all at once (batch_dequeue,
+ * batch_dequeue_for).  The queue can be closed which signals consumers that no
+ * further elements will be inserted.
  * Dequeue operations return std::nullopt if the queue is closed and empty.
  */
 template <typename T, typename MutexType, typename CVType>
@@ -150,6 +152,26 @@ class BasicSynchronizedQueue {
     return std::optional<std::queue<T>>(std::move(output));
   }
 
+  /**
+   * Extract all elements of the queue, waiting at most the given time for new
+   * elements if it is empty.  Returns std::nullopt if no element arrived.
+   */
+  template <typename Rep, typename Period>
+  std::optional<std::queue<T>> batch_dequeue_for(
+      const std::chrono::duration<Rep, Period>& timeout) noexcept {
+    std::queue<T> output;
+    std::unique_lock lock(mutex_);
+    if (queue_.empty() && !closed_ && timeout.count() > 0) {
+      cv_.wait_for(lock, timeout, [this] { return !this->queue_.empty() || this->closed_; });
+    }
+    if (queue_.empty()) {
+      return std::nullopt;
+    }
+    std::swap(queue_, output);
+    lock.unlock();
+    return std::optional<std::queue<T>>(std::move(output));
+  }
+
  private:
   bool closed_ = false;
   std::queue<T> queue_;
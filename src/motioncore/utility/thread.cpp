@@ -19,8 +19,10 @@
 // IN THE SOFTWARE.
 
 #include <pthread.h>
+#include <sched.h>
 #include <cassert>
 #include <string>
+#include <system_error>
 #include <thread>
 #include "thread.h"
 
@@ -32,4 +34,14 @@ void thread_set_name(std::thread& thread, const std::string& name) {
   pthread_setname_np(handle, name.c_str());
 }
 
+void thread_set_affinity(std::thread& thread, int cpu) {
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  CPU_SET(cpu, &cpu_set);
+  auto handle = thread.native_handle();
+  if (int error = pthread_setaffinity_np(handle, sizeof(cpu_set), &cpu_set); error != 0) {
+    throw std::system_error(error, std::generic_category(), "pthread_setaffinity_np");
+  }
+}
+
 }  // namespace ENCRYPTO
@@ -29,4 +29,7 @@ namespace ENCRYPTO {
 // - name.size() <= 16
 void thread_set_name(std::thread& thread, const std::string& name);
 
+// Pins a given thread to a CPU using pthread_setaffinity_np.
+void thread_set_affinity(std::thread& thread, int cpu);
+
 }  // namespace ENCRYPTO
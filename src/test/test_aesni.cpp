@@ -130,6 +130,39 @@ TEST(aesni128, ctr_stream_blockwise) {
   EXPECT_EQ(output, expected_output);
 }
 
+TEST(aesni128, ctr_stream_long) {
+  // long enough streams to take the wide batches if the CPU supports VAES
+  std::array<std::uint8_t, aes_key_size_128> key = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  alignas(aes_block_size) std::array<std::uint8_t, aes_round_keys_size_128> round_keys;
+  std::copy(std::begin(key), std::end(key), std::begin(round_keys));
+  aesni_key_expansion_128(round_keys.data());
+
+  constexpr std::size_t max_num_blocks = 71;
+  alignas(aes_block_size) std::array<std::uint8_t, max_num_blocks * aes_block_size> output;
+  std::array<std::uint8_t, (max_num_blocks + 1) * aes_block_size> output_unaligned;
+  std::array<std::uint8_t, max_num_blocks * aes_block_size> expected_output;
+  std::uint64_t counter = 42;
+  for (size_t i = 0; i < max_num_blocks; ++i) {
+    aesni_ctr_stream_single_block_128_unaligned(round_keys.data(), &counter,
+                                                expected_output.data() + i * aes_block_size);
+  }
+  for (size_t n : {15, 16, 17, 32, 63, 64, 71}) {
+    counter = 42;
+    aesni_ctr_stream_blocks_128(round_keys.data(), &counter, output.data(), n);
+    EXPECT_EQ(counter, 42 + n);
+    EXPECT_TRUE(std::equal(std::begin(output), std::begin(output) + n * aes_block_size,
+                           std::begin(expected_output)));
+    counter = 42;
+    aesni_ctr_stream_blocks_128_unaligned(round_keys.data(), &counter, output_unaligned.data() + 1,
+                                          n);
+    EXPECT_EQ(counter, 42 + n);
+    EXPECT_TRUE(std::equal(std::begin(output_unaligned) + 1,
+                           std::begin(output_unaligned) + 1 + n * aes_block_size,
+                           std::begin(expected_output)));
+  }
+}
+
 TEST(aesni128, tmmo_batch_4) {
   std::array<std::uint8_t, aes_key_size_128> key = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
                                                     0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
@@ -172,3 +205,37 @@ TEST(aesni128, mmo_single) {
   aesni_mmo_single(round_keys.data(), output.data());
   EXPECT_EQ(output, expected_output);
 }
+
+TEST(aesni128, ggm_expand) {
+  std::array<std::uint8_t, aes_key_size_128> key = {0x2b, 0x7e, 0x15, 0x16, 0x28, 0xae, 0xd2, 0xa6,
+                                                    0xab, 0xf7, 0x15, 0x88, 0x09, 0xcf, 0x4f, 0x3c};
+  alignas(aes_block_size) std::array<std::uint8_t, aes_round_keys_size_128> round_keys_0;
+  alignas(aes_block_size) std::array<std::uint8_t, aes_round_keys_size_128> round_keys_1;
+  std::copy(std::begin(key), std::end(key), std::begin(round_keys_0));
+  key[0] ^= 1;
+  std::copy(std::begin(key), std::end(key), std::begin(round_keys_1));
+  aesni_key_expansion_128(round_keys_0.data());
+  aesni_key_expansion_128(round_keys_1.data());
+
+  // cover both the batched and the remaining parents
+  constexpr std::size_t num_parents = 7;
+  alignas(aes_block_size) std::array<std::uint8_t, num_parents * aes_block_size> parents;
+  for (std::size_t i = 0; i < parents.size(); ++i) {
+    parents[i] = static_cast<std::uint8_t>(3 * i + 1);
+  }
+  alignas(aes_block_size) std::array<std::uint8_t, 2 * num_parents * aes_block_size> children;
+  aesni_ggm_expand(round_keys_0.data(), round_keys_1.data(), parents.data(), children.data(),
+                   num_parents);
+
+  for (std::size_t i = 0; i < num_parents; ++i) {
+    alignas(aes_block_size) std::array<std::uint8_t, aes_block_size> left, right;
+    std::copy_n(std::begin(parents) + i * aes_block_size, aes_block_size, std::begin(left));
+    right = left;
+    aesni_mmo_single(round_keys_0.data(), left.data());
+    aesni_mmo_single(round_keys_1.data(), right.data());
+    EXPECT_TRUE(std::equal(std::begin(left), std::end(left),
+                           std::begin(children) + 2 * i * aes_block_size));
+    EXPECT_TRUE(std::equal(std::begin(right), std::end(right),
+                           std::begin(children) + (2 * i + 1) * aes_block_size));
+  }
+}
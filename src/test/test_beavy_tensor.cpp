@@ -21,6 +21,8 @@
 // SOFTWARE.
 
 #include <array>
+#include <filesystem>
+#include <future>
 #include <iterator>
 #include <memory>
 
@@ -28,6 +30,7 @@
 
 #include "algorithm/circuit_loader.h"
 #include "base/gate_register.h"
+#include "base/two_party_tensor_backend.h"
 #include "communication/communication_layer.h"
 #include "crypto/arithmetic_provider.h"
 #include "crypto/base_ots/base_ot_provider.h"
@@ -37,9 +40,11 @@
 #include "protocols/beavy/beavy_provider.h"
 #include "protocols/beavy/tensor.h"
 #include "statistics/run_time_stats.h"
+#include "tensor/tensor_op_factory.h"
 #include "utility/helpers.h"
 #include "utility/linear_algebra.h"
 #include "utility/logger.h"
+#include "utility/share_file.h"
 
 using namespace MOTION::proto::beavy;
 
@@ -101,6 +106,24 @@ class BEAVYTensorTest : public ::testing::Test {
     std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
   }
 
+  // prepare the gates for another evaluation and run the OT extension again
+  void clear_and_rerun_ot_setup() {
+    std::vector<std::future<void>> futs;
+    for (std::size_t i = 0; i < 2; ++i) {
+      futs.emplace_back(std::async(std::launch::async, [this, i] {
+        gate_registers_[i]->clear();
+        ot_provider_managers_[i]->clear();
+        motion_base_providers_[i]->advance_epoch();
+        auto f = std::async(std::launch::async, [this, i] {
+          ot_provider_managers_[i]->get_provider(1 - i).SendSetup();
+        });
+        ot_provider_managers_[i]->get_provider(1 - i).ReceiveSetup();
+        f.get();
+      }));
+    }
+    std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+  }
+
   void run_gates_setup() {
     auto eval_gates = [this](auto party_id) {
       for (auto& gate : gate_registers_[party_id]->get_gates()) {
@@ -294,6 +317,49 @@ TYPED_TEST(ArithmeticBEAVYTensorTest, OutputSingle) {
   ASSERT_EQ(input_a, output);
 }
 
+TYPED_TEST(ArithmeticBEAVYTensorTest, OutputShareFile) {
+  MOTION::tensor::TensorDimensions dims = {
+      .batch_size_ = 1, .num_channels_ = 1, .height_ = 28, .width_ = 28};
+  const auto input_a = this->generate_inputs(dims);
+  const auto directory = std::filesystem::temp_directory_path() /
+                         ("motiontest_output_shares_" + std::to_string(sizeof(TypeParam)));
+  for (std::size_t i = 0; i < 2; ++i) {
+    std::filesystem::create_directories(directory / ("server" + std::to_string(i)));
+    this->beavy_providers_[i]->set_output_share_directory(directory.string(), 13);
+  }
+
+  auto [input_a_promise, tensor_a_in_0] = this->make_arithmetic_T_tensor_input_my(0, dims);
+  auto tensor_a_in_1 = this->make_arithmetic_T_tensor_input_other(1, dims);
+  this->beavy_providers_[0]->make_arithmetic_tensor_output_other(tensor_a_in_0);
+  auto output_future = this->make_arithmetic_T_tensor_output_my(1, tensor_a_in_1);
+
+  this->run_setup();
+  this->run_gates_setup();
+  input_a_promise.set_value(input_a);
+  this->run_gates_online();
+  ASSERT_EQ(output_future.get(), input_a);
+
+  // each party stores its own shares of the output for the next layer
+  const MOTION::MappedShareFile file_0((directory / "server0/outputshare_0").string());
+  const MOTION::MappedShareFile file_1((directory / "server1/outputshare_1").string());
+  for (const auto* file : {&file_0, &file_1}) {
+    EXPECT_EQ(file->get_header().fractional_bits_, 13);
+    EXPECT_EQ(file->get_header().rows_, dims.get_data_size());
+    EXPECT_EQ(file->get_header().cols_, 1);
+  }
+  EXPECT_EQ(file_0.get_header().party_id_, 0);
+  EXPECT_EQ(file_1.get_header().party_id_, 1);
+  const auto pshare_0 = file_0.get_public_shares<TypeParam>();
+  const auto pshare_1 = file_1.get_public_shares<TypeParam>();
+  const auto sshare_0 = file_0.get_secret_shares<TypeParam>();
+  const auto sshare_1 = file_1.get_secret_shares<TypeParam>();
+  for (std::size_t i = 0; i < input_a.size(); ++i) {
+    ASSERT_EQ(pshare_0[i], pshare_1[i]);
+    ASSERT_EQ(input_a[i], TypeParam(pshare_0[i] - sshare_0[i] - sshare_1[i]));
+  }
+  std::filesystem::remove_all(directory);
+}
+
 TYPED_TEST(ArithmeticBEAVYTensorTest, Convolution) {
   // Convolution from CryptoNets
   const MOTION::tensor::Conv2DOp conv_op = {.kernel_shape_ = {5, 1, 5, 5},
@@ -419,6 +485,82 @@ TYPED_TEST(ArithmeticBEAVYTensorTest, Gemm) {
   ASSERT_EQ(plain_output, expected_output);
 }
 
+TYPED_TEST(ArithmeticBEAVYTensorTest, GemmRepeated) {
+  const MOTION::tensor::GemmOp gemm_op = {
+      .input_A_shape_ = {2, 30}, .input_B_shape_ = {30, 5}, .output_shape_ = {2, 5}};
+  ASSERT_TRUE(gemm_op.verify());
+  const auto input_A_dims = gemm_op.get_input_A_tensor_dims();
+  const auto input_B_dims = gemm_op.get_input_B_tensor_dims();
+  const auto output_dims = gemm_op.get_output_tensor_dims();
+
+  auto [input_A_promise, tensor_input_A_0] =
+      this->make_arithmetic_T_tensor_input_my(0, input_A_dims);
+  auto tensor_input_A_1 = this->make_arithmetic_T_tensor_input_other(1, input_A_dims);
+  auto tensor_input_B_0 = this->make_arithmetic_T_tensor_input_other(0, input_B_dims);
+  auto [input_B_promise, tensor_input_B_1] =
+      this->make_arithmetic_T_tensor_input_my(1, input_B_dims);
+  auto tensor_output_0 =
+      this->beavy_providers_[0]->make_tensor_gemm_op(gemm_op, tensor_input_A_0, tensor_input_B_0);
+  auto tensor_output_1 =
+      this->beavy_providers_[1]->make_tensor_gemm_op(gemm_op, tensor_input_A_1, tensor_input_B_1);
+  const auto output_beavy_tensor_0 =
+      std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(tensor_output_0);
+  const auto output_beavy_tensor_1 =
+      std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(tensor_output_1);
+  // the ReLU gates consume OTs, which need to be set up again in each run
+  auto tensor_relu_output_0 = this->beavy_providers_[0]->make_tensor_relu_op(tensor_output_0);
+  auto tensor_relu_output_1 = this->beavy_providers_[1]->make_tensor_relu_op(tensor_output_1);
+  const auto relu_beavy_tensor_0 =
+      std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(tensor_relu_output_0);
+  const auto relu_beavy_tensor_1 =
+      std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(tensor_relu_output_1);
+  ASSERT_NE(relu_beavy_tensor_0, nullptr);
+  ASSERT_NE(relu_beavy_tensor_1, nullptr);
+
+  this->run_setup();
+  std::vector<TypeParam> previous_secret_share;
+  for (std::size_t run_i = 0; run_i < 3; ++run_i) {
+    if (run_i > 0) {
+      this->clear_and_rerun_ot_setup();
+    }
+    const auto input_A = this->generate_inputs(input_A_dims);
+    const auto input_B = this->generate_inputs(input_B_dims);
+    this->run_gates_setup();
+    input_A_promise.set_value(input_A);
+    input_B_promise.set_value(input_B);
+    this->run_gates_online();
+
+    const auto& public_output_share_0 = output_beavy_tensor_0->get_public_share();
+    const auto& secret_output_share_0 = output_beavy_tensor_0->get_secret_share();
+    const auto& secret_output_share_1 = output_beavy_tensor_1->get_secret_share();
+    ASSERT_EQ(public_output_share_0.size(), output_dims.get_data_size());
+    ASSERT_EQ(public_output_share_0, output_beavy_tensor_1->get_public_share());
+    // each run uses fresh masks
+    ASSERT_NE(secret_output_share_0, previous_secret_share);
+    previous_secret_share = secret_output_share_0;
+
+    const auto expected_output =
+        MOTION::matrix_multiply(gemm_op.input_A_shape_[0], gemm_op.input_A_shape_[1],
+                                gemm_op.input_B_shape_[1], input_A, input_B);
+    const auto plain_output = MOTION::Helpers::SubVectors(
+        public_output_share_0,
+        MOTION::Helpers::AddVectors(secret_output_share_0, secret_output_share_1));
+    ASSERT_EQ(plain_output, expected_output);
+
+    constexpr auto bit_size = ENCRYPTO::bit_size_v<TypeParam>;
+    std::vector<TypeParam> expected_relu_output(expected_output.size());
+    std::transform(std::begin(expected_output), std::end(expected_output),
+                   std::begin(expected_relu_output),
+                   [](auto x) { return (x >> (bit_size - 1)) ? 0 : x; });
+    ASSERT_EQ(relu_beavy_tensor_0->get_public_share(), relu_beavy_tensor_1->get_public_share());
+    const auto plain_relu_output = MOTION::Helpers::SubVectors(
+        relu_beavy_tensor_0->get_public_share(),
+        MOTION::Helpers::AddVectors(relu_beavy_tensor_0->get_secret_share(),
+                                    relu_beavy_tensor_1->get_secret_share()));
+    ASSERT_EQ(plain_relu_output, expected_relu_output);
+  }
+}
+
 TYPED_TEST(ArithmeticBEAVYTensorTest, Sqr) {
   MOTION::tensor::TensorDimensions dims = {
       .batch_size_ = 1, .num_channels_ = 1, .height_ = 28, .width_ = 28};
@@ -466,3 +608,236 @@ TYPED_TEST(ArithmeticBEAVYTensorTest, Sqr) {
       MOTION::Helpers::AddVectors(secret_output_share_0, secret_output_share_1));
   ASSERT_EQ(plain_output, expected_output);
 }
+
+TYPED_TEST(ArithmeticBEAVYTensorTest, Msb) {
+  MOTION::tensor::TensorDimensions dims = {
+      .batch_size_ = 1, .num_channels_ = 1, .height_ = 28, .width_ = 28};
+  const auto input = this->generate_inputs(dims);
+
+  auto [input_promise, tensor_in_0] = this->make_arithmetic_T_tensor_input_my(0, dims);
+  auto tensor_in_1 = this->make_arithmetic_T_tensor_input_other(1, dims);
+
+  auto tensor_out_0 = this->beavy_providers_[0]->make_tensor_msb_op(tensor_in_0);
+  auto tensor_out_1 = this->beavy_providers_[1]->make_tensor_msb_op(tensor_in_1);
+
+  ASSERT_EQ(tensor_out_0->get_dimensions(), dims);
+  ASSERT_EQ(tensor_out_1->get_dimensions(), dims);
+  ASSERT_EQ(tensor_out_0->get_bit_size(), 1);
+
+  this->run_setup();
+  this->run_gates_setup();
+  input_promise.set_value(input);
+  this->run_gates_online();
+
+  const auto tensor_output_0 = std::dynamic_pointer_cast<const BooleanBEAVYTensor>(tensor_out_0);
+  const auto tensor_output_1 = std::dynamic_pointer_cast<const BooleanBEAVYTensor>(tensor_out_1);
+
+  ASSERT_NE(tensor_output_0, nullptr);
+  ASSERT_NE(tensor_output_1, nullptr);
+
+  tensor_output_0->wait_online();
+  tensor_output_1->wait_online();
+
+  const auto& public_output_share_0 = tensor_output_0->get_public_share();
+  const auto& public_output_share_1 = tensor_output_1->get_public_share();
+  ASSERT_EQ(public_output_share_0, public_output_share_1);
+  const auto plain_output = public_output_share_0[0] ^ tensor_output_0->get_secret_share()[0] ^
+                            tensor_output_1->get_secret_share()[0];
+  ASSERT_EQ(plain_output.GetSize(), input.size());
+
+  constexpr auto bit_size = ENCRYPTO::bit_size_v<TypeParam>;
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    ASSERT_EQ(plain_output.Get(i), bool(input[i] >> (bit_size - 1)));
+  }
+}
+
+TYPED_TEST(ArithmeticBEAVYTensorTest, Relu) {
+  MOTION::tensor::TensorDimensions dims = {
+      .batch_size_ = 1, .num_channels_ = 1, .height_ = 28, .width_ = 28};
+  auto input = this->generate_inputs(dims);
+  // include the corner cases
+  input[0] = 0;
+  input[1] = TypeParam(-1);
+  input[2] = TypeParam(-1) >> 1;
+  input[3] = ~(TypeParam(-1) >> 1);
+
+  auto [input_promise, tensor_in_0] = this->make_arithmetic_T_tensor_input_my(0, dims);
+  auto tensor_in_1 = this->make_arithmetic_T_tensor_input_other(1, dims);
+
+  auto tensor_out_0 = this->beavy_providers_[0]->make_tensor_relu_op(tensor_in_0);
+  auto tensor_out_1 = this->beavy_providers_[1]->make_tensor_relu_op(tensor_in_1);
+
+  ASSERT_EQ(tensor_out_0->get_dimensions(), dims);
+  ASSERT_EQ(tensor_out_1->get_dimensions(), dims);
+
+  this->run_setup();
+  this->run_gates_setup();
+  input_promise.set_value(input);
+  this->run_gates_online();
+
+  const auto tensor_output_0 =
+      std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(tensor_out_0);
+  const auto tensor_output_1 =
+      std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<TypeParam>>(tensor_out_1);
+
+  ASSERT_NE(tensor_output_0, nullptr);
+  ASSERT_NE(tensor_output_1, nullptr);
+
+  tensor_output_0->wait_online();
+  tensor_output_1->wait_online();
+
+  const auto& public_output_share_0 = tensor_output_0->get_public_share();
+  const auto& public_output_share_1 = tensor_output_1->get_public_share();
+  const auto& secret_output_share_0 = tensor_output_0->get_secret_share();
+  const auto& secret_output_share_1 = tensor_output_1->get_secret_share();
+  ASSERT_EQ(public_output_share_0, public_output_share_1);
+
+  constexpr auto bit_size = ENCRYPTO::bit_size_v<TypeParam>;
+  std::vector<TypeParam> expected_output(input.size());
+  std::transform(std::begin(input), std::end(input), std::begin(expected_output),
+                 [](auto x) { return (x >> (bit_size - 1)) ? 0 : x; });
+  const auto plain_output = MOTION::Helpers::SubVectors(
+      public_output_share_0,
+      MOTION::Helpers::AddVectors(secret_output_share_0, secret_output_share_1));
+  ASSERT_EQ(plain_output, expected_output);
+}
+
+class TwoPartyTensorBackendTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    comm_layers_ = MOTION::Communication::make_dummy_communication_layers(2);
+    for (std::size_t i = 0; i < 2; ++i) {
+      auto logger =
+          std::make_shared<MOTION::Logger>(i, boost::log::trivial::severity_level::trace);
+      comm_layers_[i]->set_logger(logger);
+      backends_[i] =
+          std::make_unique<MOTION::TwoPartyTensorBackend>(*comm_layers_[i], 2, false, logger);
+    }
+  }
+
+  void TearDown() override {
+    std::vector<std::future<void>> futs;
+    for (std::size_t i = 0; i < 2; ++i) {
+      futs.emplace_back(std::async(std::launch::async, [this, i] { comm_layers_[i]->shutdown(); }));
+    }
+    std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+  }
+
+  MOTION::tensor::TensorOpFactory& get_factory(std::size_t party_id) {
+    return backends_[party_id]->get_tensor_op_factory(MOTION::MPCProtocol::ArithmeticBEAVY);
+  }
+
+  template <typename F>
+  void run_backends(F run) {
+    std::vector<std::future<void>> futs;
+    for (std::size_t i = 0; i < 2; ++i) {
+      futs.emplace_back(std::async(std::launch::async, [this, i, run] { run(*backends_[i]); }));
+    }
+    std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+  }
+
+  std::vector<std::unique_ptr<MOTION::Communication::CommunicationLayer>> comm_layers_;
+  std::array<std::unique_ptr<MOTION::TwoPartyTensorBackend>, 2> backends_;
+};
+
+// Evaluate a network with two independent branches with the dependency driven
+// scheduler of TwoPartyTensorBackend::run_asap.
+TEST_F(TwoPartyTensorBackendTest, RunAsap) {
+  MOTION::tensor::TensorDimensions dims = {
+      .batch_size_ = 1, .num_channels_ = 1, .height_ = 4, .width_ = 4};
+  const auto input_x = MOTION::Helpers::RandomVector<std::uint64_t>(dims.get_data_size());
+  const auto input_y = MOTION::Helpers::RandomVector<std::uint64_t>(dims.get_data_size());
+
+  // x is input by party 0, y by party 1; x^2 and y^2 do not depend on each other
+  std::array<ENCRYPTO::ReusableFiberPromise<MOTION::IntegerValues<std::uint64_t>>, 2> promises;
+  ENCRYPTO::ReusableFiberFuture<MOTION::IntegerValues<std::uint64_t>> output_future;
+  for (std::size_t i = 0; i < 2; ++i) {
+    auto& factory = get_factory(i);
+    MOTION::tensor::TensorCP tensor_x, tensor_y;
+    if (i == 0) {
+      std::tie(promises[i], tensor_x) = factory.make_arithmetic_64_tensor_input_my(dims);
+      tensor_y = factory.make_arithmetic_64_tensor_input_other(dims);
+    } else {
+      tensor_x = factory.make_arithmetic_64_tensor_input_other(dims);
+      std::tie(promises[i], tensor_y) = factory.make_arithmetic_64_tensor_input_my(dims);
+    }
+    auto tensor_xx = factory.make_tensor_sqr_op(tensor_x);
+    auto tensor_yy = factory.make_tensor_sqr_op(tensor_y);
+    auto tensor_sum = factory.make_tensor_add_op(tensor_xx, tensor_yy);
+    if (i == 0) {
+      output_future = factory.make_arithmetic_64_tensor_output_my(tensor_sum);
+    } else {
+      factory.make_arithmetic_tensor_output_other(tensor_sum);
+    }
+  }
+
+  promises[0].set_value(input_x);
+  promises[1].set_value(input_y);
+  run_backends([](auto& backend) { backend.run_asap(); });
+
+  const auto expected_output = MOTION::Helpers::AddVectors(
+      MOTION::Helpers::MultiplyVectors(input_x, input_x),
+      MOTION::Helpers::MultiplyVectors(input_y, input_y));
+  ASSERT_EQ(output_future.get(), expected_output);
+
+  for (std::size_t i = 0; i < 2; ++i) {
+    const auto& stats = backends_[i]->get_run_time_stats();
+    // two inputs, two squares, the sum and the output
+    ASSERT_EQ(stats.gate_timings_.size(), 6);
+    for (const auto& timings : stats.gate_timings_) {
+      EXPECT_LE(timings.online_.first, timings.online_.second);
+    }
+    // at most input -> square -> sum -> output
+    EXPECT_FALSE(stats.critical_path_.empty());
+    EXPECT_LE(stats.critical_path_.size(), 4);
+  }
+}
+
+// With set_release_dead_tensors the buffers of all tensors read by some gate
+// are freed once the last of them is done, without affecting the result.
+TEST_F(TwoPartyTensorBackendTest, ReleaseDeadTensors) {
+  MOTION::tensor::TensorDimensions dims = {
+      .batch_size_ = 1, .num_channels_ = 1, .height_ = 4, .width_ = 4};
+  const auto input = MOTION::Helpers::RandomVector<std::uint64_t>(dims.get_data_size());
+
+  ENCRYPTO::ReusableFiberPromise<MOTION::IntegerValues<std::uint64_t>> input_promise;
+  ENCRYPTO::ReusableFiberFuture<MOTION::IntegerValues<std::uint64_t>> output_future;
+  std::array<std::vector<MOTION::tensor::TensorCP>, 2> tensors;
+  for (std::size_t i = 0; i < 2; ++i) {
+    backends_[i]->set_release_dead_tensors(true);
+    auto& factory = get_factory(i);
+    MOTION::tensor::TensorCP tensor_x;
+    if (i == 0) {
+      std::tie(input_promise, tensor_x) = factory.make_arithmetic_64_tensor_input_my(dims);
+    } else {
+      tensor_x = factory.make_arithmetic_64_tensor_input_other(dims);
+    }
+    // x is read by both the square and the sum
+    auto tensor_xx = factory.make_tensor_sqr_op(tensor_x);
+    auto tensor_sum = factory.make_tensor_add_op(tensor_xx, tensor_x);
+    if (i == 0) {
+      output_future = factory.make_arithmetic_64_tensor_output_my(tensor_sum);
+    } else {
+      factory.make_arithmetic_tensor_output_other(tensor_sum);
+    }
+    tensors[i] = {tensor_x, tensor_xx, tensor_sum};
+  }
+
+  input_promise.set_value(input);
+  run_backends([](auto& backend) { backend.run(); });
+
+  const auto expected_output =
+      MOTION::Helpers::AddVectors(MOTION::Helpers::MultiplyVectors(input, input), input);
+  ASSERT_EQ(output_future.get(), expected_output);
+
+  for (std::size_t i = 0; i < 2; ++i) {
+    for (const auto& tensor : tensors[i]) {
+      const auto beavy_tensor =
+          std::dynamic_pointer_cast<const ArithmeticBEAVYTensor<std::uint64_t>>(tensor);
+      ASSERT_NE(beavy_tensor, nullptr);
+      EXPECT_EQ(beavy_tensor->get_public_share().capacity(), 0);
+      EXPECT_EQ(beavy_tensor->get_secret_share().capacity(), 0);
+    }
+  }
+  EXPECT_THROW(backends_[0]->clear(), std::logic_error);
+}
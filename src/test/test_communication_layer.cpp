@@ -20,11 +20,16 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
+#include <numeric>
+
 #include <gtest/gtest.h>
 #include <boost/log/trivial.hpp>
 
 #include "communication/communication_layer.h"
+#include "communication/message.h"
 #include "communication/message_handler.h"
+#include "protocols/common/comm_mixin.h"
 #include "utility/logger.h"
 
 TEST(CommunicationLayer, Dummy) {
@@ -85,6 +90,132 @@ TEST(CommunicationLayer, Dummy) {
   std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
 }
 
+TEST(CommunicationLayer, Shm) {
+  auto comm_layers = MOTION::Communication::make_local_shm_communication_layers(3);
+  auto& cl_alice = comm_layers.at(0);
+  for (std::size_t party_id = 1; party_id < 3; ++party_id) {
+    comm_layers.at(party_id)->register_fallback_message_handler(
+        [](auto party_id) { return std::make_shared<MOTION::Communication::QueueHandler>(); });
+  }
+  std::for_each(std::begin(comm_layers), std::end(comm_layers), [](auto& cl) { cl->start(); });
+
+  const std::vector<std::uint8_t> message = {0xde, 0xad, 0xbe, 0xef};
+  cl_alice->broadcast_message(message);
+  for (std::size_t party_id = 1; party_id < 3; ++party_id) {
+    auto& qh = dynamic_cast<MOTION::Communication::QueueHandler&>(
+        comm_layers.at(party_id)->get_fallback_message_handler(0));
+    EXPECT_EQ(qh.get_queue().dequeue(), message);
+  }
+
+  std::vector<std::future<void>> futs;
+  for (auto& cl : comm_layers) {
+    futs.emplace_back(std::async(std::launch::async, [&cl] { cl->shutdown(); }));
+  }
+  std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+}
+
+TEST(CommMixin, ChunkedMessages) {
+  auto comm_layers = MOTION::Communication::make_dummy_communication_layers(2);
+  auto log_alice = std::make_shared<MOTION::Logger>(0, boost::log::trivial::severity_level::trace);
+  auto log_bob = std::make_shared<MOTION::Logger>(1, boost::log::trivial::severity_level::trace);
+  comm_layers.at(0)->set_logger(log_alice);
+  comm_layers.at(1)->set_logger(log_bob);
+  MOTION::proto::CommMixin mixin_alice(*comm_layers.at(0),
+                                       MOTION::Communication::MessageType::GMWGate, log_alice);
+  MOTION::proto::CommMixin mixin_bob(*comm_layers.at(1),
+                                     MOTION::Communication::MessageType::GMWGate, log_bob);
+  // 64 B chunks, so that the messages below are split
+  mixin_alice.set_max_chunk_size(70);
+  EXPECT_EQ(mixin_alice.get_max_chunk_size(), 64u);
+
+  std::vector<std::uint64_t> ints(100);
+  std::iota(std::begin(ints), std::end(ints), 42);
+  auto blocks = ENCRYPTO::block128_vector::make_random(50);
+
+  auto ints_future = mixin_bob.register_for_ints_message<std::uint64_t>(0, 1, ints.size());
+  auto blocks_queue = mixin_bob.register_for_blocks_message_chunks(0, 2, blocks.size());
+  std::for_each(std::begin(comm_layers), std::end(comm_layers), [](auto& cl) { cl->start(); });
+
+  mixin_alice.send_ints_message(1, 1, ints);
+  mixin_alice.send_blocks_message(1, 2, blocks);
+  EXPECT_EQ(ints_future.get(), ints);
+
+  ENCRYPTO::block128_vector received_blocks(blocks.size());
+  std::size_t num_chunks = 0;
+  for (std::size_t num_received = 0; num_received < blocks.size(); ++num_chunks) {
+    auto chunk = blocks_queue->dequeue();
+    ASSERT_TRUE(chunk.has_value());
+    ASSERT_LE(chunk->offset_ + chunk->data_.size(), blocks.size());
+    std::copy_n(chunk->data_.data(), chunk->data_.size(),
+                received_blocks.data() + chunk->offset_);
+    num_received += chunk->data_.size();
+  }
+  EXPECT_EQ(num_chunks, 13u);
+  EXPECT_TRUE(std::equal(received_blocks.data(), received_blocks.data() + blocks.size(),
+                         blocks.data()));
+
+  std::vector<std::future<void>> futs;
+  for (auto& cl : comm_layers) {
+    futs.emplace_back(std::async(std::launch::async, [&cl] { cl->shutdown(); }));
+  }
+  std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+}
+
+TEST(CommMixin, EncodedIntsMessages) {
+  auto comm_layers = MOTION::Communication::make_dummy_communication_layers(2);
+  auto log_alice = std::make_shared<MOTION::Logger>(0, boost::log::trivial::severity_level::trace);
+  auto log_bob = std::make_shared<MOTION::Logger>(1, boost::log::trivial::severity_level::trace);
+  comm_layers.at(0)->set_logger(log_alice);
+  comm_layers.at(1)->set_logger(log_bob);
+  MOTION::proto::CommMixin mixin_alice(*comm_layers.at(0),
+                                       MOTION::Communication::MessageType::GMWGate, log_alice);
+  MOTION::proto::CommMixin mixin_bob(*comm_layers.at(1),
+                                     MOTION::Communication::MessageType::GMWGate, log_bob);
+  mixin_alice.set_message_compression(true);
+  mixin_alice.set_max_chunk_size(256);
+
+  // compressible values, and values of which only the lower 20 bits are sent
+  std::vector<std::uint64_t> small_ints(1000);
+  std::iota(std::begin(small_ints), std::end(small_ints), 0);
+  std::vector<std::uint64_t> packed_ints(1000);
+  std::generate(std::begin(packed_ints), std::end(packed_ints),
+                [i = std::uint64_t(1)]() mutable { return i *= 6364136223846793005; });
+  std::vector<std::uint64_t> expected_packed_ints(packed_ints);
+  std::transform(std::begin(packed_ints), std::end(packed_ints), std::begin(expected_packed_ints),
+                 [](auto x) { return x & ((1 << 20) - 1); });
+
+  auto small_future = mixin_bob.register_for_ints_message<std::uint64_t>(0, 1, small_ints.size());
+  auto packed_queue =
+      mixin_bob.register_for_ints_message_chunks<std::uint64_t>(0, 2, packed_ints.size());
+  std::for_each(std::begin(comm_layers), std::end(comm_layers), [](auto& cl) { cl->start(); });
+
+  mixin_alice.send_ints_message(1, 1, small_ints);
+  mixin_alice.send_ints_message(1, 2, packed_ints, 0, 20);
+  EXPECT_EQ(small_future.get(), small_ints);
+
+  std::vector<std::uint64_t> received_packed_ints(packed_ints.size());
+  for (std::size_t num_received = 0; num_received < packed_ints.size();) {
+    auto chunk = packed_queue->dequeue();
+    ASSERT_TRUE(chunk.has_value());
+    ASSERT_LE(chunk->offset_ + chunk->data_.size(), packed_ints.size());
+    std::copy(std::begin(chunk->data_), std::end(chunk->data_),
+              std::begin(received_packed_ints) + chunk->offset_);
+    num_received += chunk->data_.size();
+  }
+  EXPECT_EQ(received_packed_ints, expected_packed_ints);
+
+  const auto stats = mixin_alice.get_message_encoding_statistics();
+  EXPECT_EQ(stats.num_messages_, 2u);
+  EXPECT_EQ(stats.num_raw_bytes_, 2 * 8 * 1000u);
+  EXPECT_LT(stats.num_encoded_bytes_, stats.num_raw_bytes_ / 2);
+
+  std::vector<std::future<void>> futs;
+  for (auto& cl : comm_layers) {
+    futs.emplace_back(std::async(std::launch::async, [&cl] { cl->shutdown(); }));
+  }
+  std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+}
+
 class CommunicationLayerTCP : public testing::TestWithParam<bool> {};
 
 TEST_P(CommunicationLayerTCP, TCP) {
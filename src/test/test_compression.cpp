@@ -0,0 +1,86 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utility/compression.h"
+
+namespace {
+
+TEST(Compression, PackBitsRoundTrip) {
+  std::mt19937_64 rng(42);
+  for (std::size_t bit_size = 1; bit_size <= 64; ++bit_size) {
+    const auto mask = bit_size == 64 ? ~std::uint64_t(0) : (std::uint64_t(1) << bit_size) - 1;
+    std::vector<std::uint64_t> values(123);
+    for (auto& v : values) {
+      v = rng();
+    }
+    std::vector<std::uint8_t> packed(MOTION::utils::packed_size(values.size(), bit_size));
+    MOTION::utils::pack_bits(values.data(), values.size(), bit_size, packed.data());
+    std::vector<std::uint64_t> unpacked(values.size());
+    MOTION::utils::unpack_bits(packed.data(), values.size(), bit_size, unpacked.data());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      EXPECT_EQ(unpacked.at(i), values.at(i) & mask);
+    }
+  }
+}
+
+TEST(Compression, LZRoundTrip) {
+  std::mt19937_64 rng(42);
+  // small values stored in 64 bit words
+  std::vector<std::uint64_t> values(10000);
+  for (auto& v : values) {
+    v = rng() % 1000;
+  }
+  const auto* data = reinterpret_cast<const std::uint8_t*>(values.data());
+  const auto size = sizeof(std::uint64_t) * values.size();
+  auto compressed = MOTION::utils::lz_compress(data, size);
+  ASSERT_TRUE(compressed.has_value());
+  EXPECT_LT(compressed->size(), size / 2);
+
+  std::vector<std::uint64_t> decompressed(values.size());
+  EXPECT_TRUE(MOTION::utils::lz_decompress(compressed->data(), compressed->size(),
+                                           reinterpret_cast<std::uint8_t*>(decompressed.data()),
+                                           size));
+  EXPECT_EQ(decompressed, values);
+  // truncated input
+  EXPECT_FALSE(MOTION::utils::lz_decompress(compressed->data(), compressed->size() - 1,
+                                            reinterpret_cast<std::uint8_t*>(decompressed.data()),
+                                            size));
+}
+
+TEST(Compression, LZRandomData) {
+  std::mt19937_64 rng(42);
+  std::vector<std::uint64_t> values(1000);
+  for (auto& v : values) {
+    v = rng();
+  }
+  EXPECT_FALSE(MOTION::utils::lz_compress(reinterpret_cast<const std::uint8_t*>(values.data()),
+                                          sizeof(std::uint64_t) * values.size())
+                   .has_value());
+}
+
+}  // namespace
@@ -20,7 +20,9 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
 #include <random>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -185,3 +187,149 @@ TEST(half_gates, circuit_garble_eval_batch) {
     }
   }
 }
+
+TEST(half_gates, circuit_garble_eval_streaming) {
+  HalfGateGarbler garbler;
+  HalfGateEvaluator evaluator(garbler.get_public_data());
+  MOTION::CircuitLoader circuit_loader;
+  const auto& algo =
+      circuit_loader.load_circuit("int_add8_size.bristol", MOTION::CircuitFormat::Bristol);
+  const std::size_t size = 8;
+  const std::size_t num_simd = 3;
+  const std::size_t and_tables_size = 2 * num_simd;
+  const std::size_t num_blocks = (size - 1) * and_tables_size;
+  const auto offset = garbler.get_offset();
+  const auto key_as = ENCRYPTO::block128_vector::make_random(size * num_simd);
+  const auto key_bs = ENCRYPTO::block128_vector::make_random(size * num_simd);
+  const std::size_t index = 42;
+
+  ENCRYPTO::block128_vector key_cs_original;
+  ENCRYPTO::block128_vector garbled_tables_original;
+  garbler.garble_circuit(key_cs_original, garbled_tables_original, index, key_as, key_bs, num_simd,
+                         algo);
+  ASSERT_EQ(garbled_tables_original.size(), num_blocks);
+
+  // the evaluator's keys of some inputs
+  auto eval_key_as = key_as;
+  auto eval_key_bs = key_bs;
+  std::minstd_rand gen(0x63);
+  std::uniform_int_distribution dist(0, 1);
+  for (std::size_t i = 0; i < size * num_simd; ++i) {
+    if (dist(gen) == 1) eval_key_as[i] ^= offset;
+    if (dist(gen) == 1) eval_key_bs[i] ^= offset;
+  }
+  ENCRYPTO::block128_vector key_cs_expected;
+  evaluator.evaluate_circuit(key_cs_expected, garbled_tables_original, index, eval_key_as,
+                             eval_key_bs, num_simd, algo);
+
+  // batches of single AND gates, of several AND gates with a partial last
+  // batch, and of the whole circuit
+  for (const std::size_t min_batch_size : {1, 7, 13, 1000}) {
+    struct Batch {
+      std::size_t offset_;
+      ENCRYPTO::block128_vector tables_;
+    };
+    std::vector<Batch> batches;
+    ENCRYPTO::block128_vector key_cs_streamed;
+    ENCRYPTO::block128_vector buffer;
+    garbler.garble_circuit(
+        key_cs_streamed, buffer, index, key_as, key_bs, num_simd, algo, false,
+        [&batches](std::size_t offset, const ENCRYPTO::block128_t* tables, std::size_t n) {
+          batches.push_back({offset, ENCRYPTO::block128_vector(n, tables)});
+        },
+        min_batch_size);
+    EXPECT_LE(buffer.size(), (min_batch_size / and_tables_size + 1) * and_tables_size);
+    ASSERT_EQ(key_cs_streamed.size(), key_cs_original.size());
+    for (std::size_t i = 0; i < key_cs_original.size(); ++i) {
+      EXPECT_EQ(key_cs_streamed[i], key_cs_original[i]);
+    }
+
+    // the batches cover the tables in order, only the last one may be short
+    ASSERT_FALSE(batches.empty());
+    std::size_t num_emitted = 0;
+    for (std::size_t batch_i = 0; batch_i < batches.size(); ++batch_i) {
+      const auto& batch = batches[batch_i];
+      EXPECT_EQ(batch.offset_, num_emitted);
+      EXPECT_EQ(batch.tables_.size() % and_tables_size, 0);
+      if (batch_i + 1 < batches.size()) {
+        EXPECT_GE(batch.tables_.size(), min_batch_size);
+      }
+      for (std::size_t i = 0; i < batch.tables_.size(); ++i) {
+        EXPECT_EQ(batch.tables_[i], garbled_tables_original[batch.offset_ + i]);
+      }
+      num_emitted += batch.tables_.size();
+    }
+    EXPECT_EQ(num_emitted, num_blocks);
+    if (min_batch_size == 7) {
+      EXPECT_EQ(batches.size(), 4);
+      EXPECT_LT(batches.back().tables_.size(), min_batch_size);
+    }
+
+    // deliver the batches one by one, the evaluator must not read tables
+    // which have not arrived yet
+    ENCRYPTO::block128_vector garbled_tables(num_blocks);
+    std::size_t num_delivered = 0;
+    std::size_t num_available = 0;
+    ENCRYPTO::block128_vector key_cs;
+    evaluator.evaluate_circuit(key_cs, garbled_tables, index, eval_key_as, eval_key_bs, num_simd,
+                               algo, false, [&](std::size_t n) {
+                                 EXPECT_LE(n, num_blocks);
+                                 while (num_available < n) {
+                                   ASSERT_LT(num_delivered, batches.size());
+                                   const auto& batch = batches[num_delivered++];
+                                   std::copy(std::begin(batch.tables_), std::end(batch.tables_),
+                                             std::begin(garbled_tables) + batch.offset_);
+                                   num_available += batch.tables_.size();
+                                 }
+                               });
+    EXPECT_EQ(num_delivered, batches.size());
+    ASSERT_EQ(key_cs.size(), key_cs_expected.size());
+    for (std::size_t i = 0; i < key_cs.size(); ++i) {
+      EXPECT_EQ(key_cs[i], key_cs_expected[i]);
+    }
+  }
+}
+
+TEST(half_gates, circuit_garble_eval_wire_slots) {
+  HalfGateGarbler garbler;
+  HalfGateEvaluator evaluator(garbler.get_public_data());
+  MOTION::CircuitLoader circuit_loader;
+  const auto& algo = circuit_loader.load_maxpool_circuit(32, 4);
+  ASSERT_EQ(algo.wire_slots_.size(), algo.n_wires_);
+  EXPECT_LT(algo.n_slots_, algo.n_wires_);
+  // same circuit, but every wire in its own slot
+  auto algo_without_slots = algo;
+  algo_without_slots.wire_slots_.clear();
+
+  const std::size_t num_simd = 3;
+  const auto key_as =
+      ENCRYPTO::block128_vector::make_random(algo.n_input_wires_parent_a_ * num_simd);
+  const std::size_t index = 42;
+
+  ENCRYPTO::block128_vector key_cs_original;
+  ENCRYPTO::block128_vector garbled_tables;
+  garbler.garble_circuit(key_cs_original, garbled_tables, index, key_as, {}, num_simd, algo);
+  ENCRYPTO::block128_vector key_cs_original_without_slots;
+  ENCRYPTO::block128_vector garbled_tables_without_slots;
+  garbler.garble_circuit(key_cs_original_without_slots, garbled_tables_without_slots, index,
+                         key_as, {}, num_simd, algo_without_slots);
+
+  ASSERT_EQ(garbled_tables.size(), garbled_tables_without_slots.size());
+  for (std::size_t i = 0; i < garbled_tables.size(); ++i) {
+    EXPECT_EQ(garbled_tables[i], garbled_tables_without_slots[i]);
+  }
+  ASSERT_EQ(key_cs_original.size(), key_cs_original_without_slots.size());
+  for (std::size_t i = 0; i < key_cs_original.size(); ++i) {
+    EXPECT_EQ(key_cs_original[i], key_cs_original_without_slots[i]);
+  }
+
+  ENCRYPTO::block128_vector key_cs;
+  ENCRYPTO::block128_vector key_cs_without_slots;
+  evaluator.evaluate_circuit(key_cs, garbled_tables, index, key_as, {}, num_simd, algo);
+  evaluator.evaluate_circuit(key_cs_without_slots, garbled_tables, index, key_as, {}, num_simd,
+                             algo_without_slots);
+  ASSERT_EQ(key_cs.size(), key_cs_without_slots.size());
+  for (std::size_t i = 0; i < key_cs.size(); ++i) {
+    EXPECT_EQ(key_cs[i], key_cs_without_slots[i]);
+  }
+}
@@ -21,13 +21,20 @@
 // SOFTWARE.
 
 #include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <iterator>
 #include <memory>
+#include <stdexcept>
+#include <thread>
 
+#include "base/linalg_triple_preprocessor.h"
 #include "communication/communication_layer.h"
 #include "crypto/arithmetic_provider.h"
 #include "crypto/base_ots/base_ot_provider.h"
 #include "crypto/motion_base_provider.h"
+#include "crypto/multiplication_triple/linalg_triple_pool.h"
 #include "crypto/multiplication_triple/linalg_triple_provider.h"
 #include "crypto/oblivious_transfer/ot_provider.h"
 #include "statistics/run_time_stats.h"
@@ -230,3 +237,117 @@ TYPED_TEST(LinAlgTripleProviderTest, ReLU) {
   }
   ASSERT_EQ(plain_triple.c_, expected_c);
 }
+
+TEST(LinAlgTriplePool, PreprocessedGemm) {
+  const MOTION::tensor::GemmOp gemm_op = {
+      .input_A_shape_ = {3, 4}, .input_B_shape_ = {4, 5}, .output_shape_ = {3, 5}};
+  // more triples than fit into the pool, so a second round is needed
+  constexpr std::size_t capacity = 2;
+  constexpr std::size_t num_triples = 3;
+  auto comm_layers = MOTION::Communication::make_dummy_communication_layers(2);
+  std::array<std::vector<MOTION::LinAlgTripleProvider::LinAlgTriple<std::uint64_t>>, 2> triples;
+
+  std::vector<std::future<void>> futs;
+  for (std::size_t i = 0; i < 2; ++i) {
+    futs.emplace_back(std::async(std::launch::async, [&, i] {
+      auto pool = std::make_shared<MOTION::LinAlgTriplePool>(capacity);
+      MOTION::LinAlgTriplePreprocessor preprocessor(*comm_layers[i], pool, capacity, nullptr);
+      preprocessor.register_gemm<std::uint64_t>(gemm_op);
+      preprocessor.start();
+
+      MOTION::PooledLinAlgTripleProvider provider(pool);
+      std::vector<std::size_t> indices;
+      for (std::size_t j = 0; j < num_triples; ++j) {
+        indices.push_back(provider.register_for_gemm_triple<std::uint64_t>(gemm_op));
+      }
+      provider.setup();
+      for (auto index : indices) {
+        triples[i].push_back(provider.get_gemm_triple<std::uint64_t>(gemm_op, index));
+      }
+      preprocessor.stop();
+      comm_layers[i]->shutdown();
+    }));
+  }
+  std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+
+  for (std::size_t j = 0; j < num_triples; ++j) {
+    const auto& triple_0 = triples[0].at(j);
+    const auto& triple_1 = triples[1].at(j);
+    ASSERT_EQ(triple_0.c_.size(), gemm_op.compute_output_size());
+    auto a = MOTION::Helpers::AddVectors(triple_0.a_, triple_1.a_);
+    auto b = MOTION::Helpers::AddVectors(triple_0.b_, triple_1.b_);
+    auto c = MOTION::Helpers::AddVectors(triple_0.c_, triple_1.c_);
+    EXPECT_EQ(c, MOTION::matrix_multiply(gemm_op.input_A_shape_[0], gemm_op.input_A_shape_[1],
+                                         gemm_op.output_shape_[1], a, b));
+  }
+}
+
+TEST(LinAlgTriplePool, PreprocessorStopWhileConsuming) {
+  const MOTION::tensor::GemmOp gemm_op = {
+      .input_A_shape_ = {3, 4}, .input_B_shape_ = {4, 5}, .output_shape_ = {3, 5}};
+  const MOTION::tensor::GemmOp other_gemm_op = {
+      .input_A_shape_ = {2, 3}, .input_B_shape_ = {3, 2}, .output_shape_ = {2, 2}};
+  constexpr std::size_t capacity = 2;
+  constexpr std::size_t min_num_triples = 4;
+  auto comm_layers = MOTION::Communication::make_dummy_communication_layers(2);
+  std::array<std::shared_ptr<MOTION::LinAlgTriplePool>, 2> pools;
+  std::array<std::unique_ptr<MOTION::LinAlgTriplePreprocessor>, 2> preprocessors;
+  std::array<std::vector<MOTION::LinAlgTripleProvider::LinAlgTriple<std::uint64_t>>, 2> triples;
+  std::array<std::atomic<std::size_t>, 2> num_taken = {0, 0};
+
+  // the consumers only take triples of the first shape, so the pool of the
+  // second one stays full and it is not part of the later rounds
+  std::vector<std::future<void>> consumers;
+  for (std::size_t i = 0; i < 2; ++i) {
+    pools[i] = std::make_shared<MOTION::LinAlgTriplePool>(capacity);
+    preprocessors[i] =
+        std::make_unique<MOTION::LinAlgTriplePreprocessor>(*comm_layers[i], pools[i], 1, nullptr);
+    preprocessors[i]->register_gemm<std::uint64_t>(gemm_op);
+    preprocessors[i]->register_gemm<std::uint64_t>(other_gemm_op);
+    consumers.emplace_back(std::async(std::launch::async, [&, i] {
+      preprocessors[i]->start();
+      while (true) {
+        try {
+          triples[i].push_back(pools[i]->take_gemm_triple<std::uint64_t>(gemm_op));
+        } catch (std::runtime_error&) {
+          break;
+        }
+        ++num_taken[i];
+      }
+    }));
+  }
+  while (num_taken[0] < min_num_triples || num_taken[1] < min_num_triples) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // both parties stop while their consumers still wait for triples
+  std::vector<std::future<void>> futs;
+  for (std::size_t i = 0; i < 2; ++i) {
+    futs.emplace_back(std::async(std::launch::async, [&, i] { preprocessors[i]->stop(); }));
+  }
+  for (auto& f : futs) {
+    ASSERT_EQ(f.wait_for(std::chrono::seconds(30)), std::future_status::ready);
+  }
+  for (auto& f : consumers) {
+    ASSERT_EQ(f.wait_for(std::chrono::seconds(30)), std::future_status::ready);
+  }
+  EXPECT_EQ(pools[0]->get_free_gemm<std::uint64_t>(other_gemm_op), 0);
+  EXPECT_EQ(pools[1]->get_free_gemm<std::uint64_t>(other_gemm_op), 0);
+
+  const auto num_triples = std::min(triples[0].size(), triples[1].size());
+  ASSERT_GE(num_triples, min_num_triples);
+  for (std::size_t j = 0; j < num_triples; ++j) {
+    const auto& triple_0 = triples[0].at(j);
+    const auto& triple_1 = triples[1].at(j);
+    auto a = MOTION::Helpers::AddVectors(triple_0.a_, triple_1.a_);
+    auto b = MOTION::Helpers::AddVectors(triple_0.b_, triple_1.b_);
+    auto c = MOTION::Helpers::AddVectors(triple_0.c_, triple_1.c_);
+    EXPECT_EQ(c, MOTION::matrix_multiply(gemm_op.input_A_shape_[0], gemm_op.input_A_shape_[1],
+                                         gemm_op.output_shape_[1], a, b));
+  }
+
+  for (std::size_t i = 0; i < 2; ++i) {
+    futs[i] = std::async(std::launch::async, [&, i] { comm_layers[i]->shutdown(); });
+  }
+  std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
+}
@@ -21,8 +21,10 @@
 // SOFTWARE.
 
 #include <gtest/gtest.h>
+#include <array>
 #include <cstdint>
 #include "tensor/tensor_op.h"
+#include "utility/helpers.h"
 #include "utility/linear_algebra.h"
 
 class Conv2DTest : public ::testing::Test {
@@ -256,3 +258,64 @@ TEST(LinearAlgebra, SumPool2) {
   MOTION::sum_pool(avgpool_op, input.data(), output.data());
   ASSERT_EQ(output, expected_output);
 }
+
+template <typename T>
+class MatrixMultiplyTest : public ::testing::Test {
+ protected:
+  static std::vector<T> naive_matrix_multiply(std::size_t dim_l, std::size_t dim_m,
+                                              std::size_t dim_n, const std::vector<T>& A,
+                                              const std::vector<T>& B) {
+    std::vector<T> output(dim_l * dim_n);
+    for (std::size_t i = 0; i < dim_l; ++i) {
+      for (std::size_t j = 0; j < dim_n; ++j) {
+        for (std::size_t k = 0; k < dim_m; ++k) {
+          output[i * dim_n + j] += A[i * dim_m + k] * B[k * dim_n + j];
+        }
+      }
+    }
+    return output;
+  }
+};
+
+using ring_types = ::testing::Types<std::uint64_t, __uint128_t>;
+TYPED_TEST_SUITE(MatrixMultiplyTest, ring_types);
+
+TYPED_TEST(MatrixMultiplyTest, Shapes) {
+  // matrix-vector products, and shapes which are not multiples of the tiles
+  const std::vector<std::array<std::size_t, 3>> shapes = {
+      {1, 1, 1}, {128, 784, 1}, {1, 784, 128}, {10, 128, 3}, {37, 300, 513}, {65, 129, 257}};
+  for (const auto [dim_l, dim_m, dim_n] : shapes) {
+    const auto A = MOTION::Helpers::RandomVector<TypeParam>(dim_l * dim_m);
+    const auto B = MOTION::Helpers::RandomVector<TypeParam>(dim_m * dim_n);
+    EXPECT_EQ(MOTION::matrix_multiply(dim_l, dim_m, dim_n, A, B),
+              this->naive_matrix_multiply(dim_l, dim_m, dim_n, A, B));
+  }
+}
+
+TYPED_TEST(MatrixMultiplyTest, Transposed) {
+  const std::size_t dim_l = 19, dim_m = 23, dim_n = 29;
+  const auto A = MOTION::Helpers::RandomVector<TypeParam>(dim_l * dim_m);
+  const auto B = MOTION::Helpers::RandomVector<TypeParam>(dim_m * dim_n);
+  std::vector<TypeParam> A_T(A.size()), B_T(B.size());
+  for (std::size_t i = 0; i < dim_l; ++i) {
+    for (std::size_t k = 0; k < dim_m; ++k) {
+      A_T[k * dim_l + i] = A[i * dim_m + k];
+    }
+  }
+  for (std::size_t k = 0; k < dim_m; ++k) {
+    for (std::size_t j = 0; j < dim_n; ++j) {
+      B_T[j * dim_m + k] = B[k * dim_n + j];
+    }
+  }
+  const auto expected_output = this->naive_matrix_multiply(dim_l, dim_m, dim_n, A, B);
+
+  const MOTION::tensor::GemmOp gemm_op = {.input_A_shape_ = {dim_m, dim_l},
+                                          .input_B_shape_ = {dim_n, dim_m},
+                                          .output_shape_ = {dim_l, dim_n},
+                                          .transA_ = true,
+                                          .transB_ = true};
+  ASSERT_TRUE(gemm_op.verify());
+  std::vector<TypeParam> output(dim_l * dim_n);
+  MOTION::matrix_multiply(gemm_op, A_T.data(), B_T.data(), output.data());
+  EXPECT_EQ(output, expected_output);
+}
@@ -31,6 +31,7 @@
 #include "test_constants.h"
 #include "utility/bit_vector.h"
 #include "utility/condition.h"
+#include "utility/helpers.h"
 
 namespace {
 TEST(Condition, Wait_NotifyOne) {
@@ -251,4 +252,32 @@ TEST(InputOutput_Un_Vectorization, VectorsOfUnsignedIntegers) {
   EXPECT_EQ(v32, v32_check);
   EXPECT_EQ(v64, v64_check);
 }
+
+TEST(Helpers, VectorArithmetic) {
+  auto f = [](auto t) {
+    using T = decltype(t);
+    // odd size to cover the remainder after the vectorized loop
+    const std::size_t n = 1001;
+    const auto a = MOTION::Helpers::RandomVector<T>(n);
+    const auto b = MOTION::Helpers::RandomVector<T>(n);
+    const auto sum = MOTION::Helpers::AddVectors(a, b);
+    const auto diff = MOTION::Helpers::SubVectors(a, b);
+    const auto prod = MOTION::Helpers::MultiplyVectors(a, b);
+    const auto sum3 = MOTION::Helpers::AddVectors(std::vector<std::vector<T>>{a, b, a});
+    EXPECT_EQ(MOTION::Helpers::RestrictAddVectors(a, b), sum);
+    EXPECT_EQ(MOTION::Helpers::RestrictSubVectors(a, b), diff);
+    EXPECT_EQ(MOTION::Helpers::RestrictMulVectors(a, b), prod);
+    for (std::size_t j = 0; j < n; ++j) {
+      EXPECT_EQ(sum.at(j), T(a.at(j) + b.at(j)));
+      EXPECT_EQ(diff.at(j), T(a.at(j) - b.at(j)));
+      EXPECT_EQ(prod.at(j), T(a.at(j) * b.at(j)));
+      EXPECT_EQ(sum3.at(j), T(a.at(j) + b.at(j) + a.at(j)));
+    }
+  };
+
+  f(std::uint8_t{});
+  f(std::uint16_t{});
+  f(std::uint32_t{});
+  f(std::uint64_t{});
+}
 }
\ No newline at end of file
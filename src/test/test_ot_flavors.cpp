@@ -89,6 +89,13 @@ class OTFlavorTest : public ::testing::Test {
     std::for_each(std::begin(futs), std::end(futs), [](auto& f) { f.get(); });
   }
 
+  void use_silent_ot() {
+    for (std::size_t i = 0; i < 2; ++i) {
+      ot_provider_wrappers_[i]->set_extension_backend(
+          ENCRYPTO::ObliviousTransfer::OTExtensionBackend::silent);
+    }
+  }
+
   std::vector<std::unique_ptr<MOTION::Communication::CommunicationLayer>> comm_layers_;
   std::vector<std::unique_ptr<MOTION::BaseOTProvider>> base_ot_providers_;
   std::vector<std::unique_ptr<MOTION::Crypto::MotionBaseProvider>> motion_base_providers_;
@@ -125,6 +132,38 @@ TEST_F(OTFlavorTest, FixedXCOT128) {
   }
 }
 
+TEST_F(OTFlavorTest, FixedXCOT128Windowed) {
+  const std::size_t num_ots = 1000;
+  const auto correlation = ENCRYPTO::block128_t::make_random();
+  const auto choice_bits = ENCRYPTO::BitVector<>::Random(num_ots);
+  for (std::size_t i = 0; i < 2; ++i) {
+    ot_provider_wrappers_[i]->set_window_size(256);
+  }
+  auto ot_sender = get_sender_provider().RegisterSendFixedXCOT128(num_ots);
+  auto ot_receiver = get_receiver_provider().RegisterReceiveFixedXCOT128(num_ots);
+
+  run_ot_extension_setup();
+
+  ot_sender->SetCorrelation(correlation);
+  ot_sender->SendMessages();
+
+  ot_receiver->SetChoices(choice_bits);
+  ot_receiver->SendCorrections();
+
+  ot_sender->ComputeOutputs();
+  ot_receiver->ComputeOutputs();
+  const auto sender_output = ot_sender->GetOutputs();
+  const auto receiver_output = ot_receiver->GetOutputs();
+
+  for (std::size_t ot_i = 0; ot_i < num_ots; ++ot_i) {
+    if (choice_bits.Get(ot_i)) {
+      ASSERT_EQ(receiver_output[ot_i], sender_output[ot_i] ^ correlation);
+    } else {
+      ASSERT_EQ(receiver_output[ot_i], sender_output[ot_i]);
+    }
+  }
+}
+
 TEST_F(OTFlavorTest, XCOTBit) {
   const std::size_t num_ots = 1000;
   const auto correlations = ENCRYPTO::BitVector<>::Random(num_ots);
@@ -383,3 +422,127 @@ TEST_F(OTFlavorTest, VectorROT) {
     }
   }
 }
+
+// the silent OT extension only kicks in for windows that are large enough, so
+// these tests use more OTs than the IKNP ones above
+
+TEST_F(OTFlavorTest, FixedXCOT128Silent) {
+  const std::size_t num_ots = 100000;
+  const auto correlation = ENCRYPTO::block128_t::make_random();
+  const auto choice_bits = ENCRYPTO::BitVector<>::Random(num_ots);
+  use_silent_ot();
+  auto ot_sender = get_sender_provider().RegisterSendFixedXCOT128(num_ots);
+  auto ot_receiver = get_receiver_provider().RegisterReceiveFixedXCOT128(num_ots);
+
+  run_ot_extension_setup();
+
+  ot_sender->SetCorrelation(correlation);
+  ot_sender->SendMessages();
+
+  ot_receiver->SetChoices(choice_bits);
+  ot_receiver->SendCorrections();
+
+  ot_sender->ComputeOutputs();
+  ot_receiver->ComputeOutputs();
+  const auto sender_output = ot_sender->GetOutputs();
+  const auto receiver_output = ot_receiver->GetOutputs();
+
+  for (std::size_t ot_i = 0; ot_i < num_ots; ++ot_i) {
+    if (choice_bits.Get(ot_i)) {
+      ASSERT_EQ(receiver_output[ot_i], sender_output[ot_i] ^ correlation);
+    } else {
+      ASSERT_EQ(receiver_output[ot_i], sender_output[ot_i]);
+    }
+  }
+}
+
+TEST_F(OTFlavorTest, FixedXCOT128SilentWindowed) {
+  // the last window is too small for the silent OT extension and uses IKNP
+  const std::size_t num_ots = 100000;
+  const auto correlation = ENCRYPTO::block128_t::make_random();
+  const auto choice_bits = ENCRYPTO::BitVector<>::Random(num_ots);
+  use_silent_ot();
+  for (std::size_t i = 0; i < 2; ++i) {
+    ot_provider_wrappers_[i]->set_window_size(1 << 15);
+  }
+  auto ot_sender = get_sender_provider().RegisterSendFixedXCOT128(num_ots);
+  auto ot_receiver = get_receiver_provider().RegisterReceiveFixedXCOT128(num_ots);
+
+  run_ot_extension_setup();
+
+  ot_sender->SetCorrelation(correlation);
+  ot_sender->SendMessages();
+
+  ot_receiver->SetChoices(choice_bits);
+  ot_receiver->SendCorrections();
+
+  ot_sender->ComputeOutputs();
+  ot_receiver->ComputeOutputs();
+  const auto sender_output = ot_sender->GetOutputs();
+  const auto receiver_output = ot_receiver->GetOutputs();
+
+  for (std::size_t ot_i = 0; ot_i < num_ots; ++ot_i) {
+    if (choice_bits.Get(ot_i)) {
+      ASSERT_EQ(receiver_output[ot_i], sender_output[ot_i] ^ correlation);
+    } else {
+      ASSERT_EQ(receiver_output[ot_i], sender_output[ot_i]);
+    }
+  }
+}
+
+TEST_F(OTFlavorTest, GOT128Silent) {
+  const std::size_t num_ots = 100000;
+  const auto sender_input = ENCRYPTO::block128_vector::make_random(2 * num_ots);
+  const auto choice_bits = ENCRYPTO::BitVector<>::Random(num_ots);
+  use_silent_ot();
+  auto ot_sender = get_sender_provider().RegisterSendGOT128(num_ots);
+  auto ot_receiver = get_receiver_provider().RegisterReceiveGOT128(num_ots);
+
+  run_ot_extension_setup();
+
+  ot_receiver->SetChoices(choice_bits);
+  ot_receiver->SendCorrections();
+
+  ot_sender->SetInputs(sender_input);
+  ot_sender->SendMessages();
+
+  ot_receiver->ComputeOutputs();
+  const auto receiver_output = ot_receiver->GetOutputs();
+
+  for (std::size_t ot_i = 0; ot_i < num_ots; ++ot_i) {
+    if (choice_bits.Get(ot_i)) {
+      ASSERT_EQ(receiver_output[ot_i], sender_input[2 * ot_i + 1]);
+    } else {
+      ASSERT_EQ(receiver_output[ot_i], sender_input[2 * ot_i]);
+    }
+  }
+}
+
+TEST_F(OTFlavorTest, ROTSilent) {
+  const std::size_t num_ots = 100000;
+  const std::size_t vector_size = 1;
+  const bool random_choice = true;
+  use_silent_ot();
+  auto ot_sender = get_sender_provider().RegisterSendROT(num_ots, vector_size, random_choice);
+  auto ot_receiver =
+      get_receiver_provider().RegisterReceiveROT(num_ots, vector_size, random_choice);
+
+  run_ot_extension_setup();
+
+  ot_receiver->ComputeOutputs();
+  const auto receiver_output = ot_receiver->GetOutputs();
+  const auto choice_bits = ot_receiver->GetChoices();
+  ot_sender->ComputeOutputs();
+  const auto [sender_output_m0, sender_output_m1] = ot_sender->GetOutputs();
+
+  ASSERT_EQ(receiver_output.GetSize(), num_ots * vector_size);
+  ASSERT_EQ(choice_bits.GetSize(), num_ots);
+
+  for (std::size_t ot_i = 0; ot_i < num_ots; ++ot_i) {
+    if (choice_bits.Get(ot_i)) {
+      ASSERT_EQ(receiver_output.Get(ot_i), sender_output_m1.Get(ot_i));
+    } else {
+      ASSERT_EQ(receiver_output.Get(ot_i), sender_output_m0.Get(ot_i));
+    }
+  }
+}
@@ -53,3 +53,28 @@ TEST(AES128_CTR_RNG, no_trivial_output) {
   rngt.random_blocks_aligned(output_1.data(), 10);
   EXPECT_NE(output_0, output_1);
 }
+
+TEST(AES128_CTR_RNG, set_key_is_deterministic) {
+  std::array<std::byte, AES128_CTR_RNG::key_size> key;
+  std::array<std::byte, 100> output_0;
+  std::array<std::byte, 100> output_1;
+  AES128_CTR_RNG rng;
+  AES128_CTR_RNG rng2;
+  rng.random_bytes(key.data(), key.size());
+
+  rng.set_key(key.data());
+  rng2.set_key(key.data());
+  rng.random_bytes(output_0.data(), output_0.size());
+  rng2.random_bytes(output_1.data(), output_1.size());
+  // the same key results in the same bytes
+  EXPECT_EQ(output_0, output_1);
+
+  rng2.random_bytes(output_1.data(), output_1.size());
+  // the counter advances
+  EXPECT_NE(output_0, output_1);
+
+  rng2.set_key(key.data());
+  rng2.random_bytes(output_1.data(), output_1.size());
+  // setting the key resets the counter
+  EXPECT_EQ(output_0, output_1);
+}
@@ -0,0 +1,111 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "utility/helpers.h"
+#include "utility/share_file.h"
+
+namespace {
+
+std::string temp_file_path(const std::string& name) {
+  return (std::filesystem::temp_directory_path() / ("motiontest_" + name)).string();
+}
+
+}  // namespace
+
+TEST(ShareFile, BinaryRoundTrip) {
+  const auto path = temp_file_path("share_file_binary");
+  const std::size_t rows = 17, cols = 3;
+  const auto public_shares = MOTION::Helpers::RandomVector<std::uint64_t>(rows * cols);
+  const auto secret_shares = MOTION::Helpers::RandomVector<std::uint64_t>(rows * cols);
+  MOTION::write_share_file<std::uint64_t>(path, 1, 13, rows, cols, public_shares, secret_shares);
+
+  {
+    MOTION::MappedShareFile file(path);
+    const auto& header = file.get_header();
+    EXPECT_EQ(header.party_id_, 1);
+    EXPECT_EQ(header.fractional_bits_, 13);
+    EXPECT_EQ(header.bit_size_, 64);
+    EXPECT_EQ(header.rows_, rows);
+    EXPECT_EQ(header.cols_, cols);
+    const auto mapped_public_shares = file.get_public_shares<std::uint64_t>();
+    const auto mapped_secret_shares = file.get_secret_shares<std::uint64_t>();
+    EXPECT_TRUE(std::equal(std::begin(mapped_public_shares), std::end(mapped_public_shares),
+                           std::begin(public_shares), std::end(public_shares)));
+    EXPECT_TRUE(std::equal(std::begin(mapped_secret_shares), std::end(mapped_secret_shares),
+                           std::begin(secret_shares), std::end(secret_shares)));
+    EXPECT_THROW(file.get_public_shares<std::uint32_t>(), std::logic_error);
+  }
+
+  const auto contents = MOTION::read_share_file<std::uint64_t>(path);
+  EXPECT_EQ(contents.rows_, rows);
+  EXPECT_EQ(contents.cols_, cols);
+  EXPECT_EQ(contents.public_shares_, public_shares);
+  EXPECT_EQ(contents.secret_shares_, secret_shares);
+  std::filesystem::remove(path);
+}
+
+TEST(ShareFile, DetectsCorruption) {
+  const auto path = temp_file_path("share_file_corrupt");
+  const auto public_shares = MOTION::Helpers::RandomVector<std::uint32_t>(8);
+  const auto secret_shares = MOTION::Helpers::RandomVector<std::uint32_t>(8);
+  MOTION::write_share_file<std::uint32_t>(path, 0, 16, 2, 4, public_shares, secret_shares);
+  {
+    std::fstream file(path, std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+    const auto offset = sizeof(MOTION::ShareFileHeader) + 5;
+    char byte;
+    file.seekg(offset);
+    file.get(byte);
+    file.seekp(offset);
+    file.put(byte ^ 0x01);
+  }
+  EXPECT_THROW(MOTION::MappedShareFile{path}, std::runtime_error);
+
+  std::filesystem::resize_file(path, sizeof(MOTION::ShareFileHeader) + 4);
+  EXPECT_THROW(MOTION::MappedShareFile{path}, std::runtime_error);
+  std::filesystem::remove(path);
+}
+
+TEST(ShareFile, ReadsLegacyTextFormat) {
+  const auto path = temp_file_path("share_file_text");
+  {
+    std::ofstream file(path);
+    file << "2 1\n";
+    file << "12345 678\n";
+    file << "18446744073709551615 0\n";
+  }
+  EXPECT_FALSE(MOTION::MappedShareFile::is_share_file(path));
+  const auto contents = MOTION::read_share_file<std::uint64_t>(path);
+  EXPECT_EQ(contents.rows_, 2);
+  EXPECT_EQ(contents.cols_, 1);
+  EXPECT_EQ(contents.public_shares_, (std::vector<std::uint64_t>{12345, 18446744073709551615u}));
+  EXPECT_EQ(contents.secret_shares_, (std::vector<std::uint64_t>{678, 0}));
+  std::filesystem::remove(path);
+}
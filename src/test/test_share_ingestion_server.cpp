@@ -0,0 +1,249 @@
+// MIT License
+//
+// Copyright (c) 2021 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <future>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+
+#include "compute_server/compute_server.h"
+#include "compute_server/share_ingestion_server.h"
+
+namespace {
+
+// Sends a tensor like the image provider does.  The public shares are
+// tag, tag + 1, ..., and the secret shares are their negation.
+void send_tensor(std::uint16_t port, int rows, int cols, std::uint64_t tag,
+                 bool seed_compressed = false, const COMPUTE_SERVER::Seed& seed = {}) {
+  boost::asio::io_context io_context;
+  boost::asio::ip::tcp::socket socket(io_context);
+  socket.connect({boost::asio::ip::make_address("127.0.0.1"), port});
+  boost::asio::streambuf fractional_bits_ack, dimensions_ack;
+
+  std::size_t fractional_bits = 13;
+  boost::asio::write(socket, boost::asio::buffer(&fractional_bits, sizeof(fractional_bits)));
+  boost::asio::read_until(socket, fractional_bits_ack, "\n");
+  std::array<int, 2> dimensions = {rows, cols};
+  boost::asio::write(socket, boost::asio::buffer(dimensions));
+  boost::asio::read_until(socket, dimensions_ack, "\n");
+
+  const std::size_t num_elements = rows * cols;
+  std::vector<std::uint64_t> Delta(num_elements);
+  for (std::size_t i = 0; i < num_elements; ++i) {
+    Delta[i] = tag + i;
+  }
+  if (seed_compressed) {
+    std::array<boost::asio::const_buffer, 2> buffers = {boost::asio::buffer(seed),
+                                                        boost::asio::buffer(Delta)};
+    boost::asio::write(socket, buffers);
+  } else {
+    std::vector<std::uint64_t> pairs(2 * num_elements);
+    for (std::size_t i = 0; i < num_elements; ++i) {
+      pairs[2 * i] = Delta[i];
+      pairs[2 * i + 1] = -Delta[i];
+    }
+    boost::asio::write(socket, boost::asio::buffer(pairs));
+  }
+}
+
+}  // namespace
+
+TEST(ShareIngestionServer, ConcurrentProviders) {
+  // more providers than slots, and tensors spanning several chunks
+  constexpr std::size_t num_providers = 6;
+  COMPUTE_SERVER::ShareIngestionServer server(0, 2);
+  std::vector<std::future<void>> providers;
+  for (std::size_t i = 0; i < num_providers; ++i) {
+    providers.push_back(std::async(std::launch::async, [&server, i] {
+      send_tensor(server.get_port(), 100 + i, 100, i << 32);
+    }));
+  }
+
+  std::vector<std::uint64_t> tags;
+  for (std::size_t i = 0; i < num_providers; ++i) {
+    auto upload = server.next_upload();
+    ASSERT_TRUE(upload.has_value());
+    EXPECT_EQ(upload->fractional_bits_, 13);
+    ASSERT_EQ(upload->tensors_.size(), 1);
+    const auto& tensor = upload->tensors_[0];
+    const auto tag = tensor.public_shares_.at(0);
+    const std::size_t provider = tag >> 32;
+    EXPECT_EQ(tensor.rows_, 100 + provider);
+    EXPECT_EQ(tensor.cols_, 100);
+    ASSERT_EQ(tensor.public_shares_.size(), tensor.rows_ * tensor.cols_);
+    ASSERT_EQ(tensor.secret_shares_.size(), tensor.rows_ * tensor.cols_);
+    for (std::size_t j = 0; j < tensor.public_shares_.size(); ++j) {
+      EXPECT_EQ(tensor.public_shares_[j], tag + j);
+      EXPECT_EQ(tensor.secret_shares_[j], -(tag + j));
+    }
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(tensor.public_shares_.data()) %
+                  MOTION::MOTION_ALIGNMENT,
+              0);
+    tags.push_back(tag);
+  }
+  for (auto& provider : providers) {
+    provider.get();
+  }
+  std::sort(std::begin(tags), std::end(tags));
+  EXPECT_EQ(std::unique(std::begin(tags), std::end(tags)), std::end(tags));
+  EXPECT_EQ(server.get_num_failed_connections(), 0);
+
+  server.stop();
+  EXPECT_FALSE(server.next_upload().has_value());
+}
+
+TEST(ShareIngestionServer, SeedCompressed) {
+  COMPUTE_SERVER::ShareIngestionServer server(0, 1, true);
+  const auto seed = COMPUTE_SERVER::sample_seed();
+  auto provider = std::async(std::launch::async, [&server, &seed] {
+    send_tensor(server.get_port(), 3, 5, 42, true, seed);
+  });
+  const auto upload = server.receive_upload();
+  provider.get();
+  const auto& tensor = upload.tensors_.at(0);
+  const auto delta = COMPUTE_SERVER::expand_seed(seed, 15);
+  for (std::size_t j = 0; j < 15; ++j) {
+    EXPECT_EQ(tensor.public_shares_.at(j), 42 + j);
+    EXPECT_EQ(tensor.secret_shares_.at(j), delta[j]);
+  }
+}
+
+TEST(ShareIngestionServer, ModelUpload) {
+  // the weight and bias matrices of all layers over one connection
+  constexpr int num_layers = 3;
+  COMPUTE_SERVER::ShareIngestionServer server(0, 1, false, COMPUTE_SERVER::UploadFormat::model);
+  auto provider = std::async(std::launch::async, [&server] {
+    boost::asio::io_context io_context;
+    boost::asio::ip::tcp::socket socket(io_context);
+    socket.connect({boost::asio::ip::make_address("127.0.0.1"), server.get_port()});
+    boost::asio::streambuf ack;
+    auto read_ack = [&socket, &ack] {
+      boost::asio::read_until(socket, ack, "\n");
+      ack.consume(ack.size());
+    };
+
+    const int number_of_layers = num_layers;
+    boost::asio::write(socket,
+                       boost::asio::buffer(&number_of_layers, sizeof(number_of_layers)));
+    read_ack();
+    std::size_t fractional_bits = 13;
+    boost::asio::write(socket, boost::asio::buffer(&fractional_bits, sizeof(fractional_bits)));
+    read_ack();
+    for (int i = 0; i < 2 * num_layers; ++i) {
+      // spans several chunks for the first weight matrix
+      std::pair<int, int> dimensions = {i % 2 ? 100 : 100 * (i + 1), i % 2 ? 1 : 100};
+      boost::asio::write(socket, boost::asio::buffer(&dimensions, sizeof(dimensions)));
+      read_ack();
+      const std::size_t num_elements = dimensions.first * dimensions.second;
+      std::vector<std::uint64_t> pairs(2 * num_elements);
+      for (std::size_t j = 0; j < num_elements; ++j) {
+        pairs[2 * j] = (std::uint64_t(i) << 32) + j;
+        pairs[2 * j + 1] = -pairs[2 * j];
+      }
+      boost::asio::write(socket, boost::asio::buffer(pairs));
+      read_ack();
+    }
+  });
+
+  const auto upload = server.receive_upload();
+  provider.get();
+  EXPECT_EQ(upload.fractional_bits_, 13);
+  ASSERT_EQ(upload.tensors_.size(), 2 * num_layers);
+  for (std::size_t i = 0; i < upload.tensors_.size(); ++i) {
+    const auto& tensor = upload.tensors_[i];
+    EXPECT_EQ(tensor.rows_, i % 2 ? 100 : 100 * (i + 1));
+    EXPECT_EQ(tensor.cols_, i % 2 ? 1 : 100);
+    ASSERT_EQ(tensor.public_shares_.size(), tensor.rows_ * tensor.cols_);
+    for (std::size_t j = 0; j < tensor.public_shares_.size(); ++j) {
+      EXPECT_EQ(tensor.public_shares_[j], (i << 32) + j);
+      EXPECT_EQ(tensor.secret_shares_[j], -((i << 32) + j));
+    }
+  }
+}
+
+TEST(ShareIngestionServer, FailedConnection) {
+  COMPUTE_SERVER::ShareIngestionServer server(0, 1);
+  auto provider = std::async(std::launch::async, [&server] {
+    boost::asio::io_context io_context;
+    boost::asio::ip::tcp::socket socket(io_context);
+    socket.connect({boost::asio::ip::make_address("127.0.0.1"), server.get_port()});
+    // hang up before sending the fractional bits
+  });
+  provider.get();
+  EXPECT_THROW(server.receive_upload(), std::runtime_error);
+  EXPECT_EQ(server.get_num_failed_connections(), 1);
+}
+
+TEST(ShareIngestionServer, ProviderDataInConnectionOrder) {
+  // get_provider_data opens its own server, so find a free port first
+  std::uint16_t port;
+  {
+    boost::asio::io_context io_context;
+    boost::asio::ip::tcp::acceptor acceptor(
+        io_context, boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), 0));
+    port = acceptor.local_endpoint().port();
+  }
+  auto result = std::async(std::launch::async, [port] {
+    return COMPUTE_SERVER::get_provider_data(port);
+  });
+
+  boost::asio::io_context io_context;
+  auto connect = [&io_context, port] {
+    boost::asio::ip::tcp::socket socket(io_context);
+    boost::system::error_code ec;
+    do {
+      std::this_thread::yield();
+      socket.close();
+      socket.connect({boost::asio::ip::make_address("127.0.0.1"), port}, ec);
+    } while (ec);
+    return socket;
+  };
+  auto send_pair = [](auto& socket, std::uint64_t Delta, std::uint64_t delta) {
+    std::array<std::uint64_t, 2> pair = {Delta, delta};
+    boost::asio::write(socket, boost::asio::buffer(pair));
+    boost::asio::streambuf ack;
+    boost::asio::read_until(socket, ack, "\n");
+  };
+  // the first provider to connect finishes its upload last
+  auto first = connect();
+  auto second = connect();
+  send_pair(second, 3, 4);
+  send_pair(first, 1, 2);
+
+  const auto data = result.get();
+  ASSERT_EQ(data.size(), 2);
+  EXPECT_EQ(data[0], std::make_pair(std::uint64_t(1), std::uint64_t(2)));
+  EXPECT_EQ(data[1], std::make_pair(std::uint64_t(3), std::uint64_t(4)));
+}
@@ -0,0 +1,125 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <gtest/gtest.h>
+
+#include <future>
+#include <vector>
+
+#include <unistd.h>
+#include <fmt/format.h>
+
+#include "communication/shm_transport.h"
+
+namespace {
+
+std::pair<std::unique_ptr<MOTION::Communication::Transport>,
+          std::unique_ptr<MOTION::Communication::Transport>>
+make_shm_transport_pair(const std::string& test_name, std::size_t ring_size) {
+  const auto name = fmt::format("motiontest-{}-{}", test_name, getpid());
+  auto transport_alice_fut = std::async(std::launch::async, [&name, ring_size] {
+    MOTION::Communication::ShmSetupHelper helper(0, 2, name, ring_size);
+    auto transports = helper.setup_connections();
+    return std::move(transports.at(1));
+  });
+  auto transport_bob_fut = std::async(std::launch::async, [&name, ring_size] {
+    MOTION::Communication::ShmSetupHelper helper(1, 2, name, ring_size);
+    auto transports = helper.setup_connections();
+    return std::move(transports.at(0));
+  });
+  auto transport_alice = transport_alice_fut.get();
+  auto transport_bob = transport_bob_fut.get();
+  return {std::move(transport_alice), std::move(transport_bob)};
+}
+
+}  // namespace
+
+TEST(ShmTransport, dummy) {
+  auto [transport_alice, transport_bob] = make_shm_transport_pair("dummy", 1 << 16);
+
+  const std::vector<std::uint8_t> message = {0xde, 0xad, 0xbe, 0xef};
+
+  EXPECT_FALSE(transport_bob->available());
+  transport_alice->send_message(message);
+  EXPECT_TRUE(transport_bob->available());
+  auto received_message = transport_bob->receive_message();
+  EXPECT_FALSE(transport_bob->available());
+  EXPECT_EQ(received_message, message);
+
+  transport_bob->send_message(message);
+  EXPECT_EQ(transport_alice->receive_message(), message);
+
+  transport_alice->shutdown_send();
+  EXPECT_FALSE(transport_bob->receive_message().has_value());
+}
+
+TEST(ShmTransport, MessagesLargerThanRing) {
+  // the ring holds only a fraction of the messages, so both sides need to take turns
+  auto [transport_alice, transport_bob] = make_shm_transport_pair("large", 4096);
+
+  std::vector<std::vector<std::uint8_t>> messages;
+  std::vector<MOTION::Communication::MessageView> message_views;
+  for (std::size_t i = 0; i < 20; ++i) {
+    auto& message = messages.emplace_back(i % 2 == 0 ? 100000 + i : i);
+    for (std::size_t j = 0; j < message.size(); ++j) {
+      message[j] = i + 7 * j;
+    }
+    message_views.emplace_back(message.data(), message.size());
+  }
+
+  auto received_fut = std::async(std::launch::async, [&transport_bob, &messages] {
+    auto pool = std::make_shared<MOTION::Communication::ReceiveBufferPool>();
+    std::vector<std::vector<std::uint8_t>> received_messages;
+    for (std::size_t i = 0; i < messages.size(); ++i) {
+      if (i % 3 == 0) {
+        auto received_message = transport_bob->receive_pooled_message(pool).value();
+        received_messages.emplace_back(received_message.data(),
+                                       received_message.data() + received_message.size());
+      } else {
+        received_messages.push_back(transport_bob->receive_message().value());
+      }
+    }
+    return received_messages;
+  });
+  transport_alice->send_messages(
+      std::vector(std::begin(message_views), std::begin(message_views) + 10));
+  for (std::size_t i = 10; i < messages.size(); ++i) {
+    transport_alice->send_message(messages[i]);
+  }
+  EXPECT_EQ(received_fut.get(), messages);
+  EXPECT_EQ(transport_alice->get_stats().num_messages_sent, messages.size());
+  EXPECT_EQ(transport_bob->get_stats().num_messages_received, messages.size());
+  EXPECT_EQ(transport_alice->get_stats().num_bytes_sent,
+            transport_bob->get_stats().num_bytes_received);
+}
+
+TEST(ShmTransport, Shutdown) {
+  auto [transport_alice, transport_bob] = make_shm_transport_pair("shutdown", 4096);
+  // a blocked receiver is woken up by its own shutdown
+  auto received_fut =
+      std::async(std::launch::async, [&transport_bob] { return transport_bob->receive_message(); });
+  transport_bob->shutdown();
+  EXPECT_FALSE(received_fut.get().has_value());
+  // a writer does not block on a receiver which has been shut down
+  std::vector<std::uint8_t> message(10000);
+  EXPECT_THROW(transport_alice->send_message(message), std::runtime_error);
+}
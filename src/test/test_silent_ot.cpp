@@ -0,0 +1,127 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "gtest/gtest.h"
+
+#include "crypto/aes/aesni_primitives.h"
+#include "crypto/oblivious_transfer/silent_ot.h"
+#include "utility/block.h"
+
+using namespace ENCRYPTO;
+using namespace ENCRYPTO::ObliviousTransfer;
+
+namespace {
+
+struct GGMRoundKeys {
+  GGMRoundKeys() {
+    for (auto& rk : round_keys) {
+      auto key = block128_t::make_random();
+      std::copy_n(key.data(), aes_key_size_128, rk.data());
+      aesni_key_expansion_128(rk.data());
+    }
+  }
+  alignas(aes_block_size) std::array<std::array<std::byte, aes_round_keys_size_128>, 2> round_keys;
+};
+
+TEST(silent_ot, parameters) {
+  for (std::size_t num_ots : {128, 4096, 100096, 1 << 20}) {
+    const SilentOTParameters params(num_ots);
+    EXPECT_GE(params.code_length_, 2 * num_ots);
+    EXPECT_GE(params.num_trees_, 400u);
+    EXPECT_EQ(params.code_length_, params.num_trees_ << params.tree_depth_);
+    EXPECT_EQ(params.num_base_ots_, params.num_trees_ * params.tree_depth_);
+  }
+  EXPECT_FALSE(SilentOTParameters(1024).SavesCommunication());
+  EXPECT_TRUE(SilentOTParameters(1 << 20).SavesCommunication());
+}
+
+TEST(silent_ot, punctured_ggm_tree) {
+  const GGMRoundKeys keys;
+  for (std::size_t depth : {1, 2, 5, 8}) {
+    const std::size_t num_leaves = std::size_t(1) << depth;
+    const auto seed = block128_t::make_random();
+    block128_vector leaves(num_leaves);
+    block128_vector level_sums(2 * depth);
+    ExpandGGMTree(keys.round_keys[0].data(), keys.round_keys[1].data(), seed, depth, leaves.data(),
+                  level_sums.data());
+
+    for (std::size_t punctured_index : {std::size_t(0), num_leaves / 3, num_leaves - 1}) {
+      block128_vector sibling_sums(depth);
+      for (std::size_t level_i = 0; level_i < depth; ++level_i) {
+        const auto bit = (punctured_index >> (depth - level_i - 1)) & 1;
+        sibling_sums[level_i] = level_sums[2 * level_i + (bit ^ 1)];
+      }
+      block128_vector punctured_leaves(num_leaves);
+      ReconstructPuncturedGGMTree(keys.round_keys[0].data(), keys.round_keys[1].data(),
+                                  punctured_index, depth, sibling_sums.data(),
+                                  punctured_leaves.data());
+      for (std::size_t leaf_i = 0; leaf_i < num_leaves; ++leaf_i) {
+        if (leaf_i == punctured_index) {
+          EXPECT_EQ(punctured_leaves[leaf_i], block128_t::make_zero());
+        } else {
+          EXPECT_EQ(punctured_leaves[leaf_i], leaves[leaf_i]);
+        }
+      }
+    }
+  }
+}
+
+TEST(silent_ot, correlated_outputs) {
+  const std::size_t num_ots = 100096;
+  const SilentOTParameters params(num_ots);
+  const std::size_t num_leaves = std::size_t(1) << params.tree_depth_;
+
+  // regular noise: the receiver's vector differs from the sender's in one
+  // leaf per tree by delta, whose lsb is set while those of the leaves are not
+  auto delta = block128_t::make_random();
+  *delta.data() |= std::byte(0x01);
+  auto v = block128_vector::make_random(params.code_length_);
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    *v[i].data() &= std::byte(0xfe);
+  }
+  auto w = v;
+  for (std::size_t tree_i = 0; tree_i < params.num_trees_; ++tree_i) {
+    w[tree_i * num_leaves + (7 * tree_i) % num_leaves] ^= delta;
+  }
+
+  block128_vector q(num_ots), t(num_ots);
+  ExpandAccumulateDualEncode(v.data(), params.code_length_, q.data(), num_ots);
+  ExpandAccumulateDualEncode(w.data(), params.code_length_, t.data(), num_ots);
+
+  std::size_t num_ones = 0;
+  for (std::size_t i = 0; i < num_ots; ++i) {
+    const bool choice = bool(*t[i].data() & std::byte(0x01));
+    num_ones += choice;
+    ASSERT_EQ(t[i], choice ? q[i] ^ delta : q[i]);
+  }
+  // the choices should look random
+  EXPECT_GT(num_ones, num_ots / 2 - num_ots / 50);
+  EXPECT_LT(num_ones, num_ots / 2 + num_ots / 50);
+}
+
+}  // namespace
@@ -23,6 +23,7 @@
 #include <gtest/gtest.h>
 
 #include <future>
+#include <vector>
 
 #include "communication/tcp_transport.h"
 
@@ -54,5 +55,159 @@ TEST_P(TCPTransportTest, dummy) {
   EXPECT_EQ(received_message, message);
 }
 
+TEST_P(TCPTransportTest, SendMessages) {
+  auto localhost = GetParam();
+  auto transport_alice_fut = std::async(std::launch::async, [localhost] {
+    MOTION::Communication::TCPSetupHelper helper(0, {{localhost, 13339}, {localhost, 13340}});
+    auto transports = helper.setup_connections();
+    return std::move(transports.at(1));
+  });
+  auto transport_bob_fut = std::async(std::launch::async, [localhost] {
+    MOTION::Communication::TCPSetupHelper helper(1, {{localhost, 13339}, {localhost, 13340}});
+    auto transports = helper.setup_connections();
+    return std::move(transports.at(0));
+  });
+  auto transport_alice = transport_alice_fut.get();
+  auto transport_bob = transport_bob_fut.get();
+
+  // small messages are copied into one buffer, every fifth message is written separately
+  constexpr std::size_t num_messages = 200;
+  std::vector<std::vector<std::uint8_t>> messages;
+  std::vector<MOTION::Communication::MessageView> message_views;
+  std::size_t num_bytes = 0;
+  for (std::size_t i = 0; i < num_messages; ++i) {
+    const std::size_t size = (i % 5 == 0) ? 5000 + i : i % 7;
+    auto& message = messages.emplace_back(size);
+    for (std::size_t j = 0; j < size; ++j) {
+      message[j] = i + j;
+    }
+    message_views.emplace_back(message.data(), message.size());
+    num_bytes += size + sizeof(std::uint32_t);
+  }
+
+  auto received_fut = std::async(std::launch::async, [&transport_bob] {
+    std::vector<std::vector<std::uint8_t>> received_messages;
+    for (std::size_t i = 0; i < num_messages; ++i) {
+      received_messages.push_back(transport_bob->receive_message().value());
+    }
+    return received_messages;
+  });
+  transport_alice->send_messages(message_views);
+  EXPECT_EQ(received_fut.get(), messages);
+
+  const auto& stats = transport_alice->get_stats();
+  EXPECT_EQ(stats.num_messages_sent, num_messages);
+  EXPECT_EQ(stats.num_bytes_sent, num_bytes);
+  EXPECT_EQ(stats.num_flushes, 1);
+  EXPECT_EQ(stats.max_messages_per_flush, num_messages);
+  EXPECT_EQ(stats.max_bytes_per_flush, num_bytes);
+}
+
+TEST_P(TCPTransportTest, ReceivePooledMessages) {
+  auto localhost = GetParam();
+  auto transport_alice_fut = std::async(std::launch::async, [localhost] {
+    MOTION::Communication::TCPSetupHelper helper(0, {{localhost, 13341}, {localhost, 13342}});
+    auto transports = helper.setup_connections();
+    return std::move(transports.at(1));
+  });
+  auto transport_bob_fut = std::async(std::launch::async, [localhost] {
+    MOTION::Communication::TCPSetupHelper helper(1, {{localhost, 13341}, {localhost, 13342}});
+    auto transports = helper.setup_connections();
+    return std::move(transports.at(0));
+  });
+  auto transport_alice = transport_alice_fut.get();
+  auto transport_bob = transport_bob_fut.get();
+
+  // large messages alternate with small ones which are served from the read-ahead buffer
+  std::vector<std::vector<std::uint8_t>> messages;
+  for (std::size_t i = 0; i < 6; ++i) {
+    auto& message = messages.emplace_back(i % 2 == 0 ? 100000 - i : 3);
+    for (std::size_t j = 0; j < message.size(); ++j) {
+      message[j] = i ^ j;
+    }
+    transport_alice->send_message(message);
+  }
+
+  auto pool = std::make_shared<MOTION::Communication::ReceiveBufferPool>();
+  for (const auto& message : messages) {
+    auto received_message = transport_bob->receive_pooled_message(pool);
+    ASSERT_TRUE(received_message.has_value());
+    EXPECT_EQ(std::vector(received_message->data(),
+                          received_message->data() + received_message->size()),
+              message);
+  }
+  EXPECT_FALSE(transport_bob->available());
+  // the buffer of the first large message is reused for the other two
+  EXPECT_EQ(pool->get_num_reused(), 2);
+  EXPECT_EQ(pool->get_num_pooled(), 1);
+}
+
+TEST_P(TCPTransportTest, Striped) {
+  auto localhost = GetParam();
+  MOTION::Communication::TCPSetupOptions options;
+  options.num_streams_ = 3;
+  options.stripe_threshold_ = 1000;
+  options.send_cpus_ = {0, 0};
+  options.receive_cpus_ = {0};
+  auto transport_alice_fut = std::async(std::launch::async, [localhost, options] {
+    MOTION::Communication::TCPSetupHelper helper(0, {{localhost, 13343}, {localhost, 13344}},
+                                                 options);
+    auto transports = helper.setup_connections();
+    return std::move(transports.at(1));
+  });
+  auto transport_bob_fut = std::async(std::launch::async, [localhost, options] {
+    MOTION::Communication::TCPSetupHelper helper(1, {{localhost, 13343}, {localhost, 13344}},
+                                                 options);
+    auto transports = helper.setup_connections();
+    return std::move(transports.at(0));
+  });
+  auto transport_alice = transport_alice_fut.get();
+  auto transport_bob = transport_bob_fut.get();
+  auto striped_transport =
+      dynamic_cast<MOTION::Communication::StripedTCPTransport*>(transport_alice.get());
+  ASSERT_NE(striped_transport, nullptr);
+  EXPECT_EQ(striped_transport->get_num_streams(), 3);
+  // stream 0 is pinned by the owner of the transport
+  EXPECT_EQ(transport_alice->get_send_cpu(), 0);
+  EXPECT_EQ(transport_alice->get_receive_cpu(), 0);
+
+  // small and large messages, whose size is not a multiple of the number of streams
+  std::vector<std::vector<std::uint8_t>> messages;
+  std::vector<MOTION::Communication::MessageView> message_views;
+  for (std::size_t i = 0; i < 20; ++i) {
+    auto& message = messages.emplace_back(i % 3 == 0 ? 1000000 + i : 10 * i);
+    for (std::size_t j = 0; j < message.size(); ++j) {
+      message[j] = i + 3 * j;
+    }
+    message_views.emplace_back(message.data(), message.size());
+  }
+
+  auto received_fut = std::async(std::launch::async, [&transport_bob, &messages] {
+    auto pool = std::make_shared<MOTION::Communication::ReceiveBufferPool>();
+    std::vector<std::vector<std::uint8_t>> received_messages;
+    for (std::size_t i = 0; i < messages.size(); ++i) {
+      if (i % 2 == 0) {
+        received_messages.push_back(transport_bob->receive_message().value());
+      } else {
+        auto received_message = transport_bob->receive_pooled_message(pool).value();
+        received_messages.emplace_back(received_message.data(),
+                                       received_message.data() + received_message.size());
+      }
+    }
+    return received_messages;
+  });
+  transport_alice->send_messages(
+      std::vector(std::begin(message_views), std::begin(message_views) + 10));
+  for (std::size_t i = 10; i < messages.size(); ++i) {
+    transport_alice->send_message(messages[i]);
+  }
+  EXPECT_EQ(received_fut.get(), messages);
+  EXPECT_EQ(transport_alice->get_stats().num_messages_sent, messages.size());
+  EXPECT_EQ(transport_bob->get_stats().num_messages_received, messages.size());
+
+  transport_alice->shutdown_send();
+  EXPECT_FALSE(transport_bob->receive_message().has_value());
+}
+
 INSTANTIATE_TEST_SUITE_P(TCPTransportSuite, TCPTransportTest, testing::Values("127.0.0.1", "::1"),
                          [](auto& info) { return info.param == "::1" ? "ipv6" : "ipv4"; });
@@ -0,0 +1,129 @@
+// MIT License
+//
+// Copyright (c) 2020 Lennart Braun
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "gate/new_gate.h"
+#include "protocols/gmw/tensor.h"
+#include "tensor/memory_plan.h"
+
+namespace {
+
+using namespace MOTION;
+using Tensor = proto::gmw::ArithmeticGMWTensor<std::uint64_t>;
+
+// gate which only reports its inputs and output
+class DummyGate : public NewGate {
+ public:
+  DummyGate(std::size_t gate_id, std::vector<const Tensor*> inputs, std::size_t size)
+      : NewGate(gate_id),
+        inputs_(std::move(inputs)),
+        output_(std::make_shared<Tensor>(tensor::TensorDimensions{1, 1, 1, size})) {}
+  bool need_setup() const noexcept override { return false; }
+  bool need_online() const noexcept override { return true; }
+  void evaluate_setup() override {}
+  void evaluate_online() override {}
+  std::vector<const NewWire*> get_input_wires() const override {
+    return {std::begin(inputs_), std::end(inputs_)};
+  }
+  std::vector<const NewWire*> get_output_wires() const override { return {output_.get()}; }
+  const Tensor* get_output() const { return output_.get(); }
+
+ private:
+  std::vector<const Tensor*> inputs_;
+  std::shared_ptr<Tensor> output_;
+};
+
+std::vector<std::unique_ptr<NewGate>> make_chain(std::size_t length, std::size_t size) {
+  std::vector<std::unique_ptr<NewGate>> gates;
+  const Tensor* previous = nullptr;
+  for (std::size_t i = 0; i < length; ++i) {
+    std::vector<const Tensor*> inputs;
+    if (previous != nullptr) {
+      inputs.push_back(previous);
+    }
+    auto gate = std::make_unique<DummyGate>(i, std::move(inputs), size);
+    previous = gate->get_output();
+    gates.push_back(std::move(gate));
+  }
+  return gates;
+}
+
+TEST(TensorMemoryPlan, ChainReusesBuffers) {
+  const std::size_t length = 10;
+  const std::size_t size = 100;
+  auto gates = make_chain(length, size);
+  auto plan = tensor::plan_tensor_memory(gates, 64);
+  ASSERT_EQ(plan.entries_.size(), length);
+  const std::size_t aligned_size = (size * sizeof(std::uint64_t) + 63) / 64 * 64;
+  EXPECT_EQ(plan.total_bytes_, length * aligned_size);
+  // only the input and output of the current gate are alive at the same time
+  EXPECT_EQ(plan.peak_bytes_, 2 * aligned_size);
+  for (const auto& entry : plan.entries_) {
+    EXPECT_EQ(entry.offset_ % 64, 0);
+    EXPECT_EQ(entry.size_, aligned_size);
+    EXPECT_LE(entry.offset_ + entry.size_, plan.peak_bytes_);
+  }
+}
+
+TEST(TensorMemoryPlan, NoOverlapOfLiveTensors) {
+  // a diamond with a long living input, repeated a few times
+  std::vector<std::unique_ptr<NewGate>> gates;
+  const Tensor* input = nullptr;
+  for (std::size_t i = 0; i < 5; ++i) {
+    std::vector<const Tensor*> inputs;
+    if (input != nullptr) {
+      inputs.push_back(input);
+    }
+    auto a = std::make_unique<DummyGate>(4 * i, inputs, 10 + i);
+    auto b = std::make_unique<DummyGate>(4 * i + 1, inputs, 300 - i);
+    auto c = std::make_unique<DummyGate>(4 * i + 2, std::vector{a->get_output()}, 7);
+    auto d = std::make_unique<DummyGate>(
+        4 * i + 3, std::vector{b->get_output(), c->get_output()}, 50);
+    input = d->get_output();
+    gates.push_back(std::move(a));
+    gates.push_back(std::move(b));
+    gates.push_back(std::move(c));
+    gates.push_back(std::move(d));
+  }
+  auto plan = tensor::plan_tensor_memory(gates, 32);
+  ASSERT_EQ(plan.entries_.size(), gates.size());
+  EXPECT_LT(plan.peak_bytes_, plan.total_bytes_);
+  for (std::size_t i = 0; i < plan.entries_.size(); ++i) {
+    const auto& e1 = plan.entries_[i];
+    EXPECT_EQ(e1.offset_ % 32, 0);
+    EXPECT_LE(e1.first_step_, e1.last_step_);
+    for (std::size_t j = i + 1; j < plan.entries_.size(); ++j) {
+      const auto& e2 = plan.entries_[j];
+      const bool alive_together =
+          e1.first_step_ <= e2.last_step_ && e2.first_step_ <= e1.last_step_;
+      const bool overlap = e1.offset_ < e2.offset_ + e2.size_ && e2.offset_ < e1.offset_ + e1.size_;
+      EXPECT_FALSE(alive_together && overlap);
+    }
+  }
+}
+
+}  // namespace
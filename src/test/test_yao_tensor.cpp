@@ -20,9 +20,12 @@
 // OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
 // SOFTWARE.
 
+#include <algorithm>
 #include <array>
+#include <future>
 #include <iterator>
 #include <memory>
+#include <random>
 #include <type_traits>
 
 #include <gtest/gtest.h>
@@ -199,6 +202,76 @@ class YaoTensorTest : public ::testing::Test {
   std::array<MOTION::Statistics::RunTimeStats, 2> stats_;
 };
 
+TEST_F(YaoTensorTest, StreamedGarbledCircuit) {
+  run_setup();
+  auto& garbler = *yao_providers_[garbler_i_];
+  auto& evaluator = *yao_providers_[evaluator_i_];
+  const auto& algo = circuit_loader_.load_relu_circuit(32);
+  const std::size_t num_simd = 5;
+  const auto num_and_gates =
+      std::count_if(std::begin(algo.gates_), std::end(algo.gates_), [](const auto& op) {
+        return op.type_ == ENCRYPTO::PrimitiveOperationType::AND;
+      });
+  const std::size_t num_blocks = YaoProvider::garbled_table_size * num_and_gates * num_simd;
+  const auto offset = garbler.get_global_offset();
+  const auto garbler_keys =
+      ENCRYPTO::block128_vector::make_random(algo.n_input_wires_parent_a_ * num_simd);
+  auto evaluator_keys = garbler_keys;
+  std::mt19937 gen(0x64);
+  std::uniform_int_distribution dist(0, 1);
+  for (std::size_t i = 0; i < evaluator_keys.size(); ++i) {
+    if (dist(gen) == 1) evaluator_keys[i] ^= offset;
+  }
+
+  // batches of single AND gates (with a batch size that does not divide the
+  // tables of an AND gate) and of several AND gates with a partial last batch
+  const std::array<std::size_t, 3> batch_sizes = {1, 7, 23};
+  for (std::size_t gate_id = 0; gate_id < batch_sizes.size(); ++gate_id) {
+    garbler.set_garbling_batch_size(batch_sizes[gate_id]);
+    auto tables_queue = evaluator.register_for_blocks_message_chunks(gate_id, num_blocks);
+    ENCRYPTO::block128_vector garbler_output_keys;
+    auto fut_g = std::async(std::launch::async, [&] {
+      garbler.send_garbled_circuit(gate_id, num_simd, algo, garbler_keys, {},
+                                   garbler_output_keys);
+    });
+    std::vector<MOTION::proto::MessageChunk<ENCRYPTO::block128_vector>> chunks;
+    for (std::size_t num_received = 0; num_received < num_blocks;) {
+      auto chunk = tables_queue->dequeue();
+      ASSERT_TRUE(chunk.has_value());
+      num_received += chunk->data_.size();
+      chunks.emplace_back(std::move(*chunk));
+    }
+    fut_g.get();
+    EXPECT_GT(chunks.size(), 1);
+
+    ENCRYPTO::block128_vector expected_tables;
+    ENCRYPTO::block128_vector expected_garbler_output_keys;
+    garbler.create_garbled_circuit(gate_id, num_simd, algo, garbler_keys, {}, expected_tables,
+                                   expected_garbler_output_keys);
+    ASSERT_EQ(garbler_output_keys.size(), expected_garbler_output_keys.size());
+    for (std::size_t i = 0; i < garbler_output_keys.size(); ++i) {
+      EXPECT_EQ(garbler_output_keys[i], expected_garbler_output_keys[i]);
+    }
+
+    // the evaluator reassembles the tables from chunks in any order
+    std::shuffle(std::begin(chunks), std::end(chunks), gen);
+    MOTION::proto::MessageChunkQueue<ENCRYPTO::block128_vector> shuffled_queue;
+    for (auto& chunk : chunks) {
+      shuffled_queue.enqueue(std::move(chunk));
+    }
+    ENCRYPTO::block128_vector evaluator_output_keys;
+    evaluator.evaluate_garbled_circuit(gate_id, num_simd, algo, evaluator_keys, {},
+                                       shuffled_queue, evaluator_output_keys);
+    ENCRYPTO::block128_vector expected_evaluator_output_keys;
+    evaluator.evaluate_garbled_circuit(gate_id, num_simd, algo, evaluator_keys, {},
+                                       expected_tables, expected_evaluator_output_keys);
+    ASSERT_EQ(evaluator_output_keys.size(), expected_evaluator_output_keys.size());
+    for (std::size_t i = 0; i < evaluator_output_keys.size(); ++i) {
+      EXPECT_EQ(evaluator_output_keys[i], expected_evaluator_output_keys[i]);
+    }
+  }
+}
+
 template <typename T>
 class YaoArithmeticGMWTensorTest : public YaoTensorTest {
  public:
@@ -786,6 +859,51 @@ TYPED_TEST(YaoArithmeticGMWTensorTest, MaxPoolInBooleanGMW) {
   EXPECT_EQ(output, expected_output);
 }
 
+TYPED_TEST(YaoArithmeticGMWTensorTest, ArgMax) {
+  const MOTION::tensor::TensorDimensions dims = {
+      .batch_size_ = 2, .num_channels_ = 5, .height_ = 1, .width_ = 1};
+  // the first maximum is selected on ties
+  const std::vector<TypeParam> input = {13, 42, 47, 37, 47, 5, 99, 3, 0, 98};
+  const std::vector<bool> expected_output = {0, 0, 1, 0, 0, 0, 1, 0, 0, 0};
+
+  auto [input_promise, tensor_in_0] = this->make_arithmetic_T_tensor_input_my(0, dims);
+  auto tensor_in_1 = this->make_arithmetic_T_tensor_input_other(1, dims);
+
+  auto tensor_0 = this->yao_providers_[0]->make_convert_from_arithmetic_gmw_tensor(tensor_in_0);
+  auto tensor_1 = this->yao_providers_[1]->make_convert_from_arithmetic_gmw_tensor(tensor_in_1);
+  auto output_tensor_0 = this->yao_providers_[0]->make_tensor_argmax_op(tensor_0);
+  auto output_tensor_1 = this->yao_providers_[1]->make_tensor_argmax_op(tensor_1);
+
+  ASSERT_EQ(output_tensor_0->get_dimensions(), dims);
+  ASSERT_EQ(output_tensor_1->get_dimensions(), dims);
+  ASSERT_EQ(output_tensor_0->get_bit_size(), 1);
+
+  this->run_setup();
+  this->run_gates_setup();
+  input_promise.set_value(input);
+  this->run_gates_online();
+
+  const auto yao_tensor_0 = std::dynamic_pointer_cast<const YaoTensor>(output_tensor_0);
+  const auto yao_tensor_1 = std::dynamic_pointer_cast<const YaoTensor>(output_tensor_1);
+  ASSERT_NE(yao_tensor_0, nullptr);
+  ASSERT_NE(yao_tensor_1, nullptr);
+  yao_tensor_0->wait_setup();
+  yao_tensor_1->wait_online();
+
+  const auto& R = this->yao_providers_[0]->get_global_offset();
+  const auto& zero_keys = yao_tensor_0->get_keys();
+  const auto& evaluator_keys = yao_tensor_1->get_keys();
+  ASSERT_EQ(zero_keys.size(), expected_output.size());
+  ASSERT_EQ(evaluator_keys.size(), expected_output.size());
+  for (std::size_t i = 0; i < expected_output.size(); ++i) {
+    if (expected_output[i]) {
+      EXPECT_EQ(evaluator_keys.at(i), zero_keys.at(i) ^ R);
+    } else {
+      EXPECT_EQ(evaluator_keys.at(i), zero_keys.at(i));
+    }
+  }
+}
+
 template <typename T>
 class YaoArithmeticBEAVYTensorTest : public YaoTensorTest {
  public:
@@ -1194,3 +1312,52 @@ TYPED_TEST(YaoArithmeticBEAVYTensorTest, MaxPoolInBooleanBEAVY) {
   const auto output = output_future.get();
   EXPECT_EQ(output, expected_output);
 }
+
+TYPED_TEST(YaoArithmeticBEAVYTensorTest, ArgMaxInBooleanBEAVY) {
+  const MOTION::tensor::TensorDimensions dims = {
+      .batch_size_ = 2, .num_channels_ = 5, .height_ = 1, .width_ = 1};
+  // the first maximum is selected on ties
+  const std::vector<TypeParam> input = {13, 42, 47, 37, 47, 5, 99, 3, 0, 98};
+  const std::vector<bool> expected_output = {0, 0, 1, 0, 0, 0, 1, 0, 0, 0};
+
+  auto [input_promise, tensor_in_0] = this->make_arithmetic_T_tensor_input_my(0, dims);
+  auto tensor_in_1 = this->make_arithmetic_T_tensor_input_other(1, dims);
+
+  auto tensor_yao_0 =
+      this->yao_providers_[0]->make_convert_from_arithmetic_beavy_tensor(tensor_in_0);
+  auto tensor_yao_1 =
+      this->yao_providers_[1]->make_convert_from_arithmetic_beavy_tensor(tensor_in_1);
+  auto tensor_bbeavy_0 =
+      this->yao_providers_[0]->make_convert_to_boolean_beavy_tensor(tensor_yao_0);
+  auto tensor_bbeavy_1 =
+      this->yao_providers_[1]->make_convert_to_boolean_beavy_tensor(tensor_yao_1);
+  auto output_tensor_0 = this->beavy_providers_[0]->make_tensor_argmax_op(tensor_bbeavy_0);
+  auto output_tensor_1 = this->beavy_providers_[1]->make_tensor_argmax_op(tensor_bbeavy_1);
+
+  ASSERT_EQ(output_tensor_0->get_dimensions(), dims);
+  ASSERT_EQ(output_tensor_1->get_dimensions(), dims);
+  ASSERT_EQ(output_tensor_0->get_bit_size(), 1);
+
+  this->run_setup();
+  this->run_gates_setup();
+  input_promise.set_value(input);
+  this->run_gates_online();
+
+  const auto bbeavy_tensor_0 =
+      std::dynamic_pointer_cast<const BooleanBEAVYTensor>(output_tensor_0);
+  const auto bbeavy_tensor_1 =
+      std::dynamic_pointer_cast<const BooleanBEAVYTensor>(output_tensor_1);
+  ASSERT_NE(bbeavy_tensor_0, nullptr);
+  ASSERT_NE(bbeavy_tensor_1, nullptr);
+  bbeavy_tensor_0->wait_online();
+  bbeavy_tensor_1->wait_online();
+
+  const auto& public_share = bbeavy_tensor_0->get_public_share().at(0);
+  ASSERT_EQ(public_share, bbeavy_tensor_1->get_public_share().at(0));
+  const auto output = public_share ^ bbeavy_tensor_0->get_secret_share().at(0) ^
+                      bbeavy_tensor_1->get_secret_share().at(0);
+  ASSERT_EQ(output.GetSize(), expected_output.size());
+  for (std::size_t i = 0; i < expected_output.size(); ++i) {
+    EXPECT_EQ(output.Get(i), expected_output[i]);
+  }
+}